@@ -90,4 +90,28 @@ BOOST_AUTO_TEST_CASE( CMA_Sphere_Niko )
 	BOOST_CHECK(!condHigh);
 }
 
+BOOST_AUTO_TEST_CASE( CMA_Ellipsoid_LazyUpdate )
+{
+	const unsigned N = 10;
+	RealVector x0(N, 0.1);
+	Ellipsoid elli(N, 1E6);
+
+	CMA cma;
+	cma.eigenUpdateInterval() = 5;
+	cma.init(elli, x0);
+	cma.setSigma(0.1);
+
+	RealVector lastEigenValues = cma.eigenValues();
+	for(unsigned i=0; i<6000; i++){
+		cma.step( elli );
+		//the eigendecomposition is only updated every 5 generations
+		if(i % 5 == 4)
+			lastEigenValues = cma.eigenValues();
+		else
+			BOOST_REQUIRE_EQUAL(norm_inf(cma.eigenValues() - lastEigenValues), 0.0);
+	}
+	BOOST_CHECK(cma.solution().value < 1E-8);
+	BOOST_CHECK(cma.condition() > 1E5);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+#define BOOST_TEST_MODULE ML_Adam
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Algorithms/GradientDescent/Adam.h>
+#include <shark/ObjectiveFunctions/ErrorFunction.h>
+#include <shark/ObjectiveFunctions/Loss/SquaredLoss.h>
+#include <shark/Models/LinearModel.h>
+#include <shark/Rng/Uniform.h>
+
+using namespace shark;
+
+struct TestFunction : public SingleObjectiveFunction
+{
+	typedef SingleObjectiveFunction Base;
+
+	RealMatrix A;
+	TestFunction():A(3,3,0.0)
+	{
+
+		A(0,0)=10;
+		A(1,1)=5;
+		A(2,2)=1;
+		A(1,0)=1;
+		A(0,1)=1;
+		A(2,0)=1;
+		A(0,2)=1;
+
+		m_features|=Base::HAS_FIRST_DERIVATIVE;
+	}
+
+	std::string name() const
+	{ return "TestFunction"; }
+
+	std::size_t numberOfVariables()const{
+		return 3;
+	}
+
+	virtual double eval(RealVector const& pattern)const
+	{
+		return inner_prod(prod(A,pattern),pattern);
+	}
+	virtual double evalDerivative(RealVector const& pattern, FirstOrderDerivative& derivative)const
+	{
+		derivative = 2*prod(A,pattern);
+		return eval(pattern);
+	}
+};
+
+
+BOOST_AUTO_TEST_SUITE (Algorithms_GradientDescent_Adam)
+
+BOOST_AUTO_TEST_CASE( Adam_Test )
+{
+	TestFunction function;
+	RealVector start(3);//startingPoint
+	start(0)=1;
+	start(1)=1;
+	start(2)=1;
+	Adam optimizer;
+	optimizer.setLearningRate(0.1);
+	optimizer.setLearningRateDecay(0.1);
+	optimizer.init(function,start);
+
+	std::cout<<"Testing: "<<optimizer.name()<<" with "<<function.name()<<std::endl;
+	double error=0;
+	for(size_t iteration=0;iteration<2000;++iteration)
+	{
+		optimizer.step(function);
+		error=optimizer.solution().value;
+	}
+	BOOST_CHECK_SMALL(error,1.e-10);
+}
+
+//linear regression where every step only sees a single random batch of the dataset
+BOOST_AUTO_TEST_CASE( Adam_Minibatch )
+{
+	const size_t trainExamples = 1000;
+	LinearModel<> model(2,2,true);
+	RealVector optimum(6);
+	for(std::size_t i = 0; i != 6; ++i){
+		optimum(i) = i-2.0;
+	}
+	model.setParameterVector(optimum);
+
+	Uniform<> uniform(Rng::globalRng,-3.0, 3.0);
+	std::vector<RealVector> input(trainExamples,RealVector(2));
+	std::vector<RealVector> target(trainExamples,RealVector(2));
+	for (size_t i=0;i!=trainExamples;++i) {
+		input[i](0) = uniform();
+		input[i](1) = uniform();
+		target[i] =  model(input[i]);
+		target[i](0) += 0.1*uniform();
+		target[i](1) += 0.1*uniform();
+	}
+	RegressionDataset trainset = createLabeledDataFromRange(input, target,100);
+	SquaredLoss<> loss;
+	ErrorFunction mse(trainset, &model,&loss);
+	mse.setNumBatches(1);
+
+	RealVector start(6,0.5);
+	Adam optimizer;
+	optimizer.setLearningRate(0.05);
+	optimizer.setLearningRateDecay(0.01);
+	optimizer.init(mse,start);
+	for(std::size_t i = 0; i != 1000; ++i){
+		optimizer.step(mse);
+	}
+	double diff = norm_sqr(optimizer.solution().point-optimum);
+	BOOST_CHECK_SMALL(diff, 1.e-3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+#define BOOST_TEST_MODULE ML_SGD
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Algorithms/GradientDescent/SGD.h>
+
+using namespace shark;
+
+struct TestFunction : public SingleObjectiveFunction
+{
+	typedef SingleObjectiveFunction Base;
+
+	RealMatrix A;
+	TestFunction():A(3,3,0.0)
+	{
+
+		A(0,0)=10;
+		A(1,1)=5;
+		A(2,2)=1;
+		A(1,0)=1;
+		A(0,1)=1;
+		A(2,0)=1;
+		A(0,2)=1;
+
+		m_features|=Base::HAS_FIRST_DERIVATIVE;
+	}
+
+	std::string name() const
+	{ return "TestFunction"; }
+
+	std::size_t numberOfVariables()const{
+		return 3;
+	}
+
+	virtual double eval(RealVector const& pattern)const
+	{
+		return inner_prod(prod(A,pattern),pattern);
+	}
+	virtual double evalDerivative(RealVector const& pattern, FirstOrderDerivative& derivative)const
+	{
+		derivative = 2*prod(A,pattern);
+		return eval(pattern);
+	}
+};
+
+
+BOOST_AUTO_TEST_SUITE (Algorithms_GradientDescent_SGD)
+
+BOOST_AUTO_TEST_CASE( SGD_Momentum )
+{
+	TestFunction function;
+	RealVector start(3);//startingPoint
+	start(0)=1;
+	start(1)=1;
+	start(2)=1;
+	SGD optimizer;
+	optimizer.setLearningRate(0.05);
+	optimizer.setMomentum(0.5);
+	optimizer.init(function,start);
+
+	std::cout<<"Testing: "<<optimizer.name()<<" with "<<function.name()<<std::endl;
+	double error=0;
+	for(size_t iteration=0;iteration<200;++iteration)
+	{
+		optimizer.step(function);
+		error=optimizer.solution().value;
+	}
+	BOOST_CHECK_SMALL(error,1.e-15);
+}
+
+BOOST_AUTO_TEST_CASE( SGD_Nesterov )
+{
+	TestFunction function;
+	RealVector start(3);//startingPoint
+	start(0)=1;
+	start(1)=1;
+	start(2)=1;
+	SGD optimizer;
+	optimizer.setLearningRate(0.05);
+	optimizer.setMomentum(0.5);
+	optimizer.setNesterov(true);
+	optimizer.init(function,start);
+
+	std::cout<<"Testing: "<<optimizer.name()<<" with "<<function.name()<<std::endl;
+	double error=0;
+	for(size_t iteration=0;iteration<200;++iteration)
+	{
+		optimizer.step(function);
+		error=optimizer.solution().value;
+	}
+	BOOST_CHECK_SMALL(error,1.e-15);
+}
+
+//a decaying learning rate slows down the optimization but still converges
+BOOST_AUTO_TEST_CASE( SGD_LearningRateDecay )
+{
+	TestFunction function;
+	RealVector start(3);//startingPoint
+	start(0)=1;
+	start(1)=1;
+	start(2)=1;
+	SGD optimizer;
+	optimizer.setLearningRate(0.05);
+	optimizer.setLearningRateDecay(0.01);
+	optimizer.init(function,start);
+	BOOST_CHECK_CLOSE(optimizer.currentLearningRate(),0.05,1.e-10);
+
+	std::cout<<"Testing: "<<optimizer.name()<<" with "<<function.name()<<std::endl;
+	double error=0;
+	for(size_t iteration=0;iteration<500;++iteration)
+	{
+		optimizer.step(function);
+		error=optimizer.solution().value;
+	}
+	BOOST_CHECK_CLOSE(optimizer.currentLearningRate(),0.05/6,1.e-10);
+	BOOST_CHECK_SMALL(error,1.e-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -34,6 +34,7 @@
 //===========================================================================
 
 #include <shark/Algorithms/JaakkolaHeuristic.h>
+#include <shark/Rng/GlobalRng.h>
 
 #define BOOST_TEST_MODULE Algorithms_JaakkolaHeuristic
 #include <boost/test/unit_test.hpp>
@@ -91,4 +92,53 @@ BOOST_AUTO_TEST_CASE( Algorithms_JaakkolaHeuristic )
 	BOOST_CHECK_SMALL(std::abs(sigma - 2.0), 1e-14);
 }
 
+//compares the blocked computation on several classes to the naive loops
+//and checks that the sampled estimates are close
+BOOST_AUTO_TEST_CASE( Algorithms_JaakkolaHeuristic_Blocked )
+{
+	std::size_t elements = 1500;
+	std::vector<RealVector> inputs(elements, RealVector(3));
+	std::vector<unsigned int> targets(elements);
+	for(std::size_t i = 0; i != elements; ++i){
+		targets[i] = Rng::discrete(0,2);
+		for(std::size_t j = 0; j != 3; ++j)
+			inputs[i](j) = Rng::gauss() + targets[i];
+	}
+	ClassificationDataset dataset = createLabeledDataFromRange(inputs, targets, 100);
+
+	std::vector<double> pairs;
+	std::vector<double> nearest;
+	for(std::size_t i = 0; i != elements; ++i){
+		double minDist = std::numeric_limits<double>::max();
+		for(std::size_t j = 0; j != elements; ++j){
+			if(targets[i] == targets[j]) continue;
+			double dist = distanceSqr(inputs[i],inputs[j]);
+			minDist = std::min(minDist,dist);
+			if(j > i) pairs.push_back(dist);
+		}
+		nearest.push_back(minDist);
+	}
+	std::sort(pairs.begin(),pairs.end());
+	std::sort(nearest.begin(),nearest.end());
+	std::size_t quarter = (pairs.size()-1)/4;
+
+	JaakkolaHeuristic all(dataset, false);
+	BOOST_CHECK_SMALL(all.sigma(0.0) - std::sqrt(pairs.front()), 1e-12);
+	BOOST_CHECK_SMALL(all.sigma(1.0) - std::sqrt(pairs.back()), 1e-12);
+	BOOST_CHECK_SMALL(all.sigma(double(quarter)/(pairs.size()-1)) - std::sqrt(pairs[quarter]), 1e-12);
+	JaakkolaHeuristic nearestFalse(dataset);
+	BOOST_CHECK_SMALL(nearestFalse.sigma(0.0) - std::sqrt(nearest.front()), 1e-12);
+	BOOST_CHECK_SMALL(nearestFalse.sigma(1.0) - std::sqrt(nearest.back()), 1e-12);
+
+	//the sampled median must be a true quantile close to 0.5
+	JaakkolaHeuristic sampledPairs(dataset, false, 20000);
+	double median = sampledPairs.sigma();
+	double rank = double(std::lower_bound(pairs.begin(),pairs.end(),median*median) - pairs.begin())/pairs.size();
+	BOOST_CHECK_SMALL(rank - 0.5, 0.03);
+	JaakkolaHeuristic sampledNearest(dataset, true, 800);
+	median = sampledNearest.sigma();
+	rank = double(std::lower_bound(nearest.begin(),nearest.end(),median*median) - nearest.begin())/nearest.size();
+	BOOST_CHECK_SMALL(rank - 0.5, 0.06);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,153 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Pegasos Test
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#define BOOST_TEST_MODULE ALGORITHMS_PEGASOS
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Algorithms/Pegasos.h>
+#include <shark/Algorithms/Trainers/CSvmTrainer.h>
+#include <shark/Rng/GlobalRng.h>
+
+
+using namespace shark;
+
+namespace{
+// two overlapping Gaussian clouds
+template<class VectorType>
+LabeledData<VectorType, unsigned int> createProblem(std::size_t ell, std::size_t dim){
+	std::vector<VectorType> input(ell, VectorType(dim));
+	std::vector<unsigned int> target(ell);
+	for(std::size_t i = 0; i != ell; ++i){
+		target[i] = Rng::coinToss() ? 1 : 0;
+		for(std::size_t d = 0; d != dim; ++d){
+			double mean = (d == 0) ? 2.0 * target[i] - 1.0 : 0.0;
+			input[i](d) = Rng::gauss(mean, 1.0);
+		}
+	}
+	return createLabeledDataFromRange(input, target, 50);
+}
+
+// primal SVM objective without bias
+template<class VectorType>
+double primal(LabeledData<VectorType, unsigned int> const& data, RealVector const& w, double C){
+	double value = 0.5 * norm_sqr(w);
+	for(std::size_t i = 0; i != data.numberOfElements(); ++i){
+		double y = 2.0 * data.element(i).label - 1.0;
+		value += C * std::max(0.0, 1.0 - y * inner_prod(w, data.element(i).input));
+	}
+	return value;
+}
+}
+
+BOOST_AUTO_TEST_SUITE (Algorithms_Pegasos)
+
+BOOST_AUTO_TEST_CASE( Pegasos_Binary )
+{
+	Rng::seed(42);
+	double C = 0.1;
+	LabeledData<RealVector, unsigned int> data = createProblem<RealVector>(500, 5);
+
+	// reference solution of the dual problem
+	LinearClassifier<RealVector> svm;
+	LinearCSvmTrainer<RealVector> trainer(C);
+	trainer.stoppingCondition().minAccuracy = 1e-6;
+	trainer.train(svm, data);
+	double optimum = primal(data, row(svm.decisionFunction().matrix(), 0), C);
+
+	std::size_t batchsizes[] = {1, 10, 100};
+	for(std::size_t b = 0; b != 3; ++b){
+		for(std::size_t averaging = 0; averaging != 2; ++averaging){
+			RealVector w(5);
+			std::size_t predictions = Pegasos<RealVector>::solve(data, C, w, batchsizes[b], 0.01, averaging == 1);
+			double value = primal(data, w, C);
+			std::cout << "batch size " << batchsizes[b] << " averaging " << averaging << ": " << value << " vs. " << optimum << std::endl;
+			BOOST_CHECK(predictions > 0);
+			BOOST_CHECK(value >= optimum - 1e-6);
+			BOOST_CHECK_CLOSE(value, optimum, 0.5);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( Pegasos_Sparse )
+{
+	Rng::seed(42);
+	double C = 0.1;
+	LabeledData<RealVector, unsigned int> dense = createProblem<RealVector>(500, 5);
+	std::vector<CompressedRealVector> input(500, CompressedRealVector(5));
+	std::vector<unsigned int> target(500);
+	for(std::size_t i = 0; i != 500; ++i){
+		for(std::size_t d = 0; d != 5; ++d) input[i](d) = dense.element(i).input(d);
+		target[i] = dense.element(i).label;
+	}
+	LabeledData<CompressedRealVector, unsigned int> sparse = createLabeledDataFromRange(input, target, 50);
+
+	RealVector w_dense(5);
+	RealVector w_sparse(5);
+	Pegasos<RealVector>::solve(dense, C, w_dense, 100, 0.01, true);
+	Pegasos<CompressedRealVector>::solve(sparse, C, w_sparse, 100, 0.01, true);
+	BOOST_CHECK_CLOSE(primal(sparse, w_sparse, C), primal(dense, w_dense, C), 0.5);
+}
+
+BOOST_AUTO_TEST_CASE( Pegasos_MultiClass )
+{
+	Rng::seed(42);
+	std::size_t classes = 3;
+	std::vector<RealVector> input(300, RealVector(classes));
+	std::vector<unsigned int> target(300);
+	for(std::size_t i = 0; i != 300; ++i){
+		target[i] = i % classes;
+		for(std::size_t d = 0; d != classes; ++d) input[i](d) = Rng::gauss((d == target[i]) ? 2.0 : 0.0, 0.25);
+	}
+	LabeledData<RealVector, unsigned int> data = createLabeledDataFromRange(input, target, 50);
+
+	for(std::size_t averaging = 0; averaging != 2; ++averaging){
+		std::vector<RealVector> w(classes, RealVector(classes));
+		McPegasos<RealVector>::solve(
+			data, McPegasos<RealVector>::emRelative, McPegasos<RealVector>::elDiscriminativeMax,
+			true, 1.0, w, 64, 0.01, averaging == 1
+		);
+		std::size_t errors = 0;
+		for(std::size_t i = 0; i != 300; ++i){
+			std::size_t best = 0;
+			for(std::size_t c = 1; c != classes; ++c)
+				if(inner_prod(w[c], input[i]) > inner_prod(w[best], input[i])) best = c;
+			if(best != target[i]) errors++;
+		}
+		BOOST_CHECK_EQUAL(errors, 0);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -42,6 +42,7 @@
 #include <shark/LinAlg/KernelMatrix.h>
 #include <shark/Models/Kernels/GaussianRbfKernel.h>
 #include <shark/Models/Kernels/KernelExpansion.h>
+#include <shark/Rng/GlobalRng.h>
 
 
 using namespace shark;
@@ -98,8 +99,93 @@ BOOST_AUTO_TEST_CASE( MergeBudgetMaintenanceStrategy_MergingProblemFunction)
 
 
 
+BOOST_AUTO_TEST_CASE( MergeBudgetMaintenanceStrategy_solveMergingProblems)
+{
+    // the same problems as above, solved at once
+    RealVector a(3), b(3), k(3), h;
+    a(0) = 1.0; b(0) = 1.0; k(0) = 1.0;
+    a(1) = 0.0; b(1) = 1.0; k(1) = 0.5;
+    a(2) = 0.1; b(2) = 0.2; k(2) = 0.2;
+    MergeBudgetMaintenanceStrategy<RealVector>::solveMergingProblems(a, b, k, h);
+    BOOST_REQUIRE_EQUAL(h.size(), 3u);
+    BOOST_CHECK(h(0) >= 0.0 && h(0) <= 1.0);
+    BOOST_CHECK_SMALL(h(1), 0.00001);
+    BOOST_CHECK_SMALL(h(2) - 0.133040685, 0.00001);
+}
+
+
 BOOST_AUTO_TEST_CASE( MergeBudgetMaintenanceStrategy_reduceBudget)
 {
+    // a budget of 20 vectors plus the buffer vector
+    std::size_t budget = 21;
+    std::size_t classes = 3;
+    std::vector<RealVector> points(budget, RealVector(2));
+    for(std::size_t i = 0; i != budget; ++i)
+    {
+        points[i](0) = Rng::gauss();
+        points[i](1) = Rng::gauss();
+    }
+    // the buffer vector is far away, so that it is not merged
+    points[budget - 1](0) = 100;
+    GaussianRbfKernel<> kernel(0.5);
+    KernelExpansion<RealVector> model(&kernel, createDataFromRange(points, 8), false, classes);
+    for(std::size_t i = 0; i != budget; ++i)
+        for(std::size_t c = 0; c != classes; ++c)
+            model.alpha(i, c) = Rng::uni(0.1, 1.0);
+    std::size_t firstIndex = 3;
+    RealMatrix alpha = model.alpha();
+
+    // find the best candidate naively, each merging problem solved on a fine grid
+    double minDegradation = std::numeric_limits<double>::infinity();
+    std::size_t secondIndex = 0;
+    double minH = 0;
+    for(std::size_t j = 0; j != budget; ++j)
+    {
+        if(j == firstIndex) continue;
+        double k = kernel.eval(points[firstIndex], points[j]);
+        double a = 0;
+        double b = 0;
+        for(std::size_t c = 0; c != classes; ++c)
+        {
+            double d = std::min(0.00001, alpha(j, c) + alpha(firstIndex, c));
+            a += alpha(firstIndex, c) / d;
+            b += alpha(j, c) / d;
+        }
+        double h = 0;
+        double best = -std::numeric_limits<double>::infinity();
+        for(std::size_t step = 0; step <= 100000; ++step)
+        {
+            double x = step / 100000.0;
+            double value = a * std::pow(k, (1 - x) * (1 - x)) + b * std::pow(k, x * x);
+            if(value > best)
+            {
+                best = value;
+                h = x;
+            }
+        }
+        double degradation = 0;
+        for(std::size_t c = 0; c != classes; ++c)
+        {
+            double z = std::pow(k, (1 - h) * (1 - h)) * alpha(firstIndex, c) + std::pow(k, h * h) * alpha(j, c);
+            degradation += sqr(alpha(firstIndex, c)) + sqr(alpha(j, c)) + 2.0 * k * alpha(firstIndex, c) * alpha(j, c) - z * z;
+        }
+        if(degradation < minDegradation)
+        {
+            minDegradation = degradation;
+            secondIndex = j;
+            minH = h;
+        }
+    }
+    RealVector merged = minH * points[firstIndex] + (1 - minH) * points[secondIndex];
+
+    MergeBudgetMaintenanceStrategy<RealVector> strategy;
+    strategy.reduceBudget(model, firstIndex);
+
+    // the merged vector replaces the second one, the buffer moves to the first index
+    BOOST_REQUIRE(secondIndex != budget - 1);
+    BOOST_CHECK_SMALL(norm_2(model.basis().element(secondIndex) - merged), 1.e-4);
+    BOOST_CHECK_SMALL(norm_2(model.basis().element(firstIndex) - points[budget - 1]), 1.e-12);
+    BOOST_CHECK_SMALL(norm_inf(row(model.alpha(), budget - 1)), 1.e-12);
 }
 
 
@@ -0,0 +1,142 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       ReducedSetApproximation Test
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+#define BOOST_TEST_MODULE REDUCEDSETAPPROXIMATION
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Algorithms/Trainers/Budgeted/ReducedSetApproximation.h>
+#include <shark/Data/DataDistribution.h>
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/Rng/GlobalRng.h>
+
+
+using namespace shark;
+
+namespace{
+//computes the squared feature space distance between two expansions directly
+double featureDistance(KernelExpansion<RealVector> const& e1, KernelExpansion<RealVector> const& e2){
+	AbstractKernelFunction<RealVector> const& kernel = *e1.kernel();
+	RealMatrix x1 = createBatch(e1.basis().elements());
+	RealMatrix x2 = createBatch(e2.basis().elements());
+	RealMatrix const& a1 = e1.alpha();
+	RealMatrix const& a2 = e2.alpha();
+	return sum(a1 * prod(kernel(x1,x1),a1)) - 2*sum(a1 * prod(kernel(x1,x2),a2)) + sum(a2 * prod(kernel(x2,x2),a2));
+}
+
+void createExpansion(KernelExpansion<RealVector>& expansion, AbstractKernelFunction<RealVector>* kernel){
+	Chessboard problem;
+	LabeledData<RealVector, unsigned int> dataset = problem.generateDataset(100,16);
+	expansion.setStructure(kernel, dataset.inputs(), true, 2);
+	for(std::size_t i = 0; i != 100; ++i){
+		expansion.alpha(i,0) = Rng::gauss(0,1);
+		expansion.alpha(i,1) = Rng::gauss(0,1);
+	}
+	expansion.offset(0) = 0.5;
+	expansion.offset(1) = -0.5;
+}
+}
+
+BOOST_AUTO_TEST_SUITE (Algorithms_Trainers_Budgeted_ReducedSetApproximation_Test)
+
+BOOST_AUTO_TEST_CASE( ReducedSetApproximation_LargeBudget )
+{
+	GaussianRbfKernel<> kernel(0.5);
+	KernelExpansion<RealVector> expansion;
+	createExpansion(expansion, &kernel);
+
+	ReducedSetApproximation reduction(100);
+	KernelExpansion<RealVector> approximation;
+	reduction.approximate(expansion, approximation);
+	BOOST_CHECK_EQUAL(approximation.basis().numberOfElements(), 100);
+	BOOST_CHECK_EQUAL(reduction.squaredError(), 0.0);
+	BOOST_CHECK_SMALL(featureDistance(expansion, approximation), 1.e-10);
+}
+
+BOOST_AUTO_TEST_CASE( ReducedSetApproximation_Merge )
+{
+	for(std::size_t trial = 0; trial != 5; ++trial){
+		GaussianRbfKernel<> kernel(0.5);
+		KernelExpansion<RealVector> expansion;
+		createExpansion(expansion, &kernel);
+
+		ReducedSetApproximation reduction(20);
+		KernelExpansion<RealVector> approximation;
+		reduction.approximate(expansion, approximation);
+
+		BOOST_REQUIRE_EQUAL(approximation.basis().numberOfElements(), 20);
+		BOOST_REQUIRE_EQUAL(approximation.outputSize(), 2);
+		BOOST_CHECK_EQUAL(approximation.offset(0), 0.5);
+		BOOST_CHECK_EQUAL(approximation.offset(1), -0.5);
+
+		//the reported error is the true feature space distance
+		double error = featureDistance(expansion, approximation);
+		BOOST_CHECK_CLOSE(reduction.squaredError(), error, 1.e-6);
+		BOOST_CHECK(reduction.relativeError() < 1.0);
+		BOOST_CHECK(reduction.relativeError() > 0.0);
+
+		//predictions are bounded by the feature space error, since k(x,x) = 1
+		RealMatrix inputs = createBatch(expansion.basis().elements());
+		RealMatrix difference = expansion(inputs) - approximation(inputs);
+		for(std::size_t i = 0; i != inputs.size1(); ++i){
+			BOOST_CHECK(norm_sqr(row(difference,i)) <= error + 1.e-10);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( ReducedSetApproximation_Optimization )
+{
+	for(std::size_t trial = 0; trial != 5; ++trial){
+		GaussianRbfKernel<> kernel(0.5);
+		KernelExpansion<RealVector> expansion;
+		createExpansion(expansion, &kernel);
+
+		ReducedSetApproximation reduction(20, 0, ReducedSetApproximation::RandomInitialization);
+		KernelExpansion<RealVector> approximation;
+		Rng::seed(42+trial);
+		reduction.approximate(expansion, approximation);
+		double initialError = reduction.squaredError();
+		BOOST_CHECK_CLOSE(initialError, featureDistance(expansion, approximation), 1.e-6);
+
+		//same initialization, but optimized basis vectors
+		reduction.setIterations(50);
+		Rng::seed(42+trial);
+		reduction.approximate(expansion, approximation);
+		BOOST_CHECK_CLOSE(reduction.squaredError(), featureDistance(expansion, approximation), 1.e-6);
+		BOOST_CHECK(reduction.squaredError() <= initialError);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       KernelSGDTrainer Test
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#define BOOST_TEST_MODULE ALGORITHMS_TRAINERS_KERNELSGDTRAINER
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Algorithms/Trainers/KernelSGDTrainer.h>
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/ObjectiveFunctions/Loss/CrossEntropy.h>
+#include <shark/ObjectiveFunctions/Loss/ZeroOneLoss.h>
+#include <shark/Data/DataDistribution.h>
+
+
+using namespace shark;
+
+BOOST_AUTO_TEST_SUITE (Algorithms_Trainers_KernelSGDTrainer)
+
+BOOST_AUTO_TEST_CASE( KernelSGDTrainer_Minibatch )
+{
+	Rng::seed(42);
+	Chessboard problem;
+	ClassificationDataset training = problem.generateDataset(400, 50);
+	ClassificationDataset test = problem.generateDataset(1000);
+
+	GaussianRbfKernel<> kernel(4.0);
+	CrossEntropy loss;
+	ZeroOneLoss<unsigned int> zeroOne;
+	KernelSGDTrainer<RealVector> trainer(&kernel, &loss, 100.0, true);
+	BOOST_CHECK_EQUAL(trainer.minibatchSize(), 1);
+	BOOST_CHECK(!trainer.averaging());
+
+	std::size_t minibatchSizes[] = {1, 10};
+	for(std::size_t m = 0; m != 2; ++m){
+		for(std::size_t averaging = 0; averaging != 2; ++averaging){
+			trainer.setMinibatchSize(minibatchSizes[m]);
+			trainer.setAveraging(averaging == 1);
+			KernelClassifier<RealVector> classifier;
+			trainer.train(classifier, training);
+
+			BOOST_REQUIRE_EQUAL(classifier.decisionFunction().alpha().size1(), 400);
+			double error = zeroOne(test.labels(), classifier(test.inputs()));
+			std::cout << "minibatch size " << minibatchSizes[m] << " averaging " << averaging << ": test error " << error << std::endl;
+			BOOST_CHECK_SMALL(error, 0.15);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
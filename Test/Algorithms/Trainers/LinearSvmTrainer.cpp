@@ -56,6 +56,7 @@
 #include <shark/Algorithms/Trainers/McSvmADMTrainer.h>
 #include <shark/Algorithms/Trainers/McSvmATSTrainer.h>
 #include <shark/Algorithms/Trainers/McSvmATMTrainer.h>
+#include <shark/Algorithms/Trainers/CSvmTrainer.h>
 
 
 using namespace shark;
@@ -167,4 +168,114 @@ BOOST_AUTO_TEST_CASE( MCSVM_TRAINER_TEST )
 	}
 }
 
+// This test case checks that the asynchronous parallel
+// mode of the linear solvers converges to the same
+// solution as the sequential mode.
+BOOST_AUTO_TEST_CASE( LINEAR_SVM_PARALLEL_TEST )
+{
+	size_t classes = 4;
+	size_t dim = 8;
+	size_t ell = 400;
+
+	const size_t var_per_class = dim / classes;
+
+	double C = 1.0;
+
+	AbstractLinearSvmTrainer<CompressedRealVector>* trainer[9];
+	trainer[0] = new LinearMcSvmMMRTrainer<CompressedRealVector>(C);
+	trainer[1] = new LinearMcSvmOVATrainer<CompressedRealVector>(C);
+	trainer[2] = new LinearMcSvmWWTrainer<CompressedRealVector>(C);
+	trainer[3] = new LinearMcSvmCSTrainer<CompressedRealVector>(C);
+	trainer[4] = new LinearMcSvmLLWTrainer<CompressedRealVector>(C);
+	trainer[5] = new LinearMcSvmADMTrainer<CompressedRealVector>(C);
+	trainer[6] = new LinearMcSvmATSTrainer<CompressedRealVector>(C);
+	trainer[7] = new LinearMcSvmATMTrainer<CompressedRealVector>(C);
+	trainer[8] = new LinearCSvmTrainer<CompressedRealVector>(C);
+
+	// generate random sparse training set
+	Rng::seed(42);
+	vector<CompressedRealVector> input(ell, CompressedRealVector(dim));
+	vector<unsigned int> target(ell);
+	for (size_t i=0; i<ell; i++)
+	{
+		unsigned int label = Rng::discrete(0, classes - 1);
+		for (unsigned int d=0; d<dim; d++)
+		{
+			if ((d / var_per_class) == label) input[i](d) = 0.5 * Rng::gauss() + 1.0;
+			else if (Rng::coinToss(0.3)) input[i](d) = 0.5 * Rng::gauss() - 1.0;
+		}
+		target[i] = label;
+	}
+	LabeledData<CompressedRealVector, unsigned int> dataset = createLabeledDataFromRange(input, target);
+	LabeledData<CompressedRealVector, unsigned int> binaryDataset = dataset;
+	binaryDataset.makeIndependent();
+	for (size_t i=0; i<ell; i++) binaryDataset.element(i).label = (target[i] < classes / 2) ? 0 : 1;
+
+	for (size_t i=0; i<9; i++)
+	{
+		cout << "  testing parallel mode of " << trainer[i]->name() << endl;
+		LabeledData<CompressedRealVector, unsigned int> const& data = (i == 8) ? binaryDataset : dataset;
+		trainer[i]->stoppingCondition().minAccuracy = MAX_KKT_VIOLATION;
+
+		LinearClassifier<CompressedRealVector> sequential;
+		trainer[i]->train(sequential, data);
+		LinearClassifier<CompressedRealVector> parallel;
+		trainer[i]->setParallel(true);
+		BOOST_CHECK(trainer[i]->parallel());
+		trainer[i]->train(parallel, data);
+
+		RealMatrix const& w_seq = sequential.decisionFunction().matrix();
+		RealMatrix const& w_par = parallel.decisionFunction().matrix();
+		BOOST_REQUIRE_EQUAL(w_seq.size1(), w_par.size1());
+		double n = 0.0;
+		double d = 0.0;
+		for (size_t j=0; j<w_seq.size1(); j++)
+		{
+			n += norm_2(row(w_seq, j));
+			d += norm_2(row(w_seq, j) - row(w_par, j));
+		}
+		BOOST_CHECK_SMALL(d, RELATIVE_ACCURACY * n);
+		delete trainer[i];
+	}
+
+	// the weight vectors returned in parallel mode must be
+	// consistent with the dual variables, despite lost updates
+	QpStoppingCondition stop(MAX_KKT_VIOLATION);
+	{
+		QpBoxLinear<CompressedRealVector> solver(binaryDataset, dim);
+		solver.setParallel(true);
+		RealVector w = solver.solve(C, stop);
+		RealVector const& alpha = solver.alpha();
+		BOOST_REQUIRE_EQUAL(alpha.size(), ell);
+		RealVector w_alpha(dim, 0.0);
+		for (size_t i=0; i<ell; i++)
+		{
+			double y_i = (binaryDataset.element(i).label > 0) ? +1.0 : -1.0;
+			noalias(w_alpha) += (alpha(i) * y_i) * binaryDataset.element(i).input;
+		}
+		BOOST_CHECK_SMALL(norm_2(w - w_alpha), 1e-10 * norm_2(w_alpha));
+	}
+	{
+		QpMcLinearWW<CompressedRealVector> solver(dataset, dim, classes);
+		solver.setParallel(true);
+		RealMatrix w = solver.solve(C, stop);
+		RealMatrix const& alpha = solver.alpha();
+		BOOST_REQUIRE_EQUAL(alpha.size1(), ell);
+		RealMatrix w_alpha(classes, dim, 0.0);
+		for (size_t i=0; i<ell; i++)
+		{
+			unsigned int y_i = dataset.element(i).label;
+			double sum_alpha = 0.0;
+			for (size_t c=0; c<classes; c++) sum_alpha += alpha(i, c);
+			for (size_t c=0; c<classes; c++)
+			{
+				double a = (c == y_i) ? 0.5 * sum_alpha : -0.5 * alpha(i, c);
+				noalias(row(w_alpha, c)) += a * dataset.element(i).input;
+			}
+		}
+		for (size_t c=0; c<classes; c++)
+			BOOST_CHECK_SMALL(norm_2(row(w, c) - row(w_alpha, c)), 1e-10 * norm_2(row(w_alpha, c)));
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+//===========================================================================
+/*!
+ * 
+ *
+ * \brief       Test case for the randomized and incremental PCA
+ * 
+ * 
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ * 
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ * 
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published 
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <shark/Algorithms/Trainers/RandomizedPCA.h>
+#include <shark/Data/Statistics.h>
+#include <shark/Rng/GlobalRng.h>
+
+#define BOOST_TEST_MODULE ALGORITHM_RANDOMIZEDPCA
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+using namespace std;
+using namespace shark;
+
+///Data with a quickly decaying spectrum: a few strong directions
+///embedded in a higher dimensional space plus small noise.
+UnlabeledData<RealVector> createData(std::size_t dimensions, std::size_t numberOfExamples, std::size_t batchSize)
+{
+	std::size_t rank = 5;
+	RealMatrix directions(rank,dimensions);
+	for(std::size_t i = 0; i != rank; ++i)
+		for(std::size_t j = 0; j != dimensions; ++j)
+			directions(i,j) = Rng::gauss();
+	
+	std::vector<RealVector> data(numberOfExamples,RealVector(dimensions));
+	for(std::size_t k = 0; k != numberOfExamples; ++k){
+		for(std::size_t j = 0; j != dimensions; ++j)
+			data[k](j) = 1.0 + 0.01 * Rng::gauss();
+		for(std::size_t i = 0; i != rank; ++i)
+			noalias(data[k]) += (rank - i) * Rng::gauss() * row(directions,i);
+	}
+	return createDataFromRange(data,batchSize);
+}
+
+///compares the first k of the m computed components with the ones of the exact PCA
+void checkComponents(PCA const& exact, PCA const& approx, std::size_t m, std::size_t k, double epsilon){
+	BOOST_REQUIRE_EQUAL(approx.eigenvectors().size2(), m);
+	BOOST_REQUIRE_EQUAL(approx.eigenvalues().size(), m);
+	for(std::size_t i = 0; i != exact.mean().size(); ++i)
+		BOOST_CHECK_SMALL(exact.mean()(i) - approx.mean()(i), 1.e-10);
+	for(std::size_t i = 0; i != k; ++i){
+		BOOST_CHECK_CLOSE(exact.eigenvalue(i), approx.eigenvalue(i), 100*epsilon);
+		double overlap = inner_prod(column(exact.eigenvectors(),i),column(approx.eigenvectors(),i));
+		BOOST_CHECK_SMALL(1.0 - std::abs(overlap), epsilon);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE (Algorithms_Trainers_RandomizedPCA)
+
+BOOST_AUTO_TEST_CASE( RandomizedPCA_Components ){
+	UnlabeledData<RealVector> data = createData(50,500,32);
+	PCA pca(data);
+	
+	RandomizedPCA rpca(3,false,3);
+	rpca.setData(data);
+	checkComponents(pca, rpca, 3, 3, 1.e-6);
+	
+	//the encoder has the requested output size and decorrelates the data
+	LinearModel<> model(50,4,true);
+	rpca.setWhitening(true);
+	rpca.train(model,data);
+	BOOST_REQUIRE_EQUAL(model.outputSize(), 4u);
+	RealVector mean;
+	RealMatrix covariance;
+	meanvar(model(data),mean,covariance);
+	for(std::size_t i = 0; i != 4; ++i){
+		BOOST_CHECK_SMALL(mean(i), 1.e-8);
+		for(std::size_t j = 0; j != 4; ++j)
+			BOOST_CHECK_SMALL(covariance(i,j) - (i == j), 1.e-8);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( IncrementalPCA_Components ){
+	UnlabeledData<RealVector> data = createData(50,500,32);
+	PCA pca(data);
+	
+	//the data is nearly rank 5, so keeping 10 components gives
+	//almost exact results for the leading 5 components
+	IncrementalPCA ipca(10);
+	ipca.setData(data);
+	BOOST_CHECK_EQUAL(ipca.numberOfPoints(), 500u);
+	checkComponents(pca, ipca, 10, 5, 1.e-4);
+	
+	//streaming the batches one by one gives the same result
+	IncrementalPCA stream(10);
+	for(std::size_t b = 0; b != data.numberOfBatches(); ++b)
+		stream.update(data.batch(b));
+	for(std::size_t i = 0; i != 10; ++i)
+		BOOST_CHECK_CLOSE(stream.eigenvalue(i), ipca.eigenvalue(i), 1.e-8);
+	
+	//the decoder reconstructs the data from the encoding
+	LinearModel<> encoder,decoder;
+	ipca.encoder(encoder,5);
+	ipca.decoder(decoder,5);
+	Data<RealVector> reconstruction = decoder(encoder(data));
+	double error = 0;
+	for(std::size_t i = 0; i != data.numberOfElements(); ++i)
+		error += norm_sqr(data.element(i) - reconstruction.element(i));
+	error /= data.numberOfElements();
+	BOOST_CHECK_SMALL(error, 50*0.01*0.01*1.1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+//===========================================================================
+/*!
+ * 
+ *
+ * \brief       test case for the sparse regularization network
+ * 
+ * 
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ * 
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ * 
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published 
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#define BOOST_TEST_MODULE ALGORITHMS_TRAINERS_SPARSE_REGULARIZATION_NETWORK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Algorithms/Trainers/SparseRegularizationNetworkTrainer.h>
+#include <shark/Algorithms/Trainers/RegularizationNetworkTrainer.h>
+#include <shark/ObjectiveFunctions/Loss/SquaredLoss.h>
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/Rng/GlobalRng.h>
+#include <shark/Data/Dataset.h>
+#include <shark/Data/DataDistribution.h>
+
+
+using namespace shark;
+
+
+BOOST_AUTO_TEST_SUITE (Algorithms_Trainers_SparseRegularizationNetworkTrainer)
+
+//with all training points as inducing points, the solution must be the one of the full network
+BOOST_AUTO_TEST_CASE( SPARSE_REGULARIZATION_NETWORK_ALL_POINTS )
+{
+	Rng::seed(42);
+	const std::size_t ell = 100;
+	const double noise = 0.1;
+
+	Wave prob;
+	RegressionDataset training = prob.generateDataset(ell,16);
+
+	GaussianRbfKernel<> kernel(1.0);
+	KernelExpansion<RealVector> full;
+	RegularizationNetworkTrainer<RealVector> fullTrainer(&kernel, noise);
+	fullTrainer.train(full, training);
+
+	KernelExpansion<RealVector> sparse;
+	SparseRegularizationNetworkTrainer<RealVector> trainer(&kernel, noise, ell);
+	trainer.setInducingPoints(training.inputs());
+	trainer.train(sparse, training);
+	BOOST_REQUIRE_EQUAL(sparse.basis().numberOfElements(), ell);
+
+	Data<RealVector> fullOutput = full(training.inputs());
+	Data<RealVector> sparseOutput = sparse(training.inputs());
+	for (std::size_t i=0; i<ell; i++){
+		BOOST_CHECK_SMALL(fullOutput.element(i)(0) - sparseOutput.element(i)(0), 1.e-4);
+	}
+}
+
+//a few inducing points must come close to the full network
+BOOST_AUTO_TEST_CASE( SPARSE_REGULARIZATION_NETWORK_FEW_POINTS )
+{
+	Rng::seed(42);
+	const std::size_t ell = 1000;
+	const std::size_t m = 40;
+	const double noise = 0.1;
+
+	Wave prob;
+	RegressionDataset training = prob.generateDataset(ell);
+	RegressionDataset test = prob.generateDataset(1000);
+	SquaredLoss<> loss;
+
+	GaussianRbfKernel<> kernel(1.0);
+	KernelExpansion<RealVector> full;
+	RegularizationNetworkTrainer<RealVector> fullTrainer(&kernel, noise);
+	fullTrainer.train(full, training);
+	double fullError = loss.eval(test.labels(), full(test.inputs()));
+
+	for(std::size_t useKMeans = 0; useKMeans != 2; ++useKMeans){
+		KernelExpansion<RealVector> sparse;
+		SparseRegularizationNetworkTrainer<RealVector> trainer(&kernel, noise, m, useKMeans != 0);
+		trainer.train(sparse, training);
+		BOOST_CHECK_EQUAL(sparse.basis().numberOfElements(), m);
+		BOOST_CHECK_EQUAL(trainer.inducingPoints().numberOfElements(), m);
+		double sparseError = loss.eval(test.labels(), sparse(test.inputs()));
+		BOOST_CHECK_SMALL(sparseError - fullError, 0.01 * fullError);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
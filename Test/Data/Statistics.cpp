@@ -118,4 +118,88 @@ BOOST_AUTO_TEST_CASE( Data_Statistics_meanvar_covariance )
 }
 
 
+BOOST_AUTO_TEST_CASE( Data_Statistics_Accumulator )
+{
+	StatisticsAccumulator statistics(true);
+	statistics.addData(inputDataSmallBatch);
+	BOOST_REQUIRE_EQUAL(statistics.count(), Dimensions);
+	RealVector varVec = statistics.variance();
+	RealMatrix varMat = statistics.covariance();
+	for(std::size_t i=0;i!=Dimensions;++i)
+	{
+		BOOST_CHECK_SMALL(statistics.mean()(i)-resultMean[i],1.e-5);
+		BOOST_CHECK_SMALL(varVec(i)-resultVariance[i][i],1.e-5);
+		for(std::size_t j=0; j != Dimensions; ++j){
+			BOOST_CHECK_SMALL(varMat(i,j)-resultVariance[i][j],1.e-5);
+		}
+		double minimum = inputData.element(0)(i);
+		double maximum = minimum;
+		for(std::size_t k = 1; k != Dimensions; ++k){
+			minimum = std::min(minimum,inputData.element(k)(i));
+			maximum = std::max(maximum,inputData.element(k)(i));
+		}
+		BOOST_CHECK_EQUAL(statistics.min()(i), minimum);
+		BOOST_CHECK_EQUAL(statistics.max()(i), maximum);
+	}
+	
+	//merging two halves gives the same result
+	StatisticsAccumulator first(true);
+	StatisticsAccumulator second(true);
+	first.addBatch(inputDataSmallBatch.batch(0));
+	for(std::size_t b = 1; b != Dimensions; ++b)
+		second.addBatch(inputDataSmallBatch.batch(b));
+	first.merge(second);
+	BOOST_REQUIRE_EQUAL(first.count(), Dimensions);
+	for(std::size_t i=0;i!=Dimensions;++i)
+	{
+		BOOST_CHECK_SMALL(first.mean()(i)-statistics.mean()(i),1.e-12);
+		for(std::size_t j=0; j != Dimensions; ++j){
+			BOOST_CHECK_SMALL(first.covariance()(i,j)-varMat(i,j),1.e-12);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( Data_Statistics_Accumulator_Sparse )
+{
+	//sparse data where some columns have no stored entries in a batch
+	std::vector<CompressedRealVector> sparse(5,CompressedRealVector(Dimensions));
+	std::vector<RealVector> dense(5,RealVector(Dimensions,0.0));
+	sparse[0](0) = dense[0](0) = 2.0;
+	sparse[1](2) = dense[1](2) = -1.0;
+	sparse[2](0) = dense[2](0) = 3.0;
+	sparse[2](3) = dense[2](3) = 0.5;
+	sparse[4](2) = dense[4](2) = -4.0;
+	
+	StatisticsAccumulator sparseStatistics(true);
+	sparseStatistics.addData(createDataFromRange(sparse,2));
+	StatisticsAccumulator denseStatistics(true);
+	denseStatistics.addData(createDataFromRange(dense,2));
+	
+	for(std::size_t i=0;i!=Dimensions;++i)
+	{
+		BOOST_CHECK_SMALL(sparseStatistics.mean()(i)-denseStatistics.mean()(i),1.e-12);
+		BOOST_CHECK_SMALL(sparseStatistics.variance()(i)-denseStatistics.variance()(i),1.e-12);
+		BOOST_CHECK_EQUAL(sparseStatistics.min()(i), denseStatistics.min()(i));
+		BOOST_CHECK_EQUAL(sparseStatistics.max()(i), denseStatistics.max()(i));
+		for(std::size_t j=0; j != Dimensions; ++j){
+			BOOST_CHECK_SMALL(sparseStatistics.covariance()(i,j)-denseStatistics.covariance()(i,j),1.e-12);
+		}
+	}
+	BOOST_CHECK_EQUAL(sparseStatistics.min()(1), 0.0);
+	BOOST_CHECK_EQUAL(sparseStatistics.max()(2), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( Data_Statistics_Accumulator_Stability )
+{
+	//a large offset does not destroy the variance
+	std::vector<RealVector> vec(1000,RealVector(1));
+	for(std::size_t i = 0; i != vec.size(); ++i)
+		vec[i](0) = 1.e9 + (i % 2);
+	StatisticsAccumulator statistics;
+	statistics.addData(createDataFromRange(vec,7));
+	BOOST_CHECK_SMALL(statistics.mean()(0) - (1.e9+0.5), 1.e-6);
+	BOOST_CHECK_SMALL(statistics.variance()(0) - 0.25, 1.e-7);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END();
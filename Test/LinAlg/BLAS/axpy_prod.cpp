@@ -845,6 +845,70 @@ BOOST_AUTO_TEST_CASE( LinAlg_axpy_prod_matrix_matrix_sparse_sparse ){
 	}
 }
 
+//sparse result. The rows are large enough to be split between threads
+BOOST_AUTO_TEST_CASE( LinAlg_axpy_prod_matrix_matrix_sparse_sparse_result ){
+	std::size_t rows = 120;
+	std::size_t columns = 80;
+	std::size_t middle = 33;
+	compressed_matrix<double> arg1(rows,middle);
+	for(std::size_t i = 0; i != rows; ++i){
+		for(std::size_t j = i%3; j < middle; j+=(i%7+1)){
+			arg1(i,j) = 2*(20*i+1)+1;
+		}
+	}
+	compressed_matrix<double> arg2(middle,columns);
+	for(std::size_t i = 0; i != middle; ++i){
+		for(std::size_t j = 1; j < columns; j+=(i+1)){
+			arg2(i,j) = i*columns+1.5*j;
+		}
+	}
+	//result with some elements already set which are not all part of the product
+	compressed_matrix<double> init(rows,columns);
+	for(std::size_t i = 0; i != rows; i+=2){
+		init(i,(7*i)%columns) = 1.5;
+		init(i,0) = -1.0;
+	}
+	
+	std::cout<<"\nchecking sparse-sparse matrix matrix multiply with sparse result"<<std::endl;
+	{
+		compressed_matrix<double> result(init);
+		axpy_prod(arg1,arg2,result,false,-2.0);
+		matrix<double> expected(init);
+		axpy_prod(arg1,arg2,expected,false,-2.0);
+		compressed_matrix<double> const& constResult = result;
+		compressed_matrix<double> const& constInit = init;
+		for(std::size_t i = 0; i != rows; ++i){
+			for(std::size_t j = 0; j != columns; ++j){
+				double test_result = constInit(i,j);
+				for(std::size_t k = 0; k != middle; ++k){
+					test_result -= 2.0 * arg1(i,k)*arg2(k,j);
+				}
+				BOOST_CHECK_CLOSE(constResult(i,j), test_result,1.e-10);
+				BOOST_CHECK_CLOSE(expected(i,j), test_result,1.e-10);
+			}
+			//the elements of every row are sorted
+			compressed_matrix<double>::const_row_iterator pos = constResult.row_begin(i);
+			for(std::size_t last = 0; pos != constResult.row_end(i); ++pos){
+				BOOST_CHECK(pos == constResult.row_begin(i) || pos.index() > last);
+				last = pos.index();
+			}
+		}
+		BOOST_CHECK_CLOSE(sum(result), sum(expected),1.e-10);
+	}
+	{
+		compressed_matrix<double> result(init);
+		axpy_prod(arg1,arg2,result,true,-2.0);
+		checkMatrixMatrixMultiply(arg1,arg2,result,-2.0,0);
+	}
+	//dense column major first argument, computed as linear combination of the rows of the second
+	{
+		matrix<double,column_major> arg1cm(arg1);
+		matrix<double> result(rows,columns,1.5);
+		axpy_prod(arg1cm,arg2,result,false,-2.0);
+		checkMatrixMatrixMultiply(arg1cm,arg2,result,-2.0,1.5);
+	}
+}
+
 BOOST_AUTO_TEST_CASE( LinAlg_axpy_prod_matrix_vector_triangular ){
 	std::size_t rows = 50;
 	//initialize the arguments in both row and column major as well as transposed
@@ -3,6 +3,8 @@
 #include <boost/test/floating_point_comparison.hpp>
 
 #include <shark/LinAlg/Base.h>
+#include <shark/Rng/GlobalRng.h>
+#include <boost/math/special_functions/next.hpp>
 
 using namespace shark;
 using namespace std;
@@ -134,7 +136,7 @@ BOOST_AUTO_TEST_CASE( LinAlg_SoftPlus )
 	{
 		x(i) = i;
 		xm(i,0) = i;
-		result(i) = softPlus(x(i));
+		result(i) = std::log(1+std::exp(x(i)));
 	}
 	RealVector y = softPlus(x);
 	RealMatrix ym = softPlus(xm);
@@ -266,4 +268,95 @@ BOOST_AUTO_TEST_CASE( LinAlg_UnaryTransformation_Sparse_Matrix ){
 }
 
 
+
+double ulpDistance(double a, double b){
+	if(a == b) return 0;
+	return std::abs(boost::math::float_distance(a,b));
+}
+//checks the branch-free kernels against the standard library in units of the last place
+BOOST_AUTO_TEST_CASE( LinAlg_VectorizedMath_Accuracy ){
+	using namespace blas::detail;
+	Rng::seed(42);
+	double maxError[5]={0,0,0,0,0};
+	for(std::size_t i = 0; i != 100000; ++i){
+		double x = Rng::uni(-750,750);
+		if(i % 3 == 1) x = Rng::uni(-3,3);
+		if(i % 3 == 2) x = std::ldexp(Rng::uni(-1,1),-(int)Rng::discrete(0,1080));
+		double ax = std::abs(x);
+		
+		long double sigmoidx = 1.0L/(1.0L+std::exp(-(long double)x));
+		long double softPlusx = x > 0 ? x+std::log1p(std::exp(-(long double)x)) : std::log1p(std::exp((long double)x));
+		double errors[5] = {
+			ulpDistance(vectorized::exp(x),std::exp(x)),
+			ulpDistance(vectorized::log(ax),std::log(ax)),
+			ulpDistance(vectorized::tanh(x),std::tanh(x)),
+			ulpDistance(vectorized::sigmoid(x),(double)sigmoidx),
+			ulpDistance(vectorized::softPlus(x),(double)softPlusx)
+		};
+		for(std::size_t k = 0; k != 5; ++k)
+			maxError[k] = std::max(maxError[k],errors[k]);
+	}
+	BOOST_CHECK_LE(maxError[0], 2);
+	BOOST_CHECK_LE(maxError[1], 2);
+	BOOST_CHECK_LE(maxError[2], 4);
+	BOOST_CHECK_LE(maxError[3], 4);
+	BOOST_CHECK_LE(maxError[4], 4);
+	
+	//special values
+	double inf = std::numeric_limits<double>::infinity();
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	BOOST_CHECK_EQUAL(vectorized::exp(inf), inf);
+	BOOST_CHECK_EQUAL(vectorized::exp(-inf), 0.0);
+	BOOST_CHECK_EQUAL(vectorized::exp(1000.0), inf);
+	BOOST_CHECK_EQUAL(vectorized::log(0.0), -inf);
+	BOOST_CHECK_EQUAL(vectorized::log(inf), inf);
+	BOOST_CHECK(boost::math::isnan(vectorized::log(-1.0)));
+	BOOST_CHECK(boost::math::isnan(vectorized::exp(nan)));
+	BOOST_CHECK(boost::math::isnan(vectorized::log(nan)));
+	BOOST_CHECK(boost::math::isnan(vectorized::tanh(nan)));
+	BOOST_CHECK_EQUAL(vectorized::tanh(inf), 1.0);
+	BOOST_CHECK_EQUAL(vectorized::tanh(-inf), -1.0);
+	BOOST_CHECK_EQUAL(vectorized::sigmoid(-inf), 0.0);
+	BOOST_CHECK_EQUAL(vectorized::sigmoid(inf), 1.0);
+	BOOST_CHECK_EQUAL(vectorized::softPlus(-inf), 0.0);
+	BOOST_CHECK_EQUAL(vectorized::softPlus(inf), inf);
+	BOOST_CHECK_CLOSE(vectorized::exp(1.5f), std::exp(1.5f), 1.e-5);
+}
+
+//the blockwise assignment of elementwise functions has to handle sizes which are not a multiple of the block size
+//as well as proxies and expressions as arguments
+BOOST_AUTO_TEST_CASE( LinAlg_VectorizedMath_Assignment ){
+	std::size_t rows = 7;
+	std::size_t columns = 150;
+	RealMatrix x(rows,columns);
+	RealVector b(columns);
+	for(std::size_t j = 0; j != columns; ++j){
+		b(j) = Rng::uni(-1,1);
+		for(std::size_t i = 0; i != rows; ++i){
+			x(i,j) = Rng::uni(-5,5);
+		}
+	}
+	
+	RealMatrix y(rows,columns,0.0);
+	noalias(y) = sigmoid(x+repeat(b,rows));
+	RealMatrix z(rows+2,columns+3,0.0);
+	noalias(subrange(z,1,rows+1,2,columns+2)) = tanh(x);
+	blas::matrix<double,blas::column_major> zt(columns,rows);
+	noalias(zt) = exp(trans(x));
+	RealVector v = log(abs(row(x,2)));
+	for(std::size_t i = 0; i != rows; ++i){
+		for(std::size_t j = 0; j != columns; ++j){
+			BOOST_CHECK_CLOSE(y(i,j), 1.0/(1.0+std::exp(-x(i,j)-b(j))), 1.e-12);
+			BOOST_CHECK_CLOSE(z(i+1,j+2), std::tanh(x(i,j)), 1.e-12);
+			BOOST_CHECK_CLOSE(zt(j,i), std::exp(x(i,j)), 1.e-12);
+		}
+		BOOST_CHECK_EQUAL(z(i+1,0), 0.0);
+		BOOST_CHECK_EQUAL(z(i+1,columns+2), 0.0);
+	}
+	for(std::size_t j = 0; j != columns; ++j){
+		BOOST_CHECK_CLOSE(v(j), std::log(std::abs(x(2,j))), 1.e-12);
+		BOOST_CHECK_EQUAL(z(0,j), 0.0);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -118,6 +118,50 @@ BOOST_AUTO_TEST_CASE( LinAlg_CholeskyDecomposition ){
 	}
 }
 
+//large enough to use several blocks and tiles of the blocked decomposition
+BOOST_AUTO_TEST_CASE( LinAlg_CholeskyDecomposition_Blocked ){
+	std::size_t NumTests = 5;
+	std::size_t Dimensions = 237;
+	for(std::size_t test = 0; test != NumTests; ++test){
+		RealVector lambda(Dimensions);
+		for(std::size_t i = 0; i != Dimensions; ++i){
+			lambda(i) = Rng::uni(1,3.0);
+		}
+		RealMatrix A = createRandomMatrix(lambda,Dimensions);
+		RealMatrix C(Dimensions,Dimensions);
+		choleskyDecomposition(A,C);
+		
+		//C is lower triangular
+		for(std::size_t i = 0; i != Dimensions; ++i){
+			for(std::size_t j = i+1; j != Dimensions; ++j){
+				BOOST_CHECK_EQUAL(C(i,j), 0.0);
+			}
+		}
+		RealMatrix ATest(Dimensions,Dimensions);
+		axpy_prod(C,trans(C),ATest);
+		BOOST_CHECK_SMALL(norm_inf(A-ATest),1.e-11);
+		
+		//inverse from the cholesky factor
+		RealMatrix AInv;
+		choleskyInverse(C,AInv);
+		RealMatrix I(Dimensions,Dimensions);
+		axpy_prod(A,AInv,I);
+		BOOST_CHECK_SMALL(norm_inf(I-RealIdentityMatrix(Dimensions)),1.e-11);
+		
+		//single precision factor
+		blas::matrix<float> CFloat(C);
+		blas::matrix<float> AInvFloat;
+		choleskyInverse(CFloat,AInvFloat);
+		BOOST_CHECK_SMALL(norm_inf(RealMatrix(AInvFloat)-AInv),1.e-4);
+	}
+	
+	//not positive definite
+	RealMatrix A = createRandomMatrix(RealVector(Dimensions,1.0),Dimensions);
+	A(150,150) = -1;
+	RealMatrix C;
+	BOOST_CHECK_THROW(choleskyDecomposition(A,C),Exception);
+}
+
 BOOST_AUTO_TEST_CASE( LinAlg_PivotingCholeskyDecomposition_FullRank ){
 	std::size_t NumTests = 100;
 	std::size_t Dimensions = 48;
@@ -96,4 +96,107 @@ BOOST_AUTO_TEST_CASE( LinAlg_eigensymm_general )
 		BOOST_CHECK_SMALL(error_orthogonalize,1.e-12);
 	}
 }
+
+//checks orthogonality of the eigenvectors and the residual of the decomposition
+void checkDecomposition(RealMatrix const& A, RealMatrix const& eigenVectors, RealVector const& eigenvalues, double tolerance){
+	std::size_t k = eigenvalues.size();
+	RealMatrix gram = prod(trans(eigenVectors),eigenVectors);
+	double orthogonalityError = max(abs(gram - identity_matrix<double>(k)));
+	BOOST_CHECK(!(boost::math::isnan)(orthogonalityError));
+	BOOST_CHECK_SMALL(orthogonalityError, tolerance);
+
+	RealMatrix residual = prod(A,eigenVectors);
+	for(std::size_t j = 0; j != k; ++j){
+		noalias(column(residual,j)) -= eigenvalues(j) * column(eigenVectors,j);
+	}
+	BOOST_CHECK_SMALL(max(abs(residual)), tolerance * norm_inf(eigenvalues));
+
+	for(std::size_t j = 1; j < k; ++j){
+		BOOST_CHECK(eigenvalues(j-1) >= eigenvalues(j));
+	}
+}
+
+BOOST_AUTO_TEST_CASE( LinAlg_eigensymm_large )
+{
+	//large enough to use several panels and divide and conquer levels
+	std::size_t Dimensions = 200;
+	for(std::size_t test = 0; test != 3; ++test){
+		RealVector lambda(Dimensions);
+		for(std::size_t i = 0; i != Dimensions; ++i){
+			lambda(i) = Rng::uni(-1.0,3.0);
+		}
+		//repeated eigenvalues deflate in the merge steps
+		if(test == 1){
+			for(std::size_t i = 0; i != Dimensions/2; ++i)
+				lambda(i) = 1.0;
+		}
+		if(test == 2){
+			for(std::size_t i = 0; i != Dimensions; ++i)
+				lambda(i) = std::pow(10.0, -double(i % 10));
+		}
+		//eigenvalues can be negative, so A = R diag(lambda) R^T
+		RealMatrix R = blas::randomRotationMatrix(Dimensions);
+		RealMatrix A = prod(R,prod(diagonal_matrix<RealVector>(lambda),trans(R)));
+		for(std::size_t i = 0; i != Dimensions; ++i){
+			for(std::size_t j = 0; j != i; ++j){
+				A(j,i) = A(i,j);
+			}
+		}
+		std::sort(lambda.begin(),lambda.end());
+		std::reverse(lambda.begin(),lambda.end());
+
+		RealVector eigenvalues;
+		RealMatrix eigenVectors;
+		eigensymm(A, eigenVectors, eigenvalues);
+		BOOST_CHECK_SMALL(norm_inf(eigenvalues - lambda),1.e-12);
+		checkDecomposition(A, eigenVectors, eigenvalues, 1.e-12);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( LinAlg_eigensymm_identity )
+{
+	std::size_t Dimensions = 100;
+	RealMatrix A = identity_matrix<double>(Dimensions);
+	RealVector eigenvalues;
+	RealMatrix eigenVectors;
+	eigensymm(A, eigenVectors, eigenvalues);
+	BOOST_CHECK_SMALL(norm_inf(eigenvalues - RealVector(Dimensions,1.0)),1.e-14);
+	checkDecomposition(A, eigenVectors, eigenvalues, 1.e-14);
+}
+
+BOOST_AUTO_TEST_CASE( LinAlg_eigensymm_largest )
+{
+	std::size_t Dimensions = 150;
+	std::size_t k = 10;
+	for(std::size_t test = 0; test != 2; ++test){
+		RealVector lambda(Dimensions);
+		for(std::size_t i = 0; i != Dimensions; ++i){
+			lambda(i) = Rng::uni(0.0,1.0);
+		}
+		//a cluster of equal eigenvalues among the largest ones
+		if(test == 1){
+			for(std::size_t i = 0; i != 4; ++i)
+				lambda(i) = 2.0;
+		}
+		RealMatrix A = createRandomMatrix(lambda,Dimensions);
+		std::sort(lambda.begin(),lambda.end());
+		std::reverse(lambda.begin(),lambda.end());
+
+		RealVector eigenvalues;
+		RealMatrix eigenVectors;
+		eigensymm(A, eigenVectors, eigenvalues, k);
+		BOOST_REQUIRE_EQUAL(eigenvalues.size(), k);
+		BOOST_REQUIRE_EQUAL(eigenVectors.size1(), Dimensions);
+		BOOST_REQUIRE_EQUAL(eigenVectors.size2(), k);
+		BOOST_CHECK_SMALL(norm_inf(eigenvalues - subrange(lambda,0,k)),1.e-12);
+
+		//only the lower triangle is used, so the residual is computed with the symmetric matrix
+		for(std::size_t i = 0; i != Dimensions; ++i){
+			for(std::size_t j = 0; j != i; ++j){
+				A(j,i) = A(i,j);
+			}
+		}
+		checkDecomposition(A, eigenVectors, eigenvalues, 1.e-12);
+	}
+}
 BOOST_AUTO_TEST_SUITE_END()
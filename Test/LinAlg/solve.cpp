@@ -192,6 +192,53 @@ BOOST_AUTO_TEST_CASE( LinAlg_Solve_TriangularInPlace_Calls_Matrix ){
 }
 
 //simple test which checks for all argument combinations whether they are correctly translated
+//systems large enough to use the blocked and tiled triangular solver
+BOOST_AUTO_TEST_CASE( LinAlg_Solve_TriangularInPlace_Blocked_Matrix ){
+	std::size_t Dimensions = 150;
+	std::size_t numRhs = 70;
+	RealMatrix A(Dimensions,Dimensions,0.0);
+	for(std::size_t i = 0; i != Dimensions; ++i){
+		A(i,i) = Rng::uni(1,2);
+		for(std::size_t j = 0; j != i; ++j){
+			A(i,j) = Rng::uni(-0.1,0.1)/std::sqrt(double(Dimensions));
+		}
+	}
+	RealMatrix unitA = A;
+	diag(unitA) = blas::repeat(1.0,Dimensions);
+	RealMatrix input(Dimensions,numRhs);
+	for(std::size_t i = 0; i != Dimensions; ++i){
+		for(std::size_t j = 0; j != numRhs; ++j){
+			input(i,j) = Rng::uni(-1,1);
+		}
+	}
+	{
+		RealMatrix testResult = input;
+		blas::solveTriangularSystemInPlace<blas::SolveAXB,blas::lower>(A,testResult);
+		BOOST_CHECK_SMALL(norm_inf(prod(A,testResult)-input), 1.e-12);
+	}
+	{
+		RealMatrix testResult = input;
+		blas::solveTriangularSystemInPlace<blas::SolveAXB,blas::upper>(trans(A),testResult);
+		BOOST_CHECK_SMALL(norm_inf(prod(trans(A),testResult)-input), 1.e-12);
+	}
+	{
+		RealMatrix testResult = input;
+		blas::solveTriangularSystemInPlace<blas::SolveAXB,blas::unit_lower>(A,testResult);
+		BOOST_CHECK_SMALL(norm_inf(prod(unitA,testResult)-input), 1.e-12);
+	}
+	{
+		RealMatrix testResult = trans(input);
+		blas::solveTriangularSystemInPlace<blas::SolveXAB,blas::lower>(A,testResult);
+		BOOST_CHECK_SMALL(norm_inf(prod(testResult,A)-trans(input)), 1.e-12);
+	}
+	{
+		RealMatrix testResult = input;
+		blas::solveTriangularCholeskyInPlace<blas::SolveAXB>(A,testResult);
+		RealMatrix M = prod(A,trans(A));
+		BOOST_CHECK_SMALL(norm_inf(prod(M,testResult)-input), 1.e-12);
+	}
+}
+
 BOOST_AUTO_TEST_CASE( LinAlg_Solve_TriangularInPlace_Calls_Vector ){
 	RealMatrix A(2,2);
 	A(0,0) = 3;
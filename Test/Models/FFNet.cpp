@@ -693,4 +693,46 @@ BOOST_AUTO_TEST_CASE( FFNET_WeightedDerivatives)
 	}
 }
 
+//the parameters are stored in one vector which is directly accessible. Also check serialization.
+BOOST_AUTO_TEST_CASE( FFNET_ParameterStorage )
+{
+	FFNet<LogisticNeuron,TanhNeuron> net;
+	net.setStructure(2,5,3,4,FFNetStructures::InputOutputShortcut,true);
+	BOOST_REQUIRE(net.hasParameterStorage());
+	BOOST_REQUIRE_EQUAL(net.parameterStorage().size(), net.numberOfParameters());
+	
+	RealVector parameters(net.numberOfParameters());
+	for(std::size_t i = 0; i != parameters.size(); ++i){
+		parameters(i) = Rng::uni(-1,1);
+	}
+	net.parameterStorage() = parameters;
+	BOOST_CHECK_SMALL(norm_inf(net.parameterVector()-parameters), 1.e-15);
+	BOOST_CHECK_EQUAL(net.layerMatrix(0)(1,1), parameters(3));
+	BOOST_CHECK_EQUAL(net.bias()(0), parameters(2*5+5*3+3*4));
+	BOOST_CHECK_EQUAL(net.inputOutputShortcut()(0,0), parameters(2*5+5*3+3*4+5+3+4));
+	
+	//same outputs as after setParameterVector
+	FFNet<LogisticNeuron,TanhNeuron> net2;
+	net2.setStructure(2,5,3,4,FFNetStructures::InputOutputShortcut,true);
+	net2.setParameterVector(parameters);
+	RealMatrix inputs(10,2);
+	for(std::size_t i = 0; i != 10; ++i){
+		inputs(i,0) = Rng::uni(-1,1);
+		inputs(i,1) = Rng::uni(-1,1);
+	}
+	BOOST_CHECK_SMALL(max(abs(net(inputs)-net2(inputs))), 1.e-15);
+	
+	//serialization round trip
+	ostringstream outputStream;  
+	TextOutArchive oa(outputStream);  
+	oa << net;
+	FFNet<LogisticNeuron,TanhNeuron> netDeserialized;
+	istringstream inputStream(outputStream.str());  
+	TextInArchive ia(inputStream);
+	ia >> netDeserialized;
+	BOOST_REQUIRE_EQUAL(netDeserialized.numberOfParameters(),net.numberOfParameters());
+	BOOST_CHECK_SMALL(norm_inf(netDeserialized.parameterVector()-parameters), 1.e-10);
+	BOOST_CHECK_SMALL(max(abs(net(inputs)-netDeserialized(inputs))), 1.e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,160 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       unit test for the compiled kernel expansion
+ *
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#define BOOST_TEST_MODULE MODELS_COMPILED_KERNEL_EXPANSION
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Models/Kernels/CompiledKernelExpansion.h>
+#include <shark/Rng/GlobalRng.h>
+
+#include <sstream>
+
+#include "../derivativeTestHelper.h" //for testBatchEval
+
+
+using namespace shark;
+
+namespace{
+//creates a random expansion with some zero coefficients
+void createExpansion(KernelExpansion<RealVector>& expansion, AbstractKernelFunction<RealVector>* kernel){
+	std::vector<RealVector> data(100,RealVector(3));
+	for(std::size_t i = 0; i != 100; ++i){
+		for(std::size_t j = 0; j != 3; ++j)
+			data[i](j) = Rng::uni(-1,1);
+	}
+	expansion.setStructure(kernel, createDataFromRange(data,7), true, 2);
+	for(std::size_t i = 0; i != 100; ++i){
+		if(i % 3 == 0) continue;
+		expansion.alpha(i,0) = Rng::uni(-1,1);
+		expansion.alpha(i,1) = Rng::uni(-1,1);
+	}
+	expansion.offset(0) = Rng::uni(-1,1);
+	expansion.offset(1) = Rng::uni(-1,1);
+}
+
+RealMatrix createInputs(std::size_t size){
+	RealMatrix inputs(size,3);
+	for(std::size_t i = 0; i != size; ++i){
+		for(std::size_t j = 0; j != 3; ++j)
+			inputs(i,j) = Rng::uni(-1,1);
+	}
+	return inputs;
+}
+
+template<class ValueType>
+void checkCompiled(AbstractKernelFunction<RealVector>* kernel, double epsilon){
+	KernelExpansion<RealVector> expansion;
+	createExpansion(expansion, kernel);
+	RealMatrix inputs = createInputs(50);
+	RealMatrix expected = expansion(inputs);
+
+	//small blocks to test the block decomposition
+	CompiledKernelExpansion<ValueType> compiled(expansion, 8);
+	BOOST_CHECK_EQUAL(compiled.inputSize(), 3);
+	BOOST_CHECK_EQUAL(compiled.outputSize(), 2);
+	RealMatrix result = compiled(inputs);
+	BOOST_REQUIRE_EQUAL(result.size1(), 50);
+	BOOST_REQUIRE_EQUAL(result.size2(), 2);
+	BOOST_CHECK_SMALL(max(abs(result - expected)), epsilon);
+
+	//single patterns and reuse of the state
+	boost::shared_ptr<State> state = compiled.createState();
+	for(std::size_t i = 0; i != 5; ++i){
+		RealMatrix single = rows(inputs,i,i+1);
+		RealMatrix singleResult;
+		compiled.eval(single, singleResult, *state);
+		BOOST_CHECK_SMALL(max(abs(row(singleResult,0) - row(expected,i))), epsilon);
+	}
+	testBatchEval(compiled,inputs);
+}
+}
+
+BOOST_AUTO_TEST_SUITE (Models_Kernels_CompiledKernelExpansion)
+
+BOOST_AUTO_TEST_CASE( CompiledKernelExpansion_Gaussian )
+{
+	DenseRbfKernel kernel(0.5);
+	checkCompiled<double>(&kernel, 1.e-10);
+	checkCompiled<float>(&kernel, 1.e-4);
+
+	//support vectors are all basis vectors with nonzero coefficients
+	KernelExpansion<RealVector> expansion;
+	createExpansion(expansion, &kernel);
+	CompiledKernelExpansion<> compiled(expansion);
+	BOOST_CHECK_EQUAL(compiled.numberOfBasisVectors(), 66);
+	BOOST_CHECK_EQUAL(compiled.kernelClass(), CompiledKernelExpansion<>::GAUSSIAN_KERNEL);
+}
+
+BOOST_AUTO_TEST_CASE( CompiledKernelExpansion_Polynomial )
+{
+	PolynomialKernel<> kernel(3, 1.0);
+	checkCompiled<double>(&kernel, 1.e-10);
+	checkCompiled<float>(&kernel, 1.e-3);
+}
+
+BOOST_AUTO_TEST_CASE( CompiledKernelExpansion_Linear )
+{
+	DenseLinearKernel kernel;
+	checkCompiled<double>(&kernel, 1.e-10);
+
+	//the linear kernel is collapsed to one weight vector per output
+	KernelExpansion<RealVector> expansion;
+	createExpansion(expansion, &kernel);
+	CompiledKernelExpansion<> compiled(expansion);
+	BOOST_CHECK_EQUAL(compiled.numberOfBasisVectors(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( CompiledKernelExpansion_Serialization )
+{
+	DenseRbfKernel kernel(0.5);
+	KernelExpansion<RealVector> expansion;
+	createExpansion(expansion, &kernel);
+	RealMatrix inputs = createInputs(10);
+	RealMatrix expected = expansion(inputs);
+
+	std::stringstream ss;
+	{
+		CompiledKernelExpansion<> compiled(expansion);
+		TextOutArchive oa(ss);
+		oa << const_cast<CompiledKernelExpansion<> const&>(compiled);
+	}
+	CompiledKernelExpansion<> compiled;
+	TextInArchive ia(ss);
+	ia >> compiled;
+	RealMatrix result = compiled(inputs);
+	BOOST_CHECK_SMALL(max(abs(result - expected)), 1.e-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       unit test for the Nystroem feature map and trainer
+ *
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+#define BOOST_TEST_MODULE MODELS_NYSTROEM_FEATURES
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Algorithms/Trainers/NystroemTrainer.h>
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/Models/Kernels/LinearKernel.h>
+#include <shark/Data/DataDistribution.h>
+
+#include "../derivativeTestHelper.h" //for testBatchEval
+
+using namespace shark;
+
+BOOST_AUTO_TEST_SUITE (Models_Kernels_NystroemFeatures)
+
+//with all points as landmarks, the map reproduces the kernel matrix
+BOOST_AUTO_TEST_CASE( NystroemFeatures_Exact )
+{
+	NormalDistributedPoints problem(3);
+	Data<RealVector> data = problem.generateDataset(50,7);
+	GaussianRbfKernel<> kernel(0.5);
+	NystroemFeatures<> features(&kernel, data);
+	BOOST_CHECK(features.outputSize() <= 50);
+
+	RealMatrix inputs = createBatch(data.elements());
+	RealMatrix phi = features(inputs);
+	RealMatrix K = kernel(inputs,inputs);
+	BOOST_CHECK_SMALL(max(abs(prod(phi,trans(phi)) - K)), 1.e-6);
+	testBatchEval(features,inputs);
+}
+
+//the feature space of the linear kernel is spanned by a few landmarks
+BOOST_AUTO_TEST_CASE( NystroemFeatures_Linear )
+{
+	NormalDistributedPoints problem(3);
+	Data<RealVector> data = problem.generateDataset(100,10);
+	DenseLinearKernel kernel;
+	NystroemTrainer<> trainer(&kernel, 10);
+	NystroemFeatures<> features;
+	trainer.train(features, data);
+	BOOST_CHECK_EQUAL(features.outputSize(), 3);
+
+	RealMatrix inputs = createBatch(data.elements());
+	RealMatrix phi = features(inputs);
+	BOOST_CHECK_SMALL(max(abs(prod(phi,trans(phi)) - kernel(inputs,inputs))), 1.e-8);
+}
+
+BOOST_AUTO_TEST_CASE( NystroemTrainer_KMeans )
+{
+	Chessboard problem;
+	Data<RealVector> data = problem.generateDataset(500,50).inputs();
+	RealMatrix inputs = createBatch(data.elements());
+	GaussianRbfKernel<> kernel(0.5);
+	RealMatrix K = kernel(inputs,inputs);
+
+	NystroemFeatures<> features;
+	NystroemTrainer<> trainer(&kernel, 30, true);
+	trainer.train(features, data);
+	BOOST_CHECK_EQUAL(features.landmarks().numberOfElements(), 30);
+	RealMatrix phi = features(inputs);
+	double error = norm_frobenius(prod(phi,trans(phi)) - K) / norm_frobenius(K);
+	BOOST_CHECK_SMALL(error, 0.1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       unit test for the random Fourier feature map
+ *
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+#define BOOST_TEST_MODULE MODELS_RANDOM_FOURIER_FEATURES
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <shark/Models/Kernels/RandomFourierFeatures.h>
+#include <shark/Rng/GlobalRng.h>
+
+#include "../derivativeTestHelper.h" //for testBatchEval
+
+using namespace shark;
+
+namespace{
+RealMatrix createInputs(std::size_t size, std::size_t dim){
+	RealMatrix inputs(size,dim);
+	for(std::size_t i = 0; i != size; ++i){
+		for(std::size_t j = 0; j != dim; ++j)
+			inputs(i,j) = Rng::uni(-1,1);
+	}
+	return inputs;
+}
+}
+
+BOOST_AUTO_TEST_SUITE (Models_Kernels_RandomFourierFeatures)
+
+BOOST_AUTO_TEST_CASE( RandomFourierFeatures_Gaussian )
+{
+	GaussianRbfKernel<> kernel(0.5);
+	RandomFourierFeatures<> features(kernel, 3, 20000);
+	BOOST_REQUIRE_EQUAL(features.inputSize(), 3);
+	BOOST_REQUIRE_EQUAL(features.outputSize(), 20000);
+
+	RealMatrix inputs = createInputs(20,3);
+	RealMatrix phi = features(inputs);
+	RealMatrix approximation = prod(phi,trans(phi));
+	RealMatrix K = kernel(inputs,inputs);
+	BOOST_CHECK_SMALL(max(abs(approximation - K)), 0.05);
+	testBatchEval(features,inputs);
+}
+
+BOOST_AUTO_TEST_CASE( RandomFourierFeatures_ARD )
+{
+	ARDKernelUnconstrained<> kernel(3);
+	RealVector gammas(3);
+	gammas(0) = 0.1;
+	gammas(1) = 1.0;
+	gammas(2) = 2.0;
+	kernel.setGammaVector(gammas);
+	RandomFourierFeatures<> features;
+	features.setStructure(kernel, 20000);
+
+	RealMatrix inputs = createInputs(20,3);
+	RealMatrix phi = features(inputs);
+	RealMatrix approximation = prod(phi,trans(phi));
+	RealMatrix K = kernel(inputs,inputs);
+	BOOST_CHECK_SMALL(max(abs(approximation - K)), 0.05);
+}
+
+BOOST_AUTO_TEST_CASE( RandomFourierFeatures_Parameters )
+{
+	GaussianRbfKernel<> kernel(0.5);
+	RandomFourierFeatures<> features(kernel, 3, 10);
+	RandomFourierFeatures<> copy(kernel, 3, 10);
+	copy.setParameterVector(features.parameterVector());
+
+	RealMatrix inputs = createInputs(5,3);
+	BOOST_CHECK_SMALL(max(abs(features(inputs) - copy(inputs))), 1.e-12);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -212,6 +212,61 @@ BOOST_AUTO_TEST_CASE( RNNET_WEIGHTED_PARAMETER_DERIVATIVE ){
 
 }
 
+//sequences of different lengths in one batch must give the same results as
+//evaluating every sequence on its own
+BOOST_AUTO_TEST_CASE( RNNET_RAGGED_BATCH ){
+	RecurrentStructure netStruct;
+	netStruct.setStructure(2,4,2,true,RecurrentStructure::Tanh);
+	RNNet net(&netStruct);
+
+	RealVector parameters(numberOfParameters);
+	for(size_t i=0;i!=numberOfParameters;++i){
+		parameters(i)= Rng::gauss(0,0.5);
+	}
+	net.setParameterVector(parameters);
+	net.setWarmUpSequence(Sequence(2,RealVector(2,0.5)));
+
+	//create a batch of sequences with lengths 3, 7 and 5 and coefficients for them
+	std::size_t lengths[] = {3,7,5};
+	std::vector<Sequence> inputBatch(3);
+	std::vector<Sequence> coefficientBatch(3);
+	for(size_t b = 0; b != 3; ++b){
+		inputBatch[b].resize(lengths[b],RealVector(2));
+		coefficientBatch[b].resize(lengths[b],RealVector(2));
+		for(size_t t = 0; t != lengths[b]; ++t){
+			for(size_t j = 0; j != 2; ++j){
+				inputBatch[b][t](j) = Rng::gauss(0,1);
+				coefficientBatch[b][t](j) = Rng::gauss(0,1);
+			}
+		}
+	}
+	
+	boost::shared_ptr<State> state = net.createState();
+	std::vector<Sequence> outputBatch;
+	net.eval(inputBatch,outputBatch,*state);
+	RealVector derivative;
+	net.weightedParameterDerivative(inputBatch,coefficientBatch,*state,derivative);
+	BOOST_REQUIRE_EQUAL(outputBatch.size(),3);
+	
+	RealVector testDerivative(numberOfParameters,0.0);
+	for(size_t b = 0; b != 3; ++b){
+		std::vector<Sequence> singleInput(1,inputBatch[b]);
+		std::vector<Sequence> singleCoefficients(1,coefficientBatch[b]);
+		std::vector<Sequence> singleOutput;
+		boost::shared_ptr<State> singleState = net.createState();
+		net.eval(singleInput,singleOutput,*singleState);
+		RealVector singleDerivative;
+		net.weightedParameterDerivative(singleInput,singleCoefficients,*singleState,singleDerivative);
+		testDerivative += singleDerivative;
+		
+		BOOST_REQUIRE_EQUAL(outputBatch[b].size(),lengths[b]);
+		for(size_t t = 0; t != lengths[b]; ++t){
+			BOOST_CHECK_SMALL(norm_2(outputBatch[b][t]-singleOutput[0][t]),1.e-12);
+		}
+	}
+	BOOST_CHECK_SMALL(norm_2(derivative-testDerivative),1.e-10);
+}
+
 //~ BOOST_AUTO_TEST_CASE( RNNET_SERIALIZATION_TEST)
 //~ {
 	//~ std::stringstream str;
@@ -32,6 +32,9 @@
  */
 
 #include <shark/ObjectiveFunctions/NegativeAUC.h>
+#include <shark/ObjectiveFunctions/ROC.h>
+#include <shark/Models/LinearModel.h>
+#include <shark/Rng/GlobalRng.h>
 
 #define BOOST_TEST_MODULE OBJECTIVEFUNCTIONS_AUC
 #include <boost/test/unit_test.hpp>
@@ -67,4 +70,76 @@ BOOST_AUTO_TEST_CASE( AUC_EVAL ) {
         //BOOST_CHECK((valueResult == 1.));
 }
 
+//compares the sort based computations to the definition as a sum over all pairs
+BOOST_AUTO_TEST_CASE( AUC_Ties_BruteForce ) {
+	std::size_t elements = 3000;
+	//scores are rounded so that ties occur
+	Data<RealVector> prediction(elements,RealVector(1),128);
+	Data<unsigned int> label(elements,0,128);
+	std::vector<double> pos,neg;
+	for(std::size_t i=0; i != elements; i++) {
+		double score = std::floor(Rng::uni(-1,1)*20)/20.0;
+		unsigned int l = Rng::coinToss(0.3);
+		prediction.element(i)(0) = score;
+		label.element(i) = l;
+		if(l == 1)
+			pos.push_back(score);
+		else
+			neg.push_back(score);
+	}
+	double pairs = 0;
+	double pairsStrict = 0;
+	for(std::size_t i = 0; i != pos.size(); ++i){
+		for(std::size_t j = 0; j != neg.size(); ++j){
+			if(pos[i] > neg[j]){
+				pairs += 1;
+				pairsStrict += 1;
+			}
+			else if(pos[i] == neg[j])
+				pairs += 0.5;
+		}
+	}
+	double total = double(pos.size())*neg.size();
+
+	NegativeAUC<unsigned int, RealVector> auc;
+	BOOST_CHECK_SMALL(auc.eval(label, prediction) + pairs/total, 1.e-12);
+	NegativeAUC<unsigned int, RealVector> aucInverted(true);
+	BOOST_CHECK_SMALL(aucInverted.eval(label, prediction) + 1 - pairs/total, 1.e-12);
+	NegativeWilcoxonMannWhitneyStatistic<unsigned int, RealVector> wmw;
+	BOOST_CHECK_SMALL(wmw.eval(label, prediction) + pairsStrict/total, 1.e-12);
+
+	//the identity model turns the predictions into scores
+	LinearModel<> model(1,1);
+	model.setParameterVector(RealVector(1,1.0));
+	ROC roc(model,LabeledData<RealVector,unsigned int>(prediction,label));
+	BOOST_CHECK_SMALL(roc.area() - pairs/total, 1.e-12);
+
+	//average precision: mean over positives of the precision at their score
+	double averagePrecision = 0;
+	for(std::size_t i = 0; i != pos.size(); ++i){
+		double truePositives = 0;
+		double falsePositives = 0;
+		for(std::size_t j = 0; j != pos.size(); ++j)
+			truePositives += pos[j] >= pos[i];
+		for(std::size_t j = 0; j != neg.size(); ++j)
+			falsePositives += neg[j] >= pos[i];
+		averagePrecision += truePositives/(truePositives+falsePositives);
+	}
+	averagePrecision /= pos.size();
+	BOOST_CHECK_SMALL(roc.averagePrecision() - averagePrecision, 1.e-12);
+
+	//verification rate at the false acceptance rates of the negative scores
+	for(std::size_t k = 0; k != 10; ++k){
+		double threshold = roc.threshold(0.1*k+0.05);
+		double accepted = 0;
+		for(std::size_t i = 0; i != pos.size(); ++i)
+			accepted += pos[i] >= threshold;
+		if(accepted == pos.size() || accepted == 0) continue;
+		//interpolation only happens between different positive scores
+		double value = roc.value(0.1*k+0.05);
+		BOOST_CHECK(value >= accepted/pos.size() - 1.e-12);
+		BOOST_CHECK(value <= (accepted+1)/pos.size() + 1.e-12);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,8 @@
 #include <shark/ObjectiveFunctions/ErrorFunction.h>
 #include <shark/Algorithms/Trainers/LinearRegression.h>
 #include <shark/Algorithms/GradientDescent/Rprop.h>
+#include <shark/Algorithms/GradientDescent/SGD.h>
+#include <shark/Models/FFNet.h>
 #include <shark/Statistics/Distributions/MultiVariateNormalDistribution.h>
 #include <shark/Rng/Uniform.h>
 
@@ -217,4 +219,111 @@ BOOST_AUTO_TEST_CASE( ObjFunct_ErrorFunction_LinearRegression ){
 	
 }
 
+//checks that the error on randomly drawn minibatches is an unbiased estimate of the full error
+//and that stochastic gradient descent on the minibatches finds the optimum
+BOOST_AUTO_TEST_CASE( ObjFunct_ErrorFunction_Minibatch ){
+	const size_t trainExamples = 1000;
+	LinearModel<> model(2,2,true);
+	RealVector optimum(6);
+	for(std::size_t i = 0; i != 6; ++i){
+		optimum(i) = i-2.0;
+	}
+	model.setParameterVector(optimum);
+	
+	Uniform<> uniform(Rng::globalRng,-3.0, 3.0);
+	std::vector<RealVector> input(trainExamples,RealVector(2));
+	std::vector<RealVector> target(trainExamples,RealVector(2));
+	for (size_t i=0;i!=trainExamples;++i) {
+		input[i](0) = uniform();
+		input[i](1) = uniform();
+		target[i] =  model(input[i]);
+		target[i](0) += 0.1*uniform();
+		target[i](1) += 0.1*uniform();
+	}
+	RegressionDataset trainset = createLabeledDataFromRange(input, target,100);
+	SquaredLoss<> loss;
+	
+	RealVector point(6,0.5);
+	detail::ErrorFunctionImpl<RealVector,RealVector,RealVector> sequential(trainset,&model,&loss);
+	detail::ParallelErrorFunctionImpl<RealVector,RealVector,RealVector> parallel(trainset,&model,&loss);
+	detail::ErrorFunctionWrapperBase* impls[] = {&sequential,&parallel};
+	for(std::size_t k = 0; k != 2; ++k){
+		detail::ErrorFunctionWrapperBase& mse = *impls[k];
+		RealVector fullDerivative;
+		double fullError = mse.evalDerivative(point,fullDerivative);
+		
+		//using all batches gives the exact result
+		mse.setNumBatches(10);
+		RealVector derivative;
+		BOOST_CHECK_CLOSE(mse.evalDerivative(point,derivative),fullError,1.e-10);
+		BOOST_CHECK_SMALL(norm_inf(derivative-fullDerivative),1.e-10);
+		
+		//the mean of the estimates converges to the full error
+		mse.setNumBatches(3);
+		std::size_t trials = 2000;
+		double meanError = 0;
+		RealVector meanDerivative(6,0.0);
+		for(std::size_t t = 0; t != trials; ++t){
+			meanError += mse.evalDerivative(point,derivative)/trials;
+			noalias(meanDerivative) += derivative/double(trials);
+		}
+		BOOST_CHECK_CLOSE(meanError,fullError,1.0);
+		BOOST_CHECK_SMALL(norm_inf(meanDerivative-fullDerivative)/norm_inf(fullDerivative),1.e-2);
+	}
+	
+	ErrorFunction mse(trainset, &model,&loss);
+	mse.setNumBatches(1);
+	BOOST_CHECK_EQUAL(mse.numBatches(),1u);
+	SGD sgd;
+	sgd.setLearningRate(0.01);
+	sgd.setMomentum(0.9);
+	sgd.setLearningRateDecay(0.01);
+	sgd.init(mse,point);
+	for(std::size_t i = 0; i != 1000; ++i){
+		sgd.step(mse);
+	}
+	double diff = norm_sqr(sgd.solution().point-optimum);
+	BOOST_CHECK_SMALL(diff, 1.e-3);
+}
+
+//gradient descent directly on the parameter storage of the network gives
+//the same results as passing copies of the parameters
+BOOST_AUTO_TEST_CASE( ObjFunct_ErrorFunction_ParameterStorage ){
+	FFNet<LogisticNeuron,LinearNeuron> net;
+	net.setStructure(2,5,2);
+	FFNet<LogisticNeuron,LinearNeuron> netCopy;
+	netCopy.setStructure(2,5,2);
+	RealVector point(net.numberOfParameters());
+	for(std::size_t i = 0; i != point.size(); ++i){
+		point(i) = Rng::uni(-1,1);
+	}
+	net.setParameterVector(point);
+
+	std::vector<RealVector> input(100,RealVector(2));
+	std::vector<RealVector> target(100,RealVector(2));
+	for (size_t i=0;i!=100;++i) {
+		input[i](0) = Rng::uni(-1,1);
+		input[i](1) = Rng::uni(-1,1);
+		target[i](0) = input[i](0)*input[i](1);
+		target[i](1) = input[i](0)-input[i](1);
+	}
+	RegressionDataset trainset = createLabeledDataFromRange(input, target,10);
+	SquaredLoss<> loss;
+	ErrorFunction mse(trainset, &net,&loss);
+	ErrorFunction mseCopy(trainset, &netCopy,&loss);
+
+	RealVector& storage = net.parameterStorage();
+	RealVector derivative;
+	RealVector derivativeCopy;
+	for(std::size_t i = 0; i != 10; ++i){
+		double error = mse.evalDerivative(storage,derivative);
+		double errorCopy = mseCopy.evalDerivative(point,derivativeCopy);
+		BOOST_CHECK_CLOSE(error,errorCopy,1.e-12);
+		BOOST_CHECK_SMALL(norm_inf(derivative-derivativeCopy),1.e-12);
+		noalias(storage) -= 0.1*derivative;
+		noalias(point) -= 0.1*derivativeCopy;
+	}
+	BOOST_CHECK_SMALL(norm_inf(net.parameterVector()-point),1.e-12);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
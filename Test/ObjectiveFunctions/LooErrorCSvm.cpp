@@ -197,4 +197,42 @@ BOOST_AUTO_TEST_CASE( ObjectiveFunctions_LooErrorCSvm_Chessboard_NoBias )
 	BOOST_CHECK_SMALL(value - standardLoo, 1e-10);
 }
 
+// the full problem is solved with shrinking, which permutes the variables,
+// and the leave-one-out problems are distributed over several threads.
+BOOST_AUTO_TEST_CASE( ObjectiveFunctions_LooErrorCSvm_Chessboard_Parallel_Shrinking )
+{
+	Chessboard problem;
+	ClassificationDataset dataset = problem.generateDataset(200);
+
+	GaussianRbfKernel<> kernel(0.5);
+	double C = 10;
+	for(std::size_t offset = 0; offset != 2; ++offset){
+		CSvmTrainer<RealVector> trainer(&kernel, C, offset == 1);
+		trainer.shrinking() = true;
+		trainer.setMinAccuracy(.000001);
+		RealVector parameters = trainer.parameterVector();
+
+		// brute force computation
+		ZeroOneLoss<unsigned int> loss;
+		KernelClassifier<RealVector> ke;
+		LooError<KernelClassifier<RealVector>,unsigned int> loo(dataset, &ke, &trainer, &loss);
+		double standardLoo = loo.eval();
+
+		LooErrorCSvm<RealVector> loosvm(dataset, &kernel, offset == 1);
+		loosvm.shrinking() = true;
+#ifdef SHARK_USE_OPENMP
+		int threads = omp_get_max_threads();
+		omp_set_num_threads(1);
+		double serialValue = loosvm.eval(parameters, trainer.stoppingCondition());
+		omp_set_num_threads(4);
+		double value = loosvm.eval(parameters, trainer.stoppingCondition());
+		omp_set_num_threads(threads);
+		BOOST_CHECK_SMALL(value - serialValue, 1e-10);
+#else
+		double value = loosvm.eval(parameters, trainer.stoppingCondition());
+#endif
+		BOOST_CHECK_SMALL(value - standardLoo, 1e-10);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
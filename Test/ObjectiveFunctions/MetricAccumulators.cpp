@@ -0,0 +1,110 @@
+#include <shark/ObjectiveFunctions/MetricAccumulators.h>
+#include <shark/ObjectiveFunctions/NegativeAUC.h>
+#include <shark/ObjectiveFunctions/Loss/SquaredLoss.h>
+#include <shark/ObjectiveFunctions/Loss/ZeroOneLoss.h>
+#include <shark/Models/LinearModel.h>
+#include <shark/Rng/GlobalRng.h>
+
+#define BOOST_TEST_MODULE OBJECTIVEFUNCTIONS_METRICACCUMULATORS
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+using namespace shark;
+
+namespace{
+//binary classification data with a linear model with one output
+struct Fixture{
+	Fixture():model(3,1){
+		std::size_t elements = 1000;
+		std::vector<RealVector> inputs(elements,RealVector(3));
+		std::vector<unsigned int> labels(elements);
+		for(std::size_t i = 0; i != elements; ++i){
+			for(std::size_t j = 0; j != 3; ++j)
+				inputs[i](j) = Rng::gauss();
+			labels[i] = inputs[i](0) + Rng::gauss() > 0;
+		}
+		data = createLabeledDataFromRange(inputs,labels,37);
+		RealVector parameters(3);
+		parameters(0) = 1;
+		parameters(1) = 0.1;
+		parameters(2) = -0.2;
+		model.setParameterVector(parameters);
+	}
+	LabeledData<RealVector,unsigned int> data;
+	LinearModel<> model;
+};
+}
+
+BOOST_FIXTURE_TEST_SUITE (ObjectiveFunctions_MetricAccumulators, Fixture)
+
+BOOST_AUTO_TEST_CASE( MetricAccumulators_AUC ) {
+	Data<RealVector> predictions = model(data.inputs());
+	NegativeAUC<> auc;
+	double exact = -auc.eval(data.labels(),predictions);
+
+	//the error of the histogram is bounded by the pairs sharing a bin
+	AUCAccumulator accumulator(-4,4,1<<16);
+	accumulateMetric(model,data,accumulator);
+	BOOST_REQUIRE_EQUAL(accumulator.positives()+accumulator.negatives(), data.numberOfElements());
+	BOOST_CHECK_SMALL(accumulator.area() - exact, 1.e-3);
+
+	//rounded scores are exact when every rounded value has its own bin
+	for(std::size_t b = 0; b != predictions.numberOfBatches(); ++b){
+		RealMatrix& batch = predictions.batch(b);
+		for(std::size_t i = 0; i != batch.size1(); ++i)
+			batch(i,0) = std::floor(batch(i,0)*4)/4.0 + 0.125;
+	}
+	AUCAccumulator rounded(-8,8,64);
+	for(std::size_t b = 0; b != predictions.numberOfBatches(); ++b)
+		rounded.addBatch(data.batch(b).label,predictions.batch(b));
+	BOOST_CHECK_SMALL(rounded.area() + auc.eval(data.labels(),predictions), 1.e-12);
+
+	//adding a second time does not change the area but keeps the old examples
+	accumulateMetric(model,data,accumulator);
+	BOOST_CHECK_EQUAL(accumulator.positives()+accumulator.negatives(), 2*data.numberOfElements());
+	BOOST_CHECK_SMALL(accumulator.area() - exact, 1.e-3);
+}
+
+BOOST_AUTO_TEST_CASE( MetricAccumulators_Confusion ) {
+	Data<RealVector> predictions = model(data.inputs());
+	ConfusionAccumulator confusion;
+	accumulateMetric(model,data,confusion);
+	BOOST_REQUIRE_EQUAL(confusion.examples(), data.numberOfElements());
+
+	std::size_t counts[2][2]={{0,0},{0,0}};
+	for(std::size_t i = 0; i != data.numberOfElements(); ++i){
+		unsigned int predicted = predictions.element(i)(0) > 0;
+		++counts[data.labels().element(i)][predicted];
+	}
+	for(std::size_t i = 0; i != 2; ++i)
+		for(std::size_t j = 0; j != 2; ++j)
+			BOOST_CHECK_EQUAL(confusion.count(i,j), counts[i][j]);
+
+	ZeroOneLoss<unsigned int, RealVector> loss;
+	BOOST_CHECK_SMALL(confusion.errorRate() - loss.eval(data.labels(),predictions), 1.e-12);
+}
+
+BOOST_AUTO_TEST_CASE( MetricAccumulators_Loss ) {
+	Data<RealVector> predictions = model(data.inputs());
+
+	ZeroOneLoss<unsigned int, RealVector> zeroOne;
+	LossAccumulator<unsigned int, RealVector> zeroOneSum(zeroOne);
+	accumulateMetric(model,data,zeroOneSum);
+	BOOST_CHECK_EQUAL(zeroOneSum.count(), data.numberOfElements());
+	BOOST_CHECK_SMALL(zeroOneSum.mean() - zeroOne.eval(data.labels(),predictions), 1.e-10);
+
+	//regression on the same inputs
+	Data<RealVector> targets = data.inputs();
+	LabeledData<RealVector,RealVector> regression(data.inputs(),targets);
+	LinearModel<> regressionModel(3,3);
+	regressionModel.setParameterVector(blas::repeat(0.5,9));
+	SquaredLoss<> squared;
+	LossAccumulator<RealVector, RealVector> squaredSum(squared);
+	accumulateMetric(regressionModel,regression,squaredSum);
+	BOOST_CHECK_SMALL(
+		squaredSum.mean() - squared.eval(targets,regressionModel(regression.inputs())),
+		1.e-10
+	);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
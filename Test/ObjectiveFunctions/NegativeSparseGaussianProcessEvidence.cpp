@@ -0,0 +1,164 @@
+//===========================================================================
+/*!
+ * 
+ *
+ * \brief       Test case for the approximate evidence of a sparse
+ * Gaussian Process/Regularization Network.
+ * 
+ * 
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ * 
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ * 
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published 
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <shark/Rng/GlobalRng.h>
+#include <shark/Algorithms/Trainers/SparseRegularizationNetworkTrainer.h>
+#include <shark/ObjectiveFunctions/Loss/SquaredLoss.h>
+#include <shark/Data/Dataset.h>
+#include <shark/Data/DataDistribution.h>
+
+
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/Algorithms/GradientDescent/Rprop.h>
+#include <shark/ObjectiveFunctions/NegativeGaussianProcessEvidence.h>
+#include <shark/ObjectiveFunctions/NegativeSparseGaussianProcessEvidence.h>
+
+#define BOOST_TEST_MODULE OBJECTIVEFUNCTIONS_SPARSE_EVIDENCE
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+using namespace shark;
+using namespace std;
+
+
+BOOST_AUTO_TEST_SUITE (ObjectiveFunctions_NegativeSparseGaussianProcessEvidence)
+
+//with all training points as inducing points, the evidence is the exact one
+BOOST_AUTO_TEST_CASE( SPARSE_GAUSSIAN_PROCESS_EVIDENCE_EXACT )
+{
+	Rng::seed( 0 );
+	const unsigned int ell = 50;
+	const bool unconstrained = true;
+
+	GaussianRbfKernel<> kernel(1.0, unconstrained);
+	Wave prob;
+	RegressionDataset trainingData = prob.generateDataset(ell,16);
+
+	NegativeGaussianProcessEvidence<> exact(trainingData, &kernel, unconstrained);
+	NegativeSparseGaussianProcessEvidence<> sparse(trainingData, trainingData.inputs(), &kernel, unconstrained);
+	BOOST_REQUIRE_EQUAL(exact.numberOfVariables(), sparse.numberOfVariables());
+
+	for(std::size_t test = 0; test != 10; ++test){
+		RealVector parameters(2);
+		parameters(0) = Rng::uni(-1,1);
+		parameters(1) = Rng::uni(-3,0);
+		SingleObjectiveFunction::FirstOrderDerivative exactDerivative;
+		SingleObjectiveFunction::FirstOrderDerivative sparseDerivative;
+		double exactValue = exact.evalDerivative(parameters, exactDerivative);
+		double sparseValue = sparse.evalDerivative(parameters, sparseDerivative);
+		BOOST_CHECK_CLOSE(exactValue, sparseValue, 0.01);
+		BOOST_CHECK_CLOSE(sparseValue, sparse.eval(parameters), 1.e-10);
+		for(std::size_t i = 0; i != 2; ++i){
+			BOOST_CHECK_SMALL(exactDerivative(i) - sparseDerivative(i), 1.e-3 * (1+std::abs(exactDerivative(i))));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( SPARSE_GAUSSIAN_PROCESS_EVIDENCE_DERIVATIVE )
+{
+	Rng::seed( 0 );
+	const unsigned int ell = 200;
+	const unsigned int m = 20;
+	const bool unconstrained = true;
+
+	GaussianRbfKernel<> kernel(1.0, unconstrained);
+	Wave prob;
+	RegressionDataset trainingData = prob.generateDataset(ell);
+	Data<RealVector> inducingPoints = selectLandmarks(trainingData.inputs(), m);
+	NegativeSparseGaussianProcessEvidence<> evidence(trainingData, inducingPoints, &kernel, unconstrained);
+
+	for(std::size_t test = 0; test != 20; ++test){
+		RealVector parameters(2);
+		parameters(0) = Rng::uni(-2,1);
+		parameters(1) = Rng::uni(-3,1);
+		SingleObjectiveFunction::FirstOrderDerivative derivative;
+		double value = evidence.evalDerivative(parameters, derivative);
+		BOOST_CHECK_CLOSE(value, evidence.eval(parameters), 1.e-10);
+		//central differences
+		for(std::size_t i = 0; i != 2; ++i){
+			RealVector left = parameters;
+			RealVector right = parameters;
+			left(i) -= 1.e-4;
+			right(i) += 1.e-4;
+			double estimate = (evidence.eval(right) - evidence.eval(left)) / 2.e-4;
+			BOOST_CHECK_SMALL(estimate - derivative(i), 1.e-3 * (1+std::abs(derivative(i))));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( SPARSE_GAUSSIAN_PROCESS_EVIDENCE_OPTIMIZATION )
+{
+	Rng::seed( 0 );
+	const unsigned int ell = 500;
+	const unsigned int m = 30;
+	const double gamma = 100.;
+	const double beta  = 1000;
+	const bool unconstrained = true;
+
+	GaussianRbfKernel<> kernel(gamma, unconstrained);
+	SquaredLoss<> loss;
+	Wave prob;
+	RegressionDataset trainingData = prob.generateDataset(ell);
+	RegressionDataset testData = prob.generateDataset(1000);
+
+	SparseRegularizationNetworkTrainer<RealVector> trainer(&kernel, 1.0/beta, m, true, unconstrained);
+	trainer.setInducingPoints(selectLandmarks(trainingData.inputs(), m, true));
+	NegativeSparseGaussianProcessEvidence<> evidence(trainingData, trainer.inducingPoints(), &kernel, unconstrained);
+	
+	RealVector params(2);
+	params(0) = std::log(gamma);
+	params(1) = std::log(1.0/beta);
+	IRpropPlus rprop;
+	rprop.init(evidence, params);
+	double startEvidence = rprop.solution().value;
+	
+	KernelExpansion<RealVector> model;
+	trainer.train(model, trainingData);
+	double startTestError = loss.eval(testData.labels(), model(testData.inputs()));
+	for (unsigned int iter=0; iter<50; iter++) 
+		rprop.step(evidence);
+	
+	//the trainer encodes the precision, the evidence the noise variance
+	RealVector point = rprop.solution().point;
+	point(1) *= -1;
+	trainer.setParameterVector(point);
+	trainer.train(model, trainingData);
+	double testError = loss.eval(testData.labels(), model(testData.inputs()));
+	
+	BOOST_CHECK(rprop.solution().value < startEvidence);
+	BOOST_CHECK(testError < startTestError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
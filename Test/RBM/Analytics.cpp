@@ -1,5 +1,6 @@
 #include <shark/Unsupervised/RBM/Energy.h>
 #include <shark/Unsupervised/RBM/Neuronlayers/BinaryLayer.h>
+#include <shark/Unsupervised/RBM/Neuronlayers/BipolarLayer.h>
 #include <shark/Unsupervised/RBM/RBM.h>
 #include <shark/Unsupervised/RBM/analytics.h>
 
@@ -91,6 +92,37 @@ BOOST_AUTO_TEST_CASE( Energy_Partition_HiddenGreaterVisible )
 	}
 }
 
+//the states are enumerated incrementally in several batches, so compare with summing over
+//the probabilities of all states computed from scratch
+BOOST_AUTO_TEST_CASE( Energy_Partition_Bipolar_ManyStates )
+{
+	//factorizes over the hidden as there are less hidden than visible neurons and vice versa
+	RBM<BipolarLayer,BipolarLayer,Rng::rng_type > rbmMoreVisible(Rng::globalRng);
+	rbmMoreVisible.setStructure(11,4);
+	initRandomNormal(rbmMoreVisible,0.5);
+	RBM<BipolarLayer,BipolarLayer,Rng::rng_type > rbmMoreHidden(Rng::globalRng);
+	rbmMoreHidden.setStructure(4,11);
+	initRandomNormal(rbmMoreHidden,0.5);
+	
+	std::size_t values = SymmetricBinarySpace::numberOfStates(11);
+	RealMatrix states(values,11);
+	for(std::size_t x = 0; x != values; ++x){
+		SymmetricBinarySpace::state(row(states,x),x);
+	}
+	
+	for(std::size_t i = 0; i <= 4; ++i){
+		double beta=i*0.25;
+		
+		double partitionTest = sum(exp(rbmMoreVisible.energy().logUnnormalizedProbabilityVisible(states,blas::repeat(beta,values))));
+		double logPartition = logPartitionFunction(rbmMoreVisible,beta);
+		BOOST_CHECK_CLOSE(logPartition,std::log(partitionTest),1.e-5);
+		
+		partitionTest = sum(exp(rbmMoreHidden.energy().logUnnormalizedProbabilityHidden(states,blas::repeat(beta,values))));
+		logPartition = logPartitionFunction(rbmMoreHidden,beta);
+		BOOST_CHECK_CLOSE(logPartition,std::log(partitionTest),1.e-5);
+	}
+}
+
 BOOST_AUTO_TEST_CASE( Energy_NegLogLikelihood )
 {
 	
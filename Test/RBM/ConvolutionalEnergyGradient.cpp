@@ -244,10 +244,14 @@ BOOST_AUTO_TEST_CASE( ConvolutionalEnergyGradient_DerivativeVH )
 	TestGradientVH gradient(&rbm);
 	gradient.setData(data);
 	
-	for(std::size_t i = 0; i != 100; ++i){
-		initRandomNormal(rbm,1);
-		RealVector parameters = rbm.parameterVector();
-		testDerivative(gradient,parameters,1.e-2,1.e-10,0.025);
+	//the derivative must be correct for all convolution algorithms
+	for(std::size_t algorithm = 0; algorithm != 3; ++algorithm){
+		rbm.setConvolutionAlgorithm(ConvolutionAlgorithm(algorithm));
+		for(std::size_t i = 0; i != 100; ++i){
+			initRandomNormal(rbm,1);
+			RealVector parameters = rbm.parameterVector();
+			testDerivative(gradient,parameters,1.e-2,1.e-10,0.025);
+		}
 	}
 }
 
@@ -327,10 +331,14 @@ BOOST_AUTO_TEST_CASE( ConvolutionalEnergyGradient_DerivativeHV )
 	TestGradientHV gradient(&rbm);
 	gradient.setData(data);
 	
-	for(std::size_t i = 0; i != 100; ++i){
-		initRandomNormal(rbm,1);
-		RealVector parameters = rbm.parameterVector();
-		testDerivative(gradient,parameters,2.e-2,1.e-10,0.01);
+	//the derivative must be correct for all convolution algorithms
+	for(std::size_t algorithm = 0; algorithm != 3; ++algorithm){
+		rbm.setConvolutionAlgorithm(ConvolutionAlgorithm(algorithm));
+		for(std::size_t i = 0; i != 100; ++i){
+			initRandomNormal(rbm,1);
+			RealVector parameters = rbm.parameterVector();
+			testDerivative(gradient,parameters,2.e-2,1.e-10,0.01);
+		}
 	}
 }
 
@@ -132,21 +132,114 @@ BOOST_AUTO_TEST_CASE( Input ){
 	RealMatrix resultWV=prod(batchV,trans(W));
 	RealMatrix resultWH=prod(batchH,W);
 	
-	RealMatrix rbmWV(10,8,1.0);
-	RealMatrix rbmWH(10,16,1.0);
-	
-	rbm.inputHidden(rbmWV,batchV);
-	rbm.inputVisible(rbmWH,batchH);
-	
-	for(std::size_t i = 0; i != 10; ++i){
-		for(std::size_t j = 0; j != 16; ++j){
-			BOOST_CHECK_CLOSE(rbmWH(i,j),resultWH(i,j),1.e-12);
+	//all algorithms must give the same result
+	for(std::size_t algorithm = 0; algorithm != 3; ++algorithm){
+		rbm.setConvolutionAlgorithm(ConvolutionAlgorithm(algorithm));
+		RealMatrix rbmWV(10,8,1.0);
+		RealMatrix rbmWH(10,16,1.0);
+		
+		rbm.inputHidden(rbmWV,batchV);
+		rbm.inputVisible(rbmWH,batchH);
+		
+		for(std::size_t i = 0; i != 10; ++i){
+			for(std::size_t j = 0; j != 16; ++j){
+				BOOST_CHECK_SMALL(rbmWH(i,j)-resultWH(i,j),1.e-10);
+			}
+		}
+		
+		for(std::size_t i = 0; i != 10; ++i){
+			for(std::size_t j = 0; j != 8; ++j){
+				BOOST_CHECK_SMALL(rbmWV(i,j)-resultWV(i,j),1.e-10);
+			}
 		}
 	}
-	
-	for(std::size_t i = 0; i != 10; ++i){
-		for(std::size_t j = 0; j != 8; ++j){
-			BOOST_CHECK_CLOSE(rbmWV(i,j),resultWV(i,j),1.e-12);
+}
+
+//the loop based implementation the convolution algorithms are compared against
+void referenceInputHidden(ConvolutionalBinaryRBM const& rbm, RealMatrix& inputs, RealMatrix const& visibleStates){
+	blas::matrix_set<RealMatrix> const& filters = rbm.weightMatrix();
+	inputs.clear();
+	for(std::size_t i= 0; i != inputs.size1();++i){
+		blas::dense_matrix_adaptor<double const> visibleState = 
+			to_matrix(row(visibleStates,i),rbm.inputSize1(),rbm.inputSize2());
+		blas::dense_matrix_adaptor<double> responses = 
+			to_matrix(row(inputs,i),filters.size()*rbm.responseSize1(),rbm.responseSize2());
+		
+		for (std::size_t x1=0; x1 != rbm.responseSize1(); ++x1) {
+			for (std::size_t x2=0; x2 != rbm.responseSize2(); ++x2) {
+				std::size_t end1= x1+filters.size1();
+				std::size_t end2= x2+filters.size2();
+				for(std::size_t f = 0; f != filters.size();++f){
+					responses(f*rbm.responseSize1()+x1,x2)=sum(filters[f]*subrange(visibleState,x1,end1,x2,end2));
+				}
+			}
+		}
+	}
+}
+void referenceInputVisible(ConvolutionalBinaryRBM const& rbm, RealMatrix& inputs, RealMatrix const& hiddenStates){
+	typedef blas::dense_matrix_adaptor<double> Response;
+	blas::matrix_set<RealMatrix> const& filters = rbm.weightMatrix();
+	inputs.clear();
+	for(std::size_t i= 0; i != inputs.size1();++i){
+		blas::dense_matrix_adaptor<double const> hiddenState = 
+			to_matrix(row(hiddenStates,i),rbm.responseSize1()*filters.size(),rbm.responseSize2());
+		Response responses = 
+			to_matrix(row(inputs,i),rbm.inputSize1(),rbm.inputSize2());
+		
+		for (std::size_t x1=0; x1 != rbm.responseSize1(); ++x1) {
+			for (std::size_t x2=0; x2 != rbm.responseSize2(); ++x2) {
+				std::size_t end1= x1+filters.size1();
+				std::size_t end2= x2+filters.size2();
+				blas::matrix_range<Response> receptiveArea = subrange(responses,x1,end1,x2,end2);
+					
+				for(std::size_t f = 0; f != filters.size();++f){
+					double neuronResponse = hiddenState(f*rbm.responseSize1()+x1,x2);
+					if(neuronResponse == 0.0) continue;
+					noalias(receptiveArea) += neuronResponse * filters[f];
+				}
+			}
+		}
+	}
+}
+
+//compares the GEMM and FFT algorithms against the reference for different filter sizes
+BOOST_AUTO_TEST_CASE( Input_Algorithms ){
+	std::size_t inputSize1 = 28;
+	std::size_t inputSize2 = 30;
+	std::size_t numFilters = 16;
+	std::size_t batchSize = 20;
+	std::size_t filterSizes[] = {3,9,17};
+	
+	for(std::size_t s = 0; s != 3; ++s){
+		ConvolutionalBinaryRBM rbm(Rng::globalRng);
+		rbm.setStructure(inputSize1,inputSize2,numFilters,filterSizes[s]);
+		initRandomNormal(rbm,1.0);
+		
+		RealMatrix batchV(batchSize,rbm.numberOfVN());
+		RealMatrix batchH(batchSize,rbm.numberOfHN());
+		for(std::size_t i = 0; i != batchSize; ++i){
+			for(std::size_t j = 0; j != batchV.size2(); ++j){
+				batchV(i,j)=Rng::coinToss();
+			}
+			for(std::size_t j = 0; j != batchH.size2(); ++j){
+				batchH(i,j)=Rng::coinToss();
+			}
+		}
+		
+		RealMatrix referenceWV(batchSize,rbm.numberOfHN());
+		RealMatrix referenceWH(batchSize,rbm.numberOfVN());
+		referenceInputHidden(rbm,referenceWV,batchV);
+		referenceInputVisible(rbm,referenceWH,batchH);
+		
+		for(std::size_t algorithm = 0; algorithm != 3; ++algorithm){
+			rbm.setConvolutionAlgorithm(ConvolutionAlgorithm(algorithm));
+			RealMatrix rbmWV(batchSize,rbm.numberOfHN());
+			RealMatrix rbmWH(batchSize,rbm.numberOfVN());
+			rbm.inputHidden(rbmWV,batchV);
+			rbm.inputVisible(rbmWH,batchH);
+			
+			BOOST_CHECK_SMALL(max(abs(rbmWV-referenceWV)),1.e-10);
+			BOOST_CHECK_SMALL(max(abs(rbmWH-referenceWH)),1.e-10);
 		}
 	}
 }
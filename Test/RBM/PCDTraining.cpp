@@ -50,4 +50,36 @@ BOOST_AUTO_TEST_CASE( PCDTraining_Bars ){
 	BOOST_CHECK( logLikelyhood<200.0 );
 }
 
+//the chains are advanced in parallel, but for a fixed seed the gradient must not change
+BOOST_AUTO_TEST_CASE( PCDTraining_Reproducible ){
+	BarsAndStripes problem;
+	UnlabeledData<RealVector> data = problem.data();
+	
+	RealVector derivatives[2][3];
+	for(std::size_t trial = 0; trial != 2; ++trial){
+		Rng::seed(42);
+		BinaryRBM rbm(Rng::globalRng);
+		rbm.setStructure(16,8);
+		RealVector params(rbm.numberOfParameters());
+		for(std::size_t i = 0; i != params.size();++i){
+			params(i) = Rng::gauss(0,1);
+		}
+		rbm.setParameterVector(params);
+		BinaryPCD cd(&rbm);
+		cd.setNumberOfSamples(64);
+		cd.setBatchSize(8);
+		cd.setData(data);
+		for(std::size_t step = 0; step != 3; ++step){
+			cd.evalDerivative(params,derivatives[trial][step]);
+			noalias(params) -= 0.05 * derivatives[trial][step];
+		}
+	}
+	for(std::size_t step = 0; step != 3; ++step){
+		BOOST_REQUIRE_EQUAL(derivatives[0][step].size(), derivatives[1][step].size());
+		for(std::size_t i = 0; i != derivatives[0][step].size(); ++i){
+			BOOST_CHECK_EQUAL(derivatives[0][step](i), derivatives[1][step](i));
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
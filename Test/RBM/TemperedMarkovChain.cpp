@@ -92,4 +92,46 @@ BOOST_AUTO_TEST_CASE( TemperedMarkovChain_Distribution )
 	}
 }
 
+//adapting the temperatures must lead to more uniform acceptance rates of the swaps
+BOOST_AUTO_TEST_CASE( TemperedMarkovChain_TemperatureAdaptation )
+{
+	const std::size_t numTemperatures = 10;
+	Rng::seed(1);
+	BinaryRBM rbm(Rng::globalRng);
+	rbm.setStructure(16,16);
+	RealVector params(rbm.numberOfParameters());
+	for(std::size_t i = 0; i != params.size();++i){
+		params(i) = Rng::gauss(0,1);
+	}
+	rbm.setParameterVector(params);
+	
+	TemperedMarkovChain<GibbsOperator<BinaryRBM> > pt(&rbm);
+	pt.setUniformTemperatureSpacing(numTemperatures);
+	pt.initializeChain(RealMatrix(numTemperatures,16,0));
+	pt.step(1000);
+	
+	//acceptance rates of the uniform spacing
+	pt.resetSwapAcceptanceRates();
+	pt.step(5000);
+	RealVector uniformRates = pt.swapAcceptanceRates();
+	
+	//adapt and measure again using the fixed new temperatures
+	pt.setTemperatureAdaptation(0.01);
+	pt.step(20000);
+	pt.setTemperatureAdaptation(0);
+	pt.resetSwapAcceptanceRates();
+	pt.step(10000);
+	RealVector adaptedRates = pt.swapAcceptanceRates();
+	
+	BOOST_CHECK_EQUAL(pt.beta(0),1.0);
+	BOOST_CHECK_SMALL(pt.beta(numTemperatures-1),1.e-12);
+	for(std::size_t i = 0; i != numTemperatures-1; ++i){
+		BOOST_CHECK(pt.beta(i) > pt.beta(i+1));
+	}
+	double uniformSpread = max(uniformRates) - min(uniformRates);
+	double adaptedSpread = max(adaptedRates) - min(adaptedRates);
+	std::cout<<uniformRates<<"\n"<<adaptedRates<<std::endl;
+	BOOST_CHECK(adaptedSpread < 0.5*uniformSpread);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -57,6 +57,57 @@ BOOST_AUTO_TEST_CASE( MULTIVARIATENORMAL_EIGENVALUES ) {
 	
 }
 
+BOOST_AUTO_TEST_CASE( MULTIVARIATENORMAL_Batch ) {
+	std::size_t Dimensions = 5;
+	std::size_t Samples = 10000;
+	
+	//Generate covariance matrix
+	RealMatrix base(Dimensions,2*Dimensions);
+	for(std::size_t i = 0; i != Dimensions; ++i){
+		for(std::size_t j = 0; j != 2*Dimensions; ++j){//2* to guarantue full rank.
+			base(i,j) = Rng::gauss(0,1);
+		}
+	}
+	RealMatrix covariance=prod(base,trans(base));
+	covariance /= 2*Dimensions;
+	
+	MultiVariateNormalDistribution dist(covariance);
+	RealMatrix samples;
+	RealMatrix normalSamples;
+	dist.generate(samples,normalSamples,Samples);
+	BOOST_REQUIRE_EQUAL(samples.size1(), Samples);
+	BOOST_REQUIRE_EQUAL(samples.size2(), Dimensions);
+	BOOST_REQUIRE_EQUAL(normalSamples.size1(), Samples);
+	BOOST_REQUIRE_EQUAL(normalSamples.size2(), Dimensions);
+	
+	//every sample is B D z
+	RealMatrix const& B = dist.eigenVectors();
+	RealVector const& lambda = dist.eigenValues();
+	for(std::size_t i = 0; i != 10; ++i){
+		RealVector y(Dimensions,0.0);
+		for(std::size_t j = 0; j != Dimensions; ++j){
+			for(std::size_t k = 0; k != Dimensions; ++k){
+				y(j) += B(j,k) * std::sqrt(lambda(k)) * normalSamples(i,k);
+			}
+		}
+		BOOST_CHECK_SMALL(norm_inf(y - row(samples,i)), 1.e-12);
+	}
+	
+	//check that means and covariances are correct
+	RealVector meanSampled = sum_rows(samples) / Samples;
+	RealMatrix covarianceSampled = prod(trans(samples),samples) / Samples;
+	RealVector normalMeanSampled = sum_rows(normalSamples) / Samples;
+	RealMatrix normalCovarianceSampled = prod(trans(normalSamples),normalSamples) / Samples;
+	BOOST_CHECK_SMALL(norm_2(meanSampled)/Dimensions,1.e-2);
+	BOOST_CHECK_SMALL(norm_2(normalMeanSampled)/Dimensions,1.e-2);
+	BOOST_CHECK_SMALL(norm_frobenius(covarianceSampled-covariance)/sqr(Dimensions),1.e-2);
+	BOOST_CHECK_SMALL(
+	norm_frobenius(
+		normalCovarianceSampled-blas::identity_matrix<double>(Dimensions)
+	)/sqr(Dimensions)
+	,1.e-2);
+}
+
 BOOST_AUTO_TEST_CASE( MULTIVARIATENORMAL_Cholesky) {
 	std::size_t Dimensions = 5;
 	std::size_t Samples = 10000;
@@ -460,4 +460,25 @@ BOOST_AUTO_TEST_CASE( Distribution_Uniform ) {
 		BOOST_CHECK_SMALL( uniform.p( x ) - boost::math::pdf( ud, x ), 1E-5 );
 }
 
+BOOST_AUTO_TEST_CASE( Rng_ThreadRng ) {
+	//every thread draws from its own stream, the streams are reproducible after seeding
+	const int iterations = 4;
+	std::vector<std::vector<double> > draws[2];
+	for(std::size_t trial = 0; trial != 2; ++trial){
+		shark::Rng::seed(42);
+		draws[trial].resize(iterations);
+		SHARK_PARALLEL_FOR(int i = 0; i < iterations; ++i){
+			shark::Uniform<shark::Rng::rng_type> uni(shark::Rng::threadRng());
+			for(std::size_t j = 0; j != 5; ++j)
+				draws[trial][i].push_back(uni());
+		}
+	}
+	for(int i = 0; i != iterations; ++i){
+		for(std::size_t j = 0; j != 5; ++j)
+			BOOST_CHECK_EQUAL(draws[0][i][j],draws[1][i][j]);
+		for(int k = 0; k != i; ++k)
+			BOOST_CHECK(draws[0][i][0] != draws[0][k][0]);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -219,6 +219,27 @@ namespace shark {
 			return m_lambda;
 		}
 
+		/**
+		 * \brief Returns the number of generations between two eigendecompositions of the covariance matrix.
+		 *
+		 * The covariance matrix is updated every generation, but the offspring are sampled using
+		 * its eigendecomposition, which costs \f$ \mathcal{O}(n^3) \f$ operations. As the matrix
+		 * changes only slowly, it suffices to decompose it every
+		 * \f$ 1/(10 n (c_1+c_\mu)) \approx n/(10 \lambda) \f$ generations, which is chosen when the
+		 * interval is 0 (the default). An interval of 1 decomposes the matrix in every generation.
+		 * Between two decompositions, eigenVectors() and eigenValues() refer to an older covariance matrix.
+		 */
+		unsigned int eigenUpdateInterval() const {
+			return m_eigenUpdateInterval;
+		}
+
+		/**
+		 * \brief Returns a mutable reference to the number of generations between two eigendecompositions.
+		 */
+		unsigned int& eigenUpdateInterval() {
+			return m_eigenUpdateInterval;
+		}
+
 		/**
 		 * \brief Returns eigenvectors of covariance matrix (not considering step size)
 		 */
@@ -271,6 +292,8 @@ namespace shark {
 		RealVector m_evolutionPathSigma;
 
 		unsigned m_counter; ///< counter for generations
+		unsigned int m_eigenUpdateInterval; ///< generations between two eigendecompositions, 0 chooses the interval automatically
+		unsigned m_lastEigenUpdate; ///< generation of the last eigendecomposition
 
 		MultiVariateNormalDistribution m_mutationDistribution;
 	};
@@ -79,7 +79,7 @@ namespace shark {
 		/**
 		* \brief Default c'tor.
 		*/
-		CMSA() : m_mu( 100 ), m_lambda( 200 ) {
+		CMSA() : m_mu( 100 ), m_lambda( 200 ), m_eigenUpdateInterval( 0 ), m_eigenUpdateCounter( 0 ) {
 			m_features |= REQUIRES_VALUE;
 		}
 
@@ -144,6 +144,24 @@ namespace shark {
 		unsigned int & lambda() {
 			return m_lambda;
 		}
+
+		/**
+		* \brief Accesses the number of generations between two eigendecompositions of the covariance matrix.
+		*
+		* Decomposing the matrix costs \f$ \mathcal{O}(n^3) \f$ operations. As it changes only
+		* slowly, it suffices to decompose it every \f$ c_C/(10 n) \f$ generations, which is chosen
+		* when the interval is 0 (the default). An interval of 1 decomposes the matrix in every generation.
+		*/
+		unsigned int eigenUpdateInterval() const {
+			return m_eigenUpdateInterval;
+		}
+
+		/**
+		* \brief Accesses the number of generations between two eigendecompositions, allows for l-value semantics.
+		*/
+		unsigned int & eigenUpdateInterval() {
+			return m_eigenUpdateInterval;
+		}
 	protected:
 		
 		unsigned int m_numberOfVariables; ///< Stores the dimensionality of the search space.
@@ -156,6 +174,9 @@ namespace shark {
 
 		RealVector m_mean; ///< The current cog of the population.
 
+		unsigned int m_eigenUpdateInterval; ///< Generations between two eigendecompositions, 0 chooses the interval automatically.
+		unsigned int m_eigenUpdateCounter; ///< Generations since the last eigendecomposition.
+
 		shark::MultiVariateNormalDistribution m_mutationDistribution; ///< Multi-variate normal mutation distribution.   
 	private:
 		/**
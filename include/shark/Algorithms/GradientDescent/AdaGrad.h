@@ -0,0 +1,155 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       AdaGrad
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_ML_OPTIMIZER_ADAGRAD_H
+#define SHARK_ML_OPTIMIZER_ADAGRAD_H
+
+#include <shark/Algorithms/AbstractSingleObjectiveOptimizer.h>
+
+namespace shark{
+
+///@brief AdaGrad: stochastic gradient descent with per-coordinate learning rates.
+///
+/// AdaGrad accumulates the elementwise squares of all gradients seen so far,
+/// \f$ G_{t+1} = G_t + g_t^2 \f$, and moves every coordinate by
+/// \f$ -\eta_t g_t/(\sqrt{G_{t+1}}+\epsilon) \f$. Coordinates with large or frequent gradients
+/// thus get small steps, while rarely active coordinates, e.g. weights of sparse features, keep large steps.
+///
+/// The optimizer is meant for noisy objective functions like an ErrorFunction which evaluates only
+/// a few batches of the dataset in every call (see ErrorFunction::setNumBatches).
+/// The learning rate decays as \f$ \eta_t = \eta/(1+\gamma t) \f$, where \f$ \gamma \f$ is the learning rate decay.
+class AdaGrad : public AbstractSingleObjectiveOptimizer<RealVector >
+{
+public:
+	AdaGrad() {
+		m_features |= REQUIRES_FIRST_DERIVATIVE;
+
+		m_learningRate = 0.1;
+		m_learningRateDecay = 0.0;
+		m_epsilon = 1.e-8;
+		m_iteration = 0;
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "AdaGrad"; }
+
+	void init(ObjectiveFunctionType & objectiveFunction, SearchPointType const& startingPoint) {
+		checkFeatures(objectiveFunction);
+		objectiveFunction.init();
+
+		m_squaredGradients.resize(startingPoint.size());
+		m_squaredGradients.clear();
+		m_iteration = 0;
+		m_best.point = startingPoint;
+		m_best.value = objectiveFunction.evalDerivative(m_best.point,m_derivative);
+	}
+	using AbstractSingleObjectiveOptimizer<RealVector >::init;
+
+	/// \brief Returns the initial learning rate \f$ \eta \f$.
+	double learningRate() const {
+		return m_learningRate;
+	}
+
+	/// \brief Sets the initial learning rate \f$ \eta \f$.
+	void setLearningRate(double learningRate) {
+		SHARK_CHECK(learningRate > 0, "[AdaGrad::setLearningRate] learning rate must be positive");
+		m_learningRate = learningRate;
+	}
+
+	/// \brief Returns the decay \f$ \gamma \f$ of the learning rate.
+	double learningRateDecay() const {
+		return m_learningRateDecay;
+	}
+
+	/// \brief Sets the decay \f$ \gamma \f$ of the learning rate, \f$ \eta_t = \eta/(1+\gamma t) \f$.
+	void setLearningRateDecay(double decay) {
+		SHARK_CHECK(decay >= 0, "[AdaGrad::setLearningRateDecay] decay must be non-negative");
+		m_learningRateDecay = decay;
+	}
+
+	/// \brief Returns the constant \f$ \epsilon \f$ that keeps the denominator away from 0.
+	double epsilon() const {
+		return m_epsilon;
+	}
+
+	/// \brief Sets the constant \f$ \epsilon \f$ that keeps the denominator away from 0.
+	void setEpsilon(double epsilon) {
+		SHARK_CHECK(epsilon > 0, "[AdaGrad::setEpsilon] epsilon must be positive");
+		m_epsilon = epsilon;
+	}
+
+	/// \brief Returns the learning rate used in the next step.
+	double currentLearningRate() const {
+		return m_learningRate/(1.0 + m_learningRateDecay * m_iteration);
+	}
+
+	/// \brief Accumulates the squared derivative and moves the point.
+	void step(ObjectiveFunctionType const& objectiveFunction) {
+		double learningRate = currentLearningRate();
+		noalias(m_squaredGradients) += sqr(m_derivative);
+		for(std::size_t i = 0; i != m_best.point.size(); ++i){
+			m_best.point(i) -= learningRate * m_derivative(i) / (std::sqrt(m_squaredGradients(i)) + m_epsilon);
+		}
+		++m_iteration;
+		m_best.value = objectiveFunction.evalDerivative(m_best.point,m_derivative);
+	}
+	virtual void read( InArchive & archive )
+	{
+		archive>>m_squaredGradients;
+		archive>>m_learningRate;
+		archive>>m_learningRateDecay;
+		archive>>m_epsilon;
+		archive>>m_iteration;
+	}
+
+	virtual void write( OutArchive & archive ) const
+	{
+		archive<<m_squaredGradients;
+		archive<<m_learningRate;
+		archive<<m_learningRateDecay;
+		archive<<m_epsilon;
+		archive<<m_iteration;
+	}
+
+private:
+	RealVector m_squaredGradients;
+	ObjectiveFunctionType::FirstOrderDerivative m_derivative;
+	double m_learningRate;
+	double m_learningRateDecay;
+	double m_epsilon;
+	std::size_t m_iteration;
+};
+
+}
+#endif
@@ -0,0 +1,198 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Adaptive moment estimation (Adam)
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_ML_OPTIMIZER_ADAM_H
+#define SHARK_ML_OPTIMIZER_ADAM_H
+
+#include <shark/Algorithms/AbstractSingleObjectiveOptimizer.h>
+
+namespace shark{
+
+///@brief Adaptive moment estimation (Adam) for noisy objective functions.
+///
+/// Adam keeps exponentially decaying averages of the gradient and of its elementwise square,
+/// \f[ m_{t+1} = \beta_1 m_t + (1-\beta_1) g_t \f]
+/// \f[ v_{t+1} = \beta_2 v_t + (1-\beta_2) g_t^2 \f]
+/// and moves every coordinate by \f$ -\eta_t \hat m_{t+1}/(\sqrt{\hat v_{t+1}}+\epsilon) \f$, where
+/// \f$ \hat m_{t+1}, \hat v_{t+1} \f$ are the averages corrected for their initialization with zero.
+/// Thus the step size of every coordinate is roughly \f$ \eta_t \f$, independent of the scale of the gradient.
+///
+/// The optimizer is meant for noisy objective functions like an ErrorFunction which evaluates only
+/// a few batches of the dataset in every call (see ErrorFunction::setNumBatches).
+/// The learning rate decays as \f$ \eta_t = \eta/(1+\gamma t) \f$, where \f$ \gamma \f$ is the learning rate decay.
+class Adam : public AbstractSingleObjectiveOptimizer<RealVector >
+{
+public:
+	Adam() {
+		m_features |= REQUIRES_FIRST_DERIVATIVE;
+
+		m_learningRate = 0.001;
+		m_learningRateDecay = 0.0;
+		m_beta1 = 0.9;
+		m_beta2 = 0.999;
+		m_epsilon = 1.e-8;
+		m_iteration = 0;
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "Adam"; }
+
+	void init(ObjectiveFunctionType & objectiveFunction, SearchPointType const& startingPoint) {
+		checkFeatures(objectiveFunction);
+		objectiveFunction.init();
+
+		m_firstMoment.resize(startingPoint.size());
+		m_firstMoment.clear();
+		m_secondMoment.resize(startingPoint.size());
+		m_secondMoment.clear();
+		m_iteration = 0;
+		m_best.point = startingPoint;
+		m_best.value = objectiveFunction.evalDerivative(m_best.point,m_derivative);
+	}
+	using AbstractSingleObjectiveOptimizer<RealVector >::init;
+
+	/// \brief Returns the initial learning rate \f$ \eta \f$.
+	double learningRate() const {
+		return m_learningRate;
+	}
+
+	/// \brief Sets the initial learning rate \f$ \eta \f$.
+	void setLearningRate(double learningRate) {
+		SHARK_CHECK(learningRate > 0, "[Adam::setLearningRate] learning rate must be positive");
+		m_learningRate = learningRate;
+	}
+
+	/// \brief Returns the decay \f$ \gamma \f$ of the learning rate.
+	double learningRateDecay() const {
+		return m_learningRateDecay;
+	}
+
+	/// \brief Sets the decay \f$ \gamma \f$ of the learning rate, \f$ \eta_t = \eta/(1+\gamma t) \f$.
+	void setLearningRateDecay(double decay) {
+		SHARK_CHECK(decay >= 0, "[Adam::setLearningRateDecay] decay must be non-negative");
+		m_learningRateDecay = decay;
+	}
+
+	/// \brief Returns the decay rate \f$ \beta_1 \f$ of the gradient average.
+	double beta1() const {
+		return m_beta1;
+	}
+
+	/// \brief Sets the decay rate \f$ \beta_1 \f$ of the gradient average.
+	void setBeta1(double beta1) {
+		SHARK_CHECK(beta1 >= 0 && beta1 < 1, "[Adam::setBeta1] beta1 must be in [0,1)");
+		m_beta1 = beta1;
+	}
+
+	/// \brief Returns the decay rate \f$ \beta_2 \f$ of the squared gradient average.
+	double beta2() const {
+		return m_beta2;
+	}
+
+	/// \brief Sets the decay rate \f$ \beta_2 \f$ of the squared gradient average.
+	void setBeta2(double beta2) {
+		SHARK_CHECK(beta2 >= 0 && beta2 < 1, "[Adam::setBeta2] beta2 must be in [0,1)");
+		m_beta2 = beta2;
+	}
+
+	/// \brief Returns the constant \f$ \epsilon \f$ that keeps the denominator away from 0.
+	double epsilon() const {
+		return m_epsilon;
+	}
+
+	/// \brief Sets the constant \f$ \epsilon \f$ that keeps the denominator away from 0.
+	void setEpsilon(double epsilon) {
+		SHARK_CHECK(epsilon > 0, "[Adam::setEpsilon] epsilon must be positive");
+		m_epsilon = epsilon;
+	}
+
+	/// \brief Returns the learning rate used in the next step.
+	double currentLearningRate() const {
+		return m_learningRate/(1.0 + m_learningRateDecay * m_iteration);
+	}
+
+	/// \brief Updates the moment estimates using the current derivative and moves the point.
+	void step(ObjectiveFunctionType const& objectiveFunction) {
+		++m_iteration;
+		noalias(m_firstMoment) = m_beta1 * m_firstMoment + (1 - m_beta1) * m_derivative;
+		noalias(m_secondMoment) = m_beta2 * m_secondMoment + (1 - m_beta2) * sqr(m_derivative);
+		//the bias correction of both moments is folded into the step size
+		double bias1 = 1 - std::pow(m_beta1, double(m_iteration));
+		double bias2 = 1 - std::pow(m_beta2, double(m_iteration));
+		double learningRate = m_learningRate/(1.0 + m_learningRateDecay * (m_iteration - 1));
+		double stepSize = learningRate * std::sqrt(bias2) / bias1;
+		double epsilon = m_epsilon * std::sqrt(bias2);
+		for(std::size_t i = 0; i != m_best.point.size(); ++i){
+			m_best.point(i) -= stepSize * m_firstMoment(i) / (std::sqrt(m_secondMoment(i)) + epsilon);
+		}
+		m_best.value = objectiveFunction.evalDerivative(m_best.point,m_derivative);
+	}
+	virtual void read( InArchive & archive )
+	{
+		archive>>m_firstMoment;
+		archive>>m_secondMoment;
+		archive>>m_learningRate;
+		archive>>m_learningRateDecay;
+		archive>>m_beta1;
+		archive>>m_beta2;
+		archive>>m_epsilon;
+		archive>>m_iteration;
+	}
+
+	virtual void write( OutArchive & archive ) const
+	{
+		archive<<m_firstMoment;
+		archive<<m_secondMoment;
+		archive<<m_learningRate;
+		archive<<m_learningRateDecay;
+		archive<<m_beta1;
+		archive<<m_beta2;
+		archive<<m_epsilon;
+		archive<<m_iteration;
+	}
+
+private:
+	RealVector m_firstMoment;
+	RealVector m_secondMoment;
+	ObjectiveFunctionType::FirstOrderDerivative m_derivative;
+	double m_learningRate;
+	double m_learningRateDecay;
+	double m_beta1;
+	double m_beta2;
+	double m_epsilon;
+	std::size_t m_iteration;
+};
+
+}
+#endif
@@ -0,0 +1,177 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Stochastic gradient descent with momentum
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_ML_OPTIMIZER_SGD_H
+#define SHARK_ML_OPTIMIZER_SGD_H
+
+#include <shark/Algorithms/AbstractSingleObjectiveOptimizer.h>
+
+namespace shark{
+
+///@brief Stochastic gradient descent with classical or Nesterov momentum.
+///
+/// The optimizer is meant for noisy objective functions like an ErrorFunction
+/// which evaluates only a few batches of the dataset in every call (see ErrorFunction::setNumBatches).
+/// In every step the search direction is updated as
+/// \f[ v_{t+1} = \mu v_t - \eta_t \nabla f(x_t) \f]
+/// and the point is moved by \f$ v_{t+1} \f$. With Nesterov momentum the point is moved by
+/// \f$ (1+\mu)v_{t+1} - \mu v_t \f$ instead, which is the usual reformulation of Nesterov's
+/// accelerated gradient that only needs the gradient at the current point.
+///
+/// The learning rate decays as \f$ \eta_t = \eta/(1+\gamma t) \f$, where \f$ \gamma \f$ is the learning rate decay.
+/// For \f$ \gamma = 0 \f$ (default) the learning rate is constant.
+/// The value of solution() is the value reported by the objective function at the current point,
+/// which for noisy objective functions is an estimate of the true function value.
+class SGD : public AbstractSingleObjectiveOptimizer<RealVector >
+{
+public:
+	SGD() {
+		m_features |= REQUIRES_FIRST_DERIVATIVE;
+
+		m_learningRate = 0.1;
+		m_learningRateDecay = 0.0;
+		m_momentum = 0.0;
+		m_nesterov = false;
+		m_iteration = 0;
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "SGD"; }
+
+	void init(ObjectiveFunctionType & objectiveFunction, SearchPointType const& startingPoint) {
+		checkFeatures(objectiveFunction);
+		objectiveFunction.init();
+
+		m_path.resize(startingPoint.size());
+		m_path.clear();
+		m_iteration = 0;
+		m_best.point = startingPoint;
+		m_best.value = objectiveFunction.evalDerivative(m_best.point,m_derivative);
+	}
+	using AbstractSingleObjectiveOptimizer<RealVector >::init;
+
+	/// \brief Returns the initial learning rate \f$ \eta \f$.
+	double learningRate() const {
+		return m_learningRate;
+	}
+
+	/// \brief Sets the initial learning rate \f$ \eta \f$.
+	void setLearningRate(double learningRate) {
+		SHARK_CHECK(learningRate > 0, "[SGD::setLearningRate] learning rate must be positive");
+		m_learningRate = learningRate;
+	}
+
+	/// \brief Returns the decay \f$ \gamma \f$ of the learning rate.
+	double learningRateDecay() const {
+		return m_learningRateDecay;
+	}
+
+	/// \brief Sets the decay \f$ \gamma \f$ of the learning rate, \f$ \eta_t = \eta/(1+\gamma t) \f$.
+	void setLearningRateDecay(double decay) {
+		SHARK_CHECK(decay >= 0, "[SGD::setLearningRateDecay] decay must be non-negative");
+		m_learningRateDecay = decay;
+	}
+
+	/// \brief Returns the momentum \f$ \mu \f$.
+	double momentum() const {
+		return m_momentum;
+	}
+
+	/// \brief Sets the momentum \f$ \mu \f$, 0 disables momentum.
+	void setMomentum(double momentum) {
+		SHARK_CHECK(momentum >= 0 && momentum < 1, "[SGD::setMomentum] momentum must be in [0,1)");
+		m_momentum = momentum;
+	}
+
+	/// \brief Returns true if Nesterov momentum is used.
+	bool nesterov() const {
+		return m_nesterov;
+	}
+
+	/// \brief Switches between classical and Nesterov momentum.
+	void setNesterov(bool nesterov) {
+		m_nesterov = nesterov;
+	}
+
+	/// \brief Returns the learning rate used in the next step.
+	double currentLearningRate() const {
+		return m_learningRate/(1.0 + m_learningRateDecay * m_iteration);
+	}
+
+	/// \brief Updates the search direction using the current derivative and moves the point.
+	void step(ObjectiveFunctionType const& objectiveFunction) {
+		double learningRate = currentLearningRate();
+		if(m_nesterov){
+			noalias(m_best.point) -= m_momentum * m_path;
+			noalias(m_path) = m_momentum * m_path - learningRate * m_derivative;
+			noalias(m_best.point) += (1 + m_momentum) * m_path;
+		}else{
+			noalias(m_path) = m_momentum * m_path - learningRate * m_derivative;
+			noalias(m_best.point) += m_path;
+		}
+		++m_iteration;
+		m_best.value = objectiveFunction.evalDerivative(m_best.point,m_derivative);
+	}
+	virtual void read( InArchive & archive )
+	{
+		archive>>m_path;
+		archive>>m_learningRate;
+		archive>>m_learningRateDecay;
+		archive>>m_momentum;
+		archive>>m_nesterov;
+		archive>>m_iteration;
+	}
+
+	virtual void write( OutArchive & archive ) const
+	{
+		archive<<m_path;
+		archive<<m_learningRate;
+		archive<<m_learningRateDecay;
+		archive<<m_momentum;
+		archive<<m_nesterov;
+		archive<<m_iteration;
+	}
+
+private:
+	RealVector m_path;
+	ObjectiveFunctionType::FirstOrderDerivative m_derivative;
+	double m_learningRate;
+	double m_learningRateDecay;
+	double m_momentum;
+	bool m_nesterov;
+	std::size_t m_iteration;
+};
+
+}
+#endif
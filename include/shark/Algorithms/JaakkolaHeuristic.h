@@ -38,10 +38,14 @@
 
 
 #include <shark/Data/Dataset.h>
-#include <shark/Core/Traits/ProxyReferenceTraits.h>
+#include <shark/Data/DataView.h>
+#include <shark/Core/OpenMP.h>
+#include <shark/LinAlg/Metrics.h>
+#include <shark/Rng/GlobalRng.h>
 
-#include <boost/range/adaptor/filtered.hpp>
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace shark{
 
@@ -62,6 +66,20 @@ namespace shark{
 /// label is considered. This behavior can be turned off by an option
 /// of the constructor. This is faster andin accordance with the
 /// original paper.
+///
+/// \par
+/// The distances are computed in parallel between blocks of points of
+/// different classes, so no pair of points with equal labels is visited.
+/// Still, the exact statistic needs quadratic time, and considering all
+/// pairs also quadratic memory. For large datasets the distribution can be
+/// estimated from a random sample instead: either a number of random pairs
+/// with different labels, or the nearest false neighbors of a number of
+/// random points. By the Dvoretzky-Kiefer-Wolfowitz inequality, the sample
+/// quantile of n samples is a true quantile in
+/// \f$ [q-\epsilon,q+\epsilon] \f$ with \f$ \epsilon = \sqrt{\ln(2/\delta)/(2n)} \f$
+/// with probability \f$ 1-\delta \f$, e.g. 10000 samples give
+/// \f$ \epsilon < 0.014 \f$ with 95% probability, independent of the size
+/// of the dataset.
 class JaakkolaHeuristic
 {
 public:
@@ -71,84 +89,24 @@ public:
 	template<class InputType>
 	JaakkolaHeuristic(LabeledData<InputType,unsigned int> const& dataset, bool nearestFalseNeighbor = true)
 	{
-		typedef typename LabeledData<InputType,unsigned int>::const_element_range Elements;
-		typedef typename ConstProxyReference<InputType const>::type Element;
-		Elements elements = dataset.elements();
-		if(!nearestFalseNeighbor) {
-			for(typename Elements::iterator it = elements.begin(); it != elements.end(); ++it){
-				Element x = it->input;
-				typename Elements::iterator itIn = it;
-				itIn++;
-				for (; itIn != elements.end(); itIn++) {
-					if (itIn->label == it->label) continue;
-					Element y = itIn->input;
-					double dist = distanceSqr(x,y);
-					m_stat.push_back(dist);
-				}
-			}
+		compute(dataset, nearestFalseNeighbor, std::numeric_limits<std::size_t>::max());
+	}
 
-		} else {
-			std::size_t classes = numberOfClasses(dataset);
-			std::size_t dim = inputDimension(dataset);
-			m_stat.resize(dataset.numberOfElements());
-			std::fill(m_stat.begin(),m_stat.end(), std::numeric_limits<double>::max());
-			std::size_t blockStart = 0;
-			for(std::size_t c = 0; c != classes; ++c){
-				
-				typename Elements::iterator leftIt = elements.begin();
-				typename Elements::iterator end = elements.end();
-				while(leftIt != end){
-					//todo: use a filter on the iterator
-					//create the next batch containing only elements of class c as left argument to distanceSqr
-					typename Batch<InputType>::type leftBatch(512, dim);
-					std::size_t leftElements = 0;
-					while(leftElements < 512 && leftIt != end){
-						if(leftIt->label == c){
-							row(leftBatch,leftElements) = leftIt->input;
-							++leftElements;
-						}
-						++leftIt;
-					}
-					//now go through all elements and again create batches, this time of all elements which are not of class c
-					typename Elements::iterator rightIt = elements.begin();
-					while(rightIt != end){
-						typename Batch<InputType>::type rightBatch(512, dim);
-						std::size_t rightElements = 0;
-						while(rightElements < 512 && rightIt != end){
-							if(rightIt->label != c){
-								row(rightBatch,rightElements) = rightIt->input;
-								++rightElements;
-							}
-							++rightIt;
-						}
-
-						//now compute distances and update shortest distance
-						RealMatrix distances = distanceSqr(leftBatch,rightBatch);
-						for(std::size_t i = 0; i != leftElements;++i){
-							m_stat[blockStart+i]=std::min(min(subrange(row(distances,i),0,rightElements)),m_stat[blockStart+i]);
-						}
-					}
-					blockStart+= leftElements;
-				}
-			}
-			
-			//~ for(typename Elements::iterator it = elements.begin(); it != elements.end(); ++it){
-				//~ double minDistSqr = std::numeric_limits<double>::max();//0;
-				//~ Element x = it->input;
-				//~ for (typename Elements::iterator itIn = elements.begin(); itIn != elements.end(); itIn++) {
-					//~ if (itIn->label == it->label) continue;
-					//~ Element y = itIn->input;
-					//~ double dist = distanceSqr(x,y);
-					//~ //if( (minDistSqr == 0) || (dist < minDistSqr))  minDistSqr = dist;
-					//~ if(dist < minDistSqr)  minDistSqr = dist;
-				//~ }
-				//~ m_stat.push_back(minDistSqr);
-			//~ }
-			
-		}
-		std::sort(m_stat.begin(), m_stat.end());
+	/// Constructor estimating the distribution from a random sample
+	///
+	/// If nearestFalseNeighbor is true, the nearest false neighbors of sampleSize randomly chosen
+	/// points are computed, which takes time linear in the size of the dataset. Otherwise
+	/// sampleSize random pairs with different labels are drawn. If the sample is not smaller than
+	/// the statistic of the dataset, the exact statistic is computed.
+	/// \param dataset           vector-valued input data
+	/// \param nearestFalseNeighbor  if true, only the nearest neighboring point with different label is considered
+	/// \param sampleSize        number of sampled points or pairs
+	template<class InputType>
+	JaakkolaHeuristic(LabeledData<InputType,unsigned int> const& dataset, bool nearestFalseNeighbor, std::size_t sampleSize)
+	{
+		compute(dataset, nearestFalseNeighbor, sampleSize);
 	}
-		
+
 	/// Compute the given quantile (usually median)
 	/// of the empirical distribution of Euclidean distances
 	/// of data pairs with different labels.
@@ -157,25 +115,25 @@ public:
 		std::size_t ic = m_stat.size();
 		SHARK_ASSERT(ic > 0);
 
-		std::sort(m_stat.begin(), m_stat.end());
-
-		if (quantile < 0.0)
+		if (quantile <= 0.0)
 		{
-			// TODO: find minimum
-			return std::sqrt(m_stat[0]);
+			return std::sqrt(*std::min_element(m_stat.begin(), m_stat.end()));
 		}
 		if (quantile >= 1.0)
 		{
-			// TODO: find maximum
-			return std::sqrt(m_stat[ic-1]);
+			return std::sqrt(*std::max_element(m_stat.begin(), m_stat.end()));
 		}
 		else
 		{
-			// TODO: partial sort!
+			// only the two neighbouring order statistics are needed, a selection suffices
 			double t = quantile * (ic - 1);
 			std::size_t i = (std::size_t)floor(t);
 			double rest = t - i;
-			return ((1.0 - rest) * std::sqrt(m_stat[i]) + rest * std::sqrt(m_stat[i+1]));
+			std::nth_element(m_stat.begin(), m_stat.begin() + i, m_stat.end());
+			double lower = std::sqrt(m_stat[i]);
+			if (rest == 0.0) return lower;
+			double upper = std::sqrt(*std::min_element(m_stat.begin() + i + 1, m_stat.end()));
+			return ((1.0 - rest) * lower + rest * upper);
 		}
 	}
 
@@ -191,7 +149,126 @@ public:
 
 
 private:
-	/// all pairwise distances
+	template<class InputType>
+	void compute(LabeledData<InputType,unsigned int> const& dataset, bool nearestFalseNeighbor, std::size_t sampleSize){
+		typedef Data<InputType> const InputContainer;
+		DataView<InputContainer> inputs(dataset.inputs());
+		std::size_t elements = inputs.size();
+
+		//sort the points by class
+		std::vector<unsigned int> labels;
+		labels.reserve(elements);
+		for(std::size_t b = 0; b != dataset.numberOfBatches(); ++b){
+			UIntVector const& batchLabels = dataset.batch(b).label;
+			labels.insert(labels.end(), batchLabels.begin(), batchLabels.end());
+		}
+		std::vector<std::size_t> sizes = classSizes(dataset);
+		std::vector<std::vector<std::size_t> > classIndices(sizes.size());
+		for(std::size_t i = 0; i != elements; ++i){
+			classIndices[labels[i]].push_back(i);
+		}
+		std::size_t pairs = 0;
+		for(std::size_t c = 0; c != sizes.size(); ++c){
+			pairs += sizes[c] * (elements - sizes[c]);
+		}
+		pairs /= 2;
+		SHARK_CHECK(pairs > 0, "[JaakkolaHeuristic] at least two classes are needed");
+
+		if(!nearestFalseNeighbor && sampleSize < pairs){
+			samplePairs(inputs, labels, sampleSize);
+			return;
+		}
+		//points for which the statistic is computed
+		std::vector<std::vector<std::size_t> > leftIndices = classIndices;
+		if(nearestFalseNeighbor && sampleSize < elements){
+			std::vector<std::size_t> sample(elements);
+			for(std::size_t i = 0; i != elements; ++i) sample[i] = i;
+			partial_shuffle(sample.begin(), sample.begin() + sampleSize, sample.end());
+			sample.resize(sampleSize);
+			std::sort(sample.begin(), sample.end());
+			for(std::size_t c = 0; c != leftIndices.size(); ++c) leftIndices[c].clear();
+			for(std::size_t i = 0; i != sampleSize; ++i){
+				leftIndices[labels[sample[i]]].push_back(sample[i]);
+			}
+		}
+
+		//the points of every class are split into blocks, the distances are computed blockwise
+		std::size_t const blockSize = 512;
+		typedef typename Batch<InputType>::type BatchType;
+		std::vector<std::vector<BatchType> > classBlocks(classIndices.size());
+		for(std::size_t c = 0; c != classIndices.size(); ++c){
+			for(std::size_t start = 0; start < classIndices[c].size(); start += blockSize){
+				std::size_t end = std::min(start + blockSize, classIndices[c].size());
+				classBlocks[c].push_back(createBatch<InputType>(subset(inputs, boost::make_iterator_range(
+					classIndices[c].begin() + start, classIndices[c].begin() + end
+				))));
+			}
+		}
+
+		//every task is a block of points of class c compared to the blocks of the other classes.
+		//When all pairs are considered, only classes larger than c are used, so that every pair is visited once.
+		//The points of all tasks are stored consecutively, taskBounds holds the ranges of the tasks.
+		std::vector<std::size_t> leftPoints;
+		std::vector<std::size_t> taskClass;
+		std::vector<std::size_t> taskBounds(1, 0);
+		for(std::size_t c = 0; c != leftIndices.size(); ++c){
+			for(std::size_t start = 0; start < leftIndices[c].size(); start += blockSize){
+				std::size_t end = std::min(start + blockSize, leftIndices[c].size());
+				leftPoints.insert(leftPoints.end(), leftIndices[c].begin() + start, leftIndices[c].begin() + end);
+				taskClass.push_back(c);
+				taskBounds.push_back(leftPoints.size());
+			}
+		}
+		std::size_t tasks = taskClass.size();
+		std::vector<std::vector<double> > taskStat(tasks);
+		parallelBlocks(taskBounds, [&](std::size_t t, std::size_t start, std::size_t end){
+			std::size_t c = taskClass[t];
+			BatchType left = createBatch<InputType>(subset(inputs, boost::make_iterator_range(
+				leftPoints.begin() + start, leftPoints.begin() + end
+			)));
+			std::size_t leftSize = end - start;
+			std::vector<double>& stat = taskStat[t];
+			if(nearestFalseNeighbor)
+				stat.resize(leftSize, std::numeric_limits<double>::max());
+			RealMatrix distances;
+			for(std::size_t c2 = nearestFalseNeighbor? 0: c + 1; c2 < classBlocks.size(); ++c2){
+				if(c2 == c) continue;
+				for(std::size_t b = 0; b != classBlocks[c2].size(); ++b){
+					distances = distanceSqr(left, classBlocks[c2][b]);
+					for(std::size_t i = 0; i != leftSize; ++i){
+						if(nearestFalseNeighbor)
+							stat[i] = std::min(min(row(distances,i)), stat[i]);
+						else
+							stat.insert(stat.end(), row(distances,i).begin(), row(distances,i).end());
+					}
+				}
+			}
+		});
+		m_stat.clear();
+		for(std::size_t t = 0; t != tasks; ++t){
+			m_stat.insert(m_stat.end(), taskStat[t].begin(), taskStat[t].end());
+		}
+	}
+
+	/// draws pairs of points with different labels uniformly and stores their squared distances
+	template<class InputContainer>
+	void samplePairs(DataView<InputContainer> const& inputs, std::vector<unsigned int> const& labels, std::size_t sampleSize){
+		//the random pairs are drawn sequentially, the distances computed in parallel
+		std::vector<std::size_t> first(sampleSize);
+		std::vector<std::size_t> second(sampleSize);
+		for(std::size_t s = 0; s != sampleSize; ++s){
+			do{
+				first[s] = Rng::discrete(0, labels.size() - 1);
+				second[s] = Rng::discrete(0, labels.size() - 1);
+			}while(labels[first[s]] == labels[second[s]]);
+		}
+		m_stat.resize(sampleSize);
+		SHARK_PARALLEL_FOR(int s = 0; s < (int)sampleSize; ++s){
+			m_stat[s] = distanceSqr(inputs[first[s]], inputs[second[s]]);
+		}
+	}
+
+	/// squared distances of the considered pairs, in no particular order
 	std::vector<double> m_stat;
 };
 
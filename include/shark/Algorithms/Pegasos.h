@@ -39,17 +39,41 @@
 
 #include <shark/LinAlg/Base.h>
 #include <shark/Data/Dataset.h>
+#include <shark/Data/DataView.h>
 #include <shark/Rng/GlobalRng.h>
+#include <shark/Rng/DiscreteUniform.h>
+#include <shark/Core/OpenMP.h>
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 
 namespace shark {
 
 
+namespace detail{
+// minimal minibatch size for computing the predictions in parallel
+static const std::size_t PegasosParallelBatchsize = 64;
+}
+
+
 ///
 /// \brief Pegasos solver for linear (binary) support vector machines.
 ///
+/// \par
+/// The examples are visited in the order of a random permutation,
+/// which is redrawn once per epoch (sampling without replacement).
+/// The predictions of large minibatches as well as the full gradient
+/// for checking the stopping criterion are computed in parallel.
+///
+/// \par
+/// Optionally, the solver returns the average of the iterates
+/// instead of the final iterate (averaged SGD, see Polyak and
+/// Juditsky, 1992). Averaging starts after the first epoch. The
+/// average is maintained in time proportional to the number of
+/// non-zero entries of the gradient, thus it is cheap also for
+/// sparse data.
+///
 template <class VectorType>
 class Pegasos
 {
@@ -67,7 +91,8 @@ public:
 			double C,                                           ///< SVM regularization parameter
 			WeightType& w,                                      ///< weight vector
 			std::size_t batchsize = 1,                          ///< number of samples in each gradient estimate
-			double varepsilon = 0.001)                          ///< solution accuracy (factor by which the primal gradient should be reduced)
+			double varepsilon = 0.001,                          ///< solution accuracy (factor by which the primal gradient should be reduced)
+			bool averaging = false)                             ///< return the average of the iterates instead of the last iterate?
 	{
 		std::size_t ell = data.numberOfElements();
 		double lambda = 1.0 / (ell * C);
@@ -78,12 +103,28 @@ public:
 		double norm_w2 = 0.0;                           // squared norm of w
 		double sigma = 1.0;                             // scaling factor for w
 		VectorType gradient(w.size());                  // gradient (to be computed in each iteration)
-		w = RealZeroVector(w.size());                   // clear does not work on matrix rows (ublas sucks!)
+		std::vector<VectorType> partial(SHARK_NUM_THREADS, VectorType(w.size()));   // thread-wise parts of the gradient
+		w = RealVector(w.size(), 0.0);                  // clear does not work on matrix rows (ublas sucks!)
+
+		// random access to the examples in the order of a permutation
+		DataView<LabeledData<VectorType, unsigned int> const> view(data);
+		std::vector<std::size_t> permutation(ell);
+		for (std::size_t i=0; i<ell; i++) permutation[i] = i;
+		std::size_t position = ell;
+		DiscreteUniform<Rng::rng_type> uni(Rng::globalRng);
+		std::vector<std::size_t> active(batchsize);     // examples in the current minibatch
+		RealVector f(batchsize);                        // predictions on the minibatch
+
+		// averaging of the iterates sigma_t * w_t, represented as (S * w - B) / count
+		double S = 0.0;                                 // sum of the scaling factors
+		RealVector B(averaging ? w.size() : 0, 0.0);    // correction term
+		std::size_t count = 0;                          // number of averaged iterates
 
 		// pegasos main loop
 		std::size_t start = 10;
 		std::size_t checkinterval = (2 * ell) / batchsize;
 		std::size_t nextcheck = start + ell / batchsize;
+		std::size_t averagingstart = nextcheck;
 		std::size_t predictions = 0;
 		for (std::size_t t=start; ; t++)
 		{
@@ -92,13 +133,18 @@ public:
 			{
 				// compute the gradient
 				gradient = (lambda * sigma * (double)ell) * w;
-				for (std::size_t i=0; i<ell; i++)
+				for (std::size_t i=0; i<partial.size(); i++) partial[i].clear();
+				SHARK_PARALLEL_FOR(int b=0; b<(int)data.numberOfBatches(); b++)
 				{
-					VectorType const& x = data(i).input;
-					unsigned int y = data(i).label;
-					double f = sigma * inner_prod(w, x);
-					lg(x, y, f, gradient);
+					VectorType& g = partial[SHARK_THREAD_NUM];
+					typename LabeledData<VectorType, unsigned int>::const_batch_reference batch = data.batch(b);
+					for (std::size_t i=0; i<boost::size(batch); i++)
+					{
+						double f_i = sigma * inner_prod(w, get(batch, i).input);
+						lg(get(batch, i).input, get(batch, i).label, f_i, g);
+					}
 				}
+				for (std::size_t i=0; i<partial.size(); i++) gradient += partial[i];
 				predictions += ell;
 
 				// compute the norm of the gradient
@@ -117,23 +163,38 @@ public:
 				nextcheck = t + checkinterval;
 			}
 
-			// compute the gradient
-			gradient.clear();
-			bool nonzero = true;
-			for (unsigned int i=0; i<batchsize; i++)
+			// select the minibatch, the permutation is redrawn once per epoch
+			for (std::size_t i=0; i<batchsize; i++)
 			{
-				// select the active variable (sample with replacement)
-				std::size_t active = Rng::discrete(0, ell-1);
-				VectorType const& x = data(active).input;
-				unsigned int y = data(active).label;
-				SHARK_ASSERT(y < 2);
+				if (position == ell)
+				{
+					shark::shuffle(permutation.begin(), permutation.end(), uni);
+					position = 0;
+				}
+				active[i] = permutation[position];
+				position++;
+			}
 
-				// compute the prediction
-				double f = sigma * inner_prod(w, x);
-				predictions++;
+			// compute the predictions, in parallel for large minibatches
+			if (batchsize >= detail::PegasosParallelBatchsize)
+			{
+				SHARK_PARALLEL_FOR(int i=0; i<(int)batchsize; i++)
+					f(i) = sigma * inner_prod(w, view[active[i]].input);
+			}
+			else
+			{
+				for (std::size_t i=0; i<batchsize; i++)
+					f(i) = sigma * inner_prod(w, view[active[i]].input);
+			}
+			predictions += batchsize;
 
-				// compute the loss gradient
-				lg(x, y, f, gradient);
+			// compute the gradient
+			gradient.clear();
+			bool nonzero = false;
+			for (std::size_t i=0; i<batchsize; i++)
+			{
+				SHARK_ASSERT(view[active[i]].label < 2);
+				if (lg(view[active[i]].input, view[active[i]].label, f(i), gradient)) nonzero = true;
 			}
 
 			// update
@@ -144,22 +205,30 @@ public:
 				gradient *= eta;
 				norm_w2 += inner_prod(gradient, gradient) - 2.0 * inner_prod(w, gradient);
 				noalias(w) -= gradient;
+				if (averaging) noalias(B) -= S * gradient;
 
 				// project to the ball
 				double n2 = sigma * sigma * norm_w2;
 				if (n2 > normbound2) sigma *= std::sqrt(normbound2 / n2);
 			}
+			if (averaging && t >= averagingstart)
+			{
+				S += sigma;
+				count++;
+			}
 		}
 
 		// rescale the solution
-		w *= sigma;
+		if (averaging && count > 0) w = (S * w - B) / (double)count;
+		else w *= sigma;
 		return predictions;
 	}
 
 protected:
 	// gradient of the loss
+	template <class InputType>
 	static bool lg(
-			VectorType const& x,
+			InputType const& x,
 			unsigned int y,
 			double f,
 			VectorType& gradient)
@@ -188,6 +257,10 @@ protected:
 ///
 /// \brief Pegasos solver for linear multi-class support vector machines.
 ///
+/// \par
+/// Sampling, parallelization and averaging work as for the binary
+/// Pegasos solver.
+///
 template <class VectorType>
 class McPegasos
 {
@@ -225,7 +298,8 @@ public:
 			double C,                                           ///< SVM regularization parameter
 			std::vector<WeightType>& w,                         ///< class-wise weight vectors
 			std::size_t batchsize = 1,                          ///< number of samples in each gradient estimate
-			double varepsilon = 0.001)                          ///< solution accuracy (factor by which the primal gradient should be reduced)
+			double varepsilon = 0.001,                          ///< solution accuracy (factor by which the primal gradient should be reduced)
+			bool averaging = false)                             ///< return the average of the iterates instead of the last iterate?
 	{
 		SHARK_ASSERT(batchsize > 0);
 		std::size_t ell = data.numberOfElements();
@@ -290,17 +364,33 @@ public:
 		double sigma = 1.0;                             // scaling factor for w
 		double target = initialPrimal * varepsilon;     // target gradient norm
 		std::vector<VectorType> gradient(classes);      // gradient (to be computed in each iteration)
-		RealVector f(classes);                          // machine prediction (computed for each example)
+		std::vector<RealVector> f(batchsize, RealVector(classes));   // machine predictions on the minibatch
+		std::vector<RealVector> B(classes);             // correction terms for averaging
 		for (unsigned int c=0; c<classes; c++)
 		{
 			gradient[c].resize(w[c].size());
-			w[c] = RealZeroVector(w[c].size());
+			w[c] = RealVector(w[c].size(), 0.0);
+			if (averaging) B[c] = RealVector(w[c].size(), 0.0);
 		}
+		std::vector<std::vector<VectorType> > partial(SHARK_NUM_THREADS, gradient);   // thread-wise parts of the gradient
+
+		// random access to the examples in the order of a permutation
+		DataView<LabeledData<VectorType, unsigned int> const> view(data);
+		std::vector<std::size_t> permutation(ell);
+		for (std::size_t i=0; i<ell; i++) permutation[i] = i;
+		std::size_t position = ell;
+		DiscreteUniform<Rng::rng_type> uni(Rng::globalRng);
+		std::vector<std::size_t> active(batchsize);     // examples in the current minibatch
+
+		// averaging of the iterates sigma_t * w_t, represented as (S * w - B) / count
+		double S = 0.0;                                 // sum of the scaling factors
+		std::size_t count = 0;                          // number of averaged iterates
 
 		// pegasos main loop
 		std::size_t start = 10;
 		std::size_t checkinterval = (2 * ell) / batchsize;
 		std::size_t nextcheck = start + ell / batchsize;
+		std::size_t averagingstart = nextcheck;
 		std::size_t predictions = 0;
 		for (std::size_t t=start; ; t++)
 		{
@@ -309,13 +399,22 @@ public:
 			{
 				// compute the gradient
 				for (unsigned int c=0; c<classes; c++) gradient[c] = (lambda * sigma * (double)ell) * w[c];
-				for (std::size_t i=0; i<ell; i++)
+				for (std::size_t i=0; i<partial.size(); i++)
+					for (unsigned int c=0; c<classes; c++) partial[i][c].clear();
+				SHARK_PARALLEL_FOR(int b=0; b<(int)data.numberOfBatches(); b++)
 				{
-					VectorType const& x = data(i).input;
-					unsigned int y = data(i).label;
-					for (unsigned int c=0; c<classes; c++) f(c) = sigma * inner_prod(w[c], x);
-					lg(x, y, f, gradient, sumToZero);
+					std::vector<VectorType>& g = partial[SHARK_THREAD_NUM];
+					RealVector f_i(classes);
+					typename LabeledData<VectorType, unsigned int>::const_batch_reference batch = data.batch(b);
+					for (std::size_t i=0; i<boost::size(batch); i++)
+					{
+						VectorType x = get(batch, i).input;
+						for (unsigned int c=0; c<classes; c++) f_i(c) = sigma * inner_prod(w[c], x);
+						lg(x, get(batch, i).label, f_i, g, sumToZero);
+					}
 				}
+				for (std::size_t i=0; i<partial.size(); i++)
+					for (unsigned int c=0; c<classes; c++) gradient[c] += partial[i][c];
 				predictions += ell;
 
 				// compute the norm of the gradient
@@ -335,23 +434,40 @@ public:
 				nextcheck = t + checkinterval;
 			}
 
-			// compute the gradient
-			for (unsigned int c=0; c<classes; c++) gradient[c].clear();
-			bool nonzero = true;
-			for (unsigned int i=0; i<batchsize; i++)
+			// select the minibatch, the permutation is redrawn once per epoch
+			for (std::size_t i=0; i<batchsize; i++)
 			{
-				// select the active variable (sample with replacement)
-				std::size_t active = Rng::discrete(0, ell-1);
-				VectorType const& x = data(active).input;
-				unsigned int y = data(active).label;
-				SHARK_ASSERT(y < classes);
+				if (position == ell)
+				{
+					shark::shuffle(permutation.begin(), permutation.end(), uni);
+					position = 0;
+				}
+				active[i] = permutation[position];
+				position++;
+			}
 
-				// compute the prediction
-				for (unsigned int c=0; c<classes; c++) f(c) = sigma * inner_prod(w[c], x);
-				predictions++;
+			// compute the predictions, in parallel for large minibatches
+			if (batchsize >= detail::PegasosParallelBatchsize)
+			{
+				SHARK_PARALLEL_FOR(int i=0; i<(int)batchsize; i++)
+					for (unsigned int c=0; c<classes; c++) f[i](c) = sigma * inner_prod(w[c], view[active[i]].input);
+			}
+			else
+			{
+				for (std::size_t i=0; i<batchsize; i++)
+					for (unsigned int c=0; c<classes; c++) f[i](c) = sigma * inner_prod(w[c], view[active[i]].input);
+			}
+			predictions += batchsize;
 
-				// compute the loss gradient
-				lg(x, y, f, gradient, sumToZero);
+			// compute the loss gradient
+			for (unsigned int c=0; c<classes; c++) gradient[c].clear();
+			bool nonzero = false;
+			for (std::size_t i=0; i<batchsize; i++)
+			{
+				unsigned int y = view[active[i]].label;
+				SHARK_ASSERT(y < classes);
+				VectorType x = view[active[i]].input;
+				if (lg(x, y, f[i], gradient, sumToZero)) nonzero = true;
 			}
 
 			// update
@@ -364,16 +480,26 @@ public:
 					gradient[c] *= eta;
 					norm_w2 += inner_prod(gradient[c], gradient[c]) - 2.0 * inner_prod(w[c], gradient[c]);
 					noalias(w[c]) -= gradient[c];
+					if (averaging) noalias(B[c]) -= S * gradient[c];
 				}
 
 				// project to the ball
 				double n2 = sigma * sigma * norm_w2;
 				if (n2 > normbound2) sigma *= std::sqrt(normbound2 / n2);
 			}
+			if (averaging && t >= averagingstart)
+			{
+				S += sigma;
+				count++;
+			}
 		}
 
 		// rescale the solution
-		for (unsigned int c=0; c<classes; c++) w[c] *= sigma;
+		for (unsigned int c=0; c<classes; c++)
+		{
+			if (averaging && count > 0) w[c] = (S * w[c] - B[c]) / (double)count;
+			else w[c] *= sigma;
+		}
 		return predictions;
 	}
 
@@ -38,12 +38,15 @@
 #define SHARK_ALGORITHMS_QP_QPBOXLINEAR_H
 
 #include <shark/Core/Timer.h>
+#include <shark/Core/OpenMP.h>
 #include <shark/Algorithms/QP/QuadraticProgram.h>
 #include <shark/Data/Dataset.h>
 #include <shark/Data/DataView.h>
 #include <shark/LinAlg/Base.h>
 #include <cmath>
 #include <iostream>
+#include <numeric>
+#include <vector>
 
 
 namespace shark {
@@ -54,6 +57,36 @@ namespace shark {
 #define PREF_MIN 0.05
 #define PREF_MAX 20.0
 
+namespace detail{
+/// \brief Fill the part [begin, end) of the schedule with a random
+/// sequence of the examples in [begin, end), drawn according to their
+/// preferences. The normalization constant is updated on the fly.
+inline void defineSchedule(RealVector const& pref, double& prefsum, std::size_t begin, std::size_t end, std::vector<std::size_t>& schedule)
+{
+	std::size_t size = end - begin;
+	double psum = prefsum;
+	prefsum = 0.0;
+	std::size_t pos = 0;
+	for (std::size_t i=begin; i<end; i++)
+	{
+		double p = pref[i];
+		double num = (psum < 1e-6) ? size - pos : std::min((double)(size - pos), (size - pos) * p / psum);
+		std::size_t n = (std::size_t)std::floor(num);
+		double prob = num - n;
+		if (Rng::uni() < prob) n++;
+		for (std::size_t j=0; j<n; j++)
+		{
+			schedule[begin + pos] = i;
+			pos++;
+		}
+		psum -= p;
+		prefsum += p;
+	}
+	SHARK_ASSERT(pos == size);
+	for (std::size_t i=begin; i<end; i++) std::swap(schedule[i], schedule[Rng::discrete(begin, end - 1)]);
+}
+}
+
 
 ///
 /// \brief Quadratic program solver for box-constrained problems with linear kernel
@@ -69,6 +102,20 @@ namespace shark {
 /// working set selection. At the same time, this method replaces
 /// the shrinking heuristic.
 ///
+/// \par
+/// In parallel mode (see setParallel) the examples are split into
+/// contiguous blocks, one per OpenMP thread. The threads perform
+/// coordinate descent steps on their blocks in the style of
+/// "Hogwild!" (Niu et al., NIPS 2011), i.e., they update the shared
+/// weight vector without locking. Each block keeps its own variable
+/// preferences. The threads are synchronized after each epoch, where
+/// the weight vector is recomputed from the dual variables, so that
+/// updates lost in concurrent writes do not accumulate, before the
+/// stopping criterion is checked. The result is not deterministic in
+/// parallel mode. Concurrent writes are rare only if the inputs are
+/// sparse, with dense inputs all threads write to every coordinate of
+/// the weight vector in every step and parallel mode does not help.
+///
 template <class InputT>
 class QpBoxLinear
 {
@@ -86,6 +133,7 @@ public:
 	: m_data(dataset)
 	, m_xSquared(m_data.size())
 	, m_dim(dim)
+	, m_parallel(false)
 	{
 		SHARK_ASSERT(dim > 0);
 
@@ -97,6 +145,20 @@ public:
 		}
 	}
 
+	/// \brief Is the parallel (asynchronous) mode of the solver used?
+	bool parallel() const
+	{ return m_parallel; }
+
+	/// \brief Turn the parallel (asynchronous) mode of the solver on or off.
+	void setParallel(bool parallel)
+	{ m_parallel = parallel; }
+
+	/// \brief Dual variables of the solution found by the last call of solve.
+	///
+	/// The weight vector returned by solve is the sum of alpha_i y_i x_i.
+	RealVector const& alpha() const
+	{ return m_alpha; }
+
 	///
 	/// \brief Solve the SVM training problem.
 	///
@@ -120,108 +182,105 @@ public:
 
 		// prepare dimensions and vectors
 		std::size_t ell = m_data.size();
-		RealVector alpha(ell, 0.0);
+		RealVector& alpha = m_alpha;
+		alpha = RealVector(ell, 0.0);
 		RealVector w(m_dim, 0.0);
 		RealVector pref(ell, 1.0);          // measure of success of individual steps
-		double prefsum = ell;               // normalization constant
 		std::vector<std::size_t> schedule(ell);
 
+		// partition the examples into contiguous blocks, one per thread
+		std::size_t blocks = m_parallel ? std::max<std::size_t>(1, std::min<std::size_t>(SHARK_NUM_THREADS, ell)) : 1;
+		std::vector<std::size_t> start(blocks + 1);
+		for (std::size_t b=0; b<=blocks; b++) start[b] = b * ell / blocks;
+		std::vector<RealVector> blockWeights(blocks > 1 ? blocks : 0, RealVector(m_dim));
+
 		// prepare counters
 		std::size_t epoch = 0;
-		std::size_t steps = 0;
+		std::vector<std::size_t> steps(blocks, 0);
 
-		// prepare performance monitoring for self-adaptation
+		// prepare performance monitoring for self-adaptation, block-wise
 		double max_violation = 0.0;
-		const double gain_learning_rate = 1.0 / ell;
-		double average_gain = 0.0;
+		RealVector violation(blocks, 0.0);
+		RealVector prefsum(blocks);         // normalization constants
+		RealVector average_gain(blocks, 0.0);
+		for (std::size_t b=0; b<blocks; b++) prefsum(b) = start[b + 1] - start[b];
 		bool canstop = true;
 
 		// outer optimization loop
 		while (true)
 		{
 			// define schedule
-			double psum = prefsum;
-			prefsum = 0.0;
-			std::size_t pos = 0;
-			for (std::size_t i=0; i<ell; i++)
-			{
-				double p = pref[i];
-				double num = (psum < 1e-6) ? ell - pos : std::min((double)(ell - pos), (ell - pos) * p / psum);
-				std::size_t n = (std::size_t)std::floor(num);
-				double prob = num - n;
-				if (Rng::uni() < prob) n++;
-				for (std::size_t j=0; j<n; j++)
-				{
-					schedule[pos] = i;
-					pos++;
-				}
-				psum -= p;
-				prefsum += p;
-			}
-			SHARK_ASSERT(pos == ell);
-			for (std::size_t i=0; i<ell; i++) std::swap(schedule[i], schedule[Rng::discrete(0, ell - 1)]);
+			for (std::size_t b=0; b<blocks; b++) detail::defineSchedule(pref, prefsum(b), start[b], start[b + 1], schedule);
 
-			// inner loop
-			max_violation = 0.0;
-			for (std::size_t j=0; j<ell; j++)
+			// inner loop, the blocks are processed asynchronously
+			SHARK_PARALLEL_FOR(int b=0; b<(int)blocks; b++)
 			{
-				// active variable
-				std::size_t i = schedule[j];
-				ElementType e_i = m_data[i];
-				double y_i = (e_i.label > 0) ? +1.0 : -1.0;
-
-				// compute gradient and projected gradient
-				double a = alpha(i);
-				double wyx = y_i * inner_prod(w, e_i.input);
-				double g = 1.0 - wyx;
-				double pg = (a == 0.0 && g < 0.0) ? 0.0 : (a == C && g > 0.0 ? 0.0 : g);
-
-				// update maximal KKT violation over the epoch
-				max_violation = std::max(max_violation, std::abs(pg));
-				double gain = 0.0;
-
-				// perform the step
-				if (pg != 0.0)
+				const std::size_t size = start[b + 1] - start[b];
+				const double gain_learning_rate = 1.0 / size;
+				violation(b) = 0.0;
+				for (std::size_t j=start[b]; j<start[b + 1]; j++)
 				{
-					// SMO-style coordinate descent step
-					double q = m_xSquared(i);
-					double mu = g / q;
-					double new_a = a + mu;
-
-					// numerically stable update
-					if (new_a <= 0.0)
+					// active variable
+					std::size_t i = schedule[j];
+					ElementType e_i = m_data[i];
+					double y_i = (e_i.label > 0) ? +1.0 : -1.0;
+
+					// compute gradient and projected gradient
+					double a = alpha(i);
+					double wyx = y_i * inner_prod(w, e_i.input);
+					double g = 1.0 - wyx;
+					double pg = (a == 0.0 && g < 0.0) ? 0.0 : (a == C && g > 0.0 ? 0.0 : g);
+
+					// update maximal KKT violation over the epoch
+					violation(b) = std::max(violation(b), std::abs(pg));
+					double gain = 0.0;
+
+					// perform the step
+					if (pg != 0.0)
 					{
-						mu = -a;
-						new_a = 0.0;
+						// SMO-style coordinate descent step
+						double q = m_xSquared(i);
+						double mu = g / q;
+						double new_a = a + mu;
+
+						// numerically stable update
+						if (new_a <= 0.0)
+						{
+							mu = -a;
+							new_a = 0.0;
+						}
+						else if (new_a >= C)
+						{
+							mu = C - a;
+							new_a = C;
+						}
+
+						// update both representations of the weight vector: alpha and w
+						alpha(i) = new_a;
+						w += (mu * y_i) * e_i.input;
+						gain = mu * (g - 0.5 * q * mu);
+
+						steps[b]++;
 					}
-					else if (new_a >= C)
-					{
-						mu = C - a;
-						new_a = C;
-					}
-
-					// update both representations of the weight vector: alpha and w
-					alpha(i) = new_a;
-					w += (mu * y_i) * e_i.input;
-					gain = mu * (g - 0.5 * q * mu);
-
-					steps++;
-				}
 
-				// update gain-based preferences
-				{
-					if (epoch == 0) average_gain += gain / (double)ell;
-					else
+					// update gain-based preferences
 					{
-						double change = CHANGE_RATE * (gain / average_gain - 1.0);
-						double newpref = std::min(PREF_MAX, std::max(PREF_MIN, pref(i) * std::exp(change)));
-						prefsum += newpref - pref(i);
-						pref[i] = newpref;
-						average_gain = (1.0 - gain_learning_rate) * average_gain + gain_learning_rate * gain;
+						if (epoch == 0) average_gain(b) += gain / (double)size;
+						else
+						{
+							double change = CHANGE_RATE * (gain / average_gain(b) - 1.0);
+							double newpref = std::min(PREF_MAX, std::max(PREF_MIN, pref(i) * std::exp(change)));
+							prefsum(b) += newpref - pref(i);
+							pref[i] = newpref;
+							average_gain(b) = (1.0 - gain_learning_rate) * average_gain(b) + gain_learning_rate * gain;
+						}
 					}
 				}
 			}
 
+			// synchronize the blocks for the stopping criterion
+			if (blocks > 1) rebuildWeightVector(alpha, start, blockWeights, w);
+			max_violation = max(violation);
 			epoch++;
 
 			// stopping criteria
@@ -250,7 +309,7 @@ public:
 					// prepare full sweep for a reliable checking of the stopping criterion
 					canstop = true;
 					for (std::size_t i=0; i<ell; i++) pref[i] = 1.0;
-					prefsum = ell;
+					for (std::size_t b=0; b<blocks; b++) prefsum(b) = start[b + 1] - start[b];
 				}
 			}
 			else
@@ -293,7 +352,7 @@ public:
 			std::cout << "training time (seconds): " << timer.lastLap() << std::endl;
 			std::cout << "number of epochs: " << epoch << std::endl;
 			std::cout << "number of iterations: " << (ell * epoch) << std::endl;
-			std::cout << "number of non-zero steps: " << steps << std::endl;
+			std::cout << "number of non-zero steps: " << std::accumulate(steps.begin(), steps.end(), (std::size_t)0) << std::endl;
 			std::cout << "dual accuracy: " << max_violation << std::endl;
 			std::cout << "dual objective value: " << objective << std::endl;
 			std::cout << "number of free support vectors: " << free_SV << std::endl;
@@ -305,9 +364,33 @@ public:
 	}
 
 protected:
+	/// \brief Recompute the weight vector from the dual variables.
+	///
+	/// Every block sums its own part, the parts are added in a fixed order.
+	void rebuildWeightVector(RealVector const& alpha, std::vector<std::size_t> const& start, std::vector<RealVector>& blockWeights, RealVector& w)
+	{
+		std::size_t blocks = blockWeights.size();
+		SHARK_PARALLEL_FOR(int b=0; b<(int)blocks; b++)
+		{
+			RealVector& w_b = blockWeights[b];
+			w_b.clear();
+			for (std::size_t i=start[b]; i<start[b + 1]; i++)
+			{
+				if (alpha(i) == 0.0) continue;
+				ElementType e_i = m_data[i];
+				double y_i = (e_i.label > 0) ? +1.0 : -1.0;
+				noalias(w_b) += (alpha(i) * y_i) * e_i.input;
+			}
+		}
+		w.clear();
+		for (std::size_t b=0; b<blocks; b++) noalias(w) += blockWeights[b];
+	}
+
 	DataView<const DatasetType> m_data;               ///< view on training data
 	RealVector m_xSquared;                            ///< diagonal entries of the quadratic matrix
+	RealVector m_alpha;                               ///< dual variables of the last solution
 	std::size_t m_dim;                                ///< input space dimension
+	bool m_parallel;                                  ///< asynchronous parallel coordinate descent?
 };
 
 
@@ -328,6 +411,7 @@ public:
 	, y(dataset.numberOfElements())
 	, diagonal(dataset.numberOfElements())
 	, m_dim(dim)
+	, m_parallel(false)
 	{
 		SHARK_ASSERT(dim > 0);
 
@@ -372,6 +456,21 @@ public:
 		}
 	}
 
+	/// \brief Is the parallel (asynchronous) mode of the solver used?
+	bool parallel() const
+	{ return m_parallel; }
+
+	/// \brief Turn the parallel (asynchronous) mode of the solver on or off.
+	void setParallel(bool parallel)
+	{ m_parallel = parallel; }
+
+	/// \brief Dual variables of the solution found by the last call of solve.
+	///
+	/// The weight vector returned by solve is the sum of alpha_i y_i x_i,
+	/// where the examples without non-zero entries are skipped.
+	RealVector const& alpha() const
+	{ return m_alpha; }
+
 	///
 	/// \brief Solve the SVM training problem.
 	///
@@ -395,108 +494,105 @@ public:
 
 		// prepare dimensions and vectors
 		std::size_t ell = x.size();
-		RealVector alpha(ell, 0.0);
+		RealVector& alpha = m_alpha;
+		alpha = RealVector(ell, 0.0);
 		RealVector w(m_dim, 0.0);
 		RealVector pref(ell, 1.0);          // measure of success of individual steps
-		double prefsum = ell;               // normalization constant
 		std::vector<std::size_t> schedule(ell);
 
+		// partition the examples into contiguous blocks, one per thread
+		std::size_t blocks = m_parallel ? std::max<std::size_t>(1, std::min<std::size_t>(SHARK_NUM_THREADS, ell)) : 1;
+		std::vector<std::size_t> start(blocks + 1);
+		for (std::size_t b=0; b<=blocks; b++) start[b] = b * ell / blocks;
+		std::vector<RealVector> blockWeights(blocks > 1 ? blocks : 0, RealVector(m_dim));
+
 		// prepare counters
 		std::size_t epoch = 0;
-		std::size_t steps = 0;
+		std::vector<std::size_t> steps(blocks, 0);
 
-		// prepare performance monitoring for self-adaptation
+		// prepare performance monitoring for self-adaptation, block-wise
 		double max_violation = 0.0;
-		const double gain_learning_rate = 1.0 / ell;
-		double average_gain = 0.0;
+		RealVector violation(blocks, 0.0);
+		RealVector prefsum(blocks);         // normalization constants
+		RealVector average_gain(blocks, 0.0);
+		for (std::size_t b=0; b<blocks; b++) prefsum(b) = start[b + 1] - start[b];
 		bool canstop = true;
 
 		// outer optimization loop
 		while (true)
 		{
 			// define schedule
-			double psum = prefsum;
-			prefsum = 0.0;
-			std::size_t pos = 0;
-			for (std::size_t i=0; i<ell; i++)
-			{
-				double p = pref[i];
-				double num = (psum < 1e-6) ? ell - pos : std::min((double)(ell - pos), (ell - pos) * p / psum);
-				std::size_t n = (std::size_t)std::floor(num);
-				double prob = num - n;
-				if (Rng::uni() < prob) n++;
-				for (std::size_t j=0; j<n; j++)
-				{
-					schedule[pos] = i;
-					pos++;
-				}
-				psum -= p;
-				prefsum += p;
-			}
-			SHARK_ASSERT(pos == ell);
-			for (std::size_t i=0; i<ell; i++) std::swap(schedule[i], schedule[Rng::discrete(0, ell - 1)]);
+			for (std::size_t b=0; b<blocks; b++) detail::defineSchedule(pref, prefsum(b), start[b], start[b + 1], schedule);
 
-			// inner loop
-			max_violation = 0.0;
-			for (std::size_t j=0; j<ell; j++)
+			// inner loop, the blocks are processed asynchronously
+			SHARK_PARALLEL_FOR(int b=0; b<(int)blocks; b++)
 			{
-				// active variable
-				std::size_t i = schedule[j];
-				const SparseVector* x_i = x[i];
-
-				// compute gradient and projected gradient
-				double a = alpha(i);
-				double wyx = y(i) * inner_prod(w, x_i);
-				double g = 1.0 - wyx;
-				double pg = (a == 0.0 && g < 0.0) ? 0.0 : (a == C && g > 0.0 ? 0.0 : g);
-
-				// update maximal KKT violation over the epoch
-				max_violation = std::max(max_violation, std::abs(pg));
-				double gain = 0.0;
-
-				// perform the step
-				if (pg != 0.0)
+				const std::size_t size = start[b + 1] - start[b];
+				const double gain_learning_rate = 1.0 / size;
+				violation(b) = 0.0;
+				for (std::size_t j=start[b]; j<start[b + 1]; j++)
 				{
-					// SMO-style coordinate descent step
-					double q = diagonal(i);
-					double mu = g / q;
-					double new_a = a + mu;
-
-					// numerically stable update
-					if (new_a <= 0.0)
-					{
-						mu = -a;
-						new_a = 0.0;
-					}
-					else if (new_a >= C)
+					// active variable
+					std::size_t i = schedule[j];
+					const SparseVector* x_i = x[i];
+
+					// compute gradient and projected gradient
+					double a = alpha(i);
+					double wyx = y(i) * inner_prod(w, x_i);
+					double g = 1.0 - wyx;
+					double pg = (a == 0.0 && g < 0.0) ? 0.0 : (a == C && g > 0.0 ? 0.0 : g);
+
+					// update maximal KKT violation over the epoch
+					violation(b) = std::max(violation(b), std::abs(pg));
+					double gain = 0.0;
+
+					// perform the step
+					if (pg != 0.0)
 					{
-						mu = C - a;
-						new_a = C;
+						// SMO-style coordinate descent step
+						double q = diagonal(i);
+						double mu = g / q;
+						double new_a = a + mu;
+
+						// numerically stable update
+						if (new_a <= 0.0)
+						{
+							mu = -a;
+							new_a = 0.0;
+						}
+						else if (new_a >= C)
+						{
+							mu = C - a;
+							new_a = C;
+						}
+
+						// update both representations of the weight vector: alpha and w
+						alpha(i) = new_a;
+						// w += (mu * y(i)) * x_i;
+						axpy(w, mu * y(i), x_i);
+						gain = mu * (g - 0.5 * q * mu);
+
+						steps[b]++;
 					}
 
-					// update both representations of the weight vector: alpha and w
-					alpha(i) = new_a;
-					// w += (mu * y(i)) * x_i;
-					axpy(w, mu * y(i), x_i);
-					gain = mu * (g - 0.5 * q * mu);
-
-					steps++;
-				}
-
-				// update gain-based preferences
-				{
-					if (epoch == 0) average_gain += gain / (double)ell;
-					else
+					// update gain-based preferences
 					{
-						double change = CHANGE_RATE * (gain / average_gain - 1.0);
-						double newpref = std::min(PREF_MAX, std::max(PREF_MIN, pref(i) * std::exp(change)));
-						prefsum += newpref - pref(i);
-						pref[i] = newpref;
-						average_gain = (1.0 - gain_learning_rate) * average_gain + gain_learning_rate * gain;
+						if (epoch == 0) average_gain(b) += gain / (double)size;
+						else
+						{
+							double change = CHANGE_RATE * (gain / average_gain(b) - 1.0);
+							double newpref = std::min(PREF_MAX, std::max(PREF_MIN, pref(i) * std::exp(change)));
+							prefsum(b) += newpref - pref(i);
+							pref[i] = newpref;
+							average_gain(b) = (1.0 - gain_learning_rate) * average_gain(b) + gain_learning_rate * gain;
+						}
 					}
 				}
 			}
 
+			// synchronize the blocks for the stopping criterion
+			if (blocks > 1) rebuildWeightVector(alpha, start, blockWeights, w);
+			max_violation = max(violation);
 			epoch++;
 
 			// stopping criteria
@@ -525,7 +621,7 @@ public:
 					// prepare full sweep for a reliable checking of the stopping criterion
 					canstop = true;
 					for (std::size_t i=0; i<ell; i++) pref[i] = 1.0;
-					prefsum = ell;
+					for (std::size_t b=0; b<blocks; b++) prefsum(b) = start[b + 1] - start[b];
 				}
 			}
 			else
@@ -568,7 +664,7 @@ public:
 			std::cout << "training time (seconds): " << timer.lastLap() << std::endl;
 			std::cout << "number of epochs: " << epoch << std::endl;
 			std::cout << "number of iterations: " << (ell * epoch) << std::endl;
-			std::cout << "number of non-zero steps: " << steps << std::endl;
+			std::cout << "number of non-zero steps: " << std::accumulate(steps.begin(), steps.end(), (std::size_t)0) << std::endl;
 			std::cout << "dual accuracy: " << max_violation << std::endl;
 			std::cout << "dual objective value: " << objective << std::endl;
 			std::cout << "number of free support vectors: " << free_SV << std::endl;
@@ -610,11 +706,32 @@ protected:
 		}
 	}
 
+	/// \brief Recompute the weight vector from the dual variables.
+	///
+	/// Every block sums its own part, the parts are added in a fixed order.
+	void rebuildWeightVector(RealVector const& alpha, std::vector<std::size_t> const& start, std::vector<RealVector>& blockWeights, RealVector& w)
+	{
+		std::size_t blocks = blockWeights.size();
+		SHARK_PARALLEL_FOR(int b=0; b<(int)blocks; b++)
+		{
+			RealVector& w_b = blockWeights[b];
+			w_b.clear();
+			for (std::size_t i=start[b]; i<start[b + 1]; i++)
+			{
+				if (alpha(i) != 0.0) axpy(w_b, alpha(i) * y(i), x[i]);
+			}
+		}
+		w.clear();
+		for (std::size_t b=0; b<blocks; b++) noalias(w) += blockWeights[b];
+	}
+
 	std::vector<SparseVector> storage;                ///< storage for sparse vectors
 	std::vector<SparseVector*> x;                     ///< sparse vectors
 	RealVector y;                                     ///< +1/-1 labels
 	RealVector diagonal;                              ///< diagonal entries of the quadratic matrix
+	RealVector m_alpha;                               ///< dual variables of the last solution
 	std::size_t m_dim;                                ///< input space dimension
+	bool m_parallel;                                  ///< asynchronous parallel coordinate descent?
 };
 
 
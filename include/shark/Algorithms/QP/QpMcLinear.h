@@ -37,12 +37,14 @@
 #define SHARK_ALGORITHMS_QP_QPMCLINEAR_H
 
 #include <shark/Core/Timer.h>
+#include <shark/Core/OpenMP.h>
 #include <shark/Algorithms/QP/QuadraticProgram.h>
 #include <shark/Data/Dataset.h>
 #include <shark/Data/DataView.h>
 #include <shark/LinAlg/Base.h>
 #include <cmath>
 #include <iostream>
+#include <numeric>
 #include <vector>
 
 
@@ -60,6 +62,19 @@ namespace shark {
 
 
 /// \brief Generic solver skeleton for linear multi-class SVM problems.
+///
+/// \par
+/// In parallel mode (see setParallel) the examples are split into
+/// contiguous blocks, one per OpenMP thread. The threads perform
+/// steps on their blocks asynchronously and update the shared weight
+/// vectors without locking ("Hogwild!", Niu et al., NIPS 2011). The
+/// preferences and the shrinking state are kept block-wise. The
+/// threads are synchronized after each epoch, where the weight vectors
+/// are recomputed from the dual variables, so that updates lost in
+/// concurrent writes do not accumulate, before the stopping criterion
+/// is checked. The result is not deterministic in parallel mode.
+/// Concurrent writes are rare only if the inputs are sparse, with
+/// dense inputs parallel mode does not help.
 template <class InputT>
 class QpMcLinear
 {
@@ -92,6 +107,7 @@ public:
 	, m_classes(classes)
 	, m_strategy(strategy)
 	, m_shrinking(shrinking)
+	, m_parallel(false)
 	{
 		SHARK_ASSERT(m_dim > 0);
 
@@ -101,6 +117,22 @@ public:
 		}
 	}
 
+	/// \brief Is the parallel (asynchronous) mode of the solver used?
+	bool parallel() const
+	{ return m_parallel; }
+
+	/// \brief Turn the parallel (asynchronous) mode of the solver on or off.
+	void setParallel(bool parallel)
+	{ m_parallel = parallel; }
+
+	/// \brief Dual variables of the solution found by the last call of solve.
+	///
+	/// The matrix has one row per example. The first classes columns
+	/// hold the variables the weight vectors are built from, the last
+	/// column is used internally by some of the solvers.
+	RealMatrix const& alpha() const
+	{ return m_alpha; }
+
 	///
 	/// \brief Solve the SVM training problem.
 	///
@@ -124,12 +156,19 @@ public:
 
 		// prepare dimensions and vectors
 		std::size_t ell = m_data.size();             // number of training examples
-		RealMatrix alpha(ell, m_classes + 1, 0.0);   // Lagrange multipliers; dual variables. Reserve one extra column.
+		RealMatrix& alpha = m_alpha;                 // Lagrange multipliers; dual variables. Reserve one extra column.
+		alpha = RealMatrix(ell, m_classes + 1, 0.0);
 		RealMatrix w(m_classes, m_dim, 0.0);         // weight vectors; primal variables
 
+		// partition the examples into contiguous blocks, one per thread
+		std::size_t blocks = m_parallel ? std::max<std::size_t>(1, std::min<std::size_t>(SHARK_NUM_THREADS, ell)) : 1;
+		std::vector<std::size_t> start(blocks + 1);
+		for (std::size_t b=0; b<=blocks; b++) start[b] = b * ell / blocks;
+		std::vector<RealMatrix> blockWeights(blocks > 1 ? blocks : 0, RealMatrix(m_classes, m_dim));
+
 		// scheduling of steps, for ACF only
 		RealVector pref(ell, 1.0);                   // example-wise measure of success
-		double prefsum = ell;                        // normalization constant
+		RealVector prefsum(blocks);                  // block-wise normalization constants
 
 		std::vector<std::size_t> schedule(ell);
 		if (m_strategy == UNIFORM)
@@ -138,117 +177,138 @@ public:
 		}
 
 		// used for shrinking
-		std::size_t active = ell;
+		std::vector<std::size_t> active(blocks);     // number of active examples per block
+
+		for (std::size_t b=0; b<blocks; b++)
+		{
+			prefsum(b) = start[b + 1] - start[b];
+			active[b] = start[b + 1] - start[b];
+		}
 
 		// prepare counters
 		std::size_t epoch = 0;
-		std::size_t steps = 0;
+		std::vector<std::size_t> steps(blocks, 0);
 
 		// prepare performance monitoring
 		double objective = 0.0;
 		double max_violation = 0.0;
+		RealVector violation(blocks, 0.0);
 
 		// gain for ACF
-		const double gain_learning_rate = 1.0 / ell;
-		double average_gain = 0.0;
+		RealVector average_gain(blocks, 0.0);
 
         
 		// outer optimization loop (epochs)
 		bool canstop = true;
 		while (true)
 		{
-			if (m_strategy == ACF)
+			for (std::size_t b=0; b<blocks; b++)
 			{
-				// define schedule
-				double psum = prefsum;
-				prefsum = 0.0;
-				std::size_t pos = 0;
-				for (std::size_t i=0; i<ell; i++)
+				const std::size_t begin = start[b];
+				const std::size_t end = start[b + 1];
+
+				if (m_strategy == ACF)
 				{
-					double p = pref(i);
-					double num = (psum < 1e-6) ? ell - pos : std::min((double)(ell - pos), (ell - pos) * p / psum);
-					std::size_t n = (std::size_t)std::floor(num);
-					double prob = num - n;
-					if (Rng::uni() < prob) n++;
-					for (std::size_t j=0; j<n; j++)
+					// define schedule
+					const std::size_t size = end - begin;
+					double psum = prefsum(b);
+					prefsum(b) = 0.0;
+					std::size_t pos = 0;
+					for (std::size_t i=begin; i<end; i++)
 					{
-						schedule[pos] = i;
-						pos++;
+						double p = pref(i);
+						double num = (psum < 1e-6) ? size - pos : std::min((double)(size - pos), (size - pos) * p / psum);
+						std::size_t n = (std::size_t)std::floor(num);
+						double prob = num - n;
+						if (Rng::uni() < prob) n++;
+						for (std::size_t j=0; j<n; j++)
+						{
+							schedule[begin + pos] = i;
+							pos++;
+						}
+						psum -= p;
+						prefsum(b) += p;
 					}
-					psum -= p;
-					prefsum += p;
+					SHARK_ASSERT(pos == size);
 				}
-				SHARK_ASSERT(pos == ell);
-			}
 
-			if (m_shrinking == true)
-			{
-				for (std::size_t i=0; i<active; i++) 
-					std::swap(schedule[i], schedule[Rng::discrete(0, active - 1)]);
-			}
-			else
-			{
-				for (std::size_t i=0; i<ell; i++) 
-					std::swap(schedule[i], schedule[Rng::discrete(0, ell - 1)]);
+				if (m_shrinking == true)
+				{
+					for (std::size_t i=begin; i<begin + active[b]; i++) 
+						std::swap(schedule[i], schedule[Rng::discrete(begin, begin + active[b] - 1)]);
+				}
+				else
+				{
+					for (std::size_t i=begin; i<end; i++) 
+						std::swap(schedule[i], schedule[Rng::discrete(begin, end - 1)]);
+				}
 			}
                 
-			// inner loop (one epoch)
-			max_violation = 0.0;
-			size_t nPoints = ell;
-			if (m_shrinking == true)
-				nPoints = active;
-
-			for (std::size_t j=0; j<nPoints; j++)
+			// inner loop (one epoch), the blocks are processed asynchronously
+			SHARK_PARALLEL_FOR(int b=0; b<(int)blocks; b++)
 			{
-				// active example
-				double gain = 0.0;
-				const std::size_t i = schedule[j];
-				InputReferenceType x_i = m_data[i].input;
-				const unsigned int y_i = m_data[i].label;
-				const double q = m_xSquared(i);
-				RealMatrixRow a = row(alpha, i);
-
-				// compute gradient and KKT violation
-				RealVector wx(m_classes,0.0);
-				axpy_prod(w,x_i,wx,false);
-				RealVector g(m_classes);
-				double kkt = calcGradient(g, wx, a, C, y_i);
-
-				if (kkt > 0.0)
+				const std::size_t begin = start[b];
+				const std::size_t size = start[b + 1] - begin;
+				const double gain_learning_rate = 1.0 / size;
+				violation(b) = 0.0;
+				size_t nPoints = size;
+				if (m_shrinking == true)
+					nPoints = active[b];
+				for (std::size_t j=begin; j<begin + nPoints; j++)
 				{
-					max_violation = std::max(max_violation, kkt);
+					// active example
+					double gain = 0.0;
+					const std::size_t i = schedule[j];
+					InputReferenceType x_i = m_data[i].input;
+					const unsigned int y_i = m_data[i].label;
+					const double q = m_xSquared(i);
+					RealMatrixRow a = row(alpha, i);
+
+					// compute gradient and KKT violation
+					RealVector wx(m_classes,0.0);
+					axpy_prod(w,x_i,wx,false);
+					RealVector g(m_classes);
+					double kkt = calcGradient(g, wx, a, C, y_i);
+
+					if (kkt > 0.0)
+					{
+						violation(b) = std::max(violation(b), kkt);
 
-					// perform the step on alpha
-					RealVector mu(m_classes, 0.0);
-					gain = solveSub(0.1 * stop.minAccuracy, g, q, C, y_i, a, mu);
-					objective += gain;
-					steps++;
+						// perform the step on alpha
+						RealVector mu(m_classes, 0.0);
+						gain = solveSub(0.1 * stop.minAccuracy, g, q, C, y_i, a, mu);
+						steps[b]++;
 
-					// update weight vectors
-					updateWeightVectors(w, mu, i);
-				}
-				else if (m_shrinking == true)
-				{
-					active--;
-					std::swap(schedule[j], schedule[active]);
-					j--;
-				}
+						// update weight vectors
+						updateWeightVectors(w, mu, i);
+					}
+					else if (m_shrinking == true)
+					{
+						active[b]--;
+						std::swap(schedule[j], schedule[begin + active[b]]);
+						j--;
+					}
 
-				// update gain-based preferences
-				if (m_strategy == ACF)
-				{
-					if (epoch == 0) average_gain += gain / (double)ell;
-					else
+					// update gain-based preferences
+					if (m_strategy == ACF)
 					{
-						double change = CHANGE_RATE * (gain / average_gain - 1.0);
-						double newpref = std::min(PREF_MAX, std::max(PREF_MIN, pref(i) * std::exp(change)));
-						prefsum += newpref - pref(i);
-						pref(i) = newpref;
-						average_gain = (1.0 - gain_learning_rate) * average_gain + gain_learning_rate * gain;
+						if (epoch == 0) average_gain(b) += gain / (double)size;
+						else
+						{
+							double change = CHANGE_RATE * (gain / average_gain(b) - 1.0);
+							double newpref = std::min(PREF_MAX, std::max(PREF_MIN, pref(i) * std::exp(change)));
+							prefsum(b) += newpref - pref(i);
+							pref(i) = newpref;
+							average_gain(b) = (1.0 - gain_learning_rate) * average_gain(b) + gain_learning_rate * gain;
+						}
 					}
 				}
 			}
 
+			// synchronize the blocks for the stopping criterion
+			if (blocks > 1) rebuildWeightVectors(alpha, start, blockWeights, w);
+			max_violation = max(violation);
+			std::size_t totalActive = std::accumulate(active.begin(), active.end(), (std::size_t)0);
 			epoch++;
 
 			// stopping criteria
@@ -280,13 +340,13 @@ public:
 						// prepare full sweep for a reliable checking of the stopping criterion
 						canstop = true;
 						for (std::size_t i=0; i<ell; i++) pref(i) = 1.0;
-						prefsum = ell;
+						for (std::size_t b=0; b<blocks; b++) prefsum(b) = start[b + 1] - start[b];
 					}
 
 					if (m_shrinking == true)
 					{
 						// prepare full sweep for a reliable checking of the stopping criterion
-						active = ell;
+						for (std::size_t b=0; b<blocks; b++) active[b] = start[b + 1] - start[b];
 						canstop = true;
 					}
 				}
@@ -297,7 +357,7 @@ public:
 				if (m_strategy == ACF)
 					canstop = false;
 				if (m_shrinking == true)
-					canstop = (active == ell);
+					canstop = (totalActive == ell);
 			}
 		}
 		timer.stop();
@@ -330,7 +390,7 @@ public:
 			std::cout << "training time (seconds): " << timer.lastLap() << std::endl;
 			std::cout << "number of epochs: " << epoch << std::endl;
 			std::cout << "number of iterations: " << (ell * epoch) << std::endl;
-			std::cout << "number of non-zero steps: " << steps << std::endl;
+			std::cout << "number of non-zero steps: " << std::accumulate(steps.begin(), steps.end(), (std::size_t)0) << std::endl;
 			std::cout << "dual accuracy: " << max_violation << std::endl;
 			std::cout << "dual objective value: " << objective << std::endl;
 		}
@@ -346,6 +406,30 @@ protected:
 		for (std::size_t c=0; c<m_classes; c++) noalias(row(w, c)) += mu(c) * x;
 	}
 
+	/// \brief Recompute the weight vectors from the dual variables.
+	///
+	/// The weight vectors are linear in the steps passed to
+	/// updateWeightVectors, hence they are rebuilt by stepping from
+	/// zero to alpha. Every block sums its own part, the parts are
+	/// added in a fixed order.
+	void rebuildWeightVectors(RealMatrix const& alpha, std::vector<std::size_t> const& start, std::vector<RealMatrix>& blockWeights, RealMatrix& w)
+	{
+		std::size_t blocks = blockWeights.size();
+		SHARK_PARALLEL_FOR(int b=0; b<(int)blocks; b++)
+		{
+			RealMatrix& w_b = blockWeights[b];
+			w_b.clear();
+			RealVector mu(m_classes);
+			for (std::size_t i=start[b]; i<start[b + 1]; i++)
+			{
+				noalias(mu) = subrange(row(alpha, i), 0, m_classes);
+				if (norm_inf(mu) > 0.0) updateWeightVectors(w_b, mu, i);
+			}
+		}
+		w.clear();
+		for (std::size_t b=0; b<blocks; b++) noalias(w) += blockWeights[b];
+	}
+
 	/// \brief Compute the gradient from the inner products of the weight vectors with the current sample.
 	///
 	/// \param  gradient  gradient vector to be filled in. The vector is correctly sized.
@@ -383,6 +467,8 @@ protected:
 	std::size_t m_classes;                            ///< number of classes
 	std::size_t m_strategy;                         ///< strategy for coordinate selection
 	bool m_shrinking;                               ///< apply shrinking or not?
+	bool m_parallel;                                ///< asynchronous parallel coordinate descent?
+	RealMatrix m_alpha;                             ///< dual variables of the last solution
 };
 
 
@@ -324,6 +324,7 @@ public:
 	AbstractLinearSvmTrainer(double C, bool unconstrained = false)
 	: m_C(C)
 	, m_unconstrained(unconstrained)
+	, m_parallel(false)
 	{ RANGE_CHECK( C > 0 ); }
 
 	/// \brief Return the value of the regularization parameter C.
@@ -340,6 +341,17 @@ public:
 	bool isUnconstrained() const
 	{ return m_unconstrained; }
 
+	/// \brief Does the solver run asynchronously on all OpenMP threads?
+	bool parallel() const
+	{ return m_parallel; }
+
+	/// \brief Turn asynchronous parallel training on or off.
+	///
+	/// Parallel training is worthwhile for large, sparse data sets,
+	/// but the solution is not deterministic.
+	void setParallel(bool parallel)
+	{ m_parallel = parallel; }
+
 	/// \brief Get the hyper-parameter vector.
 	RealVector parameterVector() const
 	{
@@ -366,6 +378,7 @@ public:
 protected:
 	double m_C;                         ///< Regularization parameter. The exact meaning depends on the sub-class, but the value is always positive, and higher implies a less regular solution.
 	bool m_unconstrained;               ///< Is log(C) stored internally as a parameter instead of C? If yes, then we get rid of the constraint C > 0 on the level of the parameter interface.
+	bool m_parallel;                    ///< Is the solver run asynchronously in parallel?
 };
 
 
@@ -51,6 +51,7 @@
 #define SHARK_MODELS_MERGEBUDGETMAINTENANCESTRATEGY_H
 
 #include <shark/Algorithms/GradientDescent/LineSearch.h>
+#include <shark/Core/OpenMP.h>
 #include <shark/Data/Dataset.h>
 #include <shark/Data/DataView.h>
 #include <shark/Models/Converter.h>
@@ -216,118 +217,136 @@ public:
 
 
 
+	/// Solves the merging problems of many candidates at once.
+	/// For every candidate i this maximizes \f[ a_i \cdot k_i^{(1-h)^2} + b_i \cdot k_i^{h^2} \f]
+	/// over \f[ h \in [0,1] \f] (see MergingProblemFunction) by a golden section search,
+	/// refined by a few safeguarded Newton steps. All searches take the same number of steps,
+	/// so every step evaluates the objective of a whole block of candidates in one vectorized
+	/// expression. The blocks are processed in parallel.
+	/// \param[in]  a   a coefficients of the problems
+	/// \param[in]  b   b coefficients of the problems
+	/// \param[in]  k   kernel values of the problems
+	/// \param[out] h   maximizers of the problems
+	///
+	static void solveMergingProblems(RealVector const& a, RealVector const& b, RealVector const& k, RealVector& h)
+	{
+		std::size_t n = a.size();
+		SIZE_CHECK(b.size() == n);
+		SIZE_CHECK(k.size() == n);
+		// the objective is evaluated as exp(x*log(k)), small values are clamped so that 0^0 = 1
+		RealVector logK = log(max(k, std::numeric_limits<double>::min()));
+		h.resize(n);
+		std::size_t const blockSize = 256;
+		std::size_t numBlocks = (n + blockSize - 1) / blockSize;
+		SHARK_PARALLEL_FOR(int blockIndex = 0; blockIndex < (int)numBlocks; ++blockIndex)
+		{
+			std::size_t start = blockIndex * blockSize;
+			std::size_t end = std::min(start + blockSize, n);
+			RealVector blockH;
+			goldenSectionSearch(
+				subrange(a, start, end), subrange(b, start, end), subrange(logK, start, end), blockH
+			);
+			noalias(subrange(h, start, end)) = blockH;
+		}
+	}
+
+
 	/// Reduce the budget.
 	/// This is a helper routine. after the addToModel adds the new support vector
 	/// to the end of the budget (it was chosen one bigger than the capacity),
 	/// this routine will do the real merging. Given a index it will search for a second
 	/// index, so that merging is 'optimal'. It then will perform the merging. After that
 	/// the last budget vector will be freed again (by setting its alpha-coefficients to zero).
+	/// All candidates for the second index are evaluated at once: the kernel row is computed
+	/// by one kernel call per batch of the basis and the merging problems are solved together
+	/// by solveMergingProblems.
 	/// \param[in]  model   Model to work on
 	/// \param[in]  firstIndex  The index of the first element of the pair to merge.
 	///
 	virtual void reduceBudget(ModelType& model, size_t firstIndex)
 	{
 		size_t maxIndex = model.basis().numberOfElements();
+		RealMatrix &alpha = model.alpha();
+		std::size_t classes = alpha.size2();
 
 		// compute the kernel row of the given, first element and all the others
 		// should take O(B) time, as it is a row of size B
-		blas::vector<float> kernelRow(maxIndex, 0.0);
-		for(size_t j = 0; j < maxIndex; j++)
-			kernelRow(j) = model.kernel()->eval(model.basis().element(firstIndex), model.basis().element(j));
+		RealMatrix firstVector(1, dataDimension(model.basis()));
+		row(firstVector, 0) = model.basis().element(firstIndex);
+		RealVector kernelRow(maxIndex);
+		RealMatrix kernelBlock;
+		std::size_t start = 0;
+		for(std::size_t b = 0; b != model.basis().numberOfBatches(); ++b)
+		{
+			model.kernel()->eval(firstVector, model.basis().batch(b), kernelBlock);
+			noalias(subrange(kernelRow, start, start + kernelBlock.size2())) = row(kernelBlock, 0);
+			start += kernelBlock.size2();
+		}
 
-		// initialize the search
-		double fret(0.);
-		RealVector h(1);     // initial search starting point
-		RealVector xi(1);    // direction of search
+		// compute the alphas for the model, this is the formula
+		// between (6.7) and (6.8) in wang, crammer, vucetic
+		RealVector a(maxIndex, 0.0);
+		RealVector b(maxIndex, 0.0);
+		for(size_t currentIndex = 0; currentIndex < maxIndex; currentIndex++)
+		{
+			for(size_t c = 0; c < classes; c++)
+			{
+				double d = std::min(0.00001, alpha(currentIndex, c) + alpha(firstIndex, c));
+				a(currentIndex) += alpha(firstIndex, c) / d;
+				b(currentIndex) += alpha(currentIndex, c) / d;
+			}
+		}
 
-		// save the parameter at the minimum
+		// the optimal merging point of every candidate is given by h.
+		// the vector that corresponds to this is
+		// $z = h x_m + (1-h) x_n$  by formula (6.7)
+		RealVector h;
+		solveMergingProblems(a, b, kernelRow, h);
+
+		// this is another minimization problem, which has as optimal
+		// solution $\alpha_z^{(i)} = \alpha_m^{(i)} k(x_m, z) + \alpha_n^{(i)} k(x_n, z).$
+		RealVector logK = log(max(kernelRow, std::numeric_limits<double>::min()));
+		RealVector alphaMergedFirst = exp(sqr(1.0 - h) * logK);
+		RealVector alphaMergedCurrent = exp(sqr(h) * logK);
+
+		// degradation is computed for each class
+		// this is computed by using formula (6.8), applying it to each class and summing up
+		// here a kernel with $k(x,x) = 1$ is assumed. The sums over the classes only need
+		// the inner products of the alpha rows with themselves and with the first row.
+		RealVector firstAlpha = row(alpha, firstIndex);
+		double firstNorm = norm_sqr(firstAlpha);
+		RealVector cross = prod(alpha, firstAlpha);
 		double minDegradation = std::numeric_limits<double>::infinity();
-		double minH = 0.0;
-		double minAlphaMergedFirst = 0.0;
-		double minAlphaMergedSecond = 0.0;
 		size_t secondIndex = 0;
-
-
-		// we need to check every other vector
-		RealMatrix &alpha = model.alpha();
 		for(size_t currentIndex = 0; currentIndex < maxIndex; currentIndex++)
 		{
 			// we do not want the vector already chosen
 			if(firstIndex == currentIndex)
 				continue;
-
-			// compute the alphas for the model, this is the formula
-			// between (6.7) and (6.8) in wang, crammer, vucetic
-			double a = 0.0;
-			double b = 0.0;
-			for(size_t c = 0; c < alpha.size2(); c++)
-			{
-				double d = std::min(0.00001, alpha(currentIndex, c) + alpha(firstIndex, c));
-				a += alpha(firstIndex, c) / d;
-				b += alpha(currentIndex, c) / d;
-			}
-
-			// Initialize search starting point and direction:
-			h(0) = 0.0;
-			xi(0) = 0.5;
-
-			double k = kernelRow(currentIndex);
-			MergingProblemFunction mergingProblemFunction(a, b, k);
-
-			// minimize function
-			// search between 0 and 1
-			detail::dlinmin(h, xi, fret, mergingProblemFunction, 0.0, 1.0);
-
-			// the optimal point is now given by h.
-			// the vector that corresponds to this is
-			// $z = h x_m + (1-h) x_n$  by formula (6.7)
-			RealVector firstVector = model.basis().element(firstIndex);
-			RealVector currentVector = model.basis().element(currentIndex);
-			RealVector mergedVector = h(0) * firstVector + (1.0 - h(0)) * currentVector;
-
-			// this is another minimization problem, which has as optimal
-			// solution $\alpha_z^{(i)} = \alpha_m^{(i)} k(x_m, z) + \alpha_n^{(i)} k(x_n, z).$
-
-			// the coefficient of this z is computed by approximating
-			// both vectors by the merged one. maybe KernelBasisDistance can be used
-			// but i am not sure, if at all and if, if its faster.
-
-			long double alphaMergedFirst = pow(k, (1.0 - h(0)) * (1.0 - h(0)));
-			long double alphaMergedCurrent = pow(k, h(0) * h(0));
-
-			// degradation is computed for each class
-			// this is computed by using formula (6.8), applying it to each class and summing up
-			// here a kernel with $k(x,x) = 1$ is assumed
-			double currentDegradation = 0.0f;
-			for(size_t c = 0; c < alpha.size2(); c++)
-			{
-				double zAlpha = alphaMergedFirst * alpha(firstIndex, c) + alphaMergedCurrent * alpha(currentIndex, c);
-				// TODO: unclear to me why this is the thing we want to compute
-				currentDegradation += pow(alpha(firstIndex, c), 2) + pow(alpha(currentIndex, c), 2) +
-									  2.0 * k * alpha(firstIndex, c) * alpha(currentIndex, c) - zAlpha * zAlpha;
-			}
-
-			// TODO: this is shamelessly copied, as the rest, but maybe i want to refactor it and make it nicer.
+			double p = alphaMergedFirst(currentIndex);
+			double q = alphaMergedCurrent(currentIndex);
+			double currentNorm = norm_sqr(row(alpha, currentIndex));
+			double currentDegradation = firstNorm + currentNorm + 2.0 * kernelRow(currentIndex) * cross(currentIndex)
+				- (p * p * firstNorm + 2.0 * p * q * cross(currentIndex) + q * q * currentNorm);
 			if(currentDegradation < minDegradation)
 			{
 				minDegradation = currentDegradation;
-				minH = h(0);
-				minAlphaMergedFirst = alphaMergedFirst;
-				minAlphaMergedSecond = alphaMergedCurrent;
 				secondIndex = currentIndex;
 			}
 		}
+		double minH = h(secondIndex);
+		double minAlphaMergedFirst = alphaMergedFirst(secondIndex);
+		double minAlphaMergedSecond = alphaMergedCurrent(secondIndex);
 
 		// compute merged vector
-		RealVector firstVector = model.basis().element(firstIndex);
 		RealVector secondVector = model.basis().element(secondIndex);
-		RealVector mergedVector = minH * firstVector + (1.0 - minH) * secondVector;
+		RealVector mergedVector = minH * row(firstVector, 0) + (1.0 - minH) * secondVector;
 
 		// replace the second vector by the merged one
 		model.basis().element(secondIndex) = mergedVector;
 
 		// and update the alphas
-		for(size_t c = 0; c < alpha.size2(); c++)
+		for(size_t c = 0; c < classes; c++)
 		{
 			alpha(secondIndex, c) = minAlphaMergedFirst * alpha(firstIndex, c) + minAlphaMergedSecond * alpha(secondIndex, c);
 		}
@@ -408,6 +427,84 @@ public:
 
 
 protected:
+	/// golden section search of solveMergingProblems for a block of candidates
+	static void goldenSectionSearch(RealVector const& a, RealVector const& b, RealVector const& logK, RealVector& h)
+	{
+		std::size_t n = a.size();
+		double const ratio = 0.5 * (std::sqrt(5.0) - 1.0);
+		// 0.618^10 < 0.01, the Newton steps below refine from there
+		std::size_t const iterations = 10;
+		std::size_t const newtonSteps = 3;
+
+		RealVector lower(n, 0.0);
+		RealVector upper(n, 1.0);
+		RealVector x1 = blas::repeat(1.0 - ratio, n);
+		RealVector x2 = blas::repeat(ratio, n);
+		RealVector f1 = mergingObjective(a, b, logK, x1);
+		RealVector f2 = mergingObjective(a, b, logK, x2);
+		RealVector xNew(n);
+		std::vector<char> leftSide(n);
+		for(std::size_t iter = 0; iter != iterations; ++iter)
+		{
+			// shrink every interval towards the larger value and choose the next point
+			for(std::size_t i = 0; i != n; ++i)
+			{
+				leftSide[i] = f1(i) > f2(i);
+				if(leftSide[i])
+				{
+					upper(i) = x2(i);
+					x2(i) = x1(i);
+					f2(i) = f1(i);
+					xNew(i) = upper(i) - ratio * (upper(i) - lower(i));
+				}
+				else
+				{
+					lower(i) = x1(i);
+					x1(i) = x2(i);
+					f1(i) = f2(i);
+					xNew(i) = lower(i) + ratio * (upper(i) - lower(i));
+				}
+			}
+			RealVector fNew = mergingObjective(a, b, logK, xNew);
+			for(std::size_t i = 0; i != n; ++i)
+			{
+				if(leftSide[i])
+				{
+					x1(i) = xNew(i);
+					f1(i) = fNew(i);
+				}
+				else
+				{
+					x2(i) = xNew(i);
+					f2(i) = fNew(i);
+				}
+			}
+		}
+		h = 0.5 * (lower + upper);
+
+		// Newton steps on the derivative, kept inside the bracket. Where the objective is not
+		// concave the step is not taken.
+		for(std::size_t step = 0; step != newtonSteps; ++step)
+		{
+			RealVector first = element_prod(a, exp(sqr(1.0 - h) * logK));
+			RealVector second = element_prod(b, exp(sqr(h) * logK));
+			for(std::size_t i = 0; i != n; ++i)
+			{
+				double l = logK(i);
+				double g = 1.0 - h(i);
+				double derivative = 2 * l * (h(i) * second(i) - g * first(i));
+				double curvature = 2 * l * (first(i) * (1 + 2 * l * g * g) + second(i) * (1 + 2 * l * h(i) * h(i)));
+				if(curvature < 0)
+					h(i) = std::min(std::max(h(i) - derivative / curvature, lower(i)), upper(i));
+			}
+		}
+	}
+
+	/// evaluates the objective of the merging problems at the points x
+	static RealVector mergingObjective(RealVector const& a, RealVector const& b, RealVector const& logK, RealVector const& x)
+	{
+		return element_prod(a, exp(sqr(1.0 - x) * logK)) + element_prod(b, exp(sqr(x) * logK));
+	}
 };
 
 }
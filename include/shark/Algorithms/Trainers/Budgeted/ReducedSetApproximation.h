@@ -0,0 +1,261 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Reduced set approximation of trained kernel expansions
+ *
+ * \par
+ * Compresses a kernel expansion, for example the decision function
+ * of a trained SVM, to a given budget of basis vectors. The basis is
+ * initialized by merging pairs of support vectors or by a random
+ * subset, optionally refined by gradient descent and the coefficients
+ * are found by projection in the kernel-induced feature space.
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#ifndef SHARK_ALGORITHMS_TRAINERS_BUDGETED_REDUCEDSETAPPROXIMATION_H
+#define SHARK_ALGORITHMS_TRAINERS_BUDGETED_REDUCEDSETAPPROXIMATION_H
+
+#include <shark/Algorithms/Trainers/Budgeted/MergeBudgetMaintenanceStrategy.h>
+#include <shark/Algorithms/GradientDescent/Rprop.h>
+#include <shark/ObjectiveFunctions/KernelBasisDistance.h>
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/Core/OpenMP.h>
+
+
+namespace shark
+{
+
+///
+/// \brief Compresses a trained kernel expansion to a budget of basis vectors.
+///
+/// \par Budgeted trainers like the KernelBudgetedSGDTrainer bound the number of support
+/// vectors during training. This class instead shrinks an existing model, for example one
+/// trained by the CSvmTrainer, to approximate
+/// \f[ w = \sum_{i=1}^{\ell} \alpha_i k(x_i, \cdot) \f]
+/// by an expansion \f$ w' = \sum_{j=1}^{B} \beta_j k(z_j, \cdot) \f$ with \f$ B \ll \ell \f$
+/// synthetic basis vectors \f$ z_j \f$ (the "reduced set"). Prediction time shrinks by
+/// the factor \f$ \ell / B \f$.
+///
+/// \par The approximation is computed in three stages:
+/// <ol>
+/// <li> The initial basis is found either by repeatedly merging the support vector with
+///      the smallest coefficient with its best partner, using the
+///      MergeBudgetMaintenanceStrategy, or by a random subset of the support vectors.
+///      Merging requires a GaussianRbfKernel and is quadratic in \f$ \ell \f$.</li>
+/// <li> Optionally, the basis vectors are moved to minimize the KernelBasisDistance
+///      using iterations of IRpropPlus. This requires a kernel with input derivative.</li>
+/// <li> The coefficients \f$ \beta \f$ are computed as the projection of \f$ w \f$ onto
+///      the span of the basis in feature space.</li>
+/// </ol>
+///
+/// \par After the approximation, the squared feature space distance
+/// \f$ \| w - w' \|^2 \f$ (summed over all outputs) as well as the error relative to
+/// \f$ \|w\|^2 \f$ are available. Since the error bounds the difference of the
+/// predictions via \f$ |w(x) - w'(x)| \leq \|w-w'\| \sqrt{k(x,x)} \f$, it is a direct
+/// measure of the loss in accuracy. Computing \f$ \|w\|^2 \f$ requires
+/// \f$ \mathcal{O}(\ell^2) \f$ kernel evaluations, which are carried out in parallel.
+class ReducedSetApproximation : public INameable
+{
+public:
+	typedef KernelExpansion<RealVector> ModelType;
+
+	/// \brief Strategy for finding the initial reduced set.
+	enum Initialization{
+		MergeInitialization,
+		RandomInitialization
+	};
+
+	/// \brief Constructor.
+	///
+	/// \param budget number of basis vectors of the approximation
+	/// \param iterations number of gradient steps to optimize the position of the basis vectors
+	/// \param initialization strategy to find the initial basis vectors
+	ReducedSetApproximation(
+		std::size_t budget,
+		std::size_t iterations = 0,
+		Initialization initialization = MergeInitialization
+	):m_budget(budget), m_iterations(iterations), m_initialization(initialization)
+	, m_squaredError(0), m_relativeError(0){
+		SHARK_CHECK(budget > 0, "[ReducedSetApproximation] budget must be positive");
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "ReducedSetApproximation"; }
+
+	std::size_t budget()const{
+		return m_budget;
+	}
+	void setBudget(std::size_t budget){
+		SHARK_CHECK(budget > 0, "[ReducedSetApproximation::setBudget] budget must be positive");
+		m_budget = budget;
+	}
+
+	std::size_t iterations()const{
+		return m_iterations;
+	}
+	void setIterations(std::size_t iterations){
+		m_iterations = iterations;
+	}
+
+	Initialization initialization()const{
+		return m_initialization;
+	}
+	void setInitialization(Initialization initialization){
+		m_initialization = initialization;
+	}
+
+	/// \brief Squared feature space distance of the last approximation, summed over all outputs.
+	double squaredError()const{
+		return m_squaredError;
+	}
+
+	/// \brief Squared error of the last approximation relative to the squared norm of the original expansion.
+	double relativeError()const{
+		return m_relativeError;
+	}
+
+	/// \brief Computes the reduced set approximation of an expansion.
+	///
+	/// The approximation uses the same kernel object and offset as the source.
+	/// If the source has at most budget() support vectors, it is copied without its
+	/// non-support vectors.
+	///
+	/// \param source the expansion to approximate
+	/// \param approximation the resulting expansion
+	void approximate(ModelType const& source, ModelType& approximation){
+		SHARK_CHECK(source.kernel() != NULL, "[ReducedSetApproximation::approximate] source has no kernel");
+		ModelType reference = source;
+		reference.sparsify();
+		std::size_t outputs = reference.outputSize();
+
+		if(reference.alpha().size1() <= m_budget){
+			approximation = reference;
+			m_squaredError = 0;
+			m_relativeError = 0;
+			return;
+		}
+
+		//find the initial reduced set
+		Data<RealVector> basis;
+		if(m_initialization == MergeInitialization){
+			SHARK_CHECK(
+				dynamic_cast<GaussianRbfKernel<RealVector> const*>(reference.kernel()) != NULL,
+				"[ReducedSetApproximation::approximate] merging requires a GaussianRbfKernel"
+			);
+			ModelType merged = reference;
+			merged.basis().makeIndependent();//merging changes the basis in place
+			MergeBudgetMaintenanceStrategy<RealVector> strategy;
+			while(merged.alpha().size1() > m_budget){
+				std::size_t firstIndex = 0;
+				double firstAlpha = 0;
+				strategy.findSmallestVector(merged, firstIndex, firstAlpha);
+				//merges the vector into its best partner and frees the last vector
+				strategy.reduceBudget(merged, firstIndex);
+				merged.sparsify();
+			}
+			basis = merged.basis();
+		}else{
+			basis = toDataset(randomSubset(toView(reference.basis()), m_budget));
+		}
+		std::size_t basisSize = basis.numberOfElements();
+		std::size_t dim = dataDimension(basis);
+
+		//concatenate the basis vectors for the KernelBasisDistance
+		RealVector point(basisSize * dim);
+		for(std::size_t i = 0; i != basisSize; ++i){
+			noalias(subrange(point, i * dim, (i + 1) * dim)) = basis.element(i);
+		}
+
+		//optimize the position of the basis vectors
+		KernelBasisDistance distance(&reference, basisSize);
+		if(m_iterations > 0 && distance.hasFirstDerivative()){
+			IRpropPlus optimizer;
+			optimizer.init(distance, point);
+			for(std::size_t t = 0; t != m_iterations; ++t){
+				optimizer.step(distance);
+			}
+			if(optimizer.solution().value < distance(point))
+				point = optimizer.solution().point;
+		}
+
+		//project the expansion onto the final basis
+		RealMatrix beta = distance.findOptimalBeta(point);
+		std::vector<RealVector> vectors(basisSize);
+		for(std::size_t i = 0; i != basisSize; ++i){
+			vectors[i] = subrange(point, i * dim, (i + 1) * dim);
+		}
+		approximation.setStructure(reference.kernel(), createDataFromRange(vectors), reference.hasOffset(), outputs);
+		noalias(approximation.alpha()) = beta;
+		if(reference.hasOffset())
+			noalias(approximation.offset()) = reference.offset();
+
+		//the KernelBasisDistance omits the constant term 1/2 ||w||^2
+		double normW = squaredNorm(reference);
+		m_squaredError = std::max(2 * distance(point) + normW, 0.0);
+		m_relativeError = normW > 0 ? m_squaredError / normW : 0.0;
+	}
+
+private:
+	/// \brief Computes \f$ \sum_c \alpha_c^T K \alpha_c \f$ block by block.
+	static double squaredNorm(ModelType const& expansion){
+		Data<RealVector> const& basis = expansion.basis();
+		RealMatrix const& alpha = expansion.alpha();
+		AbstractKernelFunction<RealVector> const& kernel = *expansion.kernel();
+		std::size_t numBatches = basis.numberOfBatches();
+
+		std::vector<std::size_t> start(numBatches + 1, 0);
+		for(std::size_t i = 0; i != numBatches; ++i){
+			start[i + 1] = start[i] + basis.batch(i).size1();
+		}
+
+		RealVector partialNorms(numBatches, 0.0);
+		SHARK_PARALLEL_FOR(int i = 0; i < (int)numBatches; ++i){
+			//the kernel matrix is symmetric, thus only blocks with j >= i are needed
+			for(std::size_t j = i; j != numBatches; ++j){
+				RealMatrix block = kernel(basis.batch(i), basis.batch(j));
+				RealMatrix blockAlpha = prod(block, rows(alpha, start[j], start[j + 1]));
+				double value = sum(rows(alpha, start[i], start[i + 1]) * blockAlpha);
+				partialNorms(i) += (j == (std::size_t)i) ? value : 2 * value;
+			}
+		}
+		return sum(partialNorms);
+	}
+
+	std::size_t m_budget;            ///< number of basis vectors of the approximation
+	std::size_t m_iterations;        ///< number of gradient steps for the basis vectors
+	Initialization m_initialization; ///< strategy to find the initial basis
+	double m_squaredError;           ///< squared feature space error of the last approximation
+	double m_relativeError;          ///< relative error of the last approximation
+};
+
+}
+#endif
@@ -392,6 +392,7 @@ public:
 	{
 		std::size_t dim = inputDimension(dataset);
 		QpBoxLinear<InputType> solver(dataset, dim);
+		solver.setParallel(base_type::parallel());
 		RealMatrix w(1, dim, 0.0);
 		row(w, 0) = solver.solve(
 				base_type::C(),
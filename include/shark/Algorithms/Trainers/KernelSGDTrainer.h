@@ -45,6 +45,8 @@
 #include <shark/Models/Kernels/KernelExpansion.h>
 #include <shark/Models/Kernels/KernelHelpers.h>
 #include <shark/ObjectiveFunctions/Loss/AbstractLoss.h>
+#include <shark/Rng/DiscreteUniform.h>
+#include <shark/Core/OpenMP.h>
 
 
 namespace shark
@@ -86,6 +88,18 @@ namespace shark
 /// It suffers from significantly slower convergence for non-differentiable
 /// losses, e.g., the hinge loss for SVM training.
 ///
+/// \par
+/// The examples are visited in the order of a random permutation, which
+/// is redrawn once per epoch. Each step can be based on a minibatch of
+/// examples, see setMinibatchSize. The predictions on the minibatch, which
+/// dominate the cost of a step, are computed in parallel. Since the
+/// learning rate decays with the number of steps, a minibatch of size m
+/// uses the offset ell / m instead of ell in the learning rate schedule.
+/// Optionally, the trainer returns the average of the iterates after the
+/// first epoch (averaged SGD), which often reduces the noise of the
+/// final model considerably. The average is maintained at a cost
+/// proportional to the minibatch size.
+///
 template <class InputType, class CacheType = float>
 class KernelSGDTrainer : public AbstractTrainer< KernelClassifier<InputType> >, public IParameterizable
 {
@@ -117,6 +131,8 @@ public:
 		, m_offset(offset)
 		, m_unconstrained(unconstrained)
 		, m_epochs(0)
+		, m_minibatchSize(1)
+		, m_averaging(false)
 		, m_cacheSize(cacheSize)
 	{ }
 
@@ -154,43 +170,95 @@ public:
 		UIntVector y = createBatch(dataset.labels().elements());
 		const double lambda = 0.5 / (ell * m_C);
 
+		// minibatches are sampled without replacement in each epoch
+		std::size_t batchsize = std::max<std::size_t>(1, std::min(m_minibatchSize, ell / 2));
+		std::vector<std::size_t> permutation(ell);
+		for (std::size_t i=0; i<ell; i++) permutation[i] = i;
+		std::size_t position = ell;
+		DiscreteUniform<Rng::rng_type> uni(Rng::globalRng);
+		std::vector<std::size_t> active(batchsize);
+
 		double alphaScale = 1.0;
 		std::size_t iterations;
 		if(m_epochs == 0) iterations = std::max(10 * ell, std::size_t(std::ceil(m_C * ell)));
 		else iterations = m_epochs * ell;
+		std::size_t steps = (iterations + batchsize - 1) / batchsize;
+		const double t0 = (double)ell / batchsize;  // offset of the learning rate schedule
+
+		// averaging of the iterates alphaScale_t * alpha_t, represented as (S * alpha - B) / count
+		const std::size_t averagingStart = (ell + batchsize - 1) / batchsize;
+		double S = 0.0;
+		RealMatrix B;
+		RealVector offsetSum(classes, 0.0);
+		if(m_averaging) B = RealMatrix(ell, classes, 0.0);
+		std::size_t count = 0;
 
 		// preinitialize everything to prevent costly memory allocations in the loop
-		RealVector f_b(classes, 0.0);
-		RealVector derivative(classes, 0.0);
+		RealMatrix derivatives(batchsize, classes, 0.0);
+		std::vector<blas::vector<QpFloatType> > kernelRows(SHARK_NUM_THREADS, blas::vector<QpFloatType>(ell, 0));
+		// rows which are not precomputed are evaluated by a kernel matrix of the thread,
+		// as the kernel matrix counts its accesses
+		std::vector<KernelMatrixType> threadKernelMatrices(SHARK_NUM_THREADS, km);
+		std::vector<RealVector> f_b(SHARK_NUM_THREADS, RealVector(classes, 0.0));
+		std::vector<RealVector> derivative(SHARK_NUM_THREADS, RealVector(classes, 0.0));
 
 		// SGD loop
-		blas::vector<QpFloatType> kernelRow(ell, 0);
-		for(std::size_t iter = 0; iter < iterations; iter++)
+		for(std::size_t iter = 0; iter < steps; iter++)
 		{
-			// active variable
-			std::size_t b = Rng::discrete(0, ell - 1);
+			// active variables
+			for(std::size_t i = 0; i < batchsize; i++)
+			{
+				if(position == ell)
+				{
+					shark::shuffle(permutation.begin(), permutation.end(), uni);
+					position = 0;
+				}
+				active[i] = permutation[position];
+				position++;
+			}
 
 			// learning rate
-			const double eta = 1.0 / (lambda * (iter + ell));
-
-			// compute prediction
-			f_b.clear();
-			K.row(b, kernelRow);
-			axpy_prod(trans(alpha), kernelRow, f_b, false, alphaScale);
-			if(m_offset) noalias(f_b) += model.offset();
+			const double eta = 1.0 / (lambda * (iter + t0));
+
+			// compute predictions and loss derivatives on the minibatch
+			SHARK_PARALLEL_FOR(int i = 0; i < (int)batchsize; i++)
+			{
+				std::size_t thread = SHARK_THREAD_NUM;
+				std::size_t b = active[i];
+				f_b[thread].clear();
+				if(K.isCached(b)) K.row(b, kernelRows[thread]);
+				else threadKernelMatrices[thread].row(b, 0, ell, &kernelRows[thread][0]);
+				axpy_prod(trans(alpha), kernelRows[thread], f_b[thread], false, alphaScale);
+				if(m_offset) noalias(f_b[thread]) += model.offset();
+				derivative[thread].clear();
+				m_loss->evalDerivative(y[b], f_b[thread], derivative[thread]);
+				noalias(row(derivatives, i)) = derivative[thread] / (double)batchsize;
+			}
 
 			// stochastic gradient descent (SGD) step
-			derivative.clear();
-			m_loss->evalDerivative(y[b], f_b, derivative);
-
 			// alphaScale *= (1.0 - eta * lambda);
-			alphaScale = (ell - 1.0) / (ell + iter);   // numerically more stable
-
-			noalias(row(alpha, b)) -= (eta / alphaScale) * derivative;
-			if(m_offset) noalias(model.offset()) -= eta * derivative;
+			alphaScale = (t0 - 1.0) / (t0 + iter);   // numerically more stable
+
+			for(std::size_t i = 0; i < batchsize; i++)
+			{
+				noalias(row(alpha, active[i])) -= (eta / alphaScale) * row(derivatives, i);
+				if(m_averaging) noalias(row(B, active[i])) -= (S * eta / alphaScale) * row(derivatives, i);
+				if(m_offset) noalias(model.offset()) -= eta * row(derivatives, i);
+			}
+			if(m_averaging && iter >= averagingStart)
+			{
+				S += alphaScale;
+				if(m_offset) noalias(offsetSum) += model.offset();
+				count++;
+			}
 		}
 
-		alpha *= alphaScale;
+		if(m_averaging && count > 0)
+		{
+			alpha = (S * alpha - B) / (double)count;
+			if(m_offset) noalias(model.offset()) = offsetSum / (double)count;
+		}
+		else alpha *= alphaScale;
 
 		// model.sparsify();
 	}
@@ -205,6 +273,26 @@ public:
 	void setEpochs(std::size_t value)
 	{ m_epochs = value; }
 
+	/// Return the number of examples per SGD step.
+	std::size_t minibatchSize() const
+	{ return m_minibatchSize; }
+
+	/// Set the number of examples per SGD step.
+	/// The minibatch size is limited to half of the data set size.
+	void setMinibatchSize(std::size_t value)
+	{
+		RANGE_CHECK(value > 0);
+		m_minibatchSize = value;
+	}
+
+	/// Check whether the average of the iterates is returned.
+	bool averaging() const
+	{ return m_averaging; }
+
+	/// Turn averaging of the iterates (averaged SGD) on or off.
+	void setAveraging(bool value)
+	{ m_averaging = value; }
+
 	/// get the kernel function
 	KernelType* kernel()
 	{ return m_kernel; }
@@ -270,6 +358,8 @@ protected:
 	bool m_offset;                            ///< should the resulting model have an offset term?
 	bool m_unconstrained;                     ///< should C be stored as log(C) as a parameter?
 	std::size_t m_epochs;                     ///< number of training epochs (sweeps over the data), or 0 for default = max(10, C)
+	std::size_t m_minibatchSize;              ///< number of examples per SGD step
+	bool m_averaging;                         ///< return the average of the iterates?
 
 	// size of cache to use.
 	std::size_t m_cacheSize;
@@ -244,6 +244,7 @@ public:
 		std::size_t dim = inputDimension(dataset);
 		std::size_t classes = numberOfClasses(dataset);
 		QpMcLinearATM<InputType> solver(dataset, dim, classes);
+		solver.setParallel(this->parallel());
 		RealMatrix w = solver.solve(this->C(), this->stoppingCondition(), &this->solutionProperties(), this->verbosity() > 0);
 		model.decisionFunction().setStructure(w);
 	}
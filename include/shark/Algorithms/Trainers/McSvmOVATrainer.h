@@ -167,6 +167,7 @@ public:
 		{
 			LabeledData<InputType, unsigned int> bindata = oneVersusRestProblem(dataset, c);
 			QpBoxLinear<InputType> solver(bindata, dim);
+			solver.setParallel(base_type::parallel());
 			QpSolutionProperties prop;
 			row(w, c) = solver.solve(this->C(), base_type::m_stoppingcondition, &prop, base_type::m_verbosity > 0);
 			base_type::m_solutionproperties.iterations += prop.iterations;
@@ -40,6 +40,7 @@
 
 #include <shark/Models/Normalizer.h>
 #include <shark/Algorithms/Trainers/AbstractTrainer.h>
+#include <shark/Data/Statistics.h>
 
 namespace shark{
 
@@ -88,15 +89,10 @@ public:
 		SHARK_CHECK(ic >= 2, "[NormalizeComponentsUnitInterval::train] input needs to consist of at least two points");
 		std::size_t dc = dataDimension(input);
 
-		RealVector min = input.element(0);
-		RealVector max = input.element(0);
-		for(std::size_t i=1; i != ic; i++){
-			for(std::size_t d = 0; d != dc; d++){
-				double x = input.element(i)(d);
-				min(d) = std::min(min(d), x);
-				max(d) = std::max(max(d), x);
-			}
-		}
+		StatisticsAccumulator statistics;
+		statistics.addData(input);
+		RealVector const& min = statistics.min();
+		RealVector const& max = statistics.max();
 
 		RealVector diagonal(dc);
 		RealVector offset(dc);
@@ -98,9 +98,10 @@ public:
 		SHARK_CHECK(input.numberOfElements() >= 2, "[NormalizeComponentsUnitVariance::train] input needs to consist of at least two points");
 		std::size_t dc = dataDimension(input);
 
-		RealVector mean;
-		RealVector variance;
-		meanvar(input, mean, variance);
+		StatisticsAccumulator statistics;
+		statistics.addData(input);
+		RealVector const& mean = statistics.mean();
+		RealVector variance = statistics.variance();
 
 		RealVector diagonal(dc);
 		RealVector vector(dc);
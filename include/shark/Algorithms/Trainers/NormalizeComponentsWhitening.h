@@ -70,9 +70,10 @@ public:
 		// dense model with bias having input and output dimension equal to data dimension
 		model.setStructure(dc, dc, true); 
 
-		RealVector mean;
-		RealMatrix covariance;
-		meanvar(input, mean, covariance);
+		StatisticsAccumulator statistics(true);
+		statistics.addData(input);
+		RealVector const& mean = statistics.mean();
+		RealMatrix covariance = statistics.covariance();
 
 		RealMatrix whiteningMatrix = createWhiteningMatrix(covariance);
 		whiteningMatrix *= std::sqrt(m_targetVariance);
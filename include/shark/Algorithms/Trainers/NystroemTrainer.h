@@ -0,0 +1,138 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Landmark selection for the Nystroem feature map
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#ifndef SHARK_ALGORITHMS_TRAINERS_NYSTROEMTRAINER_H
+#define SHARK_ALGORITHMS_TRAINERS_NYSTROEMTRAINER_H
+
+#include <shark/Models/Kernels/NystroemFeatures.h>
+#include <shark/Algorithms/Trainers/AbstractTrainer.h>
+#include <shark/Algorithms/KMeans.h>
+#include <shark/Data/DataView.h>
+
+namespace shark{
+
+namespace detail{
+inline Data<RealVector> kMeansLandmarks(Data<RealVector> const& inputs, Data<RealVector> const& start, std::size_t iterations){
+	Centroids centroids(start);
+	kMeans(inputs, start.numberOfElements(), centroids, iterations);
+	return centroids.centroids();
+}
+
+template<class T>
+Data<T> kMeansLandmarks(Data<T> const&, Data<T> const&, std::size_t){
+	throw SHARKEXCEPTION("[selectLandmarks] k-means landmarks are only supported for RealVector inputs");
+}
+}
+
+/// \brief Selects a set of landmark points representing a dataset.
+///
+/// The landmarks are either a random subset of the data or, for RealVector inputs,
+/// the centroids found by k-means clustering started from a random subset.
+/// If the dataset has fewer points than requested, all points are returned.
+///
+/// \param inputs the points to choose from
+/// \param landmarks number of landmarks
+/// \param useKMeans use k-means centroids instead of a random subset
+/// \param kMeansIterations maximum number of k-means iterations; 0: unlimited
+template<class InputType>
+Data<InputType> selectLandmarks(
+	UnlabeledData<InputType> const& inputs, std::size_t landmarks,
+	bool useKMeans = false, std::size_t kMeansIterations = 20
+){
+	landmarks = std::min(landmarks, inputs.numberOfElements());
+	Data<InputType> subset = toDataset(randomSubset(toView(inputs), landmarks));
+	if(useKMeans)
+		subset = detail::kMeansLandmarks(inputs, subset, kMeansIterations);
+	return subset;
+}
+
+
+///
+/// \brief Chooses the landmarks of a NystroemFeatures map.
+///
+/// The landmarks are either a random subset of the data or, for RealVector inputs,
+/// the centroids found by k-means clustering started from a random subset. k-means
+/// landmarks cover the data more evenly and usually give a better approximation of
+/// the kernel for the same number of features.
+///
+template<class InputType = RealVector>
+class NystroemTrainer : public AbstractUnsupervisedTrainer<NystroemFeatures<InputType> >
+{
+public:
+	typedef AbstractKernelFunction<InputType> KernelType;
+
+	/// \brief Constructor
+	///
+	/// \param kernel the kernel to approximate
+	/// \param landmarks number of landmarks
+	/// \param useKMeans use k-means centroids instead of a random subset
+	/// \param kMeansIterations maximum number of k-means iterations; 0: unlimited
+	NystroemTrainer(KernelType* kernel, std::size_t landmarks, bool useKMeans = false, std::size_t kMeansIterations = 20)
+	: mep_kernel(kernel), m_landmarks(landmarks), m_useKMeans(useKMeans), m_kMeansIterations(kMeansIterations){
+		SHARK_CHECK(kernel != NULL, "[NystroemTrainer] kernel must not be NULL");
+		SHARK_CHECK(landmarks > 0, "[NystroemTrainer] number of landmarks must be positive");
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "NystroemTrainer"; }
+
+	std::size_t landmarks()const{
+		return m_landmarks;
+	}
+	void setLandmarks(std::size_t landmarks){
+		m_landmarks = landmarks;
+	}
+
+	bool useKMeans()const{
+		return m_useKMeans;
+	}
+	void setUseKMeans(bool useKMeans){
+		m_useKMeans = useKMeans;
+	}
+
+	void train(NystroemFeatures<InputType>& model, UnlabeledData<InputType> const& inputs){
+		model.setStructure(mep_kernel, selectLandmarks(inputs, m_landmarks, m_useKMeans, m_kMeansIterations));
+	}
+
+private:
+	KernelType* mep_kernel;
+	std::size_t m_landmarks;
+	bool m_useKMeans;
+	std::size_t m_kMeansIterations;
+};
+
+}
+#endif
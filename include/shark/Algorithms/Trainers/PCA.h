@@ -121,10 +121,11 @@ public:
 	//! Sets the input data and performs the PCA. This is a
 	//! computationally costly operation. The eigendecomposition
 	//! of the data is stored inthe PCA object.
-	SHARK_EXPORT_SYMBOL void setData(UnlabeledData<RealVector> const& inputs);
+	SHARK_EXPORT_SYMBOL virtual void setData(UnlabeledData<RealVector> const& inputs);
 
 	//! Returns a model mapping the original data to the
 	//! m-dimensional PCA coordinate system.
+	//! m=0 uses all computed components.
 	SHARK_EXPORT_SYMBOL void encoder(LinearModel<>& model, std::size_t m = 0);
 
 	//! Returns a model mapping encoded data from the
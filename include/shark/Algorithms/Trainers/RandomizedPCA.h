@@ -0,0 +1,218 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Randomized and incremental Principal Component Analysis
+ *
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#ifndef SHARK_ALGORITHMS_TRAINER_RANDOMIZEDPCA_H
+#define SHARK_ALGORITHMS_TRAINER_RANDOMIZEDPCA_H
+
+#include <shark/Algorithms/Trainers/PCA.h>
+
+namespace shark{
+
+/*!
+ *  \brief Principal Component Analysis by randomized subspace iteration
+ *
+ *  Computes only the leading m principal components. Starting from
+ *  a random subspace of dimension m plus some oversampling, the
+ *  subspace is repeatedly multiplied with the covariance matrix and
+ *  orthonormalized (block power iteration, Halko, Martinsson and Tropp 2011).
+ *  The components are then read off the projection of the
+ *  covariance matrix onto the final subspace.
+ *
+ *  The covariance matrix is never formed. Every multiplication is a
+ *  single pass over the batches of the data, computed in parallel, so
+ *  the cost is \f$ \mathcal{O}(\ell n (m+p)) \f$ per iteration instead of the
+ *  \f$ \mathcal{O}(\ell n^2 + n^3) \f$ of the PCA trainer. The more
+ *  iterations are used, the more accurate are the components, in particular
+ *  if the spectrum decays slowly.
+ *
+ *  The encoder and decoder are the same as for the PCA.
+ */
+class RandomizedPCA : public PCA
+{
+public:
+	/// Constructor.
+	///
+	/// \param components number of principal components to compute
+	/// \param whitening whether the encoded data has unit variance along the new coordinates
+	/// \param iterations number of power iterations
+	/// \param oversampling number of additional directions of the random subspace
+	RandomizedPCA(std::size_t components, bool whitening = false, std::size_t iterations = 2, std::size_t oversampling = 10)
+	: PCA(whitening), m_components(components), m_iterations(iterations), m_oversampling(oversampling){
+		SHARK_CHECK(components > 0, "[RandomizedPCA] number of components must be positive");
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "RandomizedPCA"; }
+
+	std::size_t components()const{
+		return m_components;
+	}
+	void setComponents(std::size_t components){
+		SHARK_CHECK(components > 0, "[RandomizedPCA] number of components must be positive");
+		m_components = components;
+	}
+
+	std::size_t iterations()const{
+		return m_iterations;
+	}
+	void setIterations(std::size_t iterations){
+		m_iterations = iterations;
+	}
+
+	std::size_t oversampling()const{
+		return m_oversampling;
+	}
+	void setOversampling(std::size_t oversampling){
+		m_oversampling = oversampling;
+	}
+
+	/// Train the model to perform PCA. The output dimension of the
+	/// model defines the number of components computed; if it is 0,
+	/// components() is used.
+	void train(LinearModel<>& model, UnlabeledData<RealVector> const& inputs) {
+		if(model.outputSize() != 0)
+			m_components = model.outputSize();
+		setData(inputs);
+		encoder(model, m_eigenvectors.size2());
+	}
+
+	//! Computes the leading principal components of the data.
+	//! Afterwards, eigenvalues() and eigenvectors() hold
+	//! min(components(), n, l) components.
+	SHARK_EXPORT_SYMBOL void setData(UnlabeledData<RealVector> const& inputs);
+
+protected:
+	std::size_t m_components;   ///< number of components to compute
+	std::size_t m_iterations;   ///< number of power iterations
+	std::size_t m_oversampling; ///< additional dimensions of the subspace
+};
+
+/*!
+ *  \brief Incremental Principal Component Analysis
+ *
+ *  Keeps the leading m principal components of all data seen so far
+ *  and updates them from arriving batches (Ross, Lim, Lin and Yang 2008).
+ *  The current components are represented by the scaled directions
+ *  \f$ \Sigma V^T \f$ of the centered data. A new batch \f$ B \f$ with
+ *  b points is stacked below them together with one row correcting for the
+ *  shift of the mean, and the leading m directions of this
+ *  \f$ (m+b+1) \times n \f$ matrix are computed from its small Gram matrix.
+ *
+ *  Only the components and the mean are stored, so the memory is
+ *  \f$ \mathcal{O}(nm) \f$ and each update costs \f$ \mathcal{O}(n(m+b)^2) \f$,
+ *  independent of the number of points seen before. The result is exact
+ *  as long as the data lies in an m-dimensional affine subspace, otherwise
+ *  it is an approximation of the PCA that is better the faster the
+ *  spectrum decays.
+ *
+ *  The encoder and decoder are the same as for the PCA.
+ */
+class IncrementalPCA : public PCA
+{
+public:
+	/// Constructor.
+	///
+	/// \param components number of principal components to keep
+	/// \param whitening whether the encoded data has unit variance along the new coordinates
+	IncrementalPCA(std::size_t components, bool whitening = false)
+	: PCA(whitening), m_components(components){
+		SHARK_CHECK(components > 0, "[IncrementalPCA] number of components must be positive");
+		reset();
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "IncrementalPCA"; }
+
+	std::size_t components()const{
+		return m_components;
+	}
+	/// Sets the number of components. Only allowed before the first update.
+	void setComponents(std::size_t components){
+		SHARK_CHECK(components > 0, "[IncrementalPCA] number of components must be positive");
+		SHARK_CHECK(m_l == 0, "[IncrementalPCA] number of components can not be changed after an update");
+		m_components = components;
+	}
+
+	/// Train the model to perform PCA. The output dimension of the
+	/// model defines the number of components computed; if it is 0,
+	/// components() is used.
+	void train(LinearModel<>& model, UnlabeledData<RealVector> const& inputs) {
+		if(model.outputSize() != 0)
+			m_components = model.outputSize();
+		setData(inputs);
+		encoder(model, m_eigenvectors.size2());
+	}
+
+	/// Forgets all data seen so far.
+	void reset(){
+		m_l = 0;
+		m_n = 0;
+		m_mean.resize(0);
+		m_eigenvalues.resize(0);
+		m_eigenvectors.resize(0,0);
+	}
+
+	/// Number of points seen since the last reset.
+	std::size_t numberOfPoints()const{
+		return m_l;
+	}
+
+	//! Updates the components with a batch of points, one point per row.
+	SHARK_EXPORT_SYMBOL void update(RealMatrix const& batch);
+
+	//! Updates the components with all batches of the dataset.
+	void update(UnlabeledData<RealVector> const& inputs){
+		for(std::size_t b = 0; b != inputs.numberOfBatches(); ++b)
+			update(inputs.batch(b));
+	}
+
+	//! Computes the components of the data by streaming over its batches.
+	//! Afterwards, eigenvalues() and eigenvectors() hold
+	//! min(components(), n, l) components.
+	void setData(UnlabeledData<RealVector> const& inputs){
+		SHARK_CHECK(inputs.numberOfElements() >= 2, "[IncrementalPCA::setData] input needs to contain at least two points");
+		reset();
+		update(inputs);
+	}
+
+protected:
+	std::size_t m_components;   ///< number of components to keep
+};
+
+}
+#endif
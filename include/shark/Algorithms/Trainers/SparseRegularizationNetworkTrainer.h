@@ -0,0 +1,201 @@
+//===========================================================================
+/*!
+ * 
+ *
+ * \brief       Trainer for a sparse Regularization Network or Gaussian Process using inducing points
+ * 
+ * 
+ * 
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ * 
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ * 
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published 
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#ifndef SHARK_ALGORITHMS_SPARSEREGULARIZATIONNETWORKTRAINER_H
+#define SHARK_ALGORITHMS_SPARSEREGULARIZATIONNETWORKTRAINER_H
+
+
+#include <shark/Algorithms/Trainers/AbstractSvmTrainer.h>
+#include <shark/Algorithms/Trainers/NystroemTrainer.h>
+#include <shark/Models/Kernels/KernelHelpers.h>
+#include <shark/LinAlg/solveSystem.h>
+
+
+namespace shark {
+
+
+///
+/// \brief Training of a regularization network restricted to a set of inducing points.
+///
+/// The RegularizationNetworkTrainer solves an N x N system and thus needs
+/// \f$ O(N^3) \f$ time and \f$ O(N^2) \f$ memory. This trainer instead restricts
+/// the solution to the span of the kernel functions centered on m inducing points
+/// \f$ z_1,\dots,z_m \f$ with \f$ m \ll N \f$ (subset of regressors approximation):
+/// \f[
+///     f(x) = \sum_{j=1}^m \alpha_j k(x, z_j)
+/// \f]
+/// Minimizing the regularized squared loss over this span gives
+/// \f[
+///     (\sigma_n^2 K_{mm} + K_{mn} K_{nm}) \alpha = K_{mn} y,
+/// \f]
+/// where \f$ K_{mm} \f$ is the kernel matrix of the inducing points and \f$ K_{nm} \f$
+/// the kernel matrix between the training inputs and the inducing points. The cost
+/// of training is \f$ O(N m^2) \f$ time and \f$ O(N m) \f$ memory. The predictive mean
+/// coincides with the one of the sparse Gaussian process approximations SoR and DTC,
+/// see
+///
+/// J. Quinonero-Candela & C.E. Rasmussen, A Unifying View of Sparse Approximate
+/// Gaussian Process Regression, JMLR 6, 2005
+///
+/// The inducing points are either given explicitly via setInducingPoints or chosen
+/// from the training inputs as a random subset or k-means centroids, see selectLandmarks.
+/// If m equals the number of training points and the inducing points are the training
+/// inputs, the solution coincides with the one of the RegularizationNetworkTrainer.
+///
+/// The hyperparameters can be chosen by minimizing the NegativeSparseGaussianProcessEvidence
+/// using the same inducing points.
+template <class InputType>
+class SparseRegularizationNetworkTrainer : public AbstractSvmTrainer<InputType, RealVector,KernelExpansion<InputType> >
+{
+public:
+	typedef AbstractModel<InputType, RealVector> ModelType;
+	typedef AbstractKernelFunction<InputType> KernelType;
+	typedef AbstractSvmTrainer<InputType, RealVector, KernelExpansion<InputType> > base_type;
+
+	/// \param kernel Kernel
+	/// \param betaInv Inverse precision, equal to assumed noise variance, equal to inverse regularization parameter C 
+	/// \param inducingPoints number of inducing points chosen from the training data
+	/// \param useKMeans use k-means centroids instead of a random subset as inducing points
+	/// \param unconstrained Indicates exponential encoding of the regularization parameter 
+	SparseRegularizationNetworkTrainer(
+		KernelType* kernel, double betaInv, std::size_t inducingPoints,
+		bool useKMeans = false, bool unconstrained = false
+	)
+	: base_type(kernel, 1.0 / betaInv, false, unconstrained)
+	, m_numberOfInducingPoints(inducingPoints)
+	, m_useKMeans(useKMeans)
+	, m_fixedInducingPoints(false)
+	{
+		SHARK_CHECK(inducingPoints > 0, "[SparseRegularizationNetworkTrainer] number of inducing points must be positive");
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "SparseRegularizationNetworkTrainer"; }
+
+	/// \brief Returns the assumed noise variance (i.e., 1/C) 
+	double noiseVariance() const
+	{ return 1.0 / this->C(); }
+	/// \brief Sets the assumed noise variance (i.e., 1/C) 
+	void setNoiseVariance(double betaInv)
+	{ this->C() = 1.0 / betaInv; }
+
+	/// \brief Returns the precision (i.e., C), the inverse of the assumed noise variance 
+	double precision() const
+	{ return this->C(); }
+	/// \brief Sets the precision (i.e., C), the inverse of the assumed noise variance 
+	void setPrecision(double beta)
+	{ this->C() = beta; }
+
+	/// \brief Returns the number of inducing points chosen from the training data.
+	std::size_t numberOfInducingPoints()const{
+		return m_numberOfInducingPoints;
+	}
+	/// \brief Sets the number of inducing points and discards fixed inducing points.
+	void setNumberOfInducingPoints(std::size_t inducingPoints){
+		SHARK_CHECK(inducingPoints > 0, "[SparseRegularizationNetworkTrainer] number of inducing points must be positive");
+		m_numberOfInducingPoints = inducingPoints;
+		m_fixedInducingPoints = false;
+	}
+
+	/// \brief Returns whether inducing points are chosen by k-means.
+	bool useKMeans()const{
+		return m_useKMeans;
+	}
+	void setUseKMeans(bool useKMeans){
+		m_useKMeans = useKMeans;
+	}
+
+	/// \brief Returns the inducing points used in the last call to train or set by setInducingPoints.
+	Data<InputType> const& inducingPoints()const{
+		return m_inducingPoints;
+	}
+	/// \brief Fixes the inducing points instead of choosing them from the training data.
+	///
+	/// This is needed to train with the inducing points used in the evidence.
+	void setInducingPoints(Data<InputType> const& inducingPoints){
+		SHARK_CHECK(inducingPoints.numberOfElements() > 0, "[SparseRegularizationNetworkTrainer] no inducing points given");
+		m_inducingPoints = inducingPoints;
+		m_fixedInducingPoints = true;
+		m_numberOfInducingPoints = inducingPoints.numberOfElements();
+	}
+
+	void train(KernelExpansion<InputType>& svm, const LabeledData<InputType, RealVector>& dataset)
+	{
+		if(!m_fixedInducingPoints)
+			m_inducingPoints = selectLandmarks(dataset.inputs(), m_numberOfInducingPoints, m_useKMeans);
+		std::size_t m = m_inducingPoints.numberOfElements();
+		KernelType const& kernel = *(this->m_kernel);
+		
+		// K_nm and the system matrix A = sigma^2 K_mm + K_mn K_nm
+		RealMatrix Knm = calculateMixedKernelMatrix(kernel, dataset.inputs(), m_inducingPoints);
+		RealMatrix A = calculateRegularizedKernelMatrix(kernel, m_inducingPoints, inducingPointJitter);
+		A *= noiseVariance();
+		symm_prod(trans(Knm), A, false);
+		
+		// right hand side K_mn Y, one column per output
+		RealMatrix Y = createBatch<RealVector>(dataset.labels().elements());
+		RealMatrix alpha(m, Y.size2());
+		axpy_prod(trans(Knm), Y, alpha);
+		blas::solveSymmPosDefSystemInPlace<blas::SolveAXB>(A, alpha);
+		
+		svm.setStructure(base_type::m_kernel, m_inducingPoints, false, Y.size2());
+		noalias(svm.alpha()) = alpha;
+	}
+
+	/// \brief Regularizer added to the diagonal of the kernel matrix of the inducing points.
+	///
+	/// This keeps the systems positive definite when inducing points (nearly) coincide.
+	static const double inducingPointJitter;
+
+private:
+	std::size_t m_numberOfInducingPoints;
+	bool m_useKMeans;
+	bool m_fixedInducingPoints;
+	Data<InputType> m_inducingPoints;
+};
+
+template <class InputType>
+const double SparseRegularizationNetworkTrainer<InputType>::inducingPointJitter = 1.e-6;
+
+
+// A sparse regularization network can be interpreted as a sparse Gaussian
+// process, with the same trainer:
+#define SparseGaussianProcessTrainer SparseRegularizationNetworkTrainer
+
+
+}
+#endif
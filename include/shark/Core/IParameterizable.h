@@ -66,6 +66,38 @@ public:
 	virtual std::size_t numberOfParameters() const {
 		return parameterVector().size();
 	}
+
+	/// \brief Returns whether the parameters are stored in one contiguous vector.
+	///
+	/// In this case parameterStorage() gives direct access to the parameters
+	/// and changing the vector changes the parameters without the copies
+	/// done by parameterVector() and setParameterVector().
+	virtual bool hasParameterStorage() const {
+		return false;
+	}
+
+	/// \brief Returns the vector storing the parameters, if hasParameterStorage() is true.
+	///
+	/// The vector must not be resized.
+	virtual RealVector& parameterStorage(){
+		throw SHARKEXCEPTION("[IParameterizable::parameterStorage] parameters are not stored in a single vector");
+	}
+
+	/// \brief Returns the vector storing the parameters, if hasParameterStorage() is true.
+	virtual RealVector const& parameterStorage() const{
+		throw SHARKEXCEPTION("[IParameterizable::parameterStorage] parameters are not stored in a single vector");
+	}
+
+	/// \brief Sets the parameters like setParameterVector.
+	///
+	/// Nothing is copied if newParameters is the vector returned by parameterStorage().
+	/// This way code that updates parameterStorage() in place can pass it to objective
+	/// functions, which set the parameters of their model in every evaluation.
+	void assignParameterVector(RealVector const& newParameters){
+		if(hasParameterStorage() && &parameterStorage() == &newParameters)
+			return;
+		setParameterVector(newParameters);
+	}
 };
 
 
@@ -63,4 +63,43 @@ for
 #define SHARK_THREAD_NUM (std::size_t)0
 #endif
 
+#include <vector>
+
+namespace shark{
+
+/// \brief Calls f(block, begin, end) in parallel for every block of the ranges [bounds[block], bounds[block+1]).
+///
+/// A single block is processed by the calling thread without starting a parallel region.
+template<class Functor>
+void parallelBlocks(std::vector<std::size_t> const& bounds, Functor const& f){
+	std::size_t numBlocks = bounds.size() - 1;
+	if(numBlocks == 1){
+		f(std::size_t(0), bounds[0], bounds[1]);
+		return;
+	}
+	SHARK_PARALLEL_FOR(int bi = 0; bi < (int)numBlocks; ++bi){//MSVC does not support unsigned integrals in parallel loops
+		std::size_t b = bi;
+		f(b, bounds[b], bounds[b+1]);
+	}
+}
+
+/// \brief Splits [0,size) into numBlocks contiguous blocks, whose sizes differ by at most one,
+/// and calls f(block, begin, end) in parallel for every block.
+///
+/// Usually there is one block per thread, so that every thread can use its own
+/// temporary storage indexed by the block.
+template<class Functor>
+void parallelBlocks(std::size_t size, std::size_t numBlocks, Functor const& f){
+	if(numBlocks == 1){
+		f(std::size_t(0), std::size_t(0), size);
+		return;
+	}
+	SHARK_PARALLEL_FOR(int bi = 0; bi < (int)numBlocks; ++bi){//MSVC does not support unsigned integrals in parallel loops
+		std::size_t b = bi;
+		f(b, b*size/numBlocks, (b+1)*size/numBlocks);
+	}
+}
+
+}
+
 #endif
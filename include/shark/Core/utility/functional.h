@@ -39,6 +39,8 @@
 #include <shark/Core/utility/Iterators.h>
 #include <algorithm>
 #include <shark/Rng/GlobalRng.h>
+#include <shark/Core/OpenMP.h>
+#include <vector>
 namespace shark{
 	
 ///\brief random_shuffle algorithm which stops after acquiring the random subsequence for [begin,middle)
@@ -140,5 +142,36 @@ typename boost::range_iterator<Range>::type partitionEqually(Range const& rangeA
 	Range adaptorCopy(rangeAdaptor);
 	return partitionEqually(adaptorCopy);
 }
+
+/// \brief Sorts a range in ascending order using all available threads.
+///
+/// The range is split into one block per thread, the blocks are sorted in parallel
+/// and then merged pairwise, again in parallel. Without OpenMP this is std::sort.
+template<class RandomAccessIterator>
+void parallel_sort(RandomAccessIterator begin, RandomAccessIterator end){
+	std::size_t size = end - begin;
+	std::size_t numBlocks = std::min(SHARK_NUM_THREADS, size/1024+1);
+	if(numBlocks <= 1){
+		std::sort(begin,end);
+		return;
+	}
+	//block b is [bounds[b],bounds[b+1])
+	std::vector<std::size_t> bounds(numBlocks+1);
+	for(std::size_t b = 0; b <= numBlocks; ++b)
+		bounds[b] = b * size / numBlocks;
+	SHARK_PARALLEL_FOR(int b = 0; b < (int)numBlocks; ++b){
+		std::sort(begin+bounds[b],begin+bounds[b+1]);
+	}
+	//merge neighbouring blocks until only one is left
+	for(std::size_t width = 1; width < numBlocks; width *= 2){
+		int numMerges = (int)((numBlocks + 2*width - 1) / (2*width));
+		SHARK_PARALLEL_FOR(int m = 0; m < numMerges; ++m){
+			std::size_t first = 2 * width * m;
+			std::size_t middle = std::min(first + width, numBlocks);
+			std::size_t last = std::min(first + 2 * width, numBlocks);
+			std::inplace_merge(begin+bounds[first],begin+bounds[middle],begin+bounds[last]);
+		}
+	}
+}
 }
 #endif
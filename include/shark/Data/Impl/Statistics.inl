@@ -1,10 +1,124 @@
 namespace shark{ 
+
+inline void StatisticsAccumulator::reset(){
+	m_count = 0;
+	m_mean.resize(0);
+	m_squaredDeviations.resize(0);
+	m_scatter.resize(0,0);
+	m_min.resize(0);
+	m_max.resize(0);
+}
+
+namespace detail{
+/// adds the stored entries of a row to the per-batch statistics
+template<class RowT>
+void accumulateRowStatistics(
+	RowT const& row,
+	RealVector const& mean,
+	RealVector& squaredDeviations,
+	RealVector& minimum,
+	RealVector& maximum,
+	std::vector<std::size_t>& stored
+){
+	typedef typename RowT::const_iterator iterator;
+	for(iterator it = row.begin(); it != row.end(); ++it){
+		std::size_t j = it.index();
+		double x = *it;
+		squaredDeviations(j) += sqr(x - mean(j));
+		minimum(j) = std::min(minimum(j),x);
+		maximum(j) = std::max(maximum(j),x);
+		++stored[j];
+	}
+}
+}
+
+template<class MatrixT>
+void StatisticsAccumulator::addBatch(blas::matrix_expression<MatrixT> const& batch){
+	std::size_t batchSize = batch().size1();
+	std::size_t dim = batch().size2();
+	if(batchSize == 0) return;
+	SIZE_CHECK(m_count == 0 || dim == dimension());
+
+	//statistics of the batch around its own mean
+	StatisticsAccumulator batchStatistics(m_computeCovariance);
+	batchStatistics.m_count = batchSize;
+	batchStatistics.m_mean = sum_rows(batch())/double(batchSize);
+	batchStatistics.m_squaredDeviations = blas::repeat(0.0,dim);
+	batchStatistics.m_min = blas::repeat(std::numeric_limits<double>::max(),dim);
+	batchStatistics.m_max = blas::repeat(-std::numeric_limits<double>::max(),dim);
+	std::vector<std::size_t> stored(dim,0);
+	for(std::size_t i = 0; i != batchSize; ++i){
+		detail::accumulateRowStatistics(
+			row(batch(),i), batchStatistics.m_mean,
+			batchStatistics.m_squaredDeviations,
+			batchStatistics.m_min, batchStatistics.m_max, stored
+		);
+	}
+	//entries not stored in sparse rows are zero
+	for(std::size_t j = 0; j != dim; ++j){
+		std::size_t zeros = batchSize - stored[j];
+		if(zeros == 0) continue;
+		batchStatistics.m_squaredDeviations(j) += zeros * sqr(batchStatistics.m_mean(j));
+		batchStatistics.m_min(j) = std::min(batchStatistics.m_min(j),0.0);
+		batchStatistics.m_max(j) = std::max(batchStatistics.m_max(j),0.0);
+	}
+	if(m_computeCovariance){
+		RealMatrix centered = batch() - repeat(batchStatistics.m_mean,batchSize);
+		batchStatistics.m_scatter.resize(dim,dim);
+		symm_prod(trans(centered),batchStatistics.m_scatter);
+	}
+	merge(batchStatistics);
+}
+
+inline void StatisticsAccumulator::merge(StatisticsAccumulator const& other){
+	SHARK_CHECK(!m_computeCovariance || other.m_computeCovariance, "[StatisticsAccumulator::merge] other accumulator has no covariance");
+	if(other.m_count == 0) return;
+	if(m_count == 0){
+		bool computeCovariance = m_computeCovariance;
+		*this = other;
+		m_computeCovariance = computeCovariance;
+		if(!m_computeCovariance)
+			m_scatter.resize(0,0);
+		return;
+	}
+	SIZE_CHECK(other.dimension() == dimension());
+	
+	double total = double(m_count + other.m_count);
+	double weight = double(m_count) * other.m_count / total;
+	RealVector delta = other.m_mean - m_mean;
+	noalias(m_squaredDeviations) += other.m_squaredDeviations + weight * sqr(delta);
+	if(m_computeCovariance){
+		noalias(m_scatter) += other.m_scatter + weight * outer_prod(delta,delta);
+	}
+	noalias(m_mean) += (other.m_count / total) * delta;
+	noalias(m_min) = blas::min(m_min,other.m_min);
+	noalias(m_max) = blas::max(m_max,other.m_max);
+	m_count += other.m_count;
+}
+
+template<class VectorType>
+void StatisticsAccumulator::addData(Data<VectorType> const& data){
+	std::size_t numBatches = data.numberOfBatches();
+	if(numBatches == 0) return;
+	std::size_t numThreads = std::min(SHARK_NUM_THREADS,numBatches);
+	std::vector<StatisticsAccumulator> threadStatistics(numThreads,StatisticsAccumulator(m_computeCovariance));
+	parallelBlocks(numBatches, numThreads, [&](std::size_t t, std::size_t start, std::size_t end){
+		for(std::size_t b = start; b != end; ++b){
+			threadStatistics[t].addBatch(data.batch(b));
+		}
+	});
+	//merge in a fixed order so that the result does not depend on the scheduling
+	for(std::size_t t = 0; t != numThreads; ++t){
+		merge(threadStatistics[t]);
+	}
+}
 	
 /*!
  *  \brief Calculates the mean and variance values of a dataset
  *
  *  Given the vector of data, the mean and variance values
  *  are calculated as in the functions #mean and #variance.
+ *  The data is traversed only once, see StatisticsAccumulator.
  *
  *      \param  data Input data.
  *      \param  meanVec Vector of mean values.
@@ -20,21 +134,10 @@ void meanvar
 )
 {
 	SIZE_CHECK(!data.empty());
-	typedef typename Data<Vec1T>::const_batch_reference BatchRef;
-	std::size_t const dataSize = data.numberOfElements();
-	std::size_t elementSize=dataDimension(data);
-
-	varianceVec().resize(elementSize);
-	varianceVec().clear();
-	
-	meanVec()= mean(data);
-	
-	//sum of variances of each column
-	BOOST_FOREACH(BatchRef batch,data.batches()){
-		std::size_t batchSize = batch.size1();
-		noalias(varianceVec()) += sum_rows(sqr(batch-repeat(meanVec,batchSize)));
-	}
-	varianceVec()/=dataSize;
+	StatisticsAccumulator statistics;
+	statistics.addData(data);
+	meanVec() = statistics.mean();
+	varianceVec() = statistics.variance();
 }
 
 /*!
@@ -42,6 +145,7 @@ void meanvar
  *
  *  Given the vector of data, the mean and variance values
  *  are calculated as in the functions #mean and #variance.
+ *  The data is traversed only once, see StatisticsAccumulator.
  *
  *      \param  data Input data.
  *      \param  meanVec Vector of mean values.
@@ -56,21 +160,10 @@ void meanvar
 	blas::matrix_container<MatT>& covariance
 ){
 	SIZE_CHECK(!data.empty());
-	typedef typename Batch<Vec1T>::type BatchType;
-	std::size_t const dataSize = data.numberOfElements();
-	std::size_t elementSize=dataDimension(data);
-
-	covariance().resize(elementSize,elementSize);
-	covariance().clear();
-	
-	meanVec() = mean(data);
-	//sum of variances of each column
-	for(std::size_t b = 0; b != data.numberOfBatches(); ++b){
-		//make the batch mean-free
-		BatchType batch = data.batch(b)-repeat(meanVec,data.batch(b).size1());
-		symm_prod(trans(batch),covariance,false);
-	}
-	covariance()/=dataSize;
+	StatisticsAccumulator statistics(true);
+	statistics.addData(data);
+	meanVec() = statistics.mean();
+	covariance() = statistics.covariance();
 }
 
 /*!
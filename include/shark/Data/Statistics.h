@@ -35,6 +35,7 @@
 #define SHARK_DATA_STATISTICS_H
 
 #include <shark/Data/Dataset.h>
+#include <shark/Core/OpenMP.h>
 
 /**
 * \ingroup shark_globals
@@ -43,6 +44,90 @@
 */
 
 namespace shark{
+
+/// \brief Accumulates count, mean, variance, covariance, minimum and maximum of a set of vectors
+///
+/// All statistics are obtained in a single pass over the data. The moments of
+/// every batch are computed around the mean of the batch and then merged into
+/// the running statistics (Chan, Golub and LeVeque 1979), which avoids the
+/// cancellation of the naive sum-of-squares formula. Accumulators can also be
+/// merged, which is used by addData to process the batches of a dataset in parallel.
+///
+/// Batches can be dense or sparse. For sparse batches only the stored entries are
+/// visited when computing mean, variance, minimum and maximum. The covariance matrix
+/// is dense and only computed when requested in the constructor.
+/// The variances are normalized by the number of points, as in meanvar.
+class StatisticsAccumulator{
+public:
+	/// \brief Constructor.
+	///
+	/// \param computeCovariance whether the full covariance matrix is accumulated as well
+	StatisticsAccumulator(bool computeCovariance = false)
+	: m_computeCovariance(computeCovariance){
+		reset();
+	}
+
+	/// Returns whether the covariance matrix is accumulated.
+	bool computesCovariance()const{
+		return m_computeCovariance;
+	}
+
+	/// Forgets all points seen so far.
+	void reset();
+
+	/// Adds a batch of points, stored as the rows of the matrix.
+	template<class MatrixT>
+	void addBatch(blas::matrix_expression<MatrixT> const& batch);
+
+	/// Adds all points of the dataset. The batches are processed in parallel.
+	template<class VectorType>
+	void addData(Data<VectorType> const& data);
+
+	/// Adds the points accumulated in another accumulator.
+	void merge(StatisticsAccumulator const& other);
+
+	/// Number of points seen.
+	std::size_t count()const{
+		return m_count;
+	}
+	/// Dimensionality of the points, 0 if no point was seen.
+	std::size_t dimension()const{
+		return m_mean.size();
+	}
+
+	/// Mean of the points.
+	RealVector const& mean()const{
+		return m_mean;
+	}
+	/// Variance of every component.
+	RealVector variance()const{
+		SHARK_CHECK(m_count > 0, "[StatisticsAccumulator::variance] no points accumulated");
+		return m_squaredDeviations / double(m_count);
+	}
+	/// Covariance matrix of the points.
+	RealMatrix covariance()const{
+		SHARK_CHECK(m_computeCovariance, "[StatisticsAccumulator::covariance] covariance was not accumulated");
+		SHARK_CHECK(m_count > 0, "[StatisticsAccumulator::covariance] no points accumulated");
+		return m_scatter / double(m_count);
+	}
+	/// Componentwise minimum of the points.
+	RealVector const& min()const{
+		return m_min;
+	}
+	/// Componentwise maximum of the points.
+	RealVector const& max()const{
+		return m_max;
+	}
+
+private:
+	bool m_computeCovariance;
+	std::size_t m_count;
+	RealVector m_mean;
+	RealVector m_squaredDeviations; ///< sum of squared deviations from the mean
+	RealMatrix m_scatter;           ///< sum of outer products of deviations from the mean
+	RealVector m_min;
+	RealVector m_max;
+};
 	
 //! Calculates the mean and variance values of the input data
 template<class Vec1T,class Vec2T,class Vec3T>
@@ -4,7 +4,9 @@
 #include <boost/math/constants/constants.hpp>
 #include <boost/math/special_functions/atanh.hpp>
 #include <boost/type_traits/remove_reference.hpp> 
+#include <boost/mpl/has_xxx.hpp>
 #include "traits.hpp"
+#include "vectorized_math.hpp"
 #include <shark/Core/Exception.h>
 #include <shark/Core/Math.h>
 
@@ -21,6 +23,12 @@ template<class T>
 T minExpInput() {
 	return boost::math::constants::ln_two<T>()*std::numeric_limits<T>::min_exponent;
 }
+
+/// \brief Is true for functors which mark themselves by the nested type vectorizable.
+///
+/// Dense assignment evaluates the argument of such a functor blockwise into a small buffer
+/// and applies the functor in a tight loop over the buffer, which the compiler can vectorize.
+BOOST_MPL_HAS_XXX_TRAIT_DEF(vectorizable)
 }
 
 // Scalar functors
@@ -276,9 +284,15 @@ struct scalar_exp {
 	typedef argument_type result_type;
 	static const bool zero_identity = false;
 
+	typedef void vectorizable;
+
 	result_type operator()(argument_type x)const {
+#ifdef SHARK_USE_VECTORIZED_MATH
+		return detail::vectorized::exp(x);
+#else
 		using std::exp;
 		return exp(x);
+#endif
 	}
 };
 
@@ -312,9 +326,15 @@ struct scalar_log {
 	typedef argument_type result_type;
 	static const bool zero_identity = false;
 
+	typedef void vectorizable;
+
 	result_type operator()(argument_type x)const {
+#ifdef SHARK_USE_VECTORIZED_MATH
+		return detail::vectorized::log(x);
+#else
 		using std::log;
 		return log(x);
+#endif
 	}
 };
 
@@ -339,9 +359,15 @@ struct scalar_tanh{
 	typedef argument_type result_type;
 	static const bool zero_identity = true;
 
+	typedef void vectorizable;
+
 	result_type operator()(argument_type x)const {
+#ifdef SHARK_USE_VECTORIZED_MATH
+		return detail::vectorized::tanh(x);
+#else
 		using std::tanh;
 		return tanh(x);
+#endif
 	}
 };
 
@@ -362,8 +388,16 @@ struct scalar_soft_plus {
 	typedef argument_type result_type;
 	static const bool zero_identity = false;
 
+	typedef void vectorizable;
+
 	result_type operator()(argument_type x)const {
-		return shark::softPlus(x);
+#ifdef SHARK_USE_VECTORIZED_MATH
+		return detail::vectorized::softPlus(x);
+#else
+		using std::log1p;
+		using std::exp;
+		return x > 0? x + log1p(exp(-x)) : log1p(exp(x));
+#endif
 	}
 };
 
@@ -373,8 +407,14 @@ struct scalar_sigmoid {
 	typedef argument_type result_type;
 	static const bool zero_identity = false;
 
+	typedef void vectorizable;
+
 	result_type operator()(argument_type x)const {
+#ifdef SHARK_USE_VECTORIZED_MATH
+		return detail::vectorized::sigmoid(x);
+#else
 		return shark::sigmoid(x);
+#endif
 	}
 };
 
@@ -691,7 +731,7 @@ private:
 		}
 		//apply final operator f(0,v)
 		if(nnz != v.size())
-			result = m_functor(result,*iter);
+			result = m_functor(result,typename E::value_type());
 		return result;
 	}
 	functor_type m_functor;
@@ -0,0 +1,226 @@
+#ifndef SHARK_LINALG_BLAS_DETAIL_VECTORIZED_MATH_HPP
+#define SHARK_LINALG_BLAS_DETAIL_VECTORIZED_MATH_HPP
+
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+//The kernels below are only faster than the C library when the compiler vectorizes them,
+//which on x86 requires AVX2 for the 64 bit integer and select operations. Otherwise the
+//blas functors keep using the standard library.
+#if defined(__AVX2__) && !defined(SHARK_NO_VECTORIZED_MATH)
+#define SHARK_USE_VECTORIZED_MATH
+#endif
+
+namespace shark {
+namespace blas {
+namespace detail {
+
+///\brief Branch-free implementations of exp, log, tanh, sigmoid and softPlus.
+///
+///The functions only use arithmetic, comparisons which can be turned into selects and integer
+///operations on the bit pattern of the argument. Thus a loop applying them to a contiguous range
+///of values is vectorized by the compiler, which is not possible for calls to the C library.
+///The double versions are accurate to a few ulp over the whole range of inputs, including
+///infinities, NaN and subnormal numbers. The float versions compute in double precision and round the result.
+///Other types are forwarded to the standard library.
+namespace vectorized {
+
+inline boost::uint64_t toBits(double x){
+	boost::uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(double));
+	return bits;
+}
+inline double fromBits(boost::uint64_t bits){
+	double x;
+	std::memcpy(&x, &bits, sizeof(double));
+	return x;
+}
+
+///\brief Returns condition? a : b.
+///
+///The selection is done on the bit patterns. Written as conditional expression, the compiler
+///specializes the following arithmetic for both cases and the loop can no longer be vectorized.
+inline double select(bool condition, double a, double b){
+	boost::uint64_t mask = boost::uint64_t(0) - boost::uint64_t(condition);
+	return fromBits((toBits(a) & mask) | (toBits(b) & ~mask));
+}
+
+///\brief Returns 2^k for an integer k in [-1022,1023] stored in the two's complement bits k.
+inline double exp2Integer(boost::uint64_t k){
+	return fromBits((k + 1023) << 52);
+}
+
+//x = k*ln(2)+r with |r| <= ln(2)/2 and integer k. Adding 1.5*2^52 rounds to an integer
+//which ends up in the low bits of the mantissa, from where it can be read without a conversion instruction
+struct ExpReduction{
+	double r;
+	boost::uint64_t k;
+	double kd;
+	ExpReduction(double x){
+		double const log2e = 1.4426950408889634074;
+		double const ln2hi = 6.93147180369123816490e-01;//ln(2) with enough trailing zeros that k*ln2hi is exact
+		double const ln2lo = 1.90821492927058770002e-10;
+		double const shift = 6755399441055744.0;
+		double shifted = x * log2e + shift;
+		kd = shifted - shift;
+		k = toBits(shifted) - toBits(shift);
+		r = (x - kd * ln2hi) - kd * ln2lo;
+	}
+};
+
+///\brief Computes exp(r)-1 for |r| <= ln(2)/2 using its taylor series.
+inline double expm1Reduced(double r){
+	double p = 1.0/6227020800.0;
+	p = p * r + 1.0/479001600.0;
+	p = p * r + 1.0/39916800.0;
+	p = p * r + 1.0/3628800.0;
+	p = p * r + 1.0/362880.0;
+	p = p * r + 1.0/40320.0;
+	p = p * r + 1.0/5040.0;
+	p = p * r + 1.0/720.0;
+	p = p * r + 1.0/120.0;
+	p = p * r + 1.0/24.0;
+	p = p * r + 1.0/6.0;
+	p = p * r + 0.5;
+	p = p * r + 1.0;
+	return p * r;
+}
+
+template<class T>
+T exp(T x){
+	using std::exp;
+	return exp(x);
+}
+inline double exp(double x){
+	//outside of these bounds the result is 0 or infinity
+	x = select(x > 710.0, 710.0, x);
+	x = select(x < -746.0, -746.0, x);
+	ExpReduction reduction(x);
+	double p = 1.0 + expm1Reduced(reduction.r);
+	//k can be as large as 1025 in absolute value so we split 2^k into two normalized factors
+	double const shift = 6755399441055744.0;
+	boost::uint64_t kh = toBits(reduction.kd * 0.5 + shift) - toBits(shift);
+	boost::uint64_t kl = reduction.k - kh;
+	return p * exp2Integer(kh) * exp2Integer(kl);
+}
+inline float exp(float x){
+	return float(exp(double(x)));
+}
+
+///\brief Computes exp(x)-1 for x in [-40,40], arguments outside this range are clamped.
+inline double expm1Bounded(double x){
+	x = select(x > 40.0, 40.0, x);
+	x = select(x < -40.0, -40.0, x);
+	ExpReduction reduction(x);
+	double scale = exp2Integer(reduction.k);
+	return (scale - 1.0) + scale * expm1Reduced(reduction.r);
+}
+
+template<class T>
+T log(T x){
+	using std::log;
+	return log(x);
+}
+inline double log(double x){
+	double const ln2hi = 6.93147180369123816490e-01;
+	double const ln2lo = 1.90821492927058770002e-10;
+	double const two52 = 4503599627370496.0;
+	//scale subnormal numbers into the normalized range
+	bool subnormal = x < std::numeric_limits<double>::min();
+	double xs = x * select(subnormal, 18014398509481984.0, 1.0);//2^54
+
+	//x = 2^e*m with m in [sqrt(1/2),sqrt(2)). The exponent is converted to double
+	//by placing it in the mantissa of 2^52
+	boost::uint64_t bits = toBits(xs);
+	double e = (fromBits((bits >> 52) | toBits(two52)) - two52) - 1023.0;
+	e -= select(subnormal, 54.0, 0.0);
+	double m = fromBits((bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull);
+	bool large = m > 1.4142135623730951;
+	m *= select(large, 0.5, 1.0);
+	e += select(large, 1.0, 0.0);
+
+	//log(m) = 2 atanh(s) with s=(m-1)/(m+1) and |s| < 0.172
+	double f = m - 1.0;
+	double s = f / (2.0 + f);
+	double z = s * s;
+	double p = 1.0/23.0;
+	p = p * z + 1.0/21.0;
+	p = p * z + 1.0/19.0;
+	p = p * z + 1.0/17.0;
+	p = p * z + 1.0/15.0;
+	p = p * z + 1.0/13.0;
+	p = p * z + 1.0/11.0;
+	p = p * z + 1.0/9.0;
+	p = p * z + 1.0/7.0;
+	p = p * z + 1.0/5.0;
+	p = p * z + 1.0/3.0;
+	double logm = 2.0 * s + 2.0 * s * z * p;
+	double result = e * ln2hi + (logm + e * ln2lo);
+
+	result = select(x < 0.0, std::numeric_limits<double>::quiet_NaN(), result);
+	result = select(x == 0.0, -std::numeric_limits<double>::infinity(), result);
+	result = select(x == std::numeric_limits<double>::infinity() || x != x, x, result);
+	return result;
+}
+inline float log(float x){
+	return float(log(double(x)));
+}
+
+///\brief Computes log(1+u) for u in [0,1].
+inline double log1pUnit(double u){
+	double w = 1.0 + u;
+	//the second term corrects the rounding error of 1+u
+	return log(w) - ((w - 1.0) - u) / w;
+}
+
+template<class T>
+T tanh(T x){
+	using std::tanh;
+	return tanh(x);
+}
+inline double tanh(double x){
+	//tanh(|x|) = (exp(2|x|)-1)/(exp(2|x|)+1). For |x| >= 20 the result is 1 in double precision
+	double y = 2.0 * std::abs(x);
+	double em = expm1Bounded(y);
+	double t = em / (em + 2.0);
+	return fromBits(toBits(t) | (toBits(x) & 0x8000000000000000ull));
+}
+inline float tanh(float x){
+	return float(tanh(double(x)));
+}
+
+template<class T>
+T sigmoid(T x){
+	using std::exp;
+	return T(1) / (T(1) + exp(-x));
+}
+inline double sigmoid(double x){
+	//uses exp(x)/(1+exp(x)) for negative x, so that the result does not underflow before exp(x) does
+	double e = exp(-std::abs(x));
+	double s = 1.0 / (1.0 + e);
+	return s * select(x < 0.0, e, 1.0);
+}
+inline float sigmoid(float x){
+	return float(sigmoid(double(x)));
+}
+
+template<class T>
+T softPlus(T x){
+	using std::log;
+	using std::exp;
+	return log(T(1) + exp(x));
+}
+inline double softPlus(double x){
+	//log(1+exp(x)) = max(x,0) + log(1+exp(-|x|)) which neither overflows nor loses precision for x << 0
+	double positive = select(x > 0.0, x, 0.0);
+	return positive + log1pUnit(exp(-std::abs(x)));
+}
+inline float softPlus(float x){
+	return float(softPlus(double(x)));
+}
+
+}
+}}}
+#endif
@@ -35,6 +35,11 @@ class matrix_vector_range;
 template<class M>
 class matrix_range;
 
+template<class E, class F>
+class vector_unary;
+template<class E, class F>
+class matrix_unary;
+
 
 // Sparse vectors
 template<class T, class I = std::size_t>
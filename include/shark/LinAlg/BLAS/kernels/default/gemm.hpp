@@ -34,7 +34,11 @@
 #include "../gemv.hpp"
 #include "../../matrix_proxy.hpp"
 #include "../../vector.hpp"
+#include "../../matrix_sparse.hpp"
+#include <shark/Core/OpenMP.h>
 #include <boost/mpl/bool.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace shark { namespace blas { namespace bindings {
 
@@ -56,8 +60,50 @@ namespace shark { namespace blas { namespace bindings {
 // 3.3 for B and C column major there are specialised kernels for every combination
 	
 	
+//rows of a product with dense result are independent and are computed in parallel.
+//The rows are split in one block per thread using parallelBlocks, small products are computed
+//by a single thread as starting the threads would take longer than the computation.
+inline std::size_t gemm_row_blocks(std::size_t size1, std::size_t size2){
+	if(size1*size2 < 4096) return 1;
+	return std::max<std::size_t>(1,std::min(SHARK_NUM_THREADS,size1));
+}
+
+//computes the product as a sequence of matrix-vector products over the rows of the first argument
+//dense results are computed in parallel
+template<class M, class E1, class E2>
+void gemm_rowwise(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<M>& m,
+	typename M::value_type alpha,
+	dense_tag
+) {
+	std::size_t size1 = m().size1();
+	parallelBlocks(size1, gemm_row_blocks(size1,m().size2()), [&](std::size_t, std::size_t start, std::size_t end){
+		for (std::size_t i = start; i != end; ++i) {
+			matrix_row<M> mat_row(m(),i);
+			kernels::gemv(trans(e2),row(e1,i),mat_row,alpha);
+		}
+	});
+}
+template<class M, class E1, class E2>
+void gemm_rowwise(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<M>& m,
+	typename M::value_type alpha,
+	unknown_storage_tag
+) {
+	for (std::size_t i = 0; i != e1().size1(); ++i) {
+		matrix_row<M> mat_row(m(),i);
+		kernels::gemv(trans(e2),row(e1,i),mat_row,alpha);
+	}
+}
+
 //general case: result and first argument row_major (2.)
-//=> compute as a sequence of matrix-vector products over the rows of the first argument
+//=> compute as a sequence of matrix-vector products over the rows of the first argument.
+// For sparse E1 and row_major E2 every nonzero of a row adds a row of E2 to the result, which
+// is a contiguous loop over the dense dimension if E2 is dense.
 template<class M, class E1, class E2, class Orientation2,class Tag1,class Tag2>
 void gemm_impl(
 	matrix_expression<E1> const& e1,
@@ -67,10 +113,7 @@ void gemm_impl(
 	row_major, row_major, Orientation2, 
 	Tag1, Tag2
 ) {
-	for (std::size_t i = 0; i != e1().size1(); ++i) {
-		matrix_row<M> mat_row(m(),i);
-		kernels::gemv(trans(e2),row(e1,i),mat_row,alpha);
-	}
+	gemm_rowwise(e1,e2,m,alpha,typename M::storage_category());
 }
 
 //case: sparse column_major first argument (3.1)
@@ -89,48 +132,199 @@ void gemm_impl(
 }
 
 //case: result and second argument row_major, first argument dense column major (3.2)
-//=> compute as a sequence of outer products. 
+//=> for dense results every row of the result is a linear combination of the rows of E2,
+// which is computed row by row in parallel. Otherwise compute as a sequence of outer products.
 // Note that this is likely to be slow if E2 is sparse and the result is also sparse. However choosing 
 // M as sparse is stupid in most cases.
-template<class M, class E1, class E2,class Tag>
-void gemm_impl(
+template<class M, class E1, class E2>
+void gemm_outer(
 	matrix_expression<E1> const& e1,
 	matrix_expression<E2> const& e2,
 	matrix_expression<M>& m,
 	typename M::value_type alpha,
-	row_major, column_major, row_major,
-	dense_random_access_iterator_tag, Tag
+	dense_tag
+) {
+	typedef typename M::value_type value_type;
+	std::size_t size1 = m().size1();
+	parallelBlocks(size1, gemm_row_blocks(size1,m().size2()), [&](std::size_t, std::size_t start, std::size_t end){
+		for (std::size_t i = start; i != end; ++i) {
+			matrix_row<M> mat_row(m(),i);
+			for (std::size_t j = 0; j != e1().size2(); ++j) {
+				value_type factor = alpha * e1()(i,j);
+				if(factor != value_type())
+					noalias(mat_row) += factor * row(e2,j);
+			}
+		}
+	});
+}
+template<class M, class E1, class E2>
+void gemm_outer(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<M>& m,
+	typename M::value_type alpha,
+	unknown_storage_tag
 ) {
 	for (std::size_t j = 0; j != e1().size2(); ++j) {
 		noalias(m) += alpha * outer_prod(column(e1,j),row(e2,j));
 	}
 }
 
-//special case of all row-major for sparse matrices
-template<class M, class E1, class E2>
+template<class M, class E1, class E2,class Tag>
 void gemm_impl(
 	matrix_expression<E1> const& e1,
 	matrix_expression<E2> const& e2,
 	matrix_expression<M>& m,
 	typename M::value_type alpha,
-	row_major, row_major, row_major, 
-	sparse_bidirectional_iterator_tag, sparse_bidirectional_iterator_tag
+	row_major, column_major, row_major,
+	dense_random_access_iterator_tag, Tag
 ) {
-	typedef typename M::value_type value_type;
-	value_type zero = value_type();
-	vector<value_type> temporary(e2().size2(), zero);
-	for (std::size_t i = 0; i != e1().size1(); ++i) {
-		kernels::gemv(trans(e2),row(e1,i),temporary,alpha);
-		for (std::size_t j = 0; j != temporary.size(); ++ j) {
-			if (temporary(j) != zero) {
-				m()(i, j) += temporary(j);//fixme: better use something like insert
-				temporary(j) = zero;
+	gemm_outer(e1,e2,m,alpha,typename M::storage_category());
+}
+
+//special case of all row-major for sparse matrices with sparse result
+//computes result = c + alpha * e1 * e2 in two passes: the first counts the nonzeros of every row
+//so that the storage of the result can be allocated at once. The second computes the rows using
+//a dense accumulator and writes the sorted nonzeros directly into the storage. Both passes
+//are run in parallel over blocks of rows, as rows do not share storage.
+template<class T, class I, class C, class E1, class E2>
+void sparse_prod(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<C> const& c,
+	compressed_matrix<T,I>& result,
+	T alpha
+) {
+	typedef typename C::const_row_iterator iterator;
+	typedef typename E1::const_row_iterator iterator1;
+	typedef typename E2::const_row_iterator iterator2;
+	std::size_t size1 = c().size1();
+	std::size_t size2 = c().size2();
+	std::size_t numBlocks = gemm_row_blocks(size1,e1().size2());
+	
+	//symbolic pass: number of nonzeros in every row of the result
+	std::vector<std::size_t> rowNonZeros(size1,0);
+	parallelBlocks(size1, numBlocks, [&](std::size_t, std::size_t start, std::size_t end){
+		//marker[j] = i+1 if column j was already seen in row i
+		std::vector<std::size_t> marker(size2,0);
+		for (std::size_t i = start; i != end; ++i) {
+			for(iterator it = c().row_begin(i); it != c().row_end(i); ++it){
+				marker[it.index()] = i+1;
+				++rowNonZeros[i];
+			}
+			for(iterator1 it1 = e1().row_begin(i); it1 != e1().row_end(i); ++it1){
+				std::size_t k = it1.index();
+				for(iterator2 it2 = e2().row_begin(k); it2 != e2().row_end(k); ++it2){
+					if(marker[it2.index()] != i+1){
+						marker[it2.index()] = i+1;
+						++rowNonZeros[i];
+					}
+				}
 			}
 		}
+	});
+	
+	//allocate the storage of the rows
+	std::size_t nonZeros = 0;
+	for(std::size_t i = 0; i != size1; ++i)
+		nonZeros += rowNonZeros[i];
+	compressed_matrix<T,I> temporary(size1,size2,nonZeros);
+	I* rowStart = temporary.outer_indices();
+	I* rowEnd = temporary.outer_indices_end();
+	for(std::size_t i = 0; i != size1; ++i){
+		rowEnd[i] = rowStart[i] + rowNonZeros[i];
+		rowStart[i+1] = rowEnd[i];
 	}
+	temporary.set_filled(nonZeros);
+	
+	//numeric pass
+	I* indices = temporary.inner_indices();
+	T* values = temporary.values();
+	parallelBlocks(size1, numBlocks, [&](std::size_t, std::size_t start, std::size_t end){
+		std::vector<std::size_t> marker(size2,0);
+		std::vector<T> accumulator(size2);
+		for (std::size_t i = start; i != end; ++i) {
+			I* rowIndices = indices + rowStart[i];
+			std::size_t nnz = 0;
+			for(iterator it = c().row_begin(i); it != c().row_end(i); ++it){
+				marker[it.index()] = i+1;
+				accumulator[it.index()] = *it;
+				rowIndices[nnz++] = it.index();
+			}
+			for(iterator1 it1 = e1().row_begin(i); it1 != e1().row_end(i); ++it1){
+				std::size_t k = it1.index();
+				T factor = alpha * (*it1);
+				for(iterator2 it2 = e2().row_begin(k); it2 != e2().row_end(k); ++it2){
+					std::size_t j = it2.index();
+					if(marker[j] != i+1){
+						marker[j] = i+1;
+						accumulator[j] = factor * (*it2);
+						rowIndices[nnz++] = j;
+					}else{
+						accumulator[j] += factor * (*it2);
+					}
+				}
+			}
+			std::sort(rowIndices, rowIndices + nnz);
+			for(std::size_t pos = 0; pos != nnz; ++pos){
+				values[rowStart[i] + pos] = accumulator[rowIndices[pos]];
+			}
+		}
+	});
+	result.swap(temporary);
 }
 
-	
+//the result is computed in new storage which replaces the old
+template<class T, class I, class E1, class E2>
+void gemm_sparse(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<compressed_matrix<T,I> >& m,
+	T alpha,
+	sparse_tag
+) {
+	sparse_prod(e1,e2,m(),m(),alpha);
+}
+
+//other sparse results, e.g. proxies, get the product added
+template<class M, class E1, class E2>
+void gemm_sparse(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<M>& m,
+	typename M::value_type alpha,
+	unknown_storage_tag
+) {
+	typedef typename M::value_type value_type;
+	compressed_matrix<value_type> empty(m().size1(),m().size2());
+	compressed_matrix<value_type> product;
+	sparse_prod(e1,e2,empty,product,alpha);
+	noalias(m) += product;
+}
+
+//dense results are computed row by row, the rows of E2 are added directly to the result
+template<class M, class E1, class E2>
+void gemm_sparse(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<M>& m,
+	typename M::value_type alpha,
+	dense_tag t
+) {
+	gemm_rowwise(e1,e2,m,alpha,t);
+}
+
+template<class M, class E1, class E2>
+void gemm_impl(
+	matrix_expression<E1> const& e1,
+	matrix_expression<E2> const& e2,
+	matrix_expression<M>& m,
+	typename M::value_type alpha,
+	row_major, row_major, row_major, 
+	sparse_bidirectional_iterator_tag, sparse_bidirectional_iterator_tag
+) {
+	gemm_sparse(e1,e2,m,alpha,typename M::storage_category());
+}	
 
 
 // case 3.3
@@ -148,10 +342,7 @@ void gemm_impl(
 	dense_random_access_iterator_tag, sparse_bidirectional_iterator_tag
 ) {
 	//compute the product row-wise
-	for (std::size_t i = 0; i != m().size1(); ++i) {
-		matrix_row<M> mat_row(m(),i);
-		kernels::gemv(trans(e2),row(e1,i),mat_row,alpha);
-	}
+	gemm_rowwise(e1,e2,m,alpha,typename M::storage_category());
 }
 
 //dense-dense
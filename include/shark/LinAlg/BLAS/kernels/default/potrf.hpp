@@ -0,0 +1,144 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief      Blocked Cholesky decomposition.
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_LINALG_BLAS_KERNELS_DEFAULT_POTRF_HPP
+#define SHARK_LINALG_BLAS_KERNELS_DEFAULT_POTRF_HPP
+
+#include "../../matrix.hpp"
+#include "../../matrix_proxy.hpp"
+#include "../../vector_expression.hpp"
+#include "../../operation.hpp"
+#include <shark/Core/OpenMP.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace shark { namespace blas { namespace bindings {
+
+///\brief Splits the rows [start,end) of a lower triangular block into parts of equal area.
+///
+/// Row i of the block has i-start+1+offset elements. The boundaries are returned in bounds,
+/// which has parts+1 entries.
+inline void partitionTriangle(
+	std::size_t start, std::size_t end, std::size_t offset,
+	std::size_t parts, std::vector<std::size_t>& bounds
+){
+	double a = double(offset);
+	double b = double(end - start + offset);
+	bounds.resize(parts + 1);
+	bounds[0] = start;
+	for(std::size_t t = 1; t != parts; ++t){
+		double r = std::sqrt(a * a + (b * b - a * a) * t / parts);
+		bounds[t] = std::max(bounds[t-1], std::min(end, start + std::size_t(r - a + 0.5)));
+	}
+	bounds[parts] = end;
+}
+
+///\brief Unblocked lower Cholesky decomposition of the lower triangle of A, in place.
+///
+/// Returns 0 on success and j+1 if the j-th pivot is not positive.
+template<class MatA>
+std::size_t potrf_unblocked(matrix_expression<MatA>& A){
+	typedef typename MatA::value_type value_type;
+	std::size_t n = A().size1();
+	for(std::size_t j = 0; j != n; ++j){
+		value_type s = A()(j, j);
+		for(std::size_t k = 0; k != j; ++k)
+			s -= A()(j, k) * A()(j, k);
+		if(!(s > 0))
+			return j + 1;
+		value_type ljj = std::sqrt(s);
+		A()(j, j) = ljj;
+		for(std::size_t i = j + 1; i != n; ++i){
+			value_type v = A()(i, j);
+			for(std::size_t k = 0; k != j; ++k)
+				v -= A()(i, k) * A()(j, k);
+			A()(i, j) = v / ljj;
+		}
+	}
+	return 0;
+}
+
+///\brief Right-looking blocked lower Cholesky decomposition (POTRF).
+///
+/// Only the lower triangle of A is read and replaced by L with \f$ A = LL^T \f$.
+/// The strictly upper triangle is overwritten by the tiles of the trailing update.
+/// For every panel of blockSize columns the diagonal block is factorized, the
+/// panel below it is solved against the factor and the trailing matrix receives
+/// the rank-blockSize update \f$ A_{22} -= L_{21}L_{21}^T \f$. This update carries almost
+/// all of the work; it is split into row tiles of equal work that are computed in parallel.
+///
+/// Returns 0 on success and j+1 if the j-th pivot is not positive.
+template<class MatA>
+std::size_t potrf(matrix_expression<MatA>& A, std::size_t blockSize = 64){
+	SIZE_CHECK(A().size1() == A().size2());
+	typedef matrix_range<MatA> SubA;
+	std::size_t n = A().size1();
+	std::vector<std::size_t> bounds;
+	for(std::size_t k = 0; k < n; k += blockSize){
+		std::size_t end = std::min(k + blockSize, n);
+		SubA Akk = subrange(A(), k, end, k, end);
+		std::size_t info = potrf_unblocked(Akk);
+		if(info != 0)
+			return k + info;
+		if(end == n) break;
+
+		//L21 = A21 L11^-T, row by row forward substitution
+		SubA A21 = subrange(A(), end, n, k, end);
+		SHARK_PARALLEL_FOR(int i = 0; i < (int)A21.size1(); ++i){
+			for(std::size_t j = 0; j != Akk.size1(); ++j){
+				typename MatA::value_type v = A21(i, j);
+				for(std::size_t l = 0; l != j; ++l)
+					v -= A21(i, l) * Akk(j, l);
+				A21(i, j) = v / Akk(j, j);
+			}
+		}
+
+		//A22 -= L21 L21^T on the lower triangle, in tiles of rows with equal work.
+		//the transpose is copied, as the product of two row major matrices is faster
+		matrix<typename MatA::value_type> L21T = trans(A21);
+		std::size_t numTiles = std::max<std::size_t>(1, std::min(SHARK_NUM_THREADS, (n - end) / 16));
+		partitionTriangle(end, n, 0, numTiles, bounds);
+		parallelBlocks(bounds, [&](std::size_t, std::size_t start, std::size_t stop){
+			if(start == stop) return;
+			SubA tile = subrange(A(), start, stop, end, stop);
+			axpy_prod(
+				rows(A21, start - end, stop - end),
+				columns(L21T, 0, stop - end),
+				tile, false, -1.0
+			);
+		});
+	}
+	return 0;
+}
+
+}}}
+#endif
@@ -0,0 +1,438 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief      Divide and conquer eigensolver for symmetric tridiagonal matrices.
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_LINALG_BLAS_KERNELS_DEFAULT_STEDC_HPP
+#define SHARK_LINALG_BLAS_KERNELS_DEFAULT_STEDC_HPP
+
+#include "../traits.hpp"
+#include "../../matrix.hpp"
+#include "../../vector.hpp"
+#include "../../matrix_proxy.hpp"
+#include "../../vector_proxy.hpp"
+#include "../../operation.hpp"
+
+#include <shark/Core/Exception.h>
+
+#include <boost/math/special_functions/sign.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace shark { namespace blas { namespace bindings {
+
+///\brief Eigenvalues and eigenvectors of a symmetric tridiagonal matrix by implicit QL iterations.
+///
+/// d holds the diagonal and e the n-1 off-diagonal elements. On exit d contains the
+/// (unsorted) eigenvalues and the columns of Q the corresponding eigenvectors.
+/// Used for small matrices.
+inline void steql(
+	vector<double>& d,
+	vector<double> const& e,
+	matrix<double>& Q
+){
+	const unsigned maxIterC = 50;
+	std::size_t n = d.size();
+	Q.resize(n, n);
+	Q.clear();
+	for(std::size_t i = 0; i != n; ++i)
+		Q(i, i) = 1.0;
+	if(n <= 1) return;
+
+	vector<double> odvecA(n, 0.0);
+	for(std::size_t i = 0; i + 1 < n; ++i)
+		odvecA(i) = e(i);
+
+	std::size_t m;
+	double b, c, f, g, p, r, s;
+	for (std::size_t l = 0; l < n; l++) {
+		unsigned j = 0;
+		do {
+			// look for small sub-diagonal element
+			for (m = l; m < n - 1; m++) {
+				s = std::fabs(d(m)) + std::fabs(d(m+1));
+				if (std::fabs(odvecA(m)) + s == s) {
+					break;
+				}
+			}
+
+			p = d(l);
+
+			if (m != l) {
+				if (j++ == maxIterC)
+					throw SHARKEXCEPTION("too many iterations in eigendecomposition");
+
+				// form shift
+				g = (d(l+1) - p) / (2.0 * odvecA(l));
+				r = std::sqrt(g * g + 1.0);
+				g = d(m) - p + odvecA(l) / (g + ((g) > 0 ? std::fabs(r) : -std::fabs(r)));
+				s = c = 1.0;
+				p = 0.0;
+
+				for (std::size_t i = m; i-- > l;) {
+					f = s * odvecA(i);
+					b = c * odvecA(i);
+
+					if (std::fabs(f) >= std::fabs(g)) {
+						c       = g / f;
+						r       = std::sqrt(c * c + 1.0);
+						odvecA(i+1) = f * r;
+						s       = 1.0 / r;
+						c      *= s;
+					}
+					else {
+						s       = f / g;
+						r       = std::sqrt(s * s + 1.0);
+						odvecA(i+1) = g * r;
+						c       = 1.0 / r;
+						s      *= c;
+					}
+
+					g       = d(i+1) - p;
+					r       = (d(i) - g) * s + 2.0 * c * b;
+					p       = s * r;
+					d(i+1) = g + p;
+					g       = c * r - b;
+
+					// form vector
+					for (std::size_t k = 0; k < n; k++) {
+						f           = Q(k, i+1);
+						Q(k, i+1) = s * Q(k, i) + c * f;
+						Q(k, i  ) = c * Q(k, i) - s * f;
+					}
+				}
+
+				d(l) -= p;
+				odvecA(l)  = g;
+				odvecA(m)  = 0.0;
+			}
+		}
+		while (m != l);
+	}
+}
+
+///\brief Finds the i-th root of the secular equation \f$ 1/\rho + \sum_k w_k^2/(\delta_k - \lambda) = 0 \f$.
+///
+/// The poles delta must be strictly increasing and rho positive. The i-th root lies in
+/// \f$ (\delta_i, \delta_{i+1}) \f$, the last one in \f$ (\delta_{K-1}, \delta_{K-1} + \rho w^Tw) \f$.
+/// To retain the relative accuracy of the distances to the poles, the root is returned as
+/// \f$ \lambda = \delta_{origin} + \tau \f$ relative to the closest pole. The iteration fits
+/// one pole on each side of the root to the function ("middle way", Li 1993) and is
+/// safeguarded by bisection.
+inline void secularRoot(
+	vector<double> const& delta,
+	vector<double> const& w,
+	double rho,
+	std::size_t i,
+	std::size_t& origin,
+	double& tau
+){
+	std::size_t K = delta.size();
+	double const eps = std::numeric_limits<double>::epsilon();
+	double invRho = 1.0 / rho;
+	double lo, hi;
+	if(i + 1 < K){
+		double gap = delta(i + 1) - delta(i);
+		double mid = 0.5 * gap;
+		double f = invRho;
+		for(std::size_t k = 0; k != K; ++k)
+			f += w(k) * w(k) / ((delta(k) - delta(i)) - mid);
+		if(f >= 0){
+			origin = i;
+			lo = 0;
+			hi = mid;
+		}else{
+			origin = i + 1;
+			lo = mid - gap;
+			hi = 0;
+		}
+	}else{
+		origin = i;
+		lo = 0;
+		hi = rho * inner_prod(w, w);
+	}
+	vector<double> shifted = delta - blas::repeat(delta(origin), K);
+
+	tau = 0.5 * (lo + hi);
+	for(std::size_t iter = 0; iter != 200; ++iter){
+		double psi = 0, dpsi = 0, phi = 0, dphi = 0;
+		for(std::size_t k = 0; k <= i; ++k){
+			double t = w(k) / (shifted(k) - tau);
+			psi += w(k) * t;
+			dpsi += t * t;
+		}
+		for(std::size_t k = i + 1; k < K; ++k){
+			double t = w(k) / (shifted(k) - tau);
+			phi += w(k) * t;
+			dphi += t * t;
+		}
+		double f = invRho + psi + phi;
+		if(std::abs(f) <= 8 * K * eps * (invRho + std::abs(psi) + std::abs(phi)))
+			break;
+		if(f < 0)
+			lo = tau;
+		else
+			hi = tau;
+
+		//fit f(tau+eta) ~ c + s/(da-eta) + S/(db-eta) to value and derivatives of both sums
+		double da = shifted(i) - tau;
+		double eta = 0;
+		bool valid = false;
+		if(i + 1 < K){
+			double db = shifted(i + 1) - tau;
+			double s = da * da * dpsi;
+			double S = db * db * dphi;
+			double c = f - da * dpsi - db * dphi;
+			double B = c * (da + db) + s + S;
+			double C = da * db * f;
+			if(c == 0){
+				if(B != 0){
+					eta = C / B;
+					valid = true;
+				}
+			}else{
+				double disc = B * B - 4 * c * C;
+				if(disc >= 0){
+					double q = 0.5 * (B + boost::math::sign(B) * std::sqrt(disc));
+					if(q != 0){
+						double eta1 = q / c;
+						double eta2 = C / q;
+						eta = (tau + eta1 > lo && tau + eta1 < hi) ? eta1 : eta2;
+						valid = true;
+					}
+				}
+			}
+		}else{
+			double c = f - da * dpsi;
+			if(c != 0){
+				eta = da + da * da * dpsi / c;
+				valid = true;
+			}
+		}
+		double next = tau + eta;
+		if(!valid || !(next > lo && next < hi))
+			next = 0.5 * (lo + hi);
+		if(next == tau)
+			break;
+		tau = next;
+	}
+}
+
+///\brief Eigendecomposition of \f$ \text{diag}(d) + \rho z z^T \f$ for the merge step of stedc.
+///
+/// The columns of U are the eigenvectors in the coordinates of d and lambda the eigenvalues.
+/// Components of z which are negligible and pairs of nearly equal diagonal entries are deflated
+/// (LAPACK dlaed2), the rest is solved by the secular equation and the eigenvectors are computed
+/// from the roots as proposed by Gu and Eisenstat, which keeps them numerically orthogonal.
+inline void rankOneEigensystem(
+	vector<double> const& diagonal,
+	vector<double> z,
+	double rho,
+	vector<double>& lambda,
+	matrix<double>& U
+){
+	std::size_t n = diagonal.size();
+	double const eps = std::numeric_limits<double>::epsilon();
+
+	//reduce to rho > 0 and normalized z
+	double sign = rho < 0 ? -1.0 : 1.0;
+	double zNorm = norm_2(z);
+	z /= zNorm;
+	rho = std::abs(rho) * zNorm * zNorm;
+
+	std::vector<std::pair<double, std::size_t> > order(n);
+	for(std::size_t i = 0; i != n; ++i)
+		order[i] = std::make_pair(sign * diagonal(i), i);
+	std::sort(order.begin(), order.end());
+	vector<double> d(n);
+	vector<double> w(n);
+	for(std::size_t s = 0; s != n; ++s){
+		d(s) = order[s].first;
+		w(s) = z(order[s].second);
+	}
+
+	//deflation
+	double tol = 8 * eps * std::max(norm_inf(d), norm_inf(w));
+	std::vector<bool> deflated(n, false);
+	std::vector<std::size_t> rotP, rotJ;
+	std::vector<double> rotC, rotS;
+	std::size_t p = n;
+	for(std::size_t j = 0; j != n; ++j){
+		if(rho * std::abs(w(j)) <= tol){
+			deflated[j] = true;
+			continue;
+		}
+		if(p != n){
+			double t = std::sqrt(w(p) * w(p) + w(j) * w(j));
+			double c = w(j) / t;
+			double s = -w(p) / t;
+			if(std::abs((d(j) - d(p)) * c * s) <= tol){
+				w(j) = t;
+				w(p) = 0;
+				double dp = d(p) * c * c + d(j) * s * s;
+				d(j) = d(p) * s * s + d(j) * c * c;
+				d(p) = dp;
+				deflated[p] = true;
+				rotP.push_back(p);
+				rotJ.push_back(j);
+				rotC.push_back(c);
+				rotS.push_back(s);
+			}
+		}
+		p = j;
+	}
+
+	std::vector<std::size_t> active;
+	for(std::size_t s = 0; s != n; ++s){
+		if(!deflated[s])
+			active.push_back(s);
+	}
+	std::size_t K = active.size();
+
+	//eigenvectors in the sorted and rotated coordinates
+	matrix<double> V(n, n, 0.0);
+	lambda.resize(n);
+	for(std::size_t s = 0; s != n; ++s){
+		if(deflated[s]){
+			V(s, s) = 1.0;
+			lambda(s) = sign * d(s);
+		}
+	}
+	if(K > 0){
+		vector<double> delta(K);
+		vector<double> weights(K);
+		for(std::size_t k = 0; k != K; ++k){
+			delta(k) = d(active[k]);
+			weights(k) = w(active[k]);
+		}
+		std::vector<std::size_t> origin(K);
+		vector<double> tau(K);
+		for(std::size_t i = 0; i != K; ++i){
+			secularRoot(delta, weights, rho, i, origin[i], tau(i));
+			lambda(active[i]) = sign * (delta(origin[i]) + tau(i));
+		}
+
+		//recompute the weights from the roots (Gu and Eisenstat)
+		vector<double> zHat(K);
+		for(std::size_t k = 0; k != K; ++k){
+			double prod = ((delta(origin[K - 1]) - delta(k)) + tau(K - 1)) / rho;
+			for(std::size_t j = 0; j != k; ++j)
+				prod *= ((delta(origin[j]) - delta(k)) + tau(j)) / (delta(j) - delta(k));
+			for(std::size_t j = k; j + 1 < K; ++j)
+				prod *= ((delta(origin[j]) - delta(k)) + tau(j)) / (delta(j + 1) - delta(k));
+			zHat(k) = boost::math::copysign(std::sqrt(std::abs(prod)), weights(k));
+		}
+		for(std::size_t i = 0; i != K; ++i){
+			double norm = 0;
+			for(std::size_t k = 0; k != K; ++k){
+				double value = zHat(k) / ((delta(k) - delta(origin[i])) - tau(i));
+				V(active[k], active[i]) = value;
+				norm += value * value;
+			}
+			norm = std::sqrt(norm);
+			for(std::size_t k = 0; k != K; ++k)
+				V(active[k], active[i]) /= norm;
+		}
+	}
+
+	//undo the deflating rotations and the sorting
+	for(std::size_t r = rotP.size(); r-- > 0;){
+		std::size_t rp = rotP[r];
+		std::size_t rj = rotJ[r];
+		double c = rotC[r];
+		double s = rotS[r];
+		for(std::size_t col = 0; col != n; ++col){
+			double vp = V(rp, col);
+			double vj = V(rj, col);
+			V(rp, col) = c * vp - s * vj;
+			V(rj, col) = s * vp + c * vj;
+		}
+	}
+	U.resize(n, n);
+	for(std::size_t s = 0; s != n; ++s){
+		noalias(row(U, order[s].second)) = row(V, s);
+	}
+}
+
+///\brief Eigenvalues and eigenvectors of a symmetric tridiagonal matrix by divide and conquer.
+///
+/// d holds the diagonal and e the n-1 off-diagonal elements. On exit d contains the
+/// (unsorted) eigenvalues and the columns of Q the corresponding eigenvectors.
+///
+/// The matrix is split into two halves coupled by a rank one update (Cuppen 1981), which
+/// are solved recursively. The eigenvectors of the merged problem are the product of the
+/// eigenvectors of the halves with those of the rank one update, thus nearly all work
+/// is done in matrix-matrix products. Small problems are solved by implicit QL iterations.
+inline void stedc(
+	vector<double>& d,
+	vector<double> const& e,
+	matrix<double>& Q
+){
+	std::size_t const minSize = 25;
+	std::size_t n = d.size();
+	if(n <= minSize){
+		steql(d, e, Q);
+		return;
+	}
+
+	//split T = diag(T1, T2) + beta u u^T with u = e_{m-1} + e_m
+	std::size_t m = n / 2;
+	double beta = e(m - 1);
+	vector<double> d1 = subrange(d, 0, m);
+	vector<double> d2 = subrange(d, m, n);
+	vector<double> e1 = subrange(e, 0, m - 1);
+	vector<double> e2 = subrange(e, m, n - 1);
+	d1(m - 1) -= beta;
+	d2(0) -= beta;
+	matrix<double> Q1, Q2;
+	stedc(d1, e1, Q1);
+	stedc(d2, e2, Q2);
+
+	//the halves are diagonal in the basis diag(Q1,Q2), in which u becomes z
+	vector<double> diagonal(n);
+	vector<double> z(n);
+	noalias(subrange(diagonal, 0, m)) = d1;
+	noalias(subrange(diagonal, m, n)) = d2;
+	noalias(subrange(z, 0, m)) = row(Q1, m - 1);
+	noalias(subrange(z, m, n)) = row(Q2, 0);
+
+	matrix<double> U;
+	rankOneEigensystem(diagonal, z, beta, d, U);
+
+	//Q = diag(Q1,Q2) U
+	Q.resize(n, n);
+	axpy_prod(Q1, rows(U, 0, m), rows(Q, 0, m));
+	axpy_prod(Q2, rows(U, m, n), rows(Q, m, n));
+}
+
+}}}
+
+#endif
@@ -2,7 +2,7 @@
 /*!
  * 
  *
- * \brief      Contains the lapack bindings for the symmetric eigenvalue problem syev.
+ * \brief      Default implementation of the symmetric eigenvalue problem syev.
  *
  * \author      O. Krause
  * \date        2010
@@ -33,6 +33,11 @@
 #define SHARK_LINALG_BLAS_KERNELS_DEFAULT_SYEV_HPP
 
 #include "../traits.hpp"
+#include "sytrd.hpp"
+#include "stedc.hpp"
+
+#include <algorithm>
+#include <vector>
 
 namespace shark { namespace blas { namespace bindings {
 	
@@ -61,6 +66,15 @@ void eigensort
 	}
 }
 
+///\brief Eigendecomposition of a symmetric matrix.
+///
+/// Only the lower triangle of vmatA is read, on exit it holds the eigenvectors as columns
+/// and dvecA the eigenvalues in descending order.
+///
+/// The matrix is reduced to tridiagonal form by blocked Householder reflections, the
+/// tridiagonal problem is solved by divide and conquer and the eigenvectors are transformed
+/// back by the blocked reflections. All three steps spend most of their time in
+/// matrix-matrix products.
 template <typename MatrA, typename VectorB>
 void syev(
 	matrix_expression<MatrA>& vmatA,
@@ -68,208 +82,35 @@ void syev(
 ) {
 	SIZE_CHECK(vmatA().size1() == vmatA().size2());
 	SIZE_CHECK(vmatA().size1() == dvecA().size());
-	
-	const unsigned maxIterC = 50;
-	unsigned n = vmatA().size1();
-	
-	blas::vector<double> odvecA(n,0.0);
-
-	unsigned j, k, l, m;
-	double   b, c, f, g, h, hh, p, r, s, scale;
-
-
-	//
-	// reduction to tridiagonal form
-	//
-	for (unsigned i = n; i-- > 1;) {
-		h = 0.0;
-		scale = 0.0;
-
-		if (i > 1) {
-			// scale row
-			for (unsigned k = 0; k < i; k++) {
-				scale += std::fabs(vmatA()(i, k));
-			}
-		}
-
-		if (scale == 0.0) {
-			odvecA(i) = vmatA()(i, i-1);
-		}
-		else {
-			for (k = 0; k < i; k++) {
-				vmatA()(i, k) /= scale;
-				h += vmatA()(i, k) * vmatA()(i, k);
-			}
-
-			f           = vmatA()(i, i-1);
-			g           = f > 0 ? -std::sqrt(h) : std::sqrt(h);
-			odvecA(i)       = scale * g;
-			h          -= f * g;
-			vmatA()(i, i-1) = f - g;
-			f           = 0.0;
-
-			for (j = 0; j < i; j++) {
-				vmatA()(j, i) = vmatA()(i, j) / (scale * h);
-				g = 0.0;
-
-				// form element of a*u
-				for (k = 0; k <= j; k++) {
-					g += vmatA()(j, k) * vmatA()(i, k);
-				}
-
-				for (k = j + 1; k < i; k++) {
-					g += vmatA()(k, j) * vmatA()(i, k);
-				}
-
-				// form element of p
-				f += (odvecA(j) = g / h) * vmatA()(i, j);
-			}
-
-			hh = f / (h + h);
-
-			// form reduced a
-			for (j = 0; j < i; j++) {
-				f     = vmatA()(i, j);
-				g     = odvecA(j) - hh * f;
-				odvecA(j) = g;
-
-				for (k = 0; k <= j; k++) {
-					vmatA()(j, k) -= f * odvecA(k) + g * vmatA()(i, k);
-				}
-			}
-
-			for (k = i; k--;) {
-				vmatA()(i, k) *= scale;
-			}
-		}
-
-		dvecA()(i) = h;
-	}
+	std::size_t n = vmatA().size1();
+	if(n == 0) return;
 
-	dvecA()(0) = odvecA(0) = 0.0;
-
-	// accumulation of transformation matrices
-	for (unsigned i = 0; i < n; i++) {
-		if (dvecA()(i)) {
-			for (j = 0; j < i; j++) {
-				g = 0.0;
-
-				for (k = 0; k < i; k++) {
-					g += vmatA()(i, k) * vmatA()(k, j);
-				}
-
-				for (k = 0; k < i; k++) {
-					vmatA()(k, j) -= g * vmatA()(k, i);
-				}
-			}
-		}
-
-		dvecA()(i)     = vmatA()(i, i);
-		vmatA()(i, i) = 1.0;
-
-		for (j = 0; j < i; j++) {
-			vmatA()(i, j) = vmatA()(j, i) = 0.0;
+	matrix<double> A(n, n);
+	for (std::size_t i = 0; i < n; i++) {
+		for (std::size_t j = 0; j <= i; j++) {
+			A(i, j) = A(j, i) = vmatA()(i, j);
 		}
 	}
 
-	//
-	// eigenvalues from tridiagonal form
-	//
-	if (n <= 1) {
-		return;
-	}
+	vector<double> d, e, tau;
+	sytrd(A, d, e, tau);
+	matrix<double> Q;
+	stedc(d, e, Q);
 
-	for (unsigned i = 1; i < n; i++) {
-		odvecA(i-1) = odvecA(i);
+	//sort the eigenvalues in descending order
+	std::vector<std::pair<double, std::size_t> > order(n);
+	for (std::size_t i = 0; i < n; i++) {
+		order[i] = std::make_pair(-d(i), i);
 	}
-
-	odvecA(n-1) = 0.0;
-
-	for (l = 0; l < n; l++) {
-		j = 0;
-
-		do {
-			// look for small sub-diagonal element
-			for (m = l; m < n - 1; m++) {
-				s = std::fabs(dvecA()(m)) + std::fabs(dvecA()(m+1));
-				if (std::fabs(odvecA(m)) + s == s) {
-					break;
-				}
-			}
-
-			p = dvecA()(l);
-
-			if (m != l) {
-				if (j++ == maxIterC)
-					throw SHARKEXCEPTION("too many iterations in eigendecomposition");
-
-				// form shift
-				g = (dvecA()(l+1) - p) / (2.0 * odvecA(l));
-				r = std::sqrt(g * g + 1.0);
-				g = dvecA()(m) - p + odvecA(l) / (g + ((g) > 0 ? std::fabs(r) : -std::fabs(r)));
-				s = c = 1.0;
-				p = 0.0;
-
-				for (unsigned i = m; i-- > l;) {
-					f = s * odvecA(i);
-					b = c * odvecA(i);
-
-					if (std::fabs(f) >= std::fabs(g)) {
-						c       = g / f;
-						r       = std::sqrt(c * c + 1.0);
-						odvecA(i+1) = f * r;
-						s       = 1.0 / r;
-						c      *= s;
-					}
-					else {
-						s       = f / g;
-						r       = std::sqrt(s * s + 1.0);
-						odvecA(i+1) = g * r;
-						c       = 1.0 / r;
-						s      *= c;
-					}
-
-					g       = dvecA()(i+1) - p;
-					r       = (dvecA()(i) - g) * s + 2.0 * c * b;
-					p       = s * r;
-					dvecA()(i+1) = g + p;
-					g       = c * r - b;
-
-					// form vector
-					for (k = 0; k < n; k++) {
-						f           = vmatA()(k, i+1);
-						vmatA()(k, i+1) = s * vmatA()(k, i) + c * f;
-						vmatA()(k, i  ) = c * vmatA()(k, i) - s * f;
-					}
-				}
-
-				dvecA()(l) -= p;
-				odvecA(l)  = g;
-				odvecA(m)  = 0.0;
-			}
-		}
-		while (m != l);
+	std::sort(order.begin(), order.end());
+	matrix<double> Z(n, n);
+	for (std::size_t j = 0; j < n; j++) {
+		dvecA()(j) = d(order[j].second);
+		noalias(column(Z, j)) = column(Q, order[j].second);
 	}
 
-	//
-	// sorting eigenvalues
-	//
-	eigensort(vmatA, dvecA);
-
-	//
-	// normalizing eigenvectors
-	//
-	for (unsigned j = n; j--;) {
-		s = 0.0;
-		for (unsigned i = n; i--;) {
-			s += vmatA()(i, j) * vmatA()(i, j);
-		}
-		s = std::sqrt(s);
-
-		for (unsigned i = n; i--;) {
-			vmatA()(i, j) /= s;
-		}
-	}
+	ormtr(A, tau, Z);
+	noalias(vmatA()) = Z;
 }
 
 /** @}*/
@@ -0,0 +1,260 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief      Computes selected eigenpairs of a symmetric matrix.
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_LINALG_BLAS_KERNELS_DEFAULT_SYEVX_HPP
+#define SHARK_LINALG_BLAS_KERNELS_DEFAULT_SYEVX_HPP
+
+#include "sytrd.hpp"
+
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace shark { namespace blas { namespace bindings {
+
+///\brief Number of eigenvalues of a symmetric tridiagonal matrix smaller than x (Sturm sequence).
+inline std::size_t sturmCount(
+	vector<double> const& d,
+	vector<double> const& e,
+	double x,
+	double pivmin
+){
+	std::size_t count = 0;
+	double q = d(0) - x;
+	for(std::size_t i = 0;; ++i){
+		if(std::abs(q) < pivmin)
+			q = -pivmin;
+		if(q < 0)
+			++count;
+		if(i + 1 == d.size())
+			break;
+		q = d(i + 1) - x - e(i) * e(i) / q;
+	}
+	return count;
+}
+
+///\brief Computes eigenvalues first,...,last-1 (in ascending order) of a symmetric tridiagonal matrix by bisection.
+inline void stebz(
+	vector<double> const& d,
+	vector<double> const& e,
+	std::size_t first,
+	std::size_t last,
+	vector<double>& lambda
+){
+	std::size_t n = d.size();
+	double const eps = std::numeric_limits<double>::epsilon();
+	double maxE2 = 1;
+	double lower = d(0);
+	double upper = d(0);
+	for(std::size_t i = 0; i != n; ++i){
+		double radius = 0;
+		if(i > 0) radius += std::abs(e(i - 1));
+		if(i + 1 < n) radius += std::abs(e(i));
+		lower = std::min(lower, d(i) - radius);
+		upper = std::max(upper, d(i) + radius);
+		if(i + 1 < n) maxE2 = std::max(maxE2, e(i) * e(i));
+	}
+	double pivmin = std::numeric_limits<double>::min() * maxE2;
+	double norm = std::max(std::abs(lower), std::abs(upper));
+	lower -= 2 * eps * norm * n + pivmin;
+	upper += 2 * eps * norm * n + pivmin;
+
+	lambda.resize(last - first);
+	for(std::size_t idx = first; idx != last; ++idx){
+		//the bracket of the previous eigenvalue is a valid lower bound
+		double lo = idx == first ? lower : lambda(idx - first - 1) - 2 * eps * norm;
+		double hi = upper;
+		for(std::size_t iter = 0; iter != 200; ++iter){
+			double mid = 0.5 * (lo + hi);
+			if(hi - lo <= 2 * eps * std::max(std::abs(lo), std::abs(hi)) + pivmin || mid == lo || mid == hi)
+				break;
+			if(sturmCount(d, e, mid, pivmin) > idx)
+				hi = mid;
+			else
+				lo = mid;
+		}
+		lambda(idx - first) = 0.5 * (lo + hi);
+	}
+}
+
+///\brief Computes eigenvectors of a symmetric tridiagonal matrix for given eigenvalues by inverse iteration.
+///
+/// The eigenvalues must be sorted in ascending order. Vectors of eigenvalues closer than
+/// \f$ 10^{-3} \|T\|_1 \f$ are reorthogonalized against each other (LAPACK dstein).
+inline void stein(
+	vector<double> const& d,
+	vector<double> const& e,
+	vector<double> const& lambda,
+	matrix<double>& X
+){
+	std::size_t n = d.size();
+	std::size_t k = lambda.size();
+	double const eps = std::numeric_limits<double>::epsilon();
+	X.resize(n, k);
+	if(k == 0) return;
+	if(n == 1){
+		X(0, 0) = 1;
+		return;
+	}
+
+	double norm = 0;
+	for(std::size_t i = 0; i != n; ++i){
+		double value = std::abs(d(i));
+		if(i > 0) value += std::abs(e(i - 1));
+		if(i + 1 < n) value += std::abs(e(i));
+		norm = std::max(norm, value);
+	}
+	double ortol = 1.e-3 * norm;
+	double pivot = std::max(eps * norm, std::numeric_limits<double>::min());
+
+	vector<double> u0(n), u1(n), u2(n), l(n);
+	std::vector<bool> swapped(n);
+	vector<double> x(n);
+	std::size_t clusterStart = 0;
+	double previous = 0;
+	boost::uint64_t state = 0x9E3779B97F4A7C15ull;
+	for(std::size_t j = 0; j != k; ++j){
+		double shift = lambda(j);
+		if(j > 0){
+			if(shift - lambda(j - 1) > ortol)
+				clusterStart = j;
+			//separate equal eigenvalues to get different vectors
+			if(shift - previous < eps * norm * 10)
+				shift = previous + eps * norm * 10;
+		}
+		previous = shift;
+
+		//LU decomposition of T - shift I with partial pivoting
+		for(std::size_t i = 0; i != n; ++i){
+			u0(i) = d(i) - shift;
+			u1(i) = i + 1 < n ? e(i) : 0;
+			u2(i) = 0;
+		}
+		for(std::size_t i = 0; i + 1 < n; ++i){
+			if(std::abs(u0(i)) >= std::abs(e(i))){
+				if(u0(i) == 0) u0(i) = pivot;
+				l(i) = e(i) / u0(i);
+				u0(i + 1) -= l(i) * u1(i);
+				swapped[i] = false;
+			}else{
+				l(i) = u0(i) / e(i);
+				double next0 = u0(i + 1);
+				double next1 = u1(i + 1);
+				u0(i + 1) = u1(i) - l(i) * next0;
+				u1(i + 1) = -l(i) * next1;
+				u0(i) = e(i);
+				u1(i) = next0;
+				u2(i) = next1;
+				swapped[i] = true;
+			}
+		}
+		if(std::abs(u0(n - 1)) < pivot)
+			u0(n - 1) = u0(n - 1) < 0 ? -pivot : pivot;
+		for(std::size_t i = 0; i + 1 < n; ++i){
+			if(std::abs(u0(i)) < pivot)
+				u0(i) = u0(i) < 0 ? -pivot : pivot;
+		}
+
+		//pseudo random starting vector
+		for(std::size_t i = 0; i != n; ++i){
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			x(i) = double(state >> 11) / double(boost::uint64_t(1) << 53) - 0.5;
+		}
+
+		for(std::size_t iter = 0; iter != 3; ++iter){
+			//solve (T - shift I) y = x
+			for(std::size_t i = 0; i + 1 < n; ++i){
+				if(swapped[i]) std::swap(x(i), x(i + 1));
+				x(i + 1) -= l(i) * x(i);
+			}
+			for(std::size_t i = n; i-- > 0;){
+				double value = x(i);
+				if(i + 1 < n) value -= u1(i) * x(i + 1);
+				if(i + 2 < n) value -= u2(i) * x(i + 2);
+				x(i) = value / u0(i);
+			}
+			//orthogonalize against the vectors of the cluster
+			x /= norm_inf(x);
+			for(std::size_t c = clusterStart; c != j; ++c){
+				noalias(x) -= inner_prod(x, column(X, c)) * column(X, c);
+			}
+			x /= norm_2(x);
+		}
+		noalias(column(X, j)) = x;
+	}
+}
+
+///\brief Computes the largest k eigenvalues and corresponding eigenvectors of a symmetric matrix.
+///
+/// Only the lower triangle of A is read. The matrix is reduced to tridiagonal form, the
+/// eigenvalues are found by bisection and the eigenvectors by inverse iteration, which costs
+/// \f$ \mathcal{O}(nk) \f$ operations instead of the \f$ \mathcal{O}(n^3) \f$ of the full
+/// eigensolver. Finally the vectors are transformed back by blocked Householder reflections.
+/// The eigenvalues are returned in descending order.
+template <typename MatrA, typename MatrV, typename VectorB>
+void syevx(
+	matrix_expression<MatrA> const& matA,
+	matrix_expression<MatrV>& eigenVectors,
+	vector_expression<VectorB>& eigenValues,
+	std::size_t k
+){
+	SIZE_CHECK(matA().size1() == matA().size2());
+	std::size_t n = matA().size1();
+	SIZE_CHECK(k <= n);
+	eigenVectors().resize(n, k);
+	eigenValues().resize(k);
+	if(k == 0) return;
+
+	matrix<double> A(n, n);
+	for(std::size_t i = 0; i != n; ++i){
+		for(std::size_t j = 0; j <= i; ++j){
+			A(i, j) = A(j, i) = matA()(i, j);
+		}
+	}
+	vector<double> d, e, tau;
+	sytrd(A, d, e, tau);
+
+	vector<double> lambda;
+	stebz(d, e, n - k, n, lambda);
+	matrix<double> X;
+	stein(d, e, lambda, X);
+	ormtr(A, tau, X);
+
+	for(std::size_t j = 0; j != k; ++j){
+		eigenValues()(j) = lambda(k - 1 - j);
+		noalias(column(eigenVectors, j)) = column(X, k - 1 - j);
+	}
+}
+
+}}}
+
+#endif
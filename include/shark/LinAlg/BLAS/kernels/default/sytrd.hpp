@@ -0,0 +1,187 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief      Blocked reduction of a symmetric matrix to tridiagonal form.
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_LINALG_BLAS_KERNELS_DEFAULT_SYTRD_HPP
+#define SHARK_LINALG_BLAS_KERNELS_DEFAULT_SYTRD_HPP
+
+#include "../traits.hpp"
+#include "../../matrix.hpp"
+#include "../../vector.hpp"
+#include "../../matrix_proxy.hpp"
+#include "../../vector_proxy.hpp"
+#include "../../operation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace shark { namespace blas { namespace bindings {
+
+///\brief Reduces a symmetric matrix to tridiagonal form \f$ T = Q^T A Q \f$.
+///
+/// A must contain the full symmetric matrix. On exit d and e hold the diagonal and
+/// the off-diagonal of T. Q is the product \f$ H_0 H_1 \cdots H_{n-2} \f$ of Householder
+/// reflections \f$ H_i = I - \tau_i v_i v_i^T \f$, where v_i is stored in A(i+1:n, i)
+/// and \f$ \tau_i \f$ in tau. The remaining entries of A are overwritten.
+///
+/// The columns are processed in panels of blockSize columns (LAPACK dsytrd/dlatrd).
+/// Inside a panel the updates of the trailing matrix are only accumulated as
+/// \f$ A - V W^T - W V^T \f$, so that most of the work is done by matrix-matrix products.
+inline void sytrd(
+	matrix<double>& A,
+	vector<double>& d,
+	vector<double>& e,
+	vector<double>& tau,
+	std::size_t blockSize = 32
+){
+	SIZE_CHECK(A.size1() == A.size2());
+	std::size_t n = A.size1();
+	d.resize(n);
+	e.resize(n > 0 ? n - 1 : 0);
+	tau.resize(e.size());
+	if(n == 0) return;
+
+	matrix<double> V(n, blockSize, 0.0);
+	matrix<double> W(n, blockSize, 0.0);
+	vector<double> t1(blockSize);
+	vector<double> t2(blockSize);
+	for(std::size_t k = 0; k + 1 < n; k += blockSize){
+		std::size_t nb = std::min(blockSize, n - 1 - k);
+		std::size_t end = k + nb;
+		for(std::size_t j = 0; j != nb; ++j){
+			std::size_t i = k + j;
+			//apply the pending updates of the panel to column i
+			if(j > 0){
+				axpy_prod(subrange(V, i, n, 0, j), subrange(row(W, i), 0, j), subrange(column(A, i), i, n), false, -1.0);
+				axpy_prod(subrange(W, i, n, 0, j), subrange(row(V, i), 0, j), subrange(column(A, i), i, n), false, -1.0);
+			}
+
+			//Householder reflection annihilating A(i+2:n, i)
+			double alpha = A(i + 1, i);
+			double xnorm = 0;
+			for(std::size_t r = i + 2; r < n; ++r)
+				xnorm += A(r, i) * A(r, i);
+			xnorm = std::sqrt(xnorm);
+			double beta = alpha;
+			double t = 0;
+			if(xnorm != 0){
+				beta = alpha > 0 ? -std::sqrt(alpha * alpha + xnorm * xnorm) : std::sqrt(alpha * alpha + xnorm * xnorm);
+				t = (beta - alpha) / beta;
+				double scale = 1.0 / (alpha - beta);
+				for(std::size_t r = i + 2; r < n; ++r)
+					A(r, i) *= scale;
+			}
+			A(i + 1, i) = 1.0;
+			d(i) = A(i, i);
+			e(i) = beta;
+			tau(i) = t;
+
+			//store v and compute w = tau (A22 v - V W^T v - W V^T v) - tau/2 (w^T v) v
+			noalias(subrange(column(V, j), i + 1, n)) = subrange(column(A, i), i + 1, n);
+			axpy_prod(subrange(A, i + 1, n, i + 1, n), subrange(column(V, j), i + 1, n), subrange(column(W, j), i + 1, n));
+			if(j > 0){
+				axpy_prod(trans(subrange(W, i + 1, n, 0, j)), subrange(column(V, j), i + 1, n), subrange(t1, 0, j));
+				axpy_prod(trans(subrange(V, i + 1, n, 0, j)), subrange(column(V, j), i + 1, n), subrange(t2, 0, j));
+				axpy_prod(subrange(V, i + 1, n, 0, j), subrange(t1, 0, j), subrange(column(W, j), i + 1, n), false, -1.0);
+				axpy_prod(subrange(W, i + 1, n, 0, j), subrange(t2, 0, j), subrange(column(W, j), i + 1, n), false, -1.0);
+			}
+			subrange(column(W, j), i + 1, n) *= t;
+			double gamma = 0.5 * t * inner_prod(subrange(column(W, j), i + 1, n), subrange(column(V, j), i + 1, n));
+			noalias(subrange(column(W, j), i + 1, n)) -= gamma * subrange(column(V, j), i + 1, n);
+		}
+
+		//update the trailing matrix with the whole panel
+		if(end < n){
+			axpy_prod(subrange(V, end, n, 0, nb), trans(subrange(W, end, n, 0, nb)), subrange(A, end, n, end, n), false, -1.0);
+			axpy_prod(subrange(W, end, n, 0, nb), trans(subrange(V, end, n, 0, nb)), subrange(A, end, n, end, n), false, -1.0);
+		}
+	}
+	d(n - 1) = A(n - 1, n - 1);
+}
+
+///\brief Computes \f$ Z \leftarrow Q Z \f$ for the matrix Q of a tridiagonal reduction.
+///
+/// A and tau are the results of sytrd. The reflections are applied in blocks of blockSize
+/// using the compact WY representation \f$ H_k \cdots H_{k+b-1} = I - V T V^T \f$
+/// (LAPACK dormtr/dlarft), thus Z is only touched by matrix-matrix products.
+inline void ormtr(
+	matrix<double> const& A,
+	vector<double> const& tau,
+	matrix<double>& Z,
+	std::size_t blockSize = 32
+){
+	std::size_t n = A.size1();
+	SIZE_CHECK(Z.size1() == n);
+	SIZE_CHECK(tau.size() + 1 == n || n == 0);
+	if(n < 2) return;
+	std::size_t reflections = n - 1;
+	std::size_t numBlocks = (reflections + blockSize - 1) / blockSize;
+	for(std::size_t b = numBlocks; b-- > 0;){
+		std::size_t k = b * blockSize;
+		std::size_t nb = std::min(blockSize, reflections - k);
+		std::size_t size = n - k - 1;
+
+		//gather the reflections of the block, row r corresponds to row k+1+r of A
+		matrix<double> V(size, nb, 0.0);
+		for(std::size_t c = 0; c != nb; ++c){
+			for(std::size_t r = c; r != size; ++r){
+				V(r, c) = A(k + 1 + r, k + c);
+			}
+		}
+		//triangular factor T of the compact WY representation
+		matrix<double> T(nb, nb, 0.0);
+		vector<double> temp(nb);
+		for(std::size_t c = 0; c != nb; ++c){
+			double t = tau(k + c);
+			T(c, c) = t;
+			if(c == 0 || t == 0) continue;
+			for(std::size_t r = 0; r != c; ++r){
+				temp(r) = inner_prod(subrange(column(V, r), c, size), subrange(column(V, c), c, size));
+			}
+			for(std::size_t r = 0; r != c; ++r){
+				double sum = 0;
+				for(std::size_t q = r; q != c; ++q)
+					sum += T(r, q) * temp(q);
+				T(r, c) = -t * sum;
+			}
+		}
+
+		//Z(k+1:n, :) -= V T V^T Z(k+1:n, :)
+		matrix<double> Y(nb, Z.size2());
+		axpy_prod(trans(V), rows(Z, k + 1, n), Y);
+		matrix<double> TY(nb, Z.size2());
+		axpy_prod(T, Y, TY);
+		axpy_prod(V, TY, rows(Z, k + 1, n), false, -1.0);
+	}
+}
+
+}}}
+
+#endif
@@ -33,6 +33,8 @@
 
 #include "../../matrix_proxy.hpp"
 #include "../../vector_expression.hpp"
+#include "../../operation.hpp"
+#include <shark/Core/OpenMP.h>
 #include <boost/mpl/bool.hpp>
 
 namespace shark {namespace blas {namespace bindings {
@@ -142,17 +144,61 @@ void trsm_impl(
 	}
 }
 
+//blocked version for a single tile of right hand sides. The diagonal blocks are solved
+//with the unblocked kernels above, the remaining rows are updated by matrix products.
+template <bool Upper, bool Unit,typename TriangularA, typename MatB>
+void trsm_blocked(
+	matrix_expression<TriangularA> const& A,
+	matrix_expression<MatB>& B,
+	std::size_t blockSize
+){
+	typedef matrix_range<TriangularA const> SubA;
+	typedef matrix_range<MatB> SubB;
+	std::size_t n = A().size1();
+	std::size_t numBlocks = (n+blockSize-1)/blockSize;
+	for(std::size_t b = 0; b != numBlocks; ++b){
+		//lower: blocks from top to bottom, upper: from bottom to top
+		std::size_t block = Upper? numBlocks-b-1: b;
+		std::size_t start = block*blockSize;
+		std::size_t end = std::min(start+blockSize,n);
+		SubA Akk = subrange(A(),start,end,start,end);
+		SubB Bk = rows(B(),start,end);
+		trsm_impl<Unit>(Akk,Bk,boost::mpl::bool_<Upper>(),typename TriangularA::orientation());
+		if(!Upper && end != n){
+			SubB Brest = rows(B(),end,n);
+			axpy_prod(subrange(A(),end,n,start,end),Bk,Brest,false,-1.0);
+		}
+		if(Upper && start != 0){
+			SubB Brest = rows(B(),0,start);
+			axpy_prod(subrange(A(),0,start,start,end),Bk,Brest,false,-1.0);
+		}
+	}
+}
+
+//the columns of B are independent systems. They are split into tiles,
+//which are solved in parallel with the blocked algorithm.
 template <bool Upper, bool Unit,typename TriangularA, typename MatB>
 void trsm(
 	matrix_expression<TriangularA> const& A,
 	matrix_expression<MatB>& B,
 	boost::mpl::false_
 ){
-	trsm_impl<Unit>(
-		A,B,
-		boost::mpl::bool_<Upper>(),
-		typename TriangularA::orientation()
-	);
+	std::size_t const blockSize = 64;
+	std::size_t n = A().size1();
+	if(n <= blockSize){
+		trsm_impl<Unit>(
+			A,B,
+			boost::mpl::bool_<Upper>(),
+			typename TriangularA::orientation()
+		);
+		return;
+	}
+	std::size_t numColumns = B().size2();
+	std::size_t numTiles = std::max<std::size_t>(1,std::min(SHARK_NUM_THREADS,numColumns/16));
+	parallelBlocks(numColumns, numTiles, [&](std::size_t, std::size_t start, std::size_t end){
+		matrix_range<MatB> tile = columns(B(),start,end);
+		trsm_blocked<Upper,Unit>(A,tile,blockSize);
+	});
 }
 
 }}}
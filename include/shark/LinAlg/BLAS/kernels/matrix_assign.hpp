@@ -198,6 +198,36 @@ void assign(
 	}
 }
 
+//dense row-major case for vectorizable elementwise functions.
+//the argument is evaluated blockwise into a buffer to which the function is applied in a tight loop
+template<class M, class E, class F>
+typename boost::enable_if<detail::has_vectorizable<F> >::type assign(
+	matrix_expression<M> &m, 
+	matrix_expression<matrix_unary<E,F> > const& e,
+	row_major, row_major,dense_random_access_iterator_tag, dense_random_access_iterator_tag
+) {
+	typedef typename F::result_type value_type;
+	std::size_t const blockSize = 64;
+	value_type block[blockSize];
+	F const& f = e().functor();
+	std::size_t size1 = m().size1();
+	std::size_t size2 = m().size2();
+	for(std::size_t i = 0; i != size1; ++i){
+		for(std::size_t jblock = 0; jblock < size2; jblock += blockSize){
+			std::size_t current = std::min(blockSize, size2 - jblock);
+			for(std::size_t j = 0; j != current; ++j){
+				block[j] = e().expression()(i, jblock + j);
+			}
+			for(std::size_t j = 0; j != current; ++j){
+				block[j] = f(block[j]);
+			}
+			for(std::size_t j = 0; j != current; ++j){
+				m()(i, jblock + j) = block[j];
+			}
+		}
+	}
+}
+
 //remain the versions where both argumnts to not have the same orientation
 
 //dense-dense case
@@ -0,0 +1,61 @@
+/*!
+ * 
+ *
+ * \brief       -
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ * 
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ * 
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published 
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SHARK_LINALG_BLAS_KERNELS_POTRF_HPP
+#define SHARK_LINALG_BLAS_KERNELS_POTRF_HPP
+
+#ifdef SHARK_USE_ATLAS_LAPACK
+#include "atlas/potrf.hpp"
+#endif
+#include "default/potrf.hpp"
+
+namespace shark { namespace blas {namespace kernels{
+	
+///\brief Implements the POsitive definite TRiangular Factorization (POTRF).
+///
+/// The lower triangle of the symmetric positive definite matrix A is replaced by the lower
+/// Cholesky factor L with \f$ A=LL^T \f$. The strictly upper triangle is not read, its
+/// content is unspecified on exit.
+/// Returns 0 on success. If the matrix is not positive definite, a positive value is returned.
+template <typename MatA>
+std::size_t potrf(
+	matrix_expression<MatA>& A
+){
+	SIZE_CHECK(A().size1() == A().size2());
+#ifdef SHARK_USE_ATLAS_LAPACK
+	return bindings::potrf(CblasLower, A());
+#else
+	return bindings::potrf(A);
+#endif
+}
+
+}}}
+
+#endif
@@ -36,6 +36,7 @@
 #else
 #include "default/syev.hpp"
 #endif
+#include "default/syevx.hpp"
 	
 namespace shark { namespace blas {namespace kernels{
 	
@@ -56,6 +57,20 @@ void syev(
 	bindings::syev(matA,eigenValues);
 }
 
+///\brief Computes the k largest eigenvalues and their eigenvectors of a symmetric matrix (SYEVX).
+///
+/// Only the lower part of A is accessed. The eigenvectors are stored as the columns
+/// of the n x k matrix eigenVectors and the eigenvalues in descending order in eigenValues.
+template <typename MatrA, typename MatrV, typename VectorB>
+void syevx(
+	matrix_expression<MatrA> const& matA,
+	matrix_expression<MatrV>& eigenVectors,
+	vector_expression<VectorB>& eigenValues,
+	std::size_t k
+) {
+	bindings::syevx(matA,eigenVectors,eigenValues,k);
+}
+
 
 }}}
 #endif
\ No newline at end of file
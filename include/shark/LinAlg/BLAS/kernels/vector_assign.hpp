@@ -3,6 +3,8 @@
 
 #include "../detail/functional.hpp"
 #include "../expression_types.hpp"
+#include <boost/utility/enable_if.hpp>
+#include <algorithm>
 
 namespace shark {
 namespace blas {
@@ -34,6 +36,32 @@ void assign(
 		v()(i)=e()(i);
 	}
 }
+// Dense-Dense case for vectorizable elementwise functions
+// the argument is evaluated blockwise into a buffer to which the function is applied in a tight loop
+template< class V, class E, class F>
+typename boost::enable_if<detail::has_vectorizable<F> >::type assign(
+	vector_expression<V>& v, vector_expression<vector_unary<E,F> > const& e, 
+	dense_random_access_iterator_tag, dense_random_access_iterator_tag
+) {
+	SIZE_CHECK(v().size() == e().size());
+	typedef typename F::result_type value_type;
+	std::size_t const blockSize = 64;
+	value_type block[blockSize];
+	F const& f = e().functor();
+	std::size_t size = v().size();
+	for(std::size_t start = 0; start < size; start += blockSize){
+		std::size_t current = std::min(blockSize, size - start);
+		for(std::size_t i = 0; i != current; ++i){
+			block[i] = e().expression()(start + i);
+		}
+		for(std::size_t i = 0; i != current; ++i){
+			block[i] = f(block[i]);
+		}
+		for(std::size_t i = 0; i != current; ++i){
+			v()(start + i) = block[i];
+		}
+	}
+}
 // Dense-packed case
 template< class V, class E>
 void assign(
@@ -291,6 +291,14 @@ public:
 		return m_expression.size2();
 	}
 
+	// Expression accessors
+	expression_closure_type const &expression() const {
+		return m_expression;
+	}
+	functor_type const &functor() const {
+		return m_functor;
+	}
+
 	// Element access
 	const_reference operator()(index_type i, index_type j) const {
 		return m_functor(m_expression(i, j));
@@ -214,7 +214,8 @@ public:
 
 	void clear() {
 		m_nnz = 0;
-		m_rowStart [0] = 0;
+		std::fill(m_rowStart.begin(),m_rowStart.end(),0);
+		std::fill(m_rowEnd.begin(),m_rowEnd.end(),0);
 	}
 
 	// Element access
@@ -131,6 +131,9 @@ public:
 	expression_closure_type const &expression() const {
 		return m_expression;
 	}
+	functor_type const &functor() const {
+		return m_functor;
+	}
 
 public:
 	// Element access
@@ -67,6 +67,23 @@ void choleskyDecomposition(
 );
 
 
+/*!
+ *  \brief Inverse of a symmetric positive definite matrix from its lower Cholesky factor.
+ *
+ *  Given the lower triangular factor \f$L\f$ of \f$A = LL^T \f$, computes
+ *  \f$A^{-1} = L^{-T}L^{-1} \f$. As \f$L^{-1}\f$ is triangular, this needs about a third
+ *  of the operations of solving \f$AX=I\f$ with the factor. The work is split into
+ *  column tiles which are computed in parallel.
+ *
+ *  \param  L \f$ m \times m \f$ lower Cholesky factor of A
+ *  \param  inverse \f$ m \times m \f$ matrix, which stores the inverse of A
+ */
+template<class MatrixL,class MatrixInv>
+void choleskyInverse(
+	matrix_expression<MatrixL> const& L, 
+	matrix_expression<MatrixInv>& inverse
+);
+
 /// \brief Updates a covariance factor by a rank one update
 ///
 /// Let \f$ A=LL^T \f$ be a matrix with its lower cholesky factor. Assume we want to update 
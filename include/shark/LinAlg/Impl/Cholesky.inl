@@ -36,9 +36,8 @@
 #ifndef SHARK_IMPL_LINALG_CHOLESKY_INL
 #define SHARK_IMPL_LINALG_CHOLESKY_INL
 
-#ifdef SHARK_USE_ATLAS_LAPACK
-#include <shark/LinAlg/BLAS/kernels/atlas/potrf.hpp>
-#endif
+#include <shark/LinAlg/BLAS/kernels/potrf.hpp>
+#include <shark/LinAlg/BLAS/kernels/trsm.hpp>
 
 #include <shark/Core/Math.h>
 
@@ -48,40 +47,86 @@ void shark::blas::choleskyDecomposition(
 	matrix_expression<MatrixL>& L
 )
 {
+	SIZE_CHECK(A().size1() == A().size2());
 	size_t m = A().size1();
 	ensure_size(L,m, m);
-#ifdef SHARK_USE_ATLAS_LAPACK
-	L().clear();
 	for(std::size_t i = 0; i != m; ++i){
 		for(std::size_t j = 0; j <= i; ++j){
 			L()(i,j) = A()(i,j);
 		}
 	}
-	if(bindings::potrf(CblasLower,L()) != 0){
+	if(kernels::potrf(L) != 0){
 		throw SHARKEXCEPTION("[Cholesky Decomposition] The Matrix is not positive definite");
 	}
-#else
-	SIZE_CHECK(A().size1() == A().size2());
+	for(std::size_t i = 0; i != m; ++i){
+		for(std::size_t j = i+1; j != m; ++j){
+			L()(i,j) = 0;
+		}
+	}
+}
 
+template<class MatrixL,class MatrixInv>
+void shark::blas::choleskyInverse(
+	matrix_expression<MatrixL> const& L, 
+	matrix_expression<MatrixInv>& inverse
+){
+	SIZE_CHECK(L().size1() == L().size2());
+	std::size_t n = L().size1();
+	ensure_size(inverse,n,n);
+	if(n == 0) return;
 	
-	for(size_t j = 0; j < m; j++) {
-		for(size_t i = j; i < m; i++) {
-			double s = A()(i, j);
-			for(size_t k = 0; k < j; k++) {
-				s -= L()(i, k) * L()(j, k);
-			}
-			if (i == j) {
-				if(s<=0)
-					throw SHARKEXCEPTION("[Cholesky Decomposition] The Matrix is not positive definite");
-				L()(i, j) = std::sqrt(s);
-			}
-			else {
-				L()(i, j) = s/L()(j , j);
-				L()(j, i) = 0;
-			}
+	//the work is split into column tiles. As the work for the tile starting at column c
+	//is proportional to (n-c)^2, the tiles are grouped into one contiguous range per thread
+	//with about equal work
+	std::size_t const blockSize = 64;
+	std::size_t numTiles = (n+blockSize-1)/blockSize;
+	std::size_t numThreads = std::min(SHARK_NUM_THREADS,numTiles);
+	double totalWork = 0;
+	for(std::size_t t = 0; t != numTiles; ++t)
+		totalWork += shark::sqr(double(n-t*blockSize));
+	std::vector<std::size_t> bounds(1,0);
+	double work = 0;
+	for(std::size_t t = 0; t != numTiles; ++t){
+		work += shark::sqr(double(n-t*blockSize));
+		if(bounds.size() < numThreads && work >= totalWork*bounds.size()/numThreads)
+			bounds.push_back(t+1);
+	}
+	bounds.push_back(numTiles);
+	
+	//compute X=L^-1 which is lower triangular. The columns [c0,c1)
+	//are zero above row c0, so only the lower right part of L is needed
+	typedef typename MatrixL::value_type value_type;
+	matrix<value_type> X(n,n,value_type());
+	parallelBlocks(bounds, [&](std::size_t, std::size_t start, std::size_t end){
+		for(std::size_t t = start; t != end; ++t){
+			std::size_t c0 = t*blockSize;
+			std::size_t c1 = std::min(c0+blockSize,n);
+			matrix_range<matrix<value_type> > tile = subrange(X,c0,n,c0,c1);
+			for(std::size_t j = 0; j != c1-c0; ++j)
+				tile(j,j) = value_type(1);
+			kernels::trsm<false,false>(subrange(L(),c0,n,c0,n),tile);
+		}
+	});
+	
+	//A^-1 = X^T X. For rows and columns >= c0 only rows >= c0 of X contribute.
+	//we compute the lower triangle and mirror it.
+	parallelBlocks(bounds, [&](std::size_t, std::size_t start, std::size_t end){
+		for(std::size_t t = start; t != end; ++t){
+			std::size_t c0 = t*blockSize;
+			std::size_t c1 = std::min(c0+blockSize,n);
+			matrix_range<MatrixInv> tile = subrange(inverse(),c0,n,c0,c1);
+			axpy_prod(
+				trans(subrange(X,c0,n,c0,n)),
+				subrange(X,c0,n,c0,c1),
+				tile
+			);
+		}
+	});
+	for(std::size_t i = 0; i != n; ++i){
+		for(std::size_t j = i+1; j != n; ++j){
+			inverse()(i,j) = inverse()(j,i);
 		}
 	}
-#endif
 }
 
 template<class MatrixL>
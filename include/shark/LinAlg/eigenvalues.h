@@ -47,8 +47,8 @@ namespace shark{ namespace blas{
 /*!
  *  \brief Used as frontend for
  *  eigensymm for calculating the eigenvalues and the normalized eigenvectors of a symmetric matrix
- *  'A' using the Givens and Householder reduction. Each time this frontend is called additional
- *  memory is allocated for intermediate results.
+ *  'A' using a blocked Householder reduction to tridiagonal form and divide and conquer.
+ *  Each time this frontend is called additional memory is allocated for intermediate results.
  *
  *
  * \param A \f$ n \times n \f$ matrix, which must be symmetric, so only the bottom triangular matrix must contain values.
@@ -90,6 +90,33 @@ void eigensymm
 	kernels::syev(eigenVectors,eigenValues);
 }
 
+/*!
+ *  \brief Calculates only the k largest eigenvalues and the corresponding normalized eigenvectors
+ *  of a symmetric matrix 'A'.
+ *
+ *  The eigenvalues are found by bisection on the tridiagonal form of A and the eigenvectors
+ *  by inverse iteration. For \f$ k \ll n \f$ this is considerably faster than the complete
+ *  decomposition, for example when only the leading principal components are needed.
+ *
+ * \param A \f$ n \times n \f$ matrix, which must be symmetric, so only the bottom triangular matrix must contain values.
+ * \param eigenVectors \f$ n \times k \f$ matrix with the calculated normalized eigenvectors, each column contains an eigenvector.
+ * \param eigenValues k-dimensional vector with the calculated eigenvalues in descending order.
+ * \param k number of eigenvalues to compute, at most n.
+ */
+template<class MatrixT,class MatrixU,class VectorT>
+void eigensymm
+(
+	matrix_expression<MatrixT> const& A,
+	matrix_expression<MatrixU>& eigenVectors,
+	vector_expression<VectorT>& eigenValues,
+	std::size_t k
+)
+{
+	SIZE_CHECK(A().size2() == A().size1());
+	SIZE_CHECK(k <= A().size1());
+	kernels::syevx(A,eigenVectors,eigenValues,k);
+}
+
 
 
 /** @}*/
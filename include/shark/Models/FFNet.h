@@ -65,6 +65,11 @@ struct FFNetStructures{
 //! an input-output shotcut is used, that is a shortcut that connects the input neurons directly 
 //! with the output using linear weights. But also a fully connected structure is possible, where
 //! every layer is fed as input to every successive layer instead of only the next one.
+//!
+//! All weights, biases and shortcuts are stored in one contiguous parameter vector in the
+//! order returned by parameterVector(). The layer matrices are views into this vector and
+//! backpropagation uses their transposes, so no weights are duplicated and changing the parameters
+//! does not require any reorganisation. The vector can be accessed directly via parameterStorage().
 template<class HiddenNeuron,class OutputNeuron>
 class FFNet :public AbstractModel<RealVector,RealVector>
 {
@@ -97,7 +102,7 @@ public:
 	//! one version of the #setStructure methods needs to be called
 	//! to define the network topology.
 	FFNet()
-	:m_numberOfNeurons(0),m_inputNeurons(0),m_outputNeurons(0){
+	:m_numberOfNeurons(0),m_inputNeurons(0),m_outputNeurons(0),m_biasStart(0),m_biasSize(0),m_shortcutStart(0){
 		m_features|=HAS_FIRST_PARAMETER_DERIVATIVE;
 		m_features|=HAS_FIRST_INPUT_DERIVATIVE;
 	}
@@ -124,39 +129,88 @@ public:
 	}
 
 	//! \brief Returns the matrices for every layer used by eval.
-	std::vector<RealMatrix> const& layerMatrices()const{
-		return m_layerMatrix;
+	//!
+	//! The matrices are views into the parameter vector.
+	std::vector<blas::dense_matrix_adaptor<double const> > layerMatrices()const{
+		std::vector<blas::dense_matrix_adaptor<double const> > matrices;
+		for(std::size_t i = 0; i != m_layerRows.size(); ++i){
+			matrices.push_back(layerMatrix(i));
+		}
+		return matrices;
 	}
 	
 	//! \brief Returns the weight matrix of the i-th layer.
-	RealMatrix const& layerMatrix(std::size_t layer)const{
-		return m_layerMatrix[layer];
+	blas::dense_matrix_adaptor<double const> layerMatrix(std::size_t layer)const{
+		return blas::dense_matrix_adaptor<double const>(
+			m_parameters.storage()+m_layerStart[layer], m_layerRows[layer], m_layerColumns[layer]
+		);
 	}
 	
 	void setLayer(std::size_t layerNumber, RealMatrix const& m, RealVector const& bias){
 		SIZE_CHECK(m.size1() == bias.size());
-		SIZE_CHECK(m.size1() == m_layerMatrix[layerNumber].size1());
-		SIZE_CHECK(m.size2() == m_layerMatrix[layerNumber].size2());
-		m_layerMatrix[layerNumber] = m;
-		std::size_t start = 0;
-		for(std::size_t i = 0; i != layerNumber; ++i){
-			start += m_layerMatrix[i].size1();
+		SIZE_CHECK(m.size1() == m_layerRows[layerNumber]);
+		SIZE_CHECK(m.size2() == m_layerColumns[layerNumber]);
+		blas::dense_matrix_adaptor<double> weights(
+			m_parameters.storage()+m_layerStart[layerNumber], m_layerRows[layerNumber], m_layerColumns[layerNumber]
+		);
+		noalias(weights) = m;
+		if(m_biasSize != 0){
+			std::size_t start = 0;
+			for(std::size_t i = 0; i != layerNumber; ++i){
+				start += m_layerRows[i];
+			}
+			noalias(subrange(m_parameters,m_biasStart+start,m_biasStart+start+bias.size())) = bias;
 		}
-		noalias(subrange(m_bias,start,start+bias.size())) = bias;
-		//set backprop matrices
-		setParameterVector(parameterVector());
 	}
 
-	//! \brief Returns the matrices for every layer used by backpropagation.
-	std::vector<RealMatrix> const& backpropMatrices()const{
-		return m_backpropMatrix;
+	//! \brief Returns the matrices for every layer as used by backpropagation.
+	//!
+	//! Row i of the k-th matrix holds the weights of all connections starting in neuron i of the k-th layer
+	//! (layer 0 being the inputs). The matrices are assembled from the layer matrices on every call,
+	//! backpropagation itself works directly on the transposed layer matrices.
+	std::vector<RealMatrix> backpropMatrices()const{
+		std::vector<RealMatrix> backprop(m_layerRows.size());
+		//for all connections of a neuron i with a neuron j, i->j
+		//the backpropagation matrix has an entry j->i.
+		std::size_t layeriStart = 0;
+		for(std::size_t layeri = 0; layeri != m_layerRows.size(); ++layeri){
+			std::size_t neuronsi = layeri == 0? inputSize() : m_layerRows[layeri-1];
+			std::size_t layerjStart = layeriStart + neuronsi;
+			std::size_t connectedNeurons = 0;
+			for(std::size_t layerj = layeri; layerj != m_layerRows.size(); ++layerj){
+				//only process, if layer j has connections with layer i
+				if(layerjStart-m_layerColumns[layerj] <= layeriStart)
+					connectedNeurons += m_layerRows[layerj];
+				layerjStart += m_layerRows[layerj];
+			}
+			backprop[layeri].resize(neuronsi,connectedNeurons);
+			std::size_t columni = 0;
+			layerjStart = layeriStart + neuronsi;
+			for(std::size_t layerj = layeri; layerj != m_layerRows.size(); ++layerj){
+				std::size_t neuronsj = m_layerRows[layerj];
+				if(layerjStart-m_layerColumns[layerj] <= layeriStart){
+					//Start of the weight columns to layer i in layer j.
+					//parantheses are important to protect against underflow
+					std::size_t weightStartj = layeriStart -(layerjStart - m_layerColumns[layerj]);
+					noalias(columns(backprop[layeri],columni,columni+neuronsj)) 
+					= trans(columns(layerMatrix(layerj),weightStartj,weightStartj+neuronsi)); 
+					columni += neuronsj;
+				}
+				layerjStart += neuronsj; 
+			}
+			layeriStart += neuronsi;
+		}
+		return backprop;
 	}
 	
 	//! \brief Returns the direct shortcuts between input and output neurons.
 	//!
 	//! This does not necessarily exist.
-	RealMatrix const& inputOutputShortcut() const{
-		return m_inputOutputShortcut;
+	blas::dense_matrix_adaptor<double const> inputOutputShortcut() const{
+		bool hasShortcut = m_shortcutStart != m_parameters.size();
+		return blas::dense_matrix_adaptor<double const>(
+			m_parameters.storage()+m_shortcutStart, hasShortcut? m_outputNeurons: 0, hasShortcut? m_inputNeurons : 0
+		);
 	}
 	
 	/// \brief Returns the activation function of the hidden units.
@@ -182,73 +236,48 @@ public:
 	//! This is either empty or a vector of size numberOfNeurons()-inputSize().
 	//! the first entry is the value of the first hidden unit while the last outputSize() units
 	//! are the values of the output units.
-	const RealVector& bias()const{
-		return m_bias;
+	ConstRealVectorRange bias()const{
+		return subrange(m_parameters,m_biasStart,m_biasStart+m_biasSize);
 	}
 	
 	///\brief Returns the portion of the bias vector of the i-th layer.
-	RealVector bias(std::size_t layer)const{
-		std::size_t start = 0;
+	ConstRealVectorRange bias(std::size_t layer)const{
+		std::size_t start = m_biasStart;
 		for(std::size_t i = 0; i != layer; ++i){
-			start +=layerMatrices()[i].size1();
+			start += m_layerRows[i];
 		}
-		return subrange(m_bias,start,start+layerMatrices()[layer].size1());
+		return subrange(m_parameters,start,start+m_layerRows[layer]);
 	}
 	
 	//! \brief Returns the total number of parameters of the network. 
 	std::size_t numberOfParameters()const{
-		std::size_t numParams = m_inputOutputShortcut.size1()*m_inputOutputShortcut.size2();
-		numParams += bias().size();
-		for(std::size_t i = 0; i != layerMatrices().size(); ++i){
-			numParams += layerMatrices()[i].size1()*layerMatrices()[i].size2();
-		}
-		return numParams;
+		return m_parameters.size();
 	}
 
 	//! returns the vector of used parameters inside the weight matrix
 	RealVector parameterVector() const{
-		RealVector parameters(numberOfParameters());
-		init(parameters) << matrixSet(m_layerMatrix),m_bias,toVector(m_inputOutputShortcut);
-		return parameters;
+		return m_parameters;
 	}
 	//! uses the values inside the parametervector to set the used values inside the weight matrix
 	void setParameterVector(RealVector const& newParameters){
-		//set the normal forward propagation weights
-		init(newParameters) >> matrixSet(m_layerMatrix),m_bias,toVector(m_inputOutputShortcut);
-		
-		//we also have to update the backpropagation weights
-		//this is more or less an inversion. for all connections of a neuron i with a neuron j, i->j
-		//the backpropagation matrix has an entry j->i.
-		
-		// we start with all neurons in layer i, looking at all layers j > i and checking whether 
-		// they are connected, in this case we transpose the part of the matrix which is connecting
-		// layer j with layer i and copying it into the backprop matrix.
-		// we assume here, that either all neurons in layer j are connected to all neurons in layer i
-		// or that there are no connections at all beetween the layers.
-		std::size_t layeriStart = 0;
-		for(std::size_t layeri = 0; layeri != m_layerMatrix.size(); ++layeri){
-			std::size_t columni = 0;
-			std::size_t neuronsi = inputSize();
-			if(layeri > 0)
-				neuronsi = m_layerMatrix[layeri-1].size1();
-			
-			std::size_t layerjStart = layeriStart + neuronsi;
-			for(std::size_t layerj = layeri; layerj != m_layerMatrix.size(); ++layerj){
-				std::size_t neuronsj = m_layerMatrix[layerj].size1();
-				//only process, if layer j has connections with layer i
-				if(layerjStart-m_layerMatrix[layerj].size2() <= layeriStart){
-					
-					//Start of the weight columns to layer i in layer j.
-					//parantheses are important to protect against underflow
-					std::size_t weightStartj = layeriStart -(layerjStart - m_layerMatrix[layerj].size2());
-					noalias(columns(m_backpropMatrix[layeri],columni,columni+neuronsj)) 
-					= trans(columns(m_layerMatrix[layerj],weightStartj,weightStartj+neuronsi)); 
-				}
-				columni += neuronsj;
-				layerjStart += neuronsj; 
-			}
-			layeriStart += neuronsi;
-		}
+		SIZE_CHECK(newParameters.size() == m_parameters.size());
+		noalias(m_parameters) = newParameters;
+	}
+	
+	//! \brief The network stores all parameters in one contiguous vector.
+	bool hasParameterStorage()const{
+		return true;
+	}
+	//! \brief Returns the vector holding the parameters in the order of parameterVector().
+	//!
+	//! The layer matrices, biases and shortcuts are views into this vector, thus changes
+	//! take effect immediately without a call to setParameterVector.
+	RealVector& parameterStorage(){
+		return m_parameters;
+	}
+	//! \brief Returns the vector holding the parameters in the order of parameterVector().
+	RealVector const& parameterStorage()const{
+		return m_parameters;
 	}
 
 	//! \brief Returns the output of all neurons after the last call of eval
@@ -270,22 +299,25 @@ public:
 	/// be aware that this only works without shortcuts in the network
 	void evalLayer(std::size_t layer,RealMatrix const& patterns,RealMatrix& outputs)const{
 		std::size_t numPatterns = patterns.size1();
-		std::size_t numOutputs = m_layerMatrix[layer].size1();
+		std::size_t numOutputs = m_layerRows[layer];
 		outputs.resize(numPatterns,numOutputs);
 		outputs.clear();
 
-		//calculate activation. first compute the linear part and the optional bias and then apply
-		// the non-linearity
+		//calculate activation. first compute the linear part, then add the optional bias
+		//and apply the non-linearity in a single pass
 		axpy_prod(patterns,trans(layerMatrix(layer)),outputs);
-		if(!bias().empty()){
-			noalias(outputs) += repeat(bias(layer),numPatterns);
-		}
 		// if this is the last layer, use output neuron response
-		if(layer < m_layerMatrix.size()-1) {
-			noalias(outputs) = m_hiddenNeuron(outputs);
+		if(layer < m_layerRows.size()-1) {
+			if(m_biasSize != 0)
+				noalias(outputs) = m_hiddenNeuron(outputs + repeat(bias(layer),numPatterns));
+			else
+				noalias(outputs) = m_hiddenNeuron(outputs);
 		}
 		else {
-			noalias(outputs) = m_outputNeuron(outputs);
+			if(m_biasSize != 0)
+				noalias(outputs) = m_outputNeuron(outputs + repeat(bias(layer),numPatterns));
+			else
+				noalias(outputs) = m_outputNeuron(outputs);
 		}
 	}
 	
@@ -311,8 +343,8 @@ public:
 		noalias(rows(s.responses,0,m_inputNeurons)) = trans(patterns);
 		std::size_t beginNeuron = m_inputNeurons;
 		
-		for(std::size_t layer = 0; layer != m_layerMatrix.size();++layer){
-			const RealMatrix& weights = m_layerMatrix[layer];
+		for(std::size_t layer = 0; layer != m_layerRows.size();++layer){
+			blas::dense_matrix_adaptor<double const> weights = layerMatrix(layer);
 			//number of rows of the layer is also the number of neurons
 			std::size_t endNeuron = beginNeuron + weights.size1();
 			//some subranges of vectors
@@ -321,26 +353,19 @@ public:
 			//the neurons responses
 			RealSubMatrix responses = rows(s.responses,beginNeuron,endNeuron);
 
-			//calculate activation. first compute the linear part and the optional bias and then apply
-			// the non-linearity
+			//calculate activation. first compute the linear part, then add the optional bias
+			//and apply the non-linearity in a single pass over the responses
 			axpy_prod(weights,input,responses);
-			if(!bias().empty()){
-				//the bias of the layer is shifted as input units can not have bias.
-				ConstRealVectorRange bias = subrange(m_bias,beginNeuron-inputSize(),endNeuron-inputSize());
-				noalias(responses) += trans(repeat(bias,numPatterns));
+			// if this is the last layer, use output neuron response instead
+			if(layer < m_layerRows.size()-1) {
+				applyNeuron(m_hiddenNeuron,responses,beginNeuron);
 			}
-			SHARK_CRITICAL_REGION{//beware Dropout Neurons!
-				// if this is the last layer, use output neuron response instead
-				if(layer < m_layerMatrix.size()-1) {
-					noalias(responses) = m_hiddenNeuron(responses);
-				}
-				else {
-					//add shortcuts if necessary
-					if(m_inputOutputShortcut.size1() != 0){
-						axpy_prod(m_inputOutputShortcut,trans(patterns),responses,false);
-					}
-					noalias(responses) = m_outputNeuron(responses);
+			else {
+				//add shortcuts if necessary
+				if(inputOutputShortcut().size1() != 0){
+					axpy_prod(inputOutputShortcut(),trans(patterns),responses,false);
 				}
+				applyNeuron(m_outputNeuron,responses,beginNeuron);
 			}
 			//go to the next layer
 			beginNeuron = endNeuron;
@@ -463,8 +488,7 @@ public:
 		bool biasNeuron = true
 	){
 		SIZE_CHECK(layers.size() >= 2);
-		m_layerMatrix.resize(layers.size()-1);//we don't model the input layer
-		m_backpropMatrix.resize(layers.size()-1);//we don't model the output layer
+		std::size_t numLayers = layers.size()-1;//we don't model the input layer
 		
 		//small optimization for ntworks with only 3 layers
 		//in this case, we don't need an explicit shortcut as we can integrate it into
@@ -479,32 +503,27 @@ public:
 		for(std::size_t i = 0; i != layers.size(); ++i){
 			m_numberOfNeurons += layers[i];
 		}
-		if(biasNeuron){
-			m_bias.resize(m_numberOfNeurons - m_inputNeurons);
-		}
 		
+		std::vector<std::size_t> layerColumns(numLayers);
 		if(connectivity == FFNetStructures::Full){
 			//connect to all previous layers.
 			std::size_t numNeurons = layers[0];
-			for(std::size_t i = 0; i != m_layerMatrix.size(); ++i){
-				m_layerMatrix[i].resize(layers[i+1],numNeurons);
-				m_backpropMatrix[i].resize(layers[i],m_numberOfNeurons-numNeurons);
+			for(std::size_t i = 0; i != numLayers; ++i){
+				layerColumns[i] = numNeurons;
 				numNeurons += layers[i+1];
-				
 			}
-			m_inputOutputShortcut.resize(0,0);
 		}else{
 			//only connect with the previous layer
-			for(std::size_t i = 0; i != m_layerMatrix.size(); ++i){
-				m_layerMatrix[i].resize(layers[i+1],layers[i]);
-				m_backpropMatrix[i].resize(layers[i],layers[i+1]);
-			}
-			
-			//create a shortcut from input to output when desired
-			if(connectivity == FFNetStructures::InputOutputShortcut){
-				m_inputOutputShortcut.resize(m_outputNeurons,m_inputNeurons);
+			for(std::size_t i = 0; i != numLayers; ++i){
+				layerColumns[i] = layers[i];
 			}
 		}
+		//create a shortcut from input to output when desired
+		bool shortcut = connectivity == FFNetStructures::InputOutputShortcut;
+		allocateParameters(
+			std::vector<std::size_t>(layers.begin()+1,layers.end()),layerColumns,
+			biasNeuron, shortcut
+		);
 	}
 	
 	//!  \brief Creates a connection matrix for a network with a
@@ -573,10 +592,24 @@ public:
 		archive>>m_inputNeurons;
 		archive>>m_outputNeurons;
 		archive>>m_numberOfNeurons;
-		archive>>m_layerMatrix;
-		archive>>m_backpropMatrix;
-		archive>>m_inputOutputShortcut;
-		archive>>m_bias;
+		//the archive stores the matrices separately, gather them in the parameter vector
+		std::vector<RealMatrix> layerMatrices;
+		std::vector<RealMatrix> backpropMatrices;
+		RealMatrix inputOutputShortcut;
+		RealVector bias;
+		archive>>layerMatrices;
+		archive>>backpropMatrices;
+		archive>>inputOutputShortcut;
+		archive>>bias;
+		
+		std::vector<std::size_t> layerRows(layerMatrices.size());
+		std::vector<std::size_t> layerColumns(layerMatrices.size());
+		for(std::size_t i = 0; i != layerMatrices.size(); ++i){
+			layerRows[i] = layerMatrices[i].size1();
+			layerColumns[i] = layerMatrices[i].size2();
+		}
+		allocateParameters(layerRows,layerColumns,!bias.empty(),inputOutputShortcut.size1() != 0);
+		init(m_parameters) << matrixSet(layerMatrices),bias,toVector(inputOutputShortcut);
 	}
 
 	//! From ISerializable, writes a model to an archive
@@ -584,15 +617,59 @@ public:
 		archive<<m_inputNeurons;
 		archive<<m_outputNeurons;
 		archive<<m_numberOfNeurons;
-		archive<<m_layerMatrix;
-		archive<<m_backpropMatrix;
-		archive<<m_inputOutputShortcut;
-		archive<<m_bias;
+		std::vector<RealMatrix> layerMatrices(m_layerRows.size());
+		for(std::size_t i = 0; i != m_layerRows.size(); ++i){
+			layerMatrices[i] = layerMatrix(i);
+		}
+		archive<<layerMatrices;
+		archive<<backpropMatrices();
+		archive<<RealMatrix(inputOutputShortcut());
+		archive<<RealVector(bias());
 	}
 
 
 private:
 	
+	//! \brief Adds the bias of the neurons starting at beginNeuron and applies the activation function.
+	template<class Neuron>
+	void applyNeuron(Neuron const& neuron, RealSubMatrix& responses, std::size_t beginNeuron)const{
+		if(m_biasSize != 0){
+			//the bias of the layer is shifted as input units can not have bias.
+			std::size_t biasStart = m_biasStart + beginNeuron - inputSize();
+			ConstRealVectorRange bias = subrange(m_parameters,biasStart,biasStart+responses.size1());
+			noalias(responses) = neuron(responses + trans(repeat(bias,responses.size2())));
+		}else{
+			noalias(responses) = neuron(responses);
+		}
+	}
+	
+	//! \brief Sets the shapes of the weight matrices and allocates the parameter vector.
+	void allocateParameters(
+		std::vector<std::size_t> const& layerRows,
+		std::vector<std::size_t> const& layerColumns,
+		bool bias, bool shortcut
+	){
+		SIZE_CHECK(layerRows.size() == layerColumns.size());
+		m_layerRows = layerRows;
+		m_layerColumns = layerColumns;
+		m_layerStart.resize(layerRows.size());
+		std::size_t numParams = 0;
+		std::size_t numNeurons = 0;
+		for(std::size_t i = 0; i != layerRows.size(); ++i){
+			m_layerStart[i] = numParams;
+			numParams += layerRows[i]*layerColumns[i];
+			numNeurons += layerRows[i];
+		}
+		m_biasStart = numParams;
+		m_biasSize = bias? numNeurons : 0;
+		m_shortcutStart = m_biasStart + m_biasSize;
+		numParams = m_shortcutStart;
+		if(shortcut)
+			numParams += m_inputNeurons*m_outputNeurons;
+		m_parameters.resize(numParams);
+		m_parameters.clear();
+	}
+	
 	void computeDelta(
 		RealMatrix& delta, State const& state, bool computeInputDelta
 	)const{
@@ -604,34 +681,35 @@ private:
 		ConstRealSubMatrix outputResponse = rows(s.responses,delta.size1()-outputSize(),delta.size1());
 		noalias(outputDelta) *= m_outputNeuron.derivative(outputResponse);
 
-		//iterate backwards using the backprop matrix and propagate the errors to get the needed delta values
-		//we stop until we have filled all delta values. Thus we might not necessarily compute all layers.
-		
-		//last neuron of the current layer that we need to compute
-		//we don't need (or can not) compute the values of the output neurons as they are given from the outside
-		std::size_t endNeuron = delta.size1()-outputSize();
-		std::size_t layer = m_backpropMatrix.size()-1;
-		std::size_t endIndex = computeInputDelta? 0: inputSize();
-		while(endNeuron > endIndex){
-			
-			RealMatrix const& weights = m_backpropMatrix[layer];
-			std::size_t beginNeuron = endNeuron - weights.size1();//first neuron of the current layer
-			//get the delta and response values of this layer
+		//iterate backwards over the layers. Once the delta of a layer is complete, it is propagated
+		//to all neurons feeding into the layer using the transposed layer matrix. As the inputs of
+		//a layer are a consecutive range of neurons, this is a single matrix product per layer.
+		//all later layers have propagated their delta values when a layer is reached, thus its delta is complete.
+		std::size_t endNeuron = delta.size1();
+		for(std::size_t layer = m_layerRows.size(); layer != 0; --layer){
+			std::size_t beginNeuron = endNeuron - m_layerRows[layer-1];
 			RealSubMatrix layerDelta = rows(delta,beginNeuron,endNeuron);
-			RealSubMatrix layerDeltaInput = rows(delta,endNeuron,endNeuron+weights.size2());
-			ConstRealSubMatrix layerResponse = rows(s.responses,beginNeuron,endNeuron);
-
-			axpy_prod(weights,layerDeltaInput,layerDelta,false);//add the values to the maybe non-empty delta part
-			if(layer != 0){
+			if(layer != m_layerRows.size()){
+				ConstRealSubMatrix layerResponse = rows(s.responses,beginNeuron,endNeuron);
 				noalias(layerDelta) *= m_hiddenNeuron.derivative(layerResponse);
 			}
-			//go a layer backwards
-			endNeuron=beginNeuron;
-			--layer;
+			
+			//the input delta values are only computed if asked for
+			std::size_t inputBegin = beginNeuron - m_layerColumns[layer-1];
+			std::size_t propagateBegin = computeInputDelta? inputBegin: std::max(inputBegin,inputSize());
+			if(propagateBegin < beginNeuron){
+				axpy_prod(
+					trans(columns(layerMatrix(layer-1),propagateBegin-inputBegin,m_layerColumns[layer-1])),
+					layerDelta,
+					rows(delta,propagateBegin,beginNeuron),
+					false
+				);//add the values to the maybe non-empty delta part
+			}
+			endNeuron = beginNeuron;
 		}
 		
 		//add the shortcut deltas if necessary
-		if(inputOutputShortcut().size1() != 0)
+		if(computeInputDelta && inputOutputShortcut().size1() != 0)
 			axpy_prod(trans(inputOutputShortcut()),outputDelta,rows(delta,0,inputSize()),false);
 	}
 	
@@ -643,9 +721,9 @@ private:
 		gradient.resize(numberOfParameters());
 		std::size_t pos = 0;
 		std::size_t layerStart = inputSize();
-		for(std::size_t layer = 0; layer != layerMatrices().size(); ++layer){
-			std::size_t layerRows =  layerMatrices()[layer].size1();
-			std::size_t layerColumns =  layerMatrices()[layer].size2();
+		for(std::size_t layer = 0; layer != m_layerRows.size(); ++layer){
+			std::size_t layerRows =  m_layerRows[layer];
+			std::size_t layerColumns =  m_layerColumns[layer];
 			std::size_t params = layerRows*layerColumns;
 			axpy_prod(
 				rows(delta,layerStart,layerStart+layerRows),
@@ -657,7 +735,7 @@ private:
 			layerStart += layerRows;
 		}
 		//check whether we need the bias derivative
-		if(!bias().empty()){
+		if(m_biasSize != 0){
 			//calculate bias derivative
 			for (std::size_t neuron = m_inputNeurons; neuron < m_numberOfNeurons; neuron++){
 				gradient(pos) = sum(row(delta,neuron));
@@ -685,28 +763,34 @@ private:
 	std::size_t m_inputNeurons;
 	std::size_t m_outputNeurons;
 
-	//! \brief represents the connection matrix using a layered structure for forward propagation
+	//! \brief All parameters of the network.
+	//!
+	//! The layer matrices are stored first, row major and in order of the layers, followed by the bias
+	//! and the optional input-output shortcut.
+	RealVector m_parameters;
+	
+	//! \brief Shape of the connection matrix of every layer using a layered structure for forward propagation
 	//!
 	//! a layer is made of neurons with consecutive indizes which are not
 	//! connected with each other. In other words, if there exists a k i<k<j such
 	//! that C(i,k) = 1 or C(k,j) = 1 or C(j,i) = 1 than the neurons i,j are not in the same layer.
 	//! This is the forward view, meaning that the layers holds the weights which are used to calculate
-	//! the activation of the neurons of the layer.
-	std::vector<RealMatrix> m_layerMatrix;
+	//! the activation of the neurons of the layer. The matrix of a layer connects it with the
+	//! m_layerColumns[i] neurons preceding it.
+	std::vector<std::size_t> m_layerRows;
+	std::vector<std::size_t> m_layerColumns;
+	//! \brief Start of the matrix of every layer in the parameter vector.
+	std::vector<std::size_t> m_layerStart;
 	
-	//! \brief optional matrix directly connecting input to output
-	//!
-	//! This is only filled when the ntworkhas an input-output shortcut but not a full layer connection.
-	RealMatrix m_inputOutputShortcut;
+	//! start and size of the bias weights of the neurons in the parameter vector
+	std::size_t m_biasStart;
+	std::size_t m_biasSize;
 	
-	//!\brief represents the backwards view of the network as layered structure.
+	//! \brief Start of the optional matrix directly connecting input to output.
 	//!
-	//! This is the backward view of the Network which is used for the backpropagation step. So every
-	//! Matrix contains the weights of the neurons which are activatived by the layer.
-	std::vector<RealMatrix> m_backpropMatrix;
-
-	//! bias weights of the neurons
-	RealVector m_bias;
+	//! This is only used when the network has an input-output shortcut but not a full layer connection.
+	//! Without shortcut, it is equal to the number of parameters.
+	std::size_t m_shortcutStart;
 
 	//!Type of hidden neuron. See Models/Neurons.h for a few choices
 	HiddenNeuron m_hiddenNeuron;
@@ -0,0 +1,356 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Prediction-only kernel expansion with packed support vectors
+ *
+ * \par
+ * A CompiledKernelExpansion is built from a trained KernelExpansion
+ * and evaluates the same function as a sequence of matrix-matrix
+ * products over contiguous blocks of support vectors.
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#ifndef SHARK_MODELS_KERNELS_COMPILEDKERNELEXPANSION_H
+#define SHARK_MODELS_KERNELS_COMPILEDKERNELEXPANSION_H
+
+#include <shark/Models/Kernels/KernelExpansion.h>
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/Models/Kernels/LinearKernel.h>
+#include <shark/Models/Kernels/PolynomialKernel.h>
+#include <shark/Core/OpenMP.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace shark {
+
+
+///
+/// \brief Fast prediction form of a KernelExpansion over dense inputs.
+///
+/// The KernelExpansion evaluates the kernel batch by batch on the basis and
+/// allocates a new kernel matrix for every batch. For models with many support
+/// vectors this dominates the prediction time. The CompiledKernelExpansion is
+/// constructed from a trained expansion and
+/// <ul>
+/// <li> drops all basis vectors with zero coefficients,</li>
+/// <li> packs the remaining support vectors into one contiguous matrix and
+///      stores their squared norms,</li>
+/// <li> evaluates the kernel as a matrix-matrix product followed by one fused
+///      elementwise transformation,</li>
+/// <li> splits the support vectors into blocks which are processed in parallel,
+///      so that even a single pattern is evaluated by all threads,</li>
+/// <li> keeps all intermediate matrices in the State of the model so that they
+///      can be reused between calls.</li>
+/// </ul>
+/// Supported are the GaussianRbfKernel, LinearKernel and PolynomialKernel on RealVector.
+/// A linear kernel is collapsed into one weight vector per output.
+///
+/// The storage type of the support vectors can be chosen as float to halve memory
+/// bandwidth at the cost of precision. The model has no parameters and can not be trained;
+/// after changing the source expansion, compile() needs to be called again.
+///
+/// \tparam ValueType storage type of the support vectors and intermediate results
+///
+template<class ValueType = double>
+class CompiledKernelExpansion : public AbstractModel<RealVector, RealVector>
+{
+private:
+	typedef AbstractModel<RealVector, RealVector> base_type;
+	typedef blas::matrix<ValueType, blas::row_major> MatrixType;
+	typedef blas::vector<ValueType> VectorType;
+
+	struct InternalState: public State{
+		MatrixType inputs;
+		VectorType inputNorms;
+		std::vector<MatrixType> kernelBlocks;//one per thread
+		std::vector<MatrixType> outputs;//one per thread
+
+		void resize(std::size_t numPatterns, std::size_t inputSize, std::size_t outputSize, std::size_t numThreads){
+			inputs.resize(numPatterns, inputSize);
+			inputNorms.resize(numPatterns);
+			kernelBlocks.resize(numThreads);
+			outputs.resize(numThreads);
+			for(std::size_t t = 0; t != numThreads; ++t){
+				outputs[t].resize(numPatterns, outputSize);
+				outputs[t].clear();
+			}
+		}
+	};
+public:
+	typedef base_type::BatchInputType BatchInputType;
+	typedef base_type::BatchOutputType BatchOutputType;
+
+	/// \brief Kernel functions which can be compiled.
+	enum KernelClass{
+		LINEAR_KERNEL = 0,
+		POLYNOMIAL_KERNEL = 1,
+		GAUSSIAN_KERNEL = 2
+	};
+
+	CompiledKernelExpansion(std::size_t blockSize = 1024)
+	: m_kernelClass(LINEAR_KERNEL), m_gamma(0), m_degree(1), m_kernelOffset(0), m_blockSize(blockSize){
+		SHARK_CHECK(blockSize > 0, "[CompiledKernelExpansion::CompiledKernelExpansion] block size must be positive");
+	}
+
+	CompiledKernelExpansion(KernelExpansion<RealVector> const& expansion, std::size_t blockSize = 1024)
+	: m_kernelClass(LINEAR_KERNEL), m_gamma(0), m_degree(1), m_kernelOffset(0), m_blockSize(blockSize){
+		SHARK_CHECK(blockSize > 0, "[CompiledKernelExpansion::CompiledKernelExpansion] block size must be positive");
+		compile(expansion);
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "CompiledKernelExpansion"; }
+
+	/// \brief Packs the support vectors and kernel parameters of the expansion.
+	///
+	/// \throws shark::Exception if the kernel of the expansion is not supported.
+	void compile(KernelExpansion<RealVector> const& expansion){
+		SHARK_CHECK(expansion.kernel() != NULL, "[CompiledKernelExpansion::compile] expansion has no kernel");
+		AbstractKernelFunction<RealVector> const* kernel = expansion.kernel();
+		if(GaussianRbfKernel<RealVector> const* k = dynamic_cast<GaussianRbfKernel<RealVector> const*>(kernel)){
+			m_kernelClass = GAUSSIAN_KERNEL;
+			m_gamma = k->gamma();
+		}else if(PolynomialKernel<RealVector> const* k = dynamic_cast<PolynomialKernel<RealVector> const*>(kernel)){
+			m_kernelClass = POLYNOMIAL_KERNEL;
+			m_degree = k->degree();
+			m_kernelOffset = k->offset();
+			if(m_degree == 1 && m_kernelOffset == 0.0)
+				m_kernelClass = LINEAR_KERNEL;
+		}else if(dynamic_cast<LinearKernel<RealVector> const*>(kernel)){
+			m_kernelClass = LINEAR_KERNEL;
+		}else{
+			throw SHARKEXCEPTION("[CompiledKernelExpansion::compile] unsupported kernel "+kernel->name());
+		}
+
+		RealMatrix const& alpha = expansion.alpha();
+		std::size_t outputs = alpha.size2();
+		std::size_t dim = expansion.basis().numberOfElements() == 0? 0: dataDimension(expansion.basis());
+
+		//find the support vectors
+		std::vector<std::size_t> svIndices;
+		for(std::size_t i = 0; i != alpha.size1(); ++i){
+			if(norm_1(row(alpha, i)) > 0.0)
+				svIndices.push_back(i);
+		}
+
+		//pack the support vectors and their coefficients
+		m_basis.resize(svIndices.size(), dim);
+		m_alpha.resize(svIndices.size(), outputs);
+		std::size_t sv = 0;
+		std::size_t element = 0;
+		for(std::size_t b = 0; b != expansion.basis().numberOfBatches() && sv != svIndices.size(); ++b){
+			RealMatrix const& batch = expansion.basis().batch(b);
+			for(std::size_t i = 0; i != batch.size1() && sv != svIndices.size(); ++i, ++element){
+				if(svIndices[sv] != element) continue;
+				noalias(row(m_basis, sv)) = row(batch, i);
+				noalias(row(m_alpha, sv)) = row(alpha, element);
+				++sv;
+			}
+		}
+
+		//the linear kernel collapses to one weight vector per output: f(x) = <x, sum_i alpha_i x_i>
+		if(m_kernelClass == LINEAR_KERNEL){
+			MatrixType weights(outputs, dim);
+			axpy_prod(trans(m_alpha), m_basis, weights);
+			swap(m_basis, weights);
+			m_alpha.resize(outputs, outputs);
+			noalias(m_alpha) = blas::identity_matrix<ValueType>(outputs);
+		}
+
+		m_basisNorms.resize(m_basis.size1());
+		for(std::size_t i = 0; i != m_basis.size1(); ++i){
+			m_basisNorms(i) = norm_sqr(row(m_basis, i));
+		}
+
+		if(expansion.hasOffset())
+			m_b = expansion.offset();
+		else
+			m_b = RealVector(outputs, 0.0);
+	}
+
+	/// \brief Returns the class of the compiled kernel function.
+	KernelClass kernelClass()const{
+		return m_kernelClass;
+	}
+
+	/// \brief Dimensionality of the input patterns.
+	std::size_t inputSize()const{
+		return m_basis.size2();
+	}
+
+	/// \brief Dimensionality of the output RealVector.
+	std::size_t outputSize()const{
+		return m_b.size();
+	}
+
+	/// \brief Number of packed basis vectors.
+	///
+	/// This is the number of support vectors of the compiled expansion,
+	/// or the number of outputs in case of a linear kernel.
+	std::size_t numberOfBasisVectors()const{
+		return m_basis.size1();
+	}
+
+	/// \brief Number of basis vectors processed together in one matrix-matrix product.
+	std::size_t blockSize()const{
+		return m_blockSize;
+	}
+
+	/// \brief Sets the number of basis vectors processed together in one matrix-matrix product.
+	///
+	/// Smaller blocks improve parallelism for few patterns, larger blocks reduce overhead.
+	void setBlockSize(std::size_t blockSize){
+		SHARK_CHECK(blockSize > 0, "[CompiledKernelExpansion::setBlockSize] block size must be positive");
+		m_blockSize = blockSize;
+	}
+
+	boost::shared_ptr<State> createState()const{
+		return boost::shared_ptr<State>(new InternalState());
+	}
+
+	using base_type::eval;
+	void eval(BatchInputType const& patterns, BatchOutputType& outputs, State& state)const{
+		SIZE_CHECK(patterns.size2() == inputSize());
+		std::size_t numPatterns = patterns.size1();
+		std::size_t numBlocks = (numberOfBasisVectors() + m_blockSize - 1) / m_blockSize;
+		std::size_t numThreads = std::max<std::size_t>(SHARK_NUM_THREADS, 1);
+
+		InternalState& s = state.toState<InternalState>();
+		s.resize(numPatterns, inputSize(), outputSize(), numThreads);
+		noalias(s.inputs) = patterns;
+		if(m_kernelClass == GAUSSIAN_KERNEL){
+			for(std::size_t i = 0; i != numPatterns; ++i)
+				s.inputNorms(i) = norm_sqr(row(s.inputs, i));
+		}
+
+		if(numBlocks == 1){
+			evalBlock(0, numberOfBasisVectors(), s.inputs, s.inputNorms, s.kernelBlocks[0], s.outputs[0]);
+		}else{
+			SHARK_PARALLEL_FOR(int b = 0; b < (int)numBlocks; ++b){
+				std::size_t start = b * m_blockSize;
+				std::size_t end = std::min(start + m_blockSize, numberOfBasisVectors());
+				std::size_t t = SHARK_THREAD_NUM;
+				evalBlock(start, end, s.inputs, s.inputNorms, s.kernelBlocks[t], s.outputs[t]);
+			}
+		}
+
+		//sum up the partial results of the threads
+		outputs.resize(numPatterns, outputSize());
+		noalias(outputs) = repeat(m_b, numPatterns);
+		for(std::size_t t = 0; t != numThreads; ++t){
+			for(std::size_t i = 0; i != numPatterns; ++i){
+				for(std::size_t j = 0; j != outputSize(); ++j){
+					outputs(i, j) += s.outputs[t](i, j);
+				}
+			}
+		}
+	}
+
+	/// From ISerializable, reads a model from an archive
+	void read(InArchive& archive){
+		int kernelClass;
+		archive >> kernelClass;
+		m_kernelClass = KernelClass(kernelClass);
+		archive >> m_gamma;
+		archive >> m_degree;
+		archive >> m_kernelOffset;
+		archive >> m_basis;
+		archive >> m_basisNorms;
+		archive >> m_alpha;
+		archive >> m_b;
+		archive >> m_blockSize;
+	}
+
+	/// From ISerializable, writes a model to an archive
+	void write(OutArchive& archive)const{
+		int kernelClass = m_kernelClass;
+		archive << kernelClass;
+		archive << m_gamma;
+		archive << m_degree;
+		archive << m_kernelOffset;
+		archive << m_basis;
+		archive << m_basisNorms;
+		archive << m_alpha;
+		archive << m_b;
+		archive << m_blockSize;
+	}
+
+private:
+	/// \brief Adds the contribution of the basis vectors [start,end) to the outputs.
+	void evalBlock(
+		std::size_t start, std::size_t end,
+		MatrixType const& inputs, VectorType const& inputNorms,
+		MatrixType& kernelBlock, MatrixType& outputs
+	)const{
+		std::size_t numPatterns = inputs.size1();
+		std::size_t blockLength = end - start;
+		kernelBlock.resize(numPatterns, blockLength);
+		axpy_prod(inputs, trans(rows(m_basis, start, end)), kernelBlock);
+
+		//fused elementwise transformation of the inner products to kernel values
+		if(m_kernelClass == GAUSSIAN_KERNEL){
+			ValueType gamma = ValueType(m_gamma);
+			for(std::size_t i = 0; i != numPatterns; ++i){
+				for(std::size_t j = 0; j != blockLength; ++j){
+					ValueType dist = inputNorms(i) + m_basisNorms(start + j) - 2 * kernelBlock(i, j);
+					kernelBlock(i, j) = std::exp(-gamma * std::max(dist, ValueType(0)));
+				}
+			}
+		}else if(m_kernelClass == POLYNOMIAL_KERNEL){
+			ValueType offset = ValueType(m_kernelOffset);
+			for(std::size_t i = 0; i != numPatterns; ++i){
+				for(std::size_t j = 0; j != blockLength; ++j){
+					ValueType base = kernelBlock(i, j) + offset;
+					ValueType value = base;
+					for(unsigned int d = 1; d != m_degree; ++d)
+						value *= base;
+					kernelBlock(i, j) = value;
+				}
+			}
+		}
+		axpy_prod(kernelBlock, rows(m_alpha, start, end), outputs, false);
+	}
+
+	KernelClass m_kernelClass;  ///< kernel function of the compiled expansion
+	double m_gamma;             ///< bandwidth of the Gaussian kernel
+	unsigned int m_degree;      ///< degree of the polynomial kernel
+	double m_kernelOffset;      ///< offset of the polynomial kernel
+	MatrixType m_basis;         ///< packed support vectors, one per row
+	VectorType m_basisNorms;    ///< squared norms of the support vectors
+	MatrixType m_alpha;         ///< coefficients of the support vectors
+	RealVector m_b;             ///< offset of the expansion
+	std::size_t m_blockSize;    ///< number of support vectors per block
+};
+
+}
+#endif
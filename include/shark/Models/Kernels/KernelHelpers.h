@@ -215,5 +215,60 @@ RealVector calculateKernelMatrixParameterDerivative(
 	return kernelGradient;
 }
 
+/// \brief Efficiently calculates the weighted derivative of a mixed Kernel Gram Matrix w.r.t the Kernel Parameters
+///
+/// The formula is \f$  \sum_i \sum_j w_{ij} k(x_i,z_j)\f$ where x_i are the points of the first and z_j
+/// the points of the second dataset. Unlike calculateKernelMatrixParameterDerivative, the weights
+/// need not be symmetric. The batches of the second dataset are processed in parallel.
+///  \param kernel the kernel for which to calculate the kernel gram matrix
+///  \param dataset1 the set of points corresponding to rows of the Gram matrix
+///  \param dataset2 the set of points corresponding to columns of the Gram matrix
+///  \param weights the weights of the derivative
+///  \return the weighted derivative w.r.t the parameters.
+template<class InputType,class WeightMatrix>
+RealVector calculateMixedKernelMatrixParameterDerivative(
+		AbstractKernelFunction<InputType> const& kernel,
+		Data<InputType> const& dataset1,
+		Data<InputType> const& dataset2,
+		WeightMatrix const& weights
+){
+	std::size_t kp = kernel.numberOfParameters();
+	std::size_t B1 = dataset1.numberOfBatches();
+	std::size_t B2 = dataset2.numberOfBatches();
+	SIZE_CHECK(weights.size1() == dataset1.numberOfElements());
+	SIZE_CHECK(weights.size2() == dataset2.numberOfElements());
+	std::vector<std::size_t> batchStart1(B1+1,0);
+	for(std::size_t i = 1; i != B1+1; ++i){
+		batchStart1[i] = batchStart1[i-1]+ boost::size(dataset1.batch(i-1));
+	}
+	std::vector<std::size_t> batchStart2(B2+1,0);
+	for(std::size_t i = 1; i != B2+1; ++i){
+		batchStart2[i] = batchStart2[i-1]+ boost::size(dataset2.batch(i-1));
+	}
+	
+	RealVector kernelGradient(kp);//weighted gradient summed over the whole kernel matrix
+	kernelGradient.clear();
+	SHARK_PARALLEL_FOR(int j=0; j < (int)B2; j++){
+		RealMatrix block;
+		RealVector blockGradient(kp);
+		RealVector columnGradient(kp,0.0);
+		boost::shared_ptr<State> state = kernel.createState();
+		for (std::size_t i=0; i<B1; i++){
+			kernel.eval(dataset1.batch(i), dataset2.batch(j),block,*state);
+			kernel.weightedParameterDerivative(
+				dataset1.batch(i), dataset2.batch(j),//points
+				subrange(weights,batchStart1[i],batchStart1[i+1],batchStart2[j],batchStart2[j+1]),//weights
+				*state,
+				blockGradient
+			);
+			columnGradient += blockGradient;
+		}
+		SHARK_CRITICAL_REGION{
+			kernelGradient += columnGradient;
+		}
+	}
+	return kernelGradient;
+}
+
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Nystroem feature map for arbitrary kernels
+ *
+ * \par
+ * Explicit finite dimensional feature map which reproduces the kernel
+ * on the span of a set of landmark points.
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#ifndef SHARK_MODELS_KERNELS_NYSTROEMFEATURES_H
+#define SHARK_MODELS_KERNELS_NYSTROEMFEATURES_H
+
+#include <shark/Models/AbstractModel.h>
+#include <shark/Models/Kernels/AbstractKernelFunction.h>
+#include <shark/Models/Kernels/KernelHelpers.h>
+#include <shark/LinAlg/eigenvalues.h>
+
+namespace shark {
+
+
+///
+/// \brief Nystroem approximation of the feature space of a kernel.
+///
+/// Given landmarks \f$ z_1, \dots, z_m \f$ with kernel matrix \f$ K_{zz} = U \Lambda U^T \f$
+/// the Nystroem feature map is
+/// \f[ \phi(x) = \Lambda^{-1/2} U^T \left( k(z_1,x), \dots, k(z_m,x) \right)^T . \f]
+/// It satisfies \f$ \phi(x)^T \phi(x') = k_z(x)^T K_{zz}^{-1} k_z(x') \f$, which is the kernel
+/// projected onto the span of the landmarks in feature space, and thus is exact whenever one
+/// of the points is a landmark. Directions with eigenvalues below a relative threshold are
+/// dropped, so the output dimension is at most m.
+///
+/// The map works for every kernel, including the LinearKernel and kernels on non-vector
+/// inputs. The features can be fed to linear trainers like the LinearCSvmTrainer, Pegasos
+/// or LinearRegression, which then approximate the kernel machine in time linear in the number
+/// of samples. Landmarks are usually chosen by the NystroemTrainer.
+template<class InputType = RealVector>
+class NystroemFeatures : public AbstractModel<InputType, RealVector>
+{
+private:
+	typedef AbstractModel<InputType, RealVector> base_type;
+public:
+	typedef AbstractKernelFunction<InputType> KernelType;
+	typedef typename base_type::BatchInputType BatchInputType;
+	typedef typename base_type::BatchOutputType BatchOutputType;
+
+	NystroemFeatures():mep_kernel(NULL){}
+
+	/// \brief Creates the feature map, see setStructure.
+	NystroemFeatures(KernelType* kernel, Data<InputType> const& landmarks, double threshold = 1.e-10){
+		setStructure(kernel, landmarks, threshold);
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "NystroemFeatures"; }
+
+	/// \brief Computes the feature map for a set of landmarks.
+	///
+	/// \param kernel the kernel to approximate
+	/// \param landmarks the points on which the map reproduces the kernel
+	/// \param threshold eigenvalues of the landmark kernel matrix smaller than threshold times the largest eigenvalue are dropped
+	void setStructure(KernelType* kernel, Data<InputType> const& landmarks, double threshold = 1.e-10){
+		SHARK_CHECK(kernel != NULL, "[NystroemFeatures::setStructure] kernel must not be NULL");
+		SHARK_CHECK(landmarks.numberOfElements() > 0, "[NystroemFeatures::setStructure] no landmarks given");
+		mep_kernel = kernel;
+		m_landmarks = landmarks;
+
+		RealMatrix K = calculateRegularizedKernelMatrix(*kernel, landmarks);
+		RealMatrix U;
+		RealVector lambda;
+		eigensymm(K, U, lambda);
+
+		//eigenvalues are sorted in descending order
+		std::size_t rank = 0;
+		while(rank != lambda.size() && lambda(rank) > threshold * lambda(0))
+			++rank;
+
+		m_projection.resize(rank, lambda.size());
+		for(std::size_t i = 0; i != rank; ++i){
+			noalias(row(m_projection, i)) = column(U, i) / std::sqrt(lambda(i));
+		}
+	}
+
+	KernelType const* kernel()const{
+		return mep_kernel;
+	}
+	KernelType* kernel(){
+		return mep_kernel;
+	}
+	void setKernel(KernelType* kernel){
+		mep_kernel = kernel;
+	}
+
+	/// \brief The landmarks of the map.
+	Data<InputType> const& landmarks()const{
+		return m_landmarks;
+	}
+
+	/// \brief Matrix \f$ \Lambda^{-1/2} U^T \f$ mapping kernel values to features.
+	RealMatrix const& projection()const{
+		return m_projection;
+	}
+
+	/// \brief Dimensionality of the features.
+	std::size_t outputSize()const{
+		return m_projection.size1();
+	}
+
+	boost::shared_ptr<State> createState()const{
+		return boost::shared_ptr<State>(new EmptyState());
+	}
+
+	using base_type::eval;
+	void eval(BatchInputType const& patterns, BatchOutputType& outputs)const{
+		SHARK_ASSERT(mep_kernel != NULL);
+		std::size_t numPatterns = boost::size(patterns);
+		outputs.resize(numPatterns, outputSize());
+		outputs.clear();
+
+		std::size_t batchStart = 0;
+		for(std::size_t i = 0; i != m_landmarks.numberOfBatches(); ++i){
+			std::size_t batchEnd = batchStart + boost::size(m_landmarks.batch(i));
+			RealMatrix kernelEvaluations = (*mep_kernel)(patterns, m_landmarks.batch(i));
+			axpy_prod(kernelEvaluations, trans(columns(m_projection, batchStart, batchEnd)), outputs, false);
+			batchStart = batchEnd;
+		}
+	}
+	void eval(BatchInputType const& patterns, BatchOutputType& outputs, State& state)const{
+		eval(patterns, outputs);
+	}
+
+	/// From ISerializable, reads a model from an archive
+	void read(InArchive& archive){
+		SHARK_ASSERT(mep_kernel != NULL);
+		archive >> m_landmarks;
+		archive >> m_projection;
+		archive >> (*mep_kernel);
+	}
+
+	/// From ISerializable, writes a model to an archive
+	void write(OutArchive& archive)const{
+		SHARK_ASSERT(mep_kernel != NULL);
+		archive << m_landmarks;
+		archive << m_projection;
+		archive << const_cast<KernelType const&>(*mep_kernel);//prevent compilation warning
+	}
+
+private:
+	KernelType* mep_kernel;        ///< kernel function of the map
+	Data<InputType> m_landmarks;   ///< landmark points
+	RealMatrix m_projection;       ///< maps kernel values to features
+};
+
+}
+#endif
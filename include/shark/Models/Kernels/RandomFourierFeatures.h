@@ -0,0 +1,198 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Random Fourier feature map for Gaussian kernels
+ *
+ * \par
+ * Explicit finite dimensional approximation of the feature space
+ * of shift invariant Gaussian kernels. Linear methods trained on the
+ * features approximate the corresponding kernel method.
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+
+#ifndef SHARK_MODELS_KERNELS_RANDOMFOURIERFEATURES_H
+#define SHARK_MODELS_KERNELS_RANDOMFOURIERFEATURES_H
+
+#include <shark/Models/AbstractModel.h>
+#include <shark/Models/Kernels/GaussianRbfKernel.h>
+#include <shark/Models/Kernels/ArdKernel.h>
+#include <shark/Rng/GlobalRng.h>
+
+#include <boost/math/constants/constants.hpp>
+
+namespace shark {
+
+
+///
+/// \brief Random Fourier feature map of a Gaussian kernel.
+///
+/// By Bochner's theorem a shift invariant kernel is the Fourier transform of a
+/// probability distribution \f$ p(\omega) \f$. Sampling \f$ D \f$ frequencies
+/// \f$ \omega_i \sim p \f$ and phases \f$ b_i \sim U[0, 2\pi) \f$ gives the map
+/// \f[ \phi(x) = \sqrt{2/D} \left( \cos(\omega_1^T x + b_1), \dots, \cos(\omega_D^T x + b_D) \right) \f]
+/// with \f$ E[\phi(x)^T \phi(z)] = k(x,z) \f$ (Rahimi and Recht, 2007).
+/// For the GaussianRbfKernel \f$ k(x,z) = \exp(-\gamma \|x-z\|^2) \f$ the frequencies are
+/// normally distributed with variance \f$ 2\gamma \f$, for the ARD kernel the variance of
+/// component j is \f$ 2\gamma_j \f$.
+///
+/// The features can be fed to linear trainers like the LinearCSvmTrainer, Pegasos or
+/// LinearRegression, which then approximate the kernel machine in time linear in the
+/// number of samples. The resulting predictor is the concatenation of this map and the
+/// trained linear model.
+///
+/// The parameters of the model are the frequencies and phases. They are not meant to be
+/// trained, but they are exposed to allow for storing and restoring the model.
+template<class InputType = RealVector>
+class RandomFourierFeatures : public AbstractModel<InputType, RealVector>
+{
+private:
+	typedef AbstractModel<InputType, RealVector> base_type;
+public:
+	typedef typename base_type::BatchInputType BatchInputType;
+	typedef typename base_type::BatchOutputType BatchOutputType;
+
+	RandomFourierFeatures(){}
+
+	/// \brief Creates the feature map for a Gaussian kernel, see setStructure.
+	RandomFourierFeatures(GaussianRbfKernel<InputType> const& kernel, std::size_t inputs, std::size_t features){
+		setStructure(kernel, inputs, features);
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "RandomFourierFeatures"; }
+
+	/// \brief Samples the features for a GaussianRbfKernel.
+	///
+	/// \param kernel the kernel to approximate
+	/// \param inputs dimensionality of the inputs
+	/// \param features number of random features D
+	void setStructure(GaussianRbfKernel<InputType> const& kernel, std::size_t inputs, std::size_t features){
+		setStructure(RealVector(inputs, kernel.gamma()), features);
+	}
+
+	/// \brief Samples the features for an ARD kernel.
+	///
+	/// \param kernel the kernel to approximate
+	/// \param features number of random features D
+	void setStructure(ARDKernelUnconstrained<InputType> const& kernel, std::size_t features){
+		setStructure(kernel.gammaVector(), features);
+	}
+
+	/// \brief Samples the features for a Gaussian kernel with one bandwidth per input dimension.
+	///
+	/// \param gammas the bandwidths \f$ \gamma_j \f$ of the input dimensions
+	/// \param features number of random features D
+	void setStructure(RealVector const& gammas, std::size_t features){
+		SHARK_CHECK(features > 0, "[RandomFourierFeatures::setStructure] number of features must be positive");
+		std::size_t inputs = gammas.size();
+		m_frequencies.resize(features, inputs);
+		m_phases.resize(features);
+		double const twoPi = 2 * boost::math::constants::pi<double>();
+		for(std::size_t i = 0; i != features; ++i){
+			for(std::size_t j = 0; j != inputs; ++j){
+				m_frequencies(i, j) = Rng::gauss(0, 2 * gammas(j));
+			}
+			m_phases(i) = Rng::uni(0, twoPi);
+		}
+	}
+
+	/// \brief Dimensionality of the inputs.
+	std::size_t inputSize()const{
+		return m_frequencies.size2();
+	}
+
+	/// \brief Number of random features.
+	std::size_t outputSize()const{
+		return m_frequencies.size1();
+	}
+
+	/// \brief Sampled frequencies, one per row.
+	RealMatrix const& frequencies()const{
+		return m_frequencies;
+	}
+
+	/// \brief Sampled phases.
+	RealVector const& phases()const{
+		return m_phases;
+	}
+
+	RealVector parameterVector()const{
+		RealVector ret(numberOfParameters());
+		init(ret) << toVector(m_frequencies), m_phases;
+		return ret;
+	}
+
+	void setParameterVector(RealVector const& newParameters){
+		SIZE_CHECK(newParameters.size() == numberOfParameters());
+		init(newParameters) >> toVector(m_frequencies), m_phases;
+	}
+
+	std::size_t numberOfParameters()const{
+		return m_frequencies.size1() * m_frequencies.size2() + m_phases.size();
+	}
+
+	boost::shared_ptr<State> createState()const{
+		return boost::shared_ptr<State>(new EmptyState());
+	}
+
+	using base_type::eval;
+	void eval(BatchInputType const& patterns, BatchOutputType& outputs)const{
+		SIZE_CHECK(patterns.size2() == inputSize());
+		std::size_t numPatterns = patterns.size1();
+		outputs.resize(numPatterns, outputSize());
+		axpy_prod(patterns, trans(m_frequencies), outputs);
+		noalias(outputs) += repeat(m_phases, numPatterns);
+		noalias(outputs) = std::sqrt(2.0 / outputSize()) * cos(outputs);
+	}
+	void eval(BatchInputType const& patterns, BatchOutputType& outputs, State& state)const{
+		eval(patterns, outputs);
+	}
+
+	/// From ISerializable
+	void read(InArchive& archive){
+		archive >> m_frequencies;
+		archive >> m_phases;
+	}
+
+	/// From ISerializable
+	void write(OutArchive& archive)const{
+		archive << m_frequencies;
+		archive << m_phases;
+	}
+
+private:
+	RealMatrix m_frequencies; ///< sampled frequencies \f$ \omega_i \f$, one per row
+	RealVector m_phases;      ///< sampled phases \f$ b_i \f$
+};
+
+}
+#endif
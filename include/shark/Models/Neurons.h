@@ -31,6 +31,7 @@
 #define MODELS_NEURONS_H
  
 #include <shark/LinAlg/Base.h>
+#include <shark/Rng/GlobalRng.h>
 
  
 namespace shark{
@@ -41,6 +42,7 @@ namespace detail{
 	///Those functions calculate value and derivative for a single input.
 	///Due to template magic, the neurons can either use vectors or matrices as input.
 	///Additionally, they avoid temporary values completely using ublas magic.
+	///Dense batches are evaluated blockwise, so a branch-free function() is vectorized by the compiler.
 	///Usage: 
 	///struct Neuron:public NeuronBase<Neuron> { 
 	///    double function(double x)const{return ...}
@@ -55,6 +57,7 @@ namespace detail{
 			typedef T argument_type;
 			typedef argument_type result_type;
 			static const bool zero_identity = false;
+			typedef void vectorizable;
 			
 			Function(NeuronBase<Derived> const* self):m_self(static_cast<Derived const*>(self)){}
 
@@ -68,6 +71,7 @@ namespace detail{
 			typedef T argument_type;
 			typedef argument_type result_type;
 			static const bool zero_identity = false;
+			typedef void vectorizable;
 
 			FunctionDerivative(NeuronBase<Derived> const* self):m_self(static_cast<Derived const*>(self)){}
 
@@ -116,7 +120,7 @@ namespace detail{
 struct LogisticNeuron : public detail::NeuronBase<LogisticNeuron>{
 	template<class T>
 	T function(T x)const{
-		return sigmoid(x);
+		return blas::scalar_sigmoid<T>()(x);
 	}
 	template<class T>
 	T functionDerivative(T y)const{
@@ -132,7 +136,7 @@ struct LogisticNeuron : public detail::NeuronBase<LogisticNeuron>{
 struct TanhNeuron: public detail::NeuronBase<TanhNeuron>{
 	template<class T>
 	T function(T x)const{
-		return std::tanh(x);
+		return blas::scalar_tanh<T>()(x);
 	}
 	template<class T>
 	T functionDerivative(T y)const{
@@ -189,12 +193,14 @@ struct FastSigmoidNeuron: public detail::NeuronBase<FastSigmoidNeuron>{
 /// The function assumes for the wrapped neuron type that the derivative
 /// for all points for which the output is 0, is 0. This is true for the LogisticNeuron,
 /// FastSigmoidNeuron and RectifierNeuron.
+/// The random numbers are drawn from Rng::threadRng(), thus the neuron can be evaluated
+/// by several threads at once.
 template<class Neuron>
 struct DropoutNeuron: public detail::NeuronBase<DropoutNeuron<Neuron> >{
 	DropoutNeuron():m_probability(0.5),m_stochastic(true){}
 	template<class T>
 	T function(T x)const{
-		if(m_stochastic && Rng::coinToss(m_probability)){
+		if(m_stochastic && Bernoulli<Rng::rng_type>(Rng::threadRng(),m_probability)()){
 			return T(0);
 		}
 		else if(!m_stochastic){
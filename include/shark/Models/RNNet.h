@@ -52,17 +52,21 @@ namespace shark{
 //! neurons are.
 //!
 //!  This class is optimized for batch learning. See OnlineRNNet for an online
-//!  version.
+//!  version. All sequences of a batch are processed at the same time, so that
+//!  every timestep is a single matrix-matrix product over the batch. Sequences of
+//!  a batch may have different lengths.
 class RNNet:public AbstractModel<Sequence,Sequence >
 {
 private:
 	struct InternalState: public State{
-		//! Activation of the neurons after processing the time series.
-		//! m_timeActivation(b,t,i) is a 3-dimensional array, the first dimension
-		//! returns the i-th element of the batch, the second dimension returns
-		//! the activation for timestep t, the third dimension the activation
-		//! of the neuron at the timestep of the batch element.
-		std::vector<Sequence> timeActivation;
+		//! Activation of the units after processing the time series.
+		//! The activations are stored time-major: timeActivation[t] holds
+		//! the activations of all units at timestep t, one row for every
+		//! element of the batch. Sequences shorter than the longest sequence
+		//! of the batch are padded with zero inputs.
+		std::vector<RealMatrix> timeActivation;
+		//! Length of every sequence of the batch, without warm up.
+		std::vector<std::size_t> sequenceLengths;
 	};
 public:
 
@@ -43,6 +43,23 @@
 
 namespace shark{
 
+namespace detail{
+///\brief Baseclass for the Typewrapper of the Error Function.
+class ErrorFunctionWrapperBase:public FunctionWrapperBase{
+protected:
+	std::size_t m_numBatches;
+public:
+	ErrorFunctionWrapperBase():m_numBatches(0){}
+	virtual ErrorFunctionWrapperBase* clone()const = 0;
+	void setNumBatches(std::size_t numBatches){
+		m_numBatches = numBatches;
+	}
+	std::size_t numBatches() const{
+		return m_numBatches;
+	}
+};
+}
+
 ///
 /// \brief Objective function for supervised learning
 ///
@@ -62,6 +79,10 @@ namespace shark{
 /// It also automatically infers the input und label type from the given dataset and the output type
 /// of the model in the constructor and ensures that Model and loss match. Thus the user does
 /// not need to provide the types as template parameters. 
+///
+///\par
+/// For stochastic gradient descent, the error function can be restricted to a minibatch
+/// of randomly chosen batches of the dataset in every evaluation, see setNumBatches.
 class ErrorFunction : public SingleObjectiveFunction
 {
 public:
@@ -82,6 +103,24 @@ public:
 		m_regularizer = regularizer;
 		m_regularizationStrength = factor;
 	}
+	
+	/// \brief Sets the number of batches of the dataset that are used in every evaluation.
+	///
+	/// If it is less than the number of batches, the batches are drawn at random without replacement
+	/// in every call to eval and evalDerivative and the error and its derivative are averaged over
+	/// the points of the drawn batches. This is an unbiased estimate of the error on the whole dataset
+	/// only if all batches have the same size, otherwise points in smaller batches are weighted higher.
+	/// If it is 0, all batches are used.
+	void setNumBatches(std::size_t numBatches){
+		mp_wrapper->setNumBatches(numBatches);
+	}
+	
+	/// \brief Returns the number of batches of the dataset that are used in every evaluation.
+	///
+	/// If it is 0, all batches are used.
+	std::size_t numBatches()const{
+		return mp_wrapper->numBatches();
+	}
 
 	SearchPointType proposeStartingPoint()const {
 		return mp_wrapper -> proposeStartingPoint();
@@ -96,7 +135,7 @@ public:
 	friend void swap(ErrorFunction& op1, ErrorFunction& op2);
 
 private:
-	boost::scoped_ptr<detail::FunctionWrapperBase > mp_wrapper;
+	boost::scoped_ptr<detail::ErrorFunctionWrapperBase > mp_wrapper;
 	SingleObjectiveFunction* m_regularizer;
 	double m_regularizationStrength;
 };
@@ -24,14 +24,32 @@
 #define SHARK_OBJECTIVEFUNCTIONS_IMPL_ERRORFUNCTION_INL
 
 #include <shark/Core/OpenMP.h>
+#include <shark/Rng/GlobalRng.h>
 
 namespace shark{
 namespace detail{
 
+///\brief Returns numBatches batches of the dataset drawn without replacement, or the whole dataset if numBatches is 0.
+template<class DatasetType>
+DatasetType sampleBatches(DatasetType const& dataset, std::size_t numBatches){
+	if(numBatches == 0 || numBatches >= dataset.numberOfBatches())
+		return dataset;
+	//partial Fisher-Yates shuffle of the batch indices
+	std::vector<std::size_t> batchIds(dataset.numberOfBatches());
+	for(std::size_t i = 0; i != batchIds.size(); ++i){
+		batchIds[i] = i;
+	}
+	for(std::size_t i = 0; i != numBatches; ++i){
+		std::swap(batchIds[i],batchIds[Rng::discrete(int(i),int(batchIds.size()-1))]);
+	}
+	batchIds.resize(numBatches);
+	return indexedSubset(dataset,batchIds);
+}
+
 
 ///\brief Implementation of the ErrorFunction using AbstractLoss.
 template<class InputType, class LabelType,class OutputType>
-class ErrorFunctionImpl:public FunctionWrapperBase{
+class ErrorFunctionImpl:public ErrorFunctionWrapperBase{
 public:
 	ErrorFunctionImpl(
 		LabeledData<InputType, LabelType> const& dataset,
@@ -57,23 +75,24 @@ public:
 		return mep_model->numberOfParameters();
 	}
 
-	FunctionWrapperBase* clone()const{
+	ErrorFunctionWrapperBase* clone()const{
 		return new ErrorFunctionImpl<InputType,LabelType,OutputType>(*this);
 	}
 
 	double eval(RealVector const& input) const {
-		mep_model->setParameterVector(input);
+		mep_model->assignParameterVector(input);
 
 		return evalPointSet();
 	}
 	
 	double evalPointSet() const {
-		std::size_t dataSize = m_dataset.numberOfElements();
+		LabeledData<InputType, LabelType> data = sampleBatches(m_dataset,m_numBatches);
+		std::size_t dataSize = data.numberOfElements();
 		typedef typename LabeledData<InputType,LabelType>::const_batch_reference const_reference;
 		
 		typename Batch<OutputType>::type prediction;
 		double error = 0.0;
-		BOOST_FOREACH(const_reference batch,m_dataset.batches()){
+		BOOST_FOREACH(const_reference batch,data.batches()){
 			mep_model->eval(batch.input, prediction);
 			error += mep_loss->eval(batch.label, prediction);
 		}
@@ -81,13 +100,14 @@ public:
 	}
 
 	ResultType evalDerivative( const SearchPointType & point, FirstOrderDerivative & derivative ) const {
-		mep_model->setParameterVector(point);
+		mep_model->assignParameterVector(point);
 		return evalDerivativePointSet(derivative);
 	}
 	
 	ResultType evalDerivativePointSet( FirstOrderDerivative & derivative ) const {
 		typedef typename LabeledData<InputType,LabelType>::const_batch_reference const_reference;
-		std::size_t dataSize = m_dataset.numberOfElements();
+		LabeledData<InputType, LabelType> data = sampleBatches(m_dataset,m_numBatches);
+		std::size_t dataSize = data.numberOfElements();
 		derivative.resize(mep_model->numberOfParameters());
 		derivative.clear();
 
@@ -97,7 +117,7 @@ public:
 
 		double error=0.0;
 		boost::shared_ptr<State> state = mep_model->createState();
-		BOOST_FOREACH(const_reference batch,m_dataset.batches()){
+		BOOST_FOREACH(const_reference batch,data.batches()){
 			// calculate model output for the batch as well as the derivative
 			mep_model->eval(batch.input, prediction,*state);
 
@@ -122,7 +142,7 @@ private:
 
 ///\brief Implementation of the ErrorFunction using AbstractLoss for parallelizable computations
 template<class InputType, class LabelType,class OutputType>
-class ParallelErrorFunctionImpl:public FunctionWrapperBase{
+class ParallelErrorFunctionImpl:public ErrorFunctionWrapperBase{
 public:
 
 	ParallelErrorFunctionImpl(
@@ -149,15 +169,16 @@ public:
 		return mep_model->numberOfParameters();
 	}
 
-	FunctionWrapperBase* clone()const{
+	ErrorFunctionWrapperBase* clone()const{
 		return new ParallelErrorFunctionImpl<InputType,LabelType,OutputType>(*this);
 	}
 
 	double eval(RealVector const& input) const {
-		mep_model->setParameterVector(input);
+		mep_model->assignParameterVector(input);
 
-		std::size_t numBatches = m_dataset.numberOfBatches();
-		std::size_t numElements = m_dataset.numberOfElements();
+		LabeledData<InputType, LabelType> data = sampleBatches(m_dataset,m_numBatches);
+		std::size_t numBatches = data.numberOfBatches();
+		std::size_t numElements = data.numberOfElements();
 		std::size_t numThreads = std::min(SHARK_NUM_THREADS,numBatches);
 		//calculate optimal partitioning
 		std::size_t batchesPerThread = numBatches/numThreads;
@@ -168,7 +189,7 @@ public:
 			//get start and end index of batch-range
 			std::size_t start = t*batchesPerThread+std::min(t,leftOver);
 			std::size_t end = (t+1)*batchesPerThread+std::min(t+1,leftOver);
-			LabeledData<InputType, LabelType> threadData = rangeSubset(m_dataset,start,end);//threadsafe!
+			LabeledData<InputType, LabelType> threadData = rangeSubset(data,start,end);//threadsafe!
 			ErrorFunctionImpl<InputType,LabelType,OutputType> errorFunc(threadData,mep_model,mep_loss);
 			double threadError = errorFunc.evalPointSet();//threadsafe!
 			//we need to weight the error and derivativs with the number of samples in the split.
@@ -181,12 +202,13 @@ public:
 	}
 
 	ResultType evalDerivative( const SearchPointType & point, FirstOrderDerivative & derivative ) const {
-		mep_model->setParameterVector(point);
+		mep_model->assignParameterVector(point);
 		derivative.resize(mep_model->numberOfParameters());
 		derivative.clear();
 		
-		std::size_t numBatches = m_dataset.numberOfBatches();
-		std::size_t numElements = m_dataset.numberOfElements();
+		LabeledData<InputType, LabelType> data = sampleBatches(m_dataset,m_numBatches);
+		std::size_t numBatches = data.numberOfBatches();
+		std::size_t numElements = data.numberOfElements();
 		std::size_t numThreads = std::min(SHARK_NUM_THREADS,numBatches);
 		//calculate optimal partitioning
 		std::size_t batchesPerThread = numBatches/numThreads;
@@ -198,7 +220,7 @@ public:
 			//get start and end index of batch-range
 			std::size_t start = t*batchesPerThread+std::min(t,leftOver);
 			std::size_t end = (t+1)*batchesPerThread+std::min(t+1,leftOver);
-			LabeledData<InputType, LabelType> threadData = rangeSubset(m_dataset,start,end);//threadsafe!
+			LabeledData<InputType, LabelType> threadData = rangeSubset(data,start,end);//threadsafe!
 			ErrorFunctionImpl<InputType,LabelType,OutputType> errorFunc(threadData,mep_model,mep_loss);
 			double threadError = errorFunc.evalDerivativePointSet(threadDerivative);//threadsafe!
 			//we need to weight the error and derivativs with the number of samples in the split.
@@ -75,7 +75,7 @@ public:
 	}
 
 	double eval(const RealVector & input)const {
-		mep_model->setParameterVector(input);
+		mep_model->assignParameterVector(input);
 		
 		//prepare batch for the current iteration
 		std::vector<std::size_t> indices(m_batchSize);
@@ -92,7 +92,7 @@ public:
 	}
 
 	ResultType evalDerivative( const SearchPointType & input, FirstOrderDerivative & derivative )const {
-		mep_model->setParameterVector(input);
+		mep_model->assignParameterVector(input);
 		boost::shared_ptr<State> state = mep_model->createState();
 		
 		//prepare batch for the current iteration
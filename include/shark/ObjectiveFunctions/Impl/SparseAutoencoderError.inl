@@ -93,7 +93,7 @@ public:
 		size_t dataSize = m_dataset.numberOfElements();
 		std::size_t hiddens = mep_model->numberOfHiddenNeurons();
 
-		mep_model->setParameterVector(input);
+		mep_model->assignParameterVector(input);
 
 		RealVector meanActivation(hiddens);
 		meanActivation.clear();
@@ -116,7 +116,7 @@ public:
 	}
 
 	ResultType evalDerivative( SearchPointType const& point, FirstOrderDerivative & gradient ) const {
-		mep_model->setParameterVector(point);
+		mep_model->assignParameterVector(point);
 
 		gradient.resize(mep_model->numberOfParameters());
 		gradient.clear();
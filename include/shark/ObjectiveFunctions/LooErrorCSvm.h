@@ -37,15 +37,26 @@
 #include <shark/ObjectiveFunctions/Loss/ZeroOneLoss.h>
 #include <shark/Algorithms/QP/BoxConstrainedProblems.h>
 #include <shark/Algorithms/QP/SvmProblems.h>
+#include <shark/Core/OpenMP.h>
 #include <shark/LinAlg/CachedMatrix.h>
 #include <shark/LinAlg/KernelMatrix.h>
-#include <shark/Models/Kernels/KernelExpansion.h>
+#include <numeric>
 
 namespace shark {
 
 ///
 /// \brief Leave-one-out error, specifically optimized for C-SVMs.
 ///
+/// The full problem is solved once. Only support vectors can be misclassified when left out,
+/// for each of them the reduced problem is solved starting from the full solution, where the
+/// coefficient of the removed example is set to zero (and, with offset, moved to other variables
+/// to keep the equality constraint). The decision value of the removed example is obtained
+/// from the gradient of the reduced problem, so no kernel expansion is evaluated.
+///
+/// The reduced problems are solved in parallel. Every thread works on its own copy of the
+/// problem with its own kernel matrix and cache. The rows of the support vectors are taken
+/// from the cache of the full problem once and are shared read-only between the threads.
+///
 template<class InputType, class CacheType = float>
 class LooErrorCSvm : public SingleObjectiveFunction
 {
@@ -59,6 +70,7 @@ public:
 	: mep_dataset(&dataset)
 	, mep_kernel(kernel)
 	, m_withOffset(withOffset)
+	, m_shrinking(true)
 	{
 		SHARK_CHECK(kernel != NULL, "kernel is not allowed to be Null");
 		m_features |= HAS_VALUE;
@@ -73,6 +85,14 @@ public:
 		return mep_kernel->numberOfParameters()+1;
 	}
 
+	/// Flag for shrinking in the solver of the full problem
+	bool& shrinking()
+	{ return m_shrinking; }
+
+	/// Flag for shrinking in the solver of the full problem
+	bool const& shrinking() const
+	{ return m_shrinking; }
+
 	/// Evaluate the leave-one-out error for the given parameters. 
 	/// These parameters describe the regularization 
 	/// constant and the kernel parameters.
@@ -89,101 +109,172 @@ public:
 
 		double C;
 		blas::init(params)>>parameters(*mep_kernel),C;
-		
-		ZeroOneLoss<unsigned int, RealVector> loss;
 
 		// prepare the quadratic program
-		typedef KernelMatrix<InputType, QpFloatType> KernelMatrixType;
-		typedef CachedMatrix< KernelMatrixType > CachedMatrixType;
-		typedef CSVMProblem<CachedMatrixType> SVMProblemType;
 		KernelMatrixType km(*mep_kernel, mep_dataset->inputs());
 		CachedMatrixType matrix(&km);
 		SVMProblemType svmProblem(matrix,mep_dataset->labels(),C);
-		std::size_t ell = km.size();
-		
-		//QpStoppingCondition stop;
 
 		if (m_withOffset)
 		{
-			// solve the full problem with equality constraint and activated shrinking
-			typedef SvmProblem<SVMProblemType> ProblemType;
-			ProblemType problem(svmProblem);
+			// solve the full problem with equality constraint
+			typedef SvmShrinkingProblem<SVMProblemType> ProblemType;
+			ProblemType problem(svmProblem,m_shrinking);
 			QpSolver< ProblemType > solver(problem);
 			solver.solve(stop);
-			RealVector alphaFull(problem.dimensions());
-			for(std::size_t i = 0; i != problem.dimensions(); ++i){
-				alphaFull(i) = problem.alpha(i);
-			}
-			KernelExpansion<InputType> svm(mep_kernel,mep_dataset->inputs(),true);
-
-			// leave-one-out
-			//problem.setShrinking(false);
-			double mistakes = 0;
-			for (std::size_t i=0; i<ell; i++)
-			{
-				// use sparseness of the solution:
-				if (alphaFull(i) == 0.0) continue;
-				problem.deactivateVariable(i);
-				
-				// solve the reduced problem
-				solver.solve(stop);
-
-				// predict using the previously removed example.
-				// we need to take into account that the initial problem is solved
-				// with shrinking and we thus need to get the initial permutation 
-				// for the element index and the unpermuted alpha for the svm
-				column(svm.alpha(),0)= problem.getUnpermutedAlpha();
-				svm.offset(0) = computeBias(problem);
-				std::size_t elementIndex = i;//svmProblem.permutation[i];
-				unsigned int target = mep_dataset->element(elementIndex).label;
-				mistakes += loss(target, svm(mep_dataset->element(elementIndex).input));
-				
-				problem.activateVariable(i);
-			}
-			return mistakes / (double)ell;
+			problem.unshrink();
+			return looError<SvmProblem<LooSVMProblemType> >(problem, matrix, C, stop);
 		}
 		else
 		{
-			// solve the full problem without equality constraint and activated shrinking
-			typedef BoxConstrainedProblem<SVMProblemType> ProblemType;
-			ProblemType problem(svmProblem);
+			// solve the full problem without equality constraint
+			typedef BoxConstrainedShrinkingProblem<SVMProblemType> ProblemType;
+			ProblemType problem(svmProblem,m_shrinking);
 			QpSolver< ProblemType > solver(problem);
 			solver.solve(stop);
-			RealVector alphaFull(problem.dimensions());
-			for(std::size_t i = 0; i != problem.dimensions(); ++i){
-				alphaFull(i) = problem.alpha(i);
+			problem.unshrink();
+			return looError<BoxConstrainedProblem<LooSVMProblemType> >(problem, matrix, C, stop);
+		}
+	}
+
+private:
+	typedef KernelMatrix<InputType, QpFloatType> KernelMatrixType;
+	typedef CachedMatrix< KernelMatrixType > CachedMatrixType;
+	typedef CSVMProblem<CachedMatrixType> SVMProblemType;
+
+	/// \brief Kernel matrix of one thread in the leave-one-out phase.
+	///
+	/// Rows of the support vectors are copied from a block which is shared between the threads
+	/// and never written to, all other entries are computed by a kernel matrix owned by the thread.
+	/// The matrix is never permuted, indices are the indices of the dataset.
+	class LooKernelMatrix{
+	public:
+		typedef CacheType QpFloatType;
+
+		LooKernelMatrix(
+			KernelType const& kernel, Data<InputType> const& inputs,
+			blas::matrix<QpFloatType> const& rows, std::vector<std::size_t> const& rowIndex
+		):m_kernelMatrix(kernel,inputs), m_rows(rows), m_rowIndex(rowIndex){}
+
+		QpFloatType entry(std::size_t i, std::size_t j) const{
+			if(m_rowIndex[i] != m_rowIndex.size())
+				return m_rows(m_rowIndex[i],j);
+			return m_kernelMatrix.entry(i,j);
+		}
+		QpFloatType operator () (std::size_t i, std::size_t j) const{
+			return entry(i,j);
+		}
+		void row(std::size_t k, std::size_t start,std::size_t end, QpFloatType* storage) const{
+			if(m_rowIndex[k] != m_rowIndex.size()){
+				QpFloatType const* line = &m_rows(m_rowIndex[k],0);
+				std::copy(line + start, line + end, storage);
 			}
-			KernelExpansion<InputType> svm(mep_kernel,mep_dataset->inputs(),false);
-			
-			// leave-one-out
-			//problem.setShrinking(false);
-			double mistakes = 0;
-			for (std::size_t i=0; i<ell; i++)
-			{
-				// use sparseness of the solution:
-				if (alphaFull(i) == 0.0) continue;
-				problem.deactivateVariable(i);
-				
+			else
+				m_kernelMatrix.row(k,start,end,storage);
+		}
+		std::size_t size() const{
+			return m_kernelMatrix.size();
+		}
+	private:
+		KernelMatrixType m_kernelMatrix;
+		blas::matrix<QpFloatType> const& m_rows;
+		std::vector<std::size_t> const& m_rowIndex;
+	};
+	typedef CachedMatrix< LooKernelMatrix > LooMatrixType;
+	typedef CSVMProblem<LooMatrixType> LooSVMProblemType;
 
-				// solve the reduced problem
-				solver.solve(stop);
-
-				// predict using the previously removed example.
-				// we need to take into account that the initial problem is solved
-				// with shrinking and we thus need to get the initial permutation 
-				// for the element index and the unpermuted alpha for the svm
-				column(svm.alpha(),0)= problem.getUnpermutedAlpha();
-				std::size_t elementIndex = i;//svmProblem.permutation[i];
-				unsigned int target = mep_dataset->element(elementIndex).label;
-				mistakes += loss(target, svm(mep_dataset->element(elementIndex).input));
-
-				problem.activateVariable(i);
+	/// \brief Problem which can be reset to the solution of the full problem.
+	template<class Problem>
+	class SeededProblem: public Problem{
+	public:
+		SeededProblem(LooSVMProblemType& problem):Problem(problem){}
+
+		/// \brief Sets the solution and the gradient at this solution, all variables are activated.
+		void setSolution(RealVector const& alpha, RealVector const& gradient){
+			this->m_problem.alpha = alpha;
+			this->m_gradient = gradient;
+			for(std::size_t i = 0; i != this->dimensions(); ++i){
+				this->updateAlphaStatus(i);
 			}
-			return mistakes / (double)ell;
 		}
+	};
+
+	/// \brief Solves the leave-one-out problems of all support vectors of the solved full problem.
+	///
+	/// The full problem might be permuted by shrinking, all results are mapped back to the
+	/// indices of the dataset.
+	template<class Problem, class FullProblem>
+	double looError(
+		FullProblem const& problem,
+		CachedMatrixType& matrix,
+		double C,
+		QpStoppingCondition const& stop
+	){
+		std::size_t ell = problem.dimensions();
+		RealVector alphaFull(ell);
+		RealVector gradientFull(ell);
+		std::vector<std::size_t> position(ell);
+		for(std::size_t p = 0; p != ell; ++p){
+			std::size_t i = problem.permutation(p);
+			alphaFull(i) = problem.alpha(p);
+			gradientFull(i) = problem.gradient(p);
+			position[i] = p;
+		}
+		// use sparseness of the solution:
+		std::vector<std::size_t> supportVectors;
+		for(std::size_t i = 0; i != ell; ++i){
+			if (alphaFull(i) != 0.0)
+				supportVectors.push_back(i);
+		}
+		if(supportVectors.empty()) return 0.0;
+
+		// the reduced problems start at the full solution and need the rows of the support vectors.
+		// They are copied from the cache of the full problem as far as the cache size allows,
+		// afterwards this block is only read.
+		std::size_t storedRows = std::min(supportVectors.size(), matrix.getMaxCacheSize() / ell);
+		blas::matrix<QpFloatType> rows(storedRows, ell);
+		std::vector<std::size_t> rowIndex(ell, ell);
+		std::vector<QpFloatType> line(ell);
+		for(std::size_t s = 0; s != storedRows; ++s){
+			std::size_t i = supportVectors[s];
+			matrix.row(position[i], 0, ell, &line[0]);
+			for(std::size_t p = 0; p != ell; ++p){
+				rows(s, problem.permutation(p)) = line[p];
+			}
+			rowIndex[i] = s;
+		}
+
+		std::size_t numThreads = std::min(SHARK_NUM_THREADS, supportVectors.size());
+		std::size_t cacheSize = matrix.getMaxCacheSize() / numThreads;
+		std::vector<double> mistakes(numThreads, 0.0);
+		parallelBlocks(supportVectors.size(), numThreads, [&](std::size_t t, std::size_t start, std::size_t end){
+			ZeroOneLoss<unsigned int, RealVector> loss;
+			LooKernelMatrix km(*mep_kernel, mep_dataset->inputs(), rows, rowIndex);
+			LooMatrixType looMatrix(&km, cacheSize);
+			LooSVMProblemType svmProblem(looMatrix, mep_dataset->labels(), C);
+			SeededProblem<Problem> looProblem(svmProblem);
+			QpSolver< SeededProblem<Problem> > solver(looProblem);
+			QpStoppingCondition looStop(stop);
+			RealVector decision(1);
+			for(std::size_t s = start; s != end; ++s){
+				std::size_t i = supportVectors[s];
+				looProblem.setSolution(alphaFull, gradientFull);
+				looProblem.deactivateVariable(i);
+
+				// solve the reduced problem
+				solver.solve(looStop);
+
+				// predict the removed example. The gradient is linear - K alpha
+				// and thus holds the kernel expansion of every example
+				decision(0) = looProblem.linear(i) - looProblem.gradient(i);
+				if(m_withOffset)
+					decision(0) += computeBias(looProblem);
+				mistakes[t] += loss(mep_dataset->element(i).label, decision);
+			}
+		});
+		return std::accumulate(mistakes.begin(), mistakes.end(), 0.0) / (double)ell;
 	}
 
-private:
 	/// Compute the SVM offset term (b).
 	template<class Problem>
 	double computeBias(Problem const& problem){
@@ -218,6 +309,7 @@ private:
 	const DatasetType* mep_dataset;
 	KernelType* mep_kernel;
 	bool m_withOffset;
+	bool m_shrinking; ///< shrinking in the solver of the full problem
 };
 
 
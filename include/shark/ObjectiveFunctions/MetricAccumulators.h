@@ -0,0 +1,297 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Streaming accumulators for evaluation metrics
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#ifndef SHARK_OBJECTIVEFUNCTIONS_METRICACCUMULATORS_H
+#define SHARK_OBJECTIVEFUNCTIONS_METRICACCUMULATORS_H
+
+#include <shark/Core/OpenMP.h>
+#include <shark/Models/AbstractModel.h>
+#include <shark/ObjectiveFunctions/Loss/AbstractLoss.h>
+#include <shark/Data/Dataset.h>
+#include <vector>
+#include <numeric>
+
+namespace shark{
+
+/// \brief Streaming estimate of the area under the ROC curve
+///
+/// The scores are sorted into a histogram with equally sized bins over [lower,upper],
+/// scores outside of the interval are put in the first or last bin. For every bin the
+/// number of positive and negative examples is counted. The area is the fraction of
+/// correctly ordered (positive,negative) pairs, where pairs in the same bin count one half.
+/// Thus the result is exact if no bin holds positive and negative examples with different
+/// scores, otherwise the error is bounded by the fraction of pairs sharing a bin.
+///
+/// The memory does not depend on the number of examples and accumulators with the same
+/// binning can be merged, see accumulateMetric.
+/// As in NegativeAUC, a one-dimensional model output is used directly as score and for
+/// two-dimensional outputs the second column is used.
+class AUCAccumulator{
+public:
+	/// \brief Constructor.
+	///
+	/// \param lower lower end of the score interval
+	/// \param upper upper end of the score interval
+	/// \param bins number of bins of the histogram
+	/// \param invert if set to true, the role of positive and negative class are switched
+	AUCAccumulator(double lower = -1.0, double upper = 1.0, std::size_t bins = 4096, bool invert = false)
+	: m_lower(lower), m_upper(upper), m_invert(invert)
+	, m_positive(bins,0), m_negative(bins,0){
+		SHARK_CHECK(lower < upper, "[AUCAccumulator] lower must be smaller than upper");
+		SHARK_CHECK(bins > 0, "[AUCAccumulator] at least one bin is needed");
+	}
+
+	/// Forgets all examples seen so far.
+	void reset(){
+		std::fill(m_positive.begin(),m_positive.end(),0);
+		std::fill(m_negative.begin(),m_negative.end(),0);
+	}
+
+	/// Adds a batch of labels (0 or 1) and model outputs.
+	void addBatch(UIntVector const& labels, RealMatrix const& outputs){
+		SIZE_CHECK(labels.size() == outputs.size1());
+		SHARK_CHECK(outputs.size2() == 1 || outputs.size2() == 2, "[AUCAccumulator::addBatch] no default value for column");
+		std::size_t column = outputs.size2() - 1;
+		for(std::size_t i = 0; i != labels.size(); ++i){
+			std::size_t b = bin(outputs(i,column));
+			if((labels(i) > 0) != m_invert)
+				++m_positive[b];
+			else
+				++m_negative[b];
+		}
+	}
+
+	/// Adds the examples accumulated in another accumulator with the same binning.
+	void merge(AUCAccumulator const& other){
+		SHARK_CHECK(
+			other.m_lower == m_lower && other.m_upper == m_upper && other.m_positive.size() == m_positive.size(),
+			"[AUCAccumulator::merge] binning does not match"
+		);
+		for(std::size_t b = 0; b != m_positive.size(); ++b){
+			m_positive[b] += other.m_positive[b];
+			m_negative[b] += other.m_negative[b];
+		}
+	}
+
+	/// Number of positive examples seen.
+	std::size_t positives()const{
+		return std::accumulate(m_positive.begin(),m_positive.end(),std::size_t(0));
+	}
+	/// Number of negative examples seen.
+	std::size_t negatives()const{
+		return std::accumulate(m_negative.begin(),m_negative.end(),std::size_t(0));
+	}
+
+	/// Area under the ROC curve of the binned scores.
+	double area()const{
+		double pairs = 0;
+		std::size_t negativesBelow = 0;
+		for(std::size_t b = 0; b != m_positive.size(); ++b){
+			pairs += m_positive[b] * (negativesBelow + 0.5 * m_negative[b]);
+			negativesBelow += m_negative[b];
+		}
+		return pairs / (double(positives()) * double(negativesBelow));
+	}
+
+private:
+	std::size_t bin(double score)const{
+		double pos = (score - m_lower) / (m_upper - m_lower) * m_positive.size();
+		if(!(pos > 0)) return 0;//also catches NaN
+		return std::min(std::size_t(pos), m_positive.size() - 1);
+	}
+
+	double m_lower;
+	double m_upper;
+	bool m_invert;
+	std::vector<std::size_t> m_positive; ///< number of positive examples per bin
+	std::vector<std::size_t> m_negative; ///< number of negative examples per bin
+};
+
+/// \brief Streaming confusion matrix of a classifier
+///
+/// Counts how often an example of class i is assigned to class j. The predicted class is
+/// obtained as in ZeroOneLoss: one-dimensional outputs larger than the threshold
+/// are assigned to class 1, otherwise the index of the largest output is the class
+/// (the first one if several outputs are largest).
+class ConfusionAccumulator{
+public:
+	/// \brief Constructor.
+	///
+	/// \param classes number of classes
+	/// \param threshold threshold for one-dimensional outputs
+	ConfusionAccumulator(std::size_t classes = 2, double threshold = 0.0)
+	: m_threshold(threshold), m_counts(classes,classes,0){}
+
+	/// Forgets all examples seen so far.
+	void reset(){
+		m_counts.clear();
+	}
+
+	/// Adds a batch of labels and model outputs.
+	void addBatch(UIntVector const& labels, RealMatrix const& outputs){
+		SIZE_CHECK(labels.size() == outputs.size1());
+		for(std::size_t i = 0; i != labels.size(); ++i){
+			std::size_t predicted;
+			if(outputs.size2() == 1)
+				predicted = outputs(i,0) > m_threshold;
+			else
+				predicted = arg_max(row(outputs,i));
+			RANGE_CHECK(labels(i) < m_counts.size1());
+			RANGE_CHECK(predicted < m_counts.size2());
+			++m_counts(labels(i),predicted);
+		}
+	}
+
+	/// Adds the examples accumulated in another accumulator.
+	void merge(ConfusionAccumulator const& other){
+		SIZE_CHECK(other.m_counts.size1() == m_counts.size1());
+		noalias(m_counts) += other.m_counts;
+	}
+
+	/// Number of examples of class label which were predicted as class predicted.
+	std::size_t count(unsigned int label, unsigned int predicted)const{
+		return m_counts(label,predicted);
+	}
+	/// The confusion matrix. Rows are the labels, columns the predictions.
+	blas::matrix<std::size_t> const& counts()const{
+		return m_counts;
+	}
+	/// Number of examples seen.
+	std::size_t examples()const{
+		std::size_t n = 0;
+		for(std::size_t i = 0; i != m_counts.size1(); ++i)
+			for(std::size_t j = 0; j != m_counts.size2(); ++j)
+				n += m_counts(i,j);
+		return n;
+	}
+	/// Fraction of misclassified examples, the mean ZeroOneLoss.
+	double errorRate()const{
+		std::size_t correct = 0;
+		for(std::size_t i = 0; i != m_counts.size1(); ++i)
+			correct += m_counts(i,i);
+		std::size_t n = examples();
+		return double(n - correct) / n;
+	}
+
+private:
+	double m_threshold;
+	blas::matrix<std::size_t> m_counts;
+};
+
+/// \brief Streaming sum of a loss, e.g. the SquaredLoss or ZeroOneLoss
+///
+/// The loss is only referenced and must outlive the accumulator.
+template<class LabelType, class OutputType>
+class LossAccumulator{
+public:
+	typedef AbstractLoss<LabelType,OutputType> LossType;
+
+	LossAccumulator(LossType const& loss)
+	: mep_loss(&loss), m_sum(0), m_count(0){}
+
+	/// Forgets all examples seen so far.
+	void reset(){
+		m_sum = 0;
+		m_count = 0;
+	}
+
+	/// Adds a batch of labels and model outputs.
+	void addBatch(
+		typename LossType::BatchLabelType const& labels,
+		typename LossType::BatchOutputType const& outputs
+	){
+		m_sum += mep_loss->eval(labels,outputs);
+		m_count += shark::size(labels);
+	}
+
+	/// Adds the examples accumulated in another accumulator.
+	void merge(LossAccumulator const& other){
+		m_sum += other.m_sum;
+		m_count += other.m_count;
+	}
+
+	/// Sum of the loss over all examples.
+	double sum()const{
+		return m_sum;
+	}
+	/// Number of examples seen.
+	std::size_t count()const{
+		return m_count;
+	}
+	/// Mean loss, this is the value of the ErrorFunction without regularization.
+	double mean()const{
+		return m_sum / m_count;
+	}
+
+private:
+	LossType const* mep_loss;
+	double m_sum;
+	std::size_t m_count;
+};
+
+/// \brief Feeds the outputs of a model on a labeled dataset to a metric accumulator.
+///
+/// The model is evaluated batch by batch and the predictions are never stored. The batches
+/// are split into one range per thread, every thread fills its own copy of the accumulator
+/// and the copies are merged in a fixed order, so the result does not depend on the scheduling.
+/// Sequential models are evaluated by a single thread.
+/// The accumulator needs the methods reset(), addBatch(labels,outputs) and merge(other);
+/// examples seen before are kept.
+template<class InputType, class LabelType, class OutputType, class Accumulator>
+void accumulateMetric(
+	AbstractModel<InputType,OutputType> const& model,
+	LabeledData<InputType,LabelType> const& data,
+	Accumulator& accumulator
+){
+	std::size_t numBatches = data.numberOfBatches();
+	if(numBatches == 0) return;
+	std::size_t numThreads = model.isSequential()? 1: std::min(SHARK_NUM_THREADS,numBatches);
+	Accumulator empty(accumulator);
+	empty.reset();
+	std::vector<Accumulator> threadAccumulators(numThreads,empty);
+	parallelBlocks(numBatches, numThreads, [&](std::size_t t, std::size_t start, std::size_t end){
+		boost::shared_ptr<State> state = model.createState();
+		typename Batch<OutputType>::type outputs;
+		for(std::size_t b = start; b != end; ++b){
+			model.eval(data.batch(b).input, outputs, *state);
+			threadAccumulators[t].addBatch(data.batch(b).label, outputs);
+		}
+	});
+	//merge in a fixed order so that the result does not depend on the scheduling
+	for(std::size_t t = 0; t != numThreads; ++t){
+		accumulator.merge(threadAccumulators[t]);
+	}
+}
+
+}
+#endif
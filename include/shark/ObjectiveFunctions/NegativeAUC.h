@@ -37,14 +37,62 @@
 
 #include <shark/ObjectiveFunctions/AbstractCost.h>
 #include <shark/Core/utility/KeyValuePair.h>
+#include <shark/Core/utility/functional.h>
 
 namespace shark {
+namespace detail{
+/// \brief Splits the scores in the given column into the scores of positive and negative examples.
+template<class LabelType, class OutputType>
+void splitScores(
+	Data<LabelType> const& target, Data<OutputType> const& prediction, unsigned int column, bool invert,
+	std::vector<double>& positive, std::vector<double>& negative
+){
+	SIZE_CHECK(target.numberOfBatches() == prediction.numberOfBatches());
+	positive.clear();
+	negative.clear();
+	double sign = invert? -1.0: 1.0;
+	for(std::size_t b = 0; b != target.numberOfBatches(); ++b){
+		typename Data<LabelType>::const_batch_reference labels = target.batch(b);
+		typename Data<OutputType>::const_batch_reference outputs = prediction.batch(b);
+		SIZE_CHECK(shark::size(labels) == shark::size(outputs));
+		for(std::size_t i = 0; i != shark::size(labels); ++i){
+			double score = sign * get(outputs,i)(column);
+			if(get(labels,i) > 0)
+				positive.push_back(score);
+			else
+				negative.push_back(score);
+		}
+	}
+}
+
+/// \brief Counts the pairs of a positive and a negative example in which the positive has the larger score.
+///
+/// Both score lists must be sorted in ascending order. Pairs with equal scores
+/// count tieWeight. The pairs are counted in a single merge pass.
+inline double countOrderedPairs(std::vector<double> const& positive, std::vector<double> const& negative, double tieWeight){
+	double pairs = 0;
+	std::size_t less = 0; // negatives with a smaller score
+	std::size_t equal = 0; // negatives with the same score
+	for(std::size_t i = 0; i != positive.size(); ++i){
+		if(i == 0 || positive[i] != positive[i-1]){
+			less += equal;
+			while(less != negative.size() && negative[less] < positive[i]) ++less;
+			equal = 0;
+			while(less + equal != negative.size() && negative[less + equal] == positive[i]) ++equal;
+		}
+		pairs += less + tieWeight * equal;
+	}
+	return pairs;
+}
+}
 ///
 /// \brief Negative area under the curve
 /// 
 /// This class computes the area under the ROC (receiver operating characteristic) curve.
 /// It implements the algorithm described in:
 /// Tom Fawcett. ROC Graphs: Notes and Practical Considerations for Researchers. 2004
+/// Instead of sorting all examples jointly, the scores of both classes are sorted
+/// separately and the area is obtained in a single merge pass.
 ///
 /// The area is negated so that optimizing the AUC corresponds to a minimization task. 
 ///
@@ -71,50 +119,17 @@ public:
 	double eval(Data<LabelType> const& target, Data<OutputType> const& prediction, unsigned int column) const {
 		SHARK_CHECK(dataDimension(prediction) > column,"[NegativeAUC::eval] column number too large");
 
-		std::size_t elements = target.numberOfElements();
-
-		unsigned P = 0; // positive examples
-		unsigned N = 0; // negative examples
-		std::vector<AUCPair> L(elements); // list of predictions and labels
-
-		for(std::size_t i=0; i!= elements; i++) { // build list
-			LabelType t = target.element(i);
-			// negate predictions if m_invert is set
-			if(!m_invert)
-				L[i] = AUCPair(prediction.element(i)(column), t);
-			else
-				L[i] = AUCPair(-prediction.element(i)(column), t);
-			// count positive and negative examples
-			if(t > 0) 
-				P++;
-			else 
-				N++;
-		}    
-
-		std::sort (L.begin(), L.end(),std::greater<AUCPair>() ); // sort in decreasing order
-
-		double   A = 0; // area
-		unsigned TP = 0; // true positives
-		unsigned FP = 0; // false positives
-		unsigned TPPrev = 0; // previous true positives
-		unsigned FPPrev = 0; // previous false positives
-		double   predictionPrev = -std::numeric_limits<double>::max(); // previous prediction
-		for(std::size_t i=0; i != elements; i++)  {
-			if(L[i].key != predictionPrev){
-				A += trapArea(FP/double(N),FPPrev/double(N),TP/double(P),TPPrev/double(P));
-				predictionPrev = L[i].key;
-				FPPrev = FP;
-				TPPrev = TP;
-			}
-			if(L[i].value > 0) 
-				TP++; // positive example
-			else 
-				FP++; // negative example
-		}
-		// deviation from the original algorithm description: A += trapArea(1, FPPrev, 1, TPPrev);
-		A += trapArea(FP/double(N), FPPrev/double(N), TP/double(P), TPPrev/double(P));
-
-		//~ A /= double(N*P);
+		// the area under the piecewise linear ROC curve equals the fraction of correctly
+		// ordered (positive,negative) pairs, where ties count one half. This is obtained by
+		// sorting both classes separately and merging them.
+		std::vector<double> positive;
+		std::vector<double> negative;
+		detail::splitScores(target, prediction, column, m_invert, positive, negative);
+		parallel_sort(positive.begin(), positive.end());
+		parallel_sort(negative.begin(), negative.end());
+
+		double A = detail::countOrderedPairs(positive, negative, 0.5);
+		A /= double(positive.size()) * double(negative.size());
 		return -A;
 	}
 
@@ -142,12 +157,6 @@ public:
 
 
 protected:
-	double trapArea(double x1, double x2, double y1, double y2) const {
-		double base = std::abs(x1-x2);
-		double heightAvg = (y1+y2)/2;
-		return base * heightAvg;
-	}
-
 	bool m_invert;
 };
 
@@ -181,37 +190,17 @@ public:
 	/// \param prediction: interpreted as binary class label
 	/// \param column: indicates the column of the prediction vector interpreted as probability of positive class
 	double eval(Data<LabelType> const& target, Data<OutputType> const& prediction, unsigned int column) const {
-		SHARK_CHECK(prediction(0).size() > column,"[NegativeWilcoxonMannWhitneyStatistic::eval] column number too large");
+		SHARK_CHECK(dataDimension(prediction) > column,"[NegativeWilcoxonMannWhitneyStatistic::eval] column number too large");
 		std::vector<double> pos, neg;
-		for(std::size_t i=0; i<prediction.size(); i++) {
-			if(!m_invert){
-				if(target(i) > 0) 
-					pos.push_back(prediction.element(i)(column));
-				else  
-					neg.push_back(prediction.element(i)(column));
-			}else{
-				if(target(i) > 0)
-					pos.push_back(-prediction.element(i)(column));
-				else
-					neg.push_back(-prediction.element(i)(column));
-			}
-		}
+		detail::splitScores(target, prediction, column, m_invert, pos, neg);
 		std::size_t m = pos.size();
 		std::size_t n = neg.size();
 
-		std::sort (pos.begin(), pos.end());
-		std::sort (neg.begin(), neg.end());
-
-		double A = 0;
-		for(std::size_t i = 0, j = 0; i != m; i++) {
-			A += j; 
-			for(std::size_t j = 0; j != n; j++) {
-				if(pos[i] > neg[j]) 
-					A++;
-				else 
-					break;
-			}
-		}
+		parallel_sort(pos.begin(), pos.end());
+		parallel_sort(neg.begin(), neg.end());
+
+		// single merge pass over both sorted lists, counting pos[i] > neg[j]
+		double A = detail::countOrderedPairs(pos, neg, 0.0);
 
 #ifdef DEBUG
 		// most naive implementation 
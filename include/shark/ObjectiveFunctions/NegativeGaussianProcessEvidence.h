@@ -189,28 +189,43 @@ public:
 		// dE/da = sum_i sum_j W dM_ij/da
 		//this can be calculated as blockwise derivative.
 		
-		//compute inverse matrix from the cholesky dcomposition 
-		//using forward-backward substitution,
-		RealMatrix W=RealIdentityMatrix(N);
-		blas::solveTriangularCholeskyInPlace<blas::SolveAXB>(choleskyFactor,W);
+		//calculate z = M^-1 t by forward-backward substitution
+		RealVector z = t;
+		blas::solveTriangularCholeskyInPlace<blas::SolveAXB>(choleskyFactor,z);
 		
-		//calculate z = Wt=M^-1 t
-		RealVector z(N);
-		axpy_prod(W,t,z);
-		
-		// W is already initialized as the inverse of M, so we only need 
-		// to change the sign and add z. to calculate W fully
-		W*=-1;
-		W+=outer_prod(z,z);
-		
-		
-		//now calculate the derivative
-		RealVector kernelGradient = 0.5*calculateKernelMatrixParameterDerivative(*mep_kernel,m_dataset.inputs(),W);
+		RealVector kernelGradient(kp);
+		double traceW = 0;
+		if(kp != 0){
+			//W = -M^-1 + zz^T, the inverse is computed from the cholesky factor
+			//exploiting that its inverse is triangular
+			RealMatrix W(N,N);
+			blas::choleskyInverse(choleskyFactor,W);
+			W*=-1;
+			W+=outer_prod(z,z);
+			//now calculate the derivative
+			noalias(kernelGradient) = 0.5*calculateKernelMatrixParameterDerivative(*mep_kernel,m_dataset.inputs(),W);
+			traceW = trace(W);
+		}else{
+			//only the trace is needed: tr(W) = -tr(M^-1) + z^Tz with
+			//tr(M^-1) = tr(L^-T L^-1) = ||L^-1||_F^2. The columns [c,N) of L^-1 are zero
+			//above row c, so they are solved in tiles using only the lower right part of L
+			std::size_t const tileSize = 64;
+			double traceInv = 0;
+			for(std::size_t c = 0; c < N; c += tileSize){
+				std::size_t tileEnd = std::min(c+tileSize,N);
+				RealMatrix tile(N-c,tileEnd-c,0.0);
+				for(std::size_t j = 0; j != tileEnd-c; ++j)
+					tile(j,j) = 1.0;
+				blas::solveTriangularSystemInPlace<blas::SolveAXB,blas::lower>(subrange(choleskyFactor,c,N,c,N),tile);
+				traceInv += sum(sqr(tile));
+			}
+			traceW = norm_sqr(z) - traceInv;
+		}
 		
 		// compute derivative w.r.t. regularization parameter
 		//we have: dE/dC = 1/2 * [ -tr(M^{-1}) + (M^{-1} t)^2
 		// which can also be written as 1/2 tr(W)
-		double betaInvDerivative = 0.5 * trace(W) ;
+		double betaInvDerivative = 0.5 * traceW ;
 		if(m_unconstrained) 
 			betaInvDerivative *= betaInv;
 		
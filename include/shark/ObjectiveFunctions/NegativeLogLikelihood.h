@@ -81,7 +81,7 @@ public:
 	ResultType eval(RealVector const& input) const{
 		SIZE_CHECK(input.size() == numberOfVariables());
 		m_evaluationCounter++;
-		mep_model->setParameterVector(input);
+		mep_model->assignParameterVector(input);
 		
 		double error = 0;
 		double minProb = 1e-100;//numerical stability is only guaranteed for lower bounded probabilities
@@ -102,7 +102,7 @@ public:
 	) const{
 		SIZE_CHECK(input.size() == numberOfVariables());
 		m_evaluationCounter++;
-		mep_model->setParameterVector(input);
+		mep_model->assignParameterVector(input);
 		derivative.resize(input.size());
 		derivative.clear();
 		
@@ -0,0 +1,263 @@
+//===========================================================================
+/*!
+ * 
+ *
+ * \brief       Approximate evidence for model selection of a sparse regularization network/Gaussian process.
+ * 
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ * 
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ * 
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published 
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+
+#ifndef SHARK_OBJECTIVEFUNCTIONS_NEGATIVESPARSEGAUSSIANPROCESSEVIDENCE_H
+#define SHARK_OBJECTIVEFUNCTIONS_NEGATIVESPARSEGAUSSIANPROCESSEVIDENCE_H
+
+#include <shark/ObjectiveFunctions/AbstractObjectiveFunction.h>
+#include <shark/Algorithms/Trainers/SparseRegularizationNetworkTrainer.h>
+#include <shark/Models/Kernels/KernelHelpers.h>
+
+#include <shark/LinAlg/Base.h>
+#include <shark/LinAlg/solveTriangular.h>
+#include <shark/LinAlg/Cholesky.h>
+namespace shark {
+
+
+///
+/// \brief Approximate evidence for model selection of a sparse regularization network/Gaussian process.
+///
+/// The covariance matrix \f$ K_{nn} \f$ of the NegativeGaussianProcessEvidence is replaced by
+/// its low rank approximation through m inducing points \f$ z_1,\dots,z_m \f$:
+/// \f[ Q = K_{nm} K_{mm}^{-1} K_{mn} \f]
+/// With \f$ M = Q + \sigma_n^2 I\f$ the evidence is
+/// \f[ E = 1/2 \cdot [ -\log(\det(M)) - t^T M^{-1} t - N \log(2 \pi)] \f]
+/// This is the marginal likelihood of the subset of regressors (or DTC) approximation
+/// whose predictive mean is computed by the SparseRegularizationNetworkTrainer, see
+///
+/// J. Quinonero-Candela & C.E. Rasmussen, A Unifying View of Sparse Approximate
+/// Gaussian Process Regression, JMLR 6, 2005
+///
+/// Using the Woodbury identity and the matrix determinant lemma, the evidence and its
+/// derivative are computed from the m x m matrix \f$ A = \sigma_n^2 K_{mm} + K_{mn} K_{nm} \f$
+/// in \f$ O(N m^2) \f$ time and \f$ O(N m) \f$ memory. The inducing points are fixed,
+/// only the kernel parameters and the noise variance are optimized. The parameters are
+/// encoded as in the NegativeGaussianProcessEvidence.
+template<class InputType = RealVector, class OutputType = RealVector, class LabelType = RealVector>
+class NegativeSparseGaussianProcessEvidence : public SingleObjectiveFunction
+{
+public:
+	typedef LabeledData<InputType,LabelType> DatasetType;
+	typedef AbstractKernelFunction<InputType> KernelType;
+
+	/// \param dataset: training data for the Gaussian process
+	/// \param inducingPoints: the inducing points of the approximation, e.g. chosen by selectLandmarks
+	/// \param kernel: pointer to external kernel function
+	/// \param unconstrained: exponential encoding of regularization parameter for unconstraint optimization
+	NegativeSparseGaussianProcessEvidence(
+		DatasetType const& dataset,
+		Data<InputType> const& inducingPoints,
+		KernelType* kernel,
+		bool unconstrained = false
+	): m_dataset(dataset)
+	, m_inducingPoints(inducingPoints)
+	, mep_kernel(kernel)
+	, m_unconstrained(unconstrained)
+	{
+		SHARK_CHECK(inducingPoints.numberOfElements() > 0, "[NegativeSparseGaussianProcessEvidence] no inducing points given");
+		if (kernel->hasFirstParameterDerivative()) m_features |= HAS_FIRST_DERIVATIVE;
+		setThreshold(0.);
+	}
+
+	/// \brief From INameable: return the class name.
+	std::string name() const
+	{ return "NegativeSparseGaussianProcessEvidence"; }
+	
+	std::size_t numberOfVariables()const{
+		return 1+ mep_kernel->numberOfParameters();
+	}
+
+	/// With \f$ A = \sigma_n^2 K_{mm} + K_{mn} K_{nm} \f$ and \f$ c = A^{-1} K_{mn} t \f$ we have
+	/// \f[ \log(\det(M)) = (N-m) \log(\sigma_n^2) + \log(\det(A)) - \log(\det(K_{mm})) \f]
+	/// \f[ t^T M^{-1} t = \sigma_n^{-2} t^T(t - K_{nm} c) \f]
+	double eval(const RealVector& parameters) const {
+		// keep track of how often the objective function is called
+		m_evaluationCounter++;
+		
+		Factorization f;
+		factorize(parameters,f);
+		return f.negativeEvidence;
+	}
+
+	/// For a kernel parameter \f$p\f$ the derivative is a weighted sum over the entries of the
+	/// derivatives of \f$ K_{mm} \f$ and \f$ K_{nm} \f$. With the residual \f$ r = t - K_{nm} c \f$:
+	/// \f[  -dE/dp = \sum_{ij} (W_{mm})_{ij} d(K_{mm})_{ij}/dp + \sum_{ij} (W_{nm})_{ij} d(K_{nm})_{ij}/dp\f]
+	/// \f[  W_{mm} = 1/2 \cdot [\sigma_n^2 A^{-1} - K_{mm}^{-1} + c c^T], \quad W_{nm} = K_{nm}A^{-1} - \sigma_n^{-2} r c^T \f]
+	/// and for the noise variance
+	/// \f[  -dE/d\sigma_n^2 = 1/2 \cdot [(N-m)\sigma_n^{-2} + tr(A^{-1}K_{mm}) - \sigma_n^{-4} t^T r + \sigma_n^{-2} c^T K_{mm} c] \f]
+	double evalDerivative(const RealVector& parameters, FirstOrderDerivative& derivative) const {
+		std::size_t kp = mep_kernel->numberOfParameters();
+		derivative.resize(1 + kp);
+		
+		// keep track of how often the objective function is called
+		m_evaluationCounter++;
+		
+		Factorization f;
+		factorize(parameters,f);
+		std::size_t N = f.Knm.size1();
+		std::size_t m = f.Knm.size2();
+		double betaInv = f.betaInv;
+		
+		//explicit inverses of the two m x m matrices
+		RealMatrix AInv(m,m);
+		blas::choleskyInverse(f.AFactor,AInv);
+		RealMatrix KmmInv(m,m);
+		blas::choleskyInverse(f.KmmFactor,KmmInv);
+		RealVector Kmmc = prod(f.Kmm,f.c);
+		
+		RealVector kernelGradient(kp,0.0);
+		if(kp != 0){
+			RealMatrix Wmm = betaInv*AInv - KmmInv + outer_prod(f.c,f.c);
+			Wmm *= 0.5;
+			//W_nm = K_nm A^-1 - r c^T/sigma^2, K_nm A^-1 is obtained by solving X A = K_nm
+			RealMatrix Wnm = f.Knm;
+			blas::solveTriangularCholeskyInPlace<blas::SolveXAB>(f.AFactor,Wnm);
+			noalias(Wnm) -= outer_prod(f.r,f.c)/betaInv;
+			
+			noalias(kernelGradient) = calculateKernelMatrixParameterDerivative(*mep_kernel,m_inducingPoints,Wmm);
+			noalias(kernelGradient) += calculateMixedKernelMatrixParameterDerivative(*mep_kernel,m_dataset.inputs(),m_inducingPoints,Wnm);
+		}
+		
+		// compute derivative w.r.t. regularization parameter
+		double betaInvDerivative = 0.5 * (
+			(double(N) - double(m)) / betaInv 
+			+ sum(element_prod(AInv,f.Kmm))
+			- f.tr / sqr(betaInv)
+			+ inner_prod(f.c,Kmmc) / betaInv
+		);
+		if(m_unconstrained) 
+			betaInvDerivative *= betaInv;
+		
+		//we already return the negative evidence, thus no sign flip
+		blas::init(derivative)<<kernelGradient,betaInvDerivative;
+
+		// truncate gradient vector 
+		for(std::size_t i=0; i<derivative.size(); i++) 
+			if(std::abs(derivative(i)) < m_derivativeThresholds(i)) derivative(i) = 0;
+
+		return f.negativeEvidence;
+	}
+	
+	/// set threshold value for truncating partial derivatives
+	void setThreshold(double d) {
+		m_derivativeThresholds = RealVector(mep_kernel->numberOfParameters() + 1, d); // plus one parameter for the prior 
+	}
+
+	/// set threshold values for truncating partial derivatives
+	void setThresholds(RealVector &c) {
+		SHARK_ASSERT(m_derivativeThresholds.size() == c.size());
+		m_derivativeThresholds = c;
+	}
+
+private:
+	/// \brief Quantities shared by eval and evalDerivative.
+	struct Factorization{
+		double betaInv;
+		RealMatrix Kmm;       ///< kernel matrix of the inducing points, including jitter
+		RealMatrix KmmFactor; ///< cholesky factor of Kmm
+		RealMatrix Knm;       ///< kernel matrix between inputs and inducing points
+		RealMatrix AFactor;   ///< cholesky factor of A = betaInv Kmm + Kmn Knm
+		RealVector c;         ///< A^-1 Kmn t
+		RealVector r;         ///< t - Knm c
+		double tr;            ///< t^T r
+		double negativeEvidence;
+	};
+	
+	void factorize(RealVector const& parameters, Factorization& f)const{
+		std::size_t kp = mep_kernel->numberOfParameters();
+		// check whether argument has right dimensionality
+		SHARK_ASSERT(1+kp == parameters.size());
+		
+		//set parameters
+		RealVector kernelParams(kp);
+		f.betaInv = 0;
+		blas::init(parameters) >> kernelParams, f.betaInv;
+		if(m_unconstrained)
+			f.betaInv = std::exp(f.betaInv); // for unconstraint optimization
+		mep_kernel->setParameterVector(kernelParams);
+		
+		//generate kernel matrices and label vector
+		f.Kmm = calculateRegularizedKernelMatrix(
+			*mep_kernel,m_inducingPoints,
+			SparseRegularizationNetworkTrainer<InputType>::inducingPointJitter
+		);
+		f.Knm = calculateMixedKernelMatrix(*mep_kernel,m_dataset.inputs(),m_inducingPoints);
+		RealVector t = column(createBatch<RealVector>(m_dataset.labels().elements()),0);
+		std::size_t N = f.Knm.size1();
+		std::size_t m = f.Knm.size2();
+		
+		//A = betaInv Kmm + Kmn Knm 
+		RealMatrix A = f.betaInv * f.Kmm;
+		symm_prod(trans(f.Knm),A,false);
+		f.AFactor.resize(m,m);
+		choleskyDecomposition(A,f.AFactor);
+		f.KmmFactor.resize(m,m);
+		choleskyDecomposition(f.Kmm,f.KmmFactor);
+		
+		//c = A^-1 Kmn t and r = t - Knm c
+		f.c = prod(trans(f.Knm),t);
+		blas::solveTriangularCholeskyInPlace<blas::SolveAXB>(f.AFactor,f.c);
+		f.r = t;
+		axpy_prod(f.Knm,f.c,f.r,false,-1.0);
+		f.tr = inner_prod(t,f.r);
+		
+		//log det(M) = (N-m) log(betaInv) + log det(A) - log det(Kmm)
+		double logDetM = (double(N) - double(m)) * std::log(f.betaInv)
+			+ 2 * sum(log(diag(f.AFactor))) - 2 * sum(log(diag(f.KmmFactor)));
+		double e = 0.5 * (-logDetM - f.tr / f.betaInv - N * std::log(2.0 * M_PI));
+		
+		// return the *negative* evidence
+		f.negativeEvidence = -e;
+	}
+
+	/// pointer to external data set
+	DatasetType m_dataset;
+	
+	/// the fixed inducing points
+	Data<InputType> m_inducingPoints;
+
+	/// thresholds for setting derivatives to zero
+	RealVector  m_derivativeThresholds;
+
+	/// pointer to external kernel function
+	KernelType* mep_kernel;
+
+	/// Indicates whether log() of the regularization parameter is
+	/// considered. This is useful for unconstraint
+	/// optimization. The default value is false.
+	bool m_unconstrained; 
+};
+
+
+}
+#endif
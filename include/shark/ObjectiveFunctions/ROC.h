@@ -35,6 +35,8 @@
 #define SHARK_OBJECTIVEFUNCTIONS_ROC_H
 
 #include <shark/Core/DLLSupport.h>
+#include <shark/Core/OpenMP.h>
+#include <shark/Core/utility/functional.h>
 #include <shark/Models/AbstractModel.h>
 #include <shark/Data/Dataset.h>
 #include <vector>
@@ -66,46 +68,41 @@ class ROC
 public:
 	//! Constructor
 	//!
+	//! The model is evaluated batch by batch in parallel (unless it is sequential)
+	//! and only the scores are stored. They are sorted once, afterwards all
+	//! queries take at most linear time.
+	//!
 	//! \param  model   model to use for prediction
 	//! \param  set     data set with inputs and corresponding binary outputs (0 or 1)
 	template<class InputType>
 	ROC(AbstractModel<InputType,RealVector>& model,LabeledData<InputType,unsigned int> const& set){
-		std::size_t inputs=set.numberOfElements();
-
-		//calculat the number of classes
-		std::vector<std::size_t> classes = classSizes(set);
-		SIZE_CHECK(classes.size() == 2); //only binary problems allowed!
-		
-		std::size_t positive = classes[0];
-		std::size_t negative = classes[1];
-		m_scorePositive.resize(positive);
-		m_scoreNegative.resize(negative);
-
-		// compute scores
-		std::size_t posPositive = 0;
-		std::size_t posNegative = 0;
-		
-		//calculate the model responses batchwise for the whole set
-		for(std::size_t i = 0; i != set.size(); ++i){
-			RealMatrix output = model(set.batch(i).input);
-			SIZE_CHECK(output.size2() == 1);
-			for(std::size_t j = 0; j != size(output); ++j){ 
-				double value = output(j,0);
-				if (set.batch(i)(j) == 1)
-				{
-					m_scorePositive[posPositive] = value;
-					posPositive++;
-				}
-				else
-				{
-					m_scoreNegative[posNegative] = value;
-					posNegative++;
+		std::size_t numBatches = set.numberOfBatches();
+		SHARK_CHECK(numBatches > 0, "[ROC::ROC] empty data set");
+		std::size_t numThreads = model.isSequential()? 1: std::min(SHARK_NUM_THREADS,numBatches);
+		std::vector<std::vector<double> > threadPositive(numThreads);
+		std::vector<std::vector<double> > threadNegative(numThreads);
+		parallelBlocks(numBatches, numThreads, [&](std::size_t t, std::size_t start, std::size_t end){
+			boost::shared_ptr<State> state = model.createState();
+			RealMatrix output;
+			for(std::size_t b = start; b != end; ++b){
+				model.eval(set.batch(b).input, output, *state);
+				SIZE_CHECK(output.size2() == 1);
+				for(std::size_t j = 0; j != output.size1(); ++j){
+					SIZE_CHECK(set.batch(b).label(j) < 2);//only binary problems allowed!
+					if (set.batch(b).label(j) == 1)
+						threadPositive[t].push_back(output(j,0));
+					else
+						threadNegative[t].push_back(output(j,0));
 				}
 			}
+		});
+		// concatenate in a fixed order and sort positives and negatives by score
+		for(std::size_t t = 0; t != numThreads; ++t){
+			m_scorePositive.insert(m_scorePositive.end(),threadPositive[t].begin(),threadPositive[t].end());
+			m_scoreNegative.insert(m_scoreNegative.end(),threadNegative[t].begin(),threadNegative[t].end());
 		}
-		// sort positives and negatives by score
-		std::sort(m_scorePositive.begin(), m_scorePositive.end());
-		std::sort(m_scoreNegative.begin(), m_scoreNegative.end());
+		parallel_sort(m_scorePositive.begin(), m_scorePositive.end());
+		parallel_sort(m_scoreNegative.begin(), m_scoreNegative.end());
 	}
 
 	//! Compute the threshold for given false acceptance rate,
@@ -121,6 +118,15 @@ public:
 	//! Computes the equal error rate of the classifier
 	SHARK_EXPORT_SYMBOL double equalErrorRate()const;
 
+	//! Area under the ROC curve, that is, the probability that a random
+	//! positive example has a larger score than a random negative one.
+	//! Ties count one half.
+	SHARK_EXPORT_SYMBOL double area()const;
+
+	//! Average precision, the area under the precision-recall curve
+	//! computed as the mean precision over all recall steps.
+	SHARK_EXPORT_SYMBOL double averagePrecision()const;
+
 protected:
 	//! scores of the positive examples
 	std::vector<double> m_scorePositive;
@@ -103,6 +103,8 @@
 #include <shark/Rng/Entropy.h>
 #include <shark/Rng/KullbackLeiberDivergence.h>
 
+#include <shark/Core/OpenMP.h>
+
 #include <boost/random.hpp>
 #include <vector>
 
@@ -123,6 +125,26 @@ namespace shark {
 		//! The global random number generator used by all distributions
 		static rng_type globalRng;
 
+		//! \brief Returns the generator to be used by the calling thread.
+		//!
+		//! Outside of parallel regions and in the master thread, this is globalRng.
+		//! Every other thread draws from its own generator, so random numbers can be
+		//! created in parallel regions without synchronisation. The generator of thread t
+		//! is seeded with the last value passed to seed() and t, so results are reproducible
+		//! for a fixed number of threads.
+		static rng_type& threadRng(){
+			std::size_t thread = SHARK_THREAD_NUM;
+			if(thread == 0)
+				return globalRng;
+			static thread_local rng_type rng;
+			static thread_local unsigned int seedGeneration = 0;
+			if(seedGeneration != s_seedGeneration){
+				rng.seed(typename rng_type::result_type(s_seed + 2654435761u * thread));
+				seedGeneration = s_seedGeneration;
+			}
+			return rng;
+		}
+
 		//! creates a bernoulli distributed number with propability "p"
 		static inline bool coinToss( double p = 0.5 ) {
 			Bernoulli< rng_type > coin(globalRng,p);
@@ -200,10 +222,21 @@ namespace shark {
 		//! Sets the seed for all random number generators to "s".
 		static void seed( typename rng_type::result_type s ) {
 			globalRng.seed( s );
+			s_seed = s;
+			++s_seedGeneration;
 		}
+	private:
+		//! last seed, used to seed the generators of the threads
+		static typename rng_type::result_type s_seed;
+		//! incremented by every call to seed, signals the threads to reseed
+		static unsigned int s_seedGeneration;
 	};
 	template<class Rng>
 	typename BaseRng<Rng>::rng_type BaseRng<Rng>::globalRng = typename BaseRng<Rng>::rng_type();
+	template<class Rng>
+	typename BaseRng<Rng>::rng_type::result_type BaseRng<Rng>::s_seed = 0;
+	template<class Rng>
+	unsigned int BaseRng<Rng>::s_seedGeneration = 1;
 
 	#define ANNOUNCE_SHARK_RNG( boost_rng_type, shark_rng_name )\
 		typedef BaseRng< boost_rng_type > shark_rng_name; \
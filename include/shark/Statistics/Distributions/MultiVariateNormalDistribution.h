@@ -117,13 +117,39 @@ public:
 		for( unsigned int i = 0; i < result.size(); i++ ) {
 			z( i ) = Rng::gauss( 0., 1. );
 		}
-
-		for( unsigned int i = 0; i < result.size(); i++ )
-			for( unsigned int j = 0; j < result.size(); j++ )
-				result( i ) += m_eigenVectors( i, j ) * std::sqrt( std::abs( m_eigenValues(j) ) ) * z( j );
+		RealVector scaledZ = sqrt( abs( m_eigenValues ) ) * z;
+		axpy_prod( m_eigenVectors, scaledZ, result );
 
 		return( std::make_pair( result, z ) );
-	}	    
+	}
+
+	/// \brief Samples a batch of points from the distribution.
+	///
+	/// Every row of z is filled with standard normally distributed numbers and the
+	/// corresponding row of y is set to \f$ B D z \f$, where B are the eigenvectors and
+	/// D the square roots of the eigenvalues of the covariance matrix. All samples are
+	/// computed by a single matrix-matrix product, which is much faster than drawing
+	/// them one by one.
+	///
+	/// \param [out] y the sampled points, one per row
+	/// \param [out] z the standard normally distributed vectors, one per row
+	/// \param [in] samples the number of points to sample
+	void generate( RealMatrix& y, RealMatrix& z, std::size_t samples ) const {
+		std::size_t size = m_eigenValues.size();
+		z.resize( samples, size );
+		y.resize( samples, size );
+		for( std::size_t i = 0; i != samples; i++ ) {
+			for( std::size_t j = 0; j != size; j++ ) {
+				z( i, j ) = Rng::gauss( 0., 1. );
+			}
+		}
+
+		RealMatrix BD = m_eigenVectors;
+		for( std::size_t j = 0; j != size; j++ ) {
+			column( BD, j ) *= std::sqrt( std::abs( m_eigenValues(j) ) );
+		}
+		axpy_prod( z, trans( BD ), y );
+	}
 
 	/// \brief Calculates the evd of the current covariance matrix.
 	void update() {
@@ -72,6 +72,7 @@ private:
 	RngType* mpe_rng;
 	bool m_forward;
 	bool m_evalMean;
+	ConvolutionAlgorithm m_convolutionAlgorithm;
 
 	///\brief Evaluates the input by propagating the visible input to the hidden neurons.
 	///
@@ -115,7 +116,7 @@ private:
 		}
 	}
 public:
-	ConvolutionalRBM(RngType& rng):mpe_rng(&rng),m_forward(true),m_evalMean(true)
+	ConvolutionalRBM(RngType& rng):mpe_rng(&rng),m_forward(true),m_evalMean(true),m_convolutionAlgorithm(AutomaticConvolution)
 	{ }
 
 	/// \brief From INameable: return the class name.
@@ -215,6 +216,24 @@ public:
 		return m_inputSize2-m_filters.size2()+1;
 	}
 	
+	///\brief Returns the sizes of images and filters of the convolution.
+	detail::ConvolutionShape convolutionShape()const{
+		return detail::ConvolutionShape(m_inputSize1,m_inputSize2,filterSize1(),filterSize2(),numFilters());
+	}
+	
+	///\brief Returns the algorithm used to compute the filter responses.
+	ConvolutionAlgorithm convolutionAlgorithm()const{
+		return m_convolutionAlgorithm;
+	}
+	
+	///\brief Sets the algorithm used to compute the filter responses and their derivatives.
+	///
+	///By default the algorithm is chosen automatically based on the image and filter sizes:
+	///the matrix-product based algorithm is used for small filters and the FFT for large filters.
+	void setConvolutionAlgorithm(ConvolutionAlgorithm algorithm){
+		m_convolutionAlgorithm = algorithm;
+	}
+	
 	///\brief Returns the weight matrix connecting the layers.
 	blas::matrix_set<RealMatrix>& filters(){
 		return m_filters;
@@ -288,24 +307,8 @@ public:
 		SIZE_CHECK(visibleStates.size1() == inputs.size1());
 		SIZE_CHECK(inputs.size2() == numberOfHN());
 		SIZE_CHECK( visibleStates.size2() == numberOfVN());
-		inputs.clear();
-
-		for(std::size_t i= 0; i != inputs.size1();++i){
-			blas::dense_matrix_adaptor<double const> visibleState = 
-				to_matrix(row(visibleStates,i),inputSize1(),inputSize2());
-			blas::dense_matrix_adaptor<double> responses = 
-				to_matrix(row(inputs,i),m_filters.size()*responseSize1(),responseSize2());
-			
-			for (std::size_t x1=0; x1 != responseSize1(); ++x1) {
-				for (std::size_t x2=0; x2 != responseSize2(); ++x2) {
-					std::size_t end1= x1+m_filters.size1();
-					std::size_t end2= x2+m_filters.size2();
-					for(std::size_t f = 0; f != m_filters.size();++f){
-						responses(f*responseSize1()+x1,x2)=sum(m_filters[f]*subrange(visibleState,x1,end1,x2,end2));
-					}
-				}
-			}
-		}
+		
+		detail::convolutionResponses(visibleStates,m_filters,convolutionShape(),inputs,m_convolutionAlgorithm);
 	}
 
 
@@ -317,31 +320,8 @@ public:
 		SIZE_CHECK(hiddenStates.size1() == inputs.size1());
 		SIZE_CHECK(inputs.size2() == numberOfVN());
 		SIZE_CHECK(hiddenStates.size2() == numberOfHN());
-		typedef blas::dense_matrix_adaptor<double> Response;
-		inputs.clear();
 		
-		//we slightly optimize this routine by checking whether the hiddens are 0 -
-		//this is likely when the hiddens are binary.
-		for(std::size_t i= 0; i != inputs.size1();++i){
-			blas::dense_matrix_adaptor<double const> hiddenState = 
-				to_matrix(row(hiddenStates,i),responseSize1()*m_filters.size(),responseSize2());
-			Response responses = 
-				to_matrix(row(inputs,i),m_inputSize1,m_inputSize2);
-			
-			for (std::size_t x1=0; x1 != responseSize1(); ++x1) {
-				for (std::size_t x2=0; x2 != responseSize2(); ++x2) {
-					std::size_t end1= x1+m_filters.size1();
-					std::size_t end2= x2+m_filters.size2();
-					blas::matrix_range<Response> receptiveArea = subrange(responses,x1,end1,x2,end2);
-						
-					for(std::size_t f = 0; f != m_filters.size();++f){
-						double neuronResponse = hiddenState(f*responseSize1()+x1,x2);
-						if(neuronResponse == 0.0) continue;
-						noalias(receptiveArea) += neuronResponse * m_filters[f];
-					}
-				}
-			}
-		}
+		detail::convolutionImages(hiddenStates,m_filters,convolutionShape(),inputs,m_convolutionAlgorithm);
 	}
 	
 	using base_type::eval;
@@ -33,7 +33,9 @@
 #include <shark/ObjectiveFunctions/AbstractObjectiveFunction.h>
 #include <shark/Unsupervised/RBM/Sampling/GibbsOperator.h>
 #include <shark/Unsupervised/RBM/analytics.h>
+#include <shark/Core/OpenMP.h>
 #include <boost/type_traits/is_same.hpp>
+#include <vector>
 
 namespace shark{
 
@@ -139,68 +141,90 @@ private:
 	SingleObjectiveFunction* m_regularizer;
 	double m_regularizationStrength;
 	
-	//batchwise loops over all hidden units to calculate the gradient as well as partition
+	//batchwise loops over all visible states to calculate the gradient as well as partition.
+	//The states are enumerated in Gray code order and the batches are distributed over all threads,
+	//each thread accumulating its own part of the expectation.
 	template<class GradientApproximator>//mostly dummy right now
 	void integrateOverVisible(GradientApproximator & modelExpectation) const{
-		
-		Gibbs sampler(mpe_rbm);
-		
 		typedef typename RBM::VisibleType::StateSpace VisibleStateSpace;
+		typedef detail::GrayCodeEnumeration<VisibleStateSpace> Enumeration;
 		std::size_t values = VisibleStateSpace::numberOfStates(mpe_rbm->numberOfVN());
 		std::size_t batchSize = std::min(values, std::size_t(256));
+		std::size_t numBatches = (values+batchSize-1)/batchSize;
 		
-		for (std::size_t x = 0; x < values; x+=batchSize) {
-			//create batch of states
-			std::size_t currentBatchSize=std::min(batchSize,values-x);
-			typename Batch<RealVector>::type stateBatch(currentBatchSize,mpe_rbm->numberOfVN());
-			for(std::size_t elem = 0; elem != currentBatchSize;++elem){
-				//generation of the x+elem-th state vector
-				VisibleStateSpace::state(row(stateBatch,elem),x+elem);
-			}
-			
-			//create sample from state batch
+		RealMatrix basis = Enumeration::basisStates(mpe_rbm->numberOfVN());
+		RealMatrix basisInputs(basis.size1(),mpe_rbm->numberOfHN());
+		mpe_rbm->energy().inputHidden(basisInputs,basis);
+		Enumeration enumeration(basis,basisInputs);
+		
+		std::vector<GradientApproximator> threadExpectations(SHARK_NUM_THREADS,modelExpectation);
+		SHARK_PARALLEL_FOR(std::size_t b = 0; b < numBatches; ++b) {
+			//create batch of states together with the input of the hidden neurons
+			std::size_t start = b*batchSize;
+			std::size_t currentBatchSize=std::min(batchSize,values-start);
 			typename Gibbs::HiddenSampleBatch hiddenBatch(currentBatchSize,mpe_rbm->numberOfHN());
 			typename Gibbs::VisibleSampleBatch visibleBatch(currentBatchSize,mpe_rbm->numberOfVN());
-			sampler.createSample(hiddenBatch,visibleBatch,stateBatch);
+			enumeration.enumerate(start,visibleBatch.state,hiddenBatch.input);
+			mpe_rbm->hiddenNeurons().sufficientStatistics(
+				hiddenBatch.input,hiddenBatch.statistics,blas::repeat(1.0,currentBatchSize)
+			);
 			
 			//calculate probabilities and update 
 			RealVector logP = mpe_rbm->energy().logUnnormalizedProbabilityVisible(
-				stateBatch,hiddenBatch.input,blas::repeat(1,currentBatchSize)
+				visibleBatch.state,hiddenBatch.input,blas::repeat(1,currentBatchSize)
 			);
-			modelExpectation.addVH(hiddenBatch, visibleBatch, logP);
+			threadExpectations[SHARK_THREAD_NUM].addVH(hiddenBatch, visibleBatch, logP);
 		}
+		combineExpectations(threadExpectations,modelExpectation);
 	}
 	
-	//batchwise loops over all hidden units to calculate the gradient as well as partition
+	//batchwise loops over all hidden states to calculate the gradient as well as partition.
+	//The states are enumerated in Gray code order and the batches are distributed over all threads,
+	//each thread accumulating its own part of the expectation.
 	template<class GradientApproximator>//mostly dummy right now
 	void integrateOverHidden(GradientApproximator & modelExpectation) const{
-		
-		Gibbs sampler(mpe_rbm);
-		
 		typedef typename RBM::HiddenType::StateSpace HiddenStateSpace;
+		typedef detail::GrayCodeEnumeration<HiddenStateSpace> Enumeration;
 		std::size_t values = HiddenStateSpace::numberOfStates(mpe_rbm->numberOfHN());
 		std::size_t batchSize = std::min(values, std::size_t(256) );
+		std::size_t numBatches = (values+batchSize-1)/batchSize;
 		
-		for (std::size_t x = 0; x < values; x+=batchSize) {
-			//create batch of states
-			std::size_t currentBatchSize=std::min(batchSize,values-x);
-			typename Batch<RealVector>::type stateBatch(currentBatchSize,mpe_rbm->numberOfHN());
-			for(std::size_t elem = 0; elem != currentBatchSize;++elem){
-				//generation of the x+elem-th state vector
-				HiddenStateSpace::state(row(stateBatch,elem),x+elem);
-			}
-			
-			//create sample from state batch
+		RealMatrix basis = Enumeration::basisStates(mpe_rbm->numberOfHN());
+		RealMatrix basisInputs(basis.size1(),mpe_rbm->numberOfVN());
+		mpe_rbm->energy().inputVisible(basisInputs,basis);
+		Enumeration enumeration(basis,basisInputs);
+		
+		std::vector<GradientApproximator> threadExpectations(SHARK_NUM_THREADS,modelExpectation);
+		SHARK_PARALLEL_FOR(std::size_t b = 0; b < numBatches; ++b) {
+			//create batch of states together with the input of the visible neurons
+			std::size_t start = b*batchSize;
+			std::size_t currentBatchSize=std::min(batchSize,values-start);
 			typename Gibbs::HiddenSampleBatch hiddenBatch(currentBatchSize,mpe_rbm->numberOfHN());
 			typename Gibbs::VisibleSampleBatch visibleBatch(currentBatchSize,mpe_rbm->numberOfVN());
-			hiddenBatch.state=stateBatch;
-			sampler.precomputeVisible(hiddenBatch,visibleBatch, blas::repeat(1,currentBatchSize));
+			enumeration.enumerate(start,hiddenBatch.state,visibleBatch.input);
+			mpe_rbm->visibleNeurons().sufficientStatistics(
+				visibleBatch.input,visibleBatch.statistics,blas::repeat(1.0,currentBatchSize)
+			);
 			
 			//calculate probabilities and update 
 			RealVector logP = mpe_rbm->energy().logUnnormalizedProbabilityHidden(
-				stateBatch,visibleBatch.input,blas::repeat(1,currentBatchSize)
+				hiddenBatch.state,visibleBatch.input,blas::repeat(1,currentBatchSize)
 			);
-			modelExpectation.addHV(hiddenBatch, visibleBatch, logP);
+			threadExpectations[SHARK_THREAD_NUM].addHV(hiddenBatch, visibleBatch, logP);
+		}
+		combineExpectations(threadExpectations,modelExpectation);
+	}
+	
+	//adds the expectations accumulated by the single threads
+	template<class GradientApproximator>
+	void combineExpectations(
+		std::vector<GradientApproximator>& threadExpectations, 
+		GradientApproximator & modelExpectation
+	)const{
+		for(std::size_t i = 0; i != threadExpectations.size(); ++i){
+			//threads which did not get any batch have no weight
+			if(threadExpectations[i].logWeightSum() != -std::numeric_limits<double>::infinity())
+				modelExpectation += threadExpectations[i];
 		}
 	}
 
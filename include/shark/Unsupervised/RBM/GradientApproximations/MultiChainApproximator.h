@@ -31,6 +31,7 @@
 #define SHARK_UNSUPERVISED_RBM_GRADIENTAPPROXIMATIONS_MULTICHAINAPPROXIMATOR_H
 
 #include <shark/ObjectiveFunctions/AbstractObjectiveFunction.h>
+#include <shark/Core/OpenMP.h>
 #include "Impl/DataEvaluator.h"
 #include <vector>
 
@@ -40,6 +41,10 @@ namespace shark{
 ///The advantage is, that every chain can produce samples of a different mode of the distribution.
 ///The disadvantage is however, that mixing is slower and a higher value of sampling steps between subsequent samples
 ///need to be chosen. 
+///
+///The chains are advanced in parallel. Every chain has its own random number generator which is seeded from
+///the generator of the RBM in setData and every thread accumulates the gradient of a contiguous range of chains.
+///The per-thread gradients are merged in a fixed order, thus for a fixed seed and number of threads the results are reproducible.
 template<class MarkovChainType>	
 class MultiChainApproximator: public SingleObjectiveFunction{
 public:
@@ -110,6 +115,12 @@ public:
 		}
 		m_chains.resize(batches);
 		
+		//every chain gets its own random number generator so that the chains can be advanced in parallel
+		m_chainRngs.resize(batches);
+		for(std::size_t i = 0; i != batches;++i){
+			m_chainRngs[i].seed(mpe_rbm->rng()());
+		}
+		
 		//swap every sample batch from the vector into the operator, initialize it and shift it back out.
 		for(std::size_t i = 0; i != batches;++i){
 			swap(m_chains[i],m_chainOperator.samples());
@@ -140,12 +151,24 @@ public:
 		RealVector empiricalAverage = detail::evaluateData(m_data,*mpe_rbm,m_numBatches);
 		
 		//approximate the expectation of the energy gradient with respect to the model distribution
-		//using samples from the Markov chain
-		for(std::size_t i = 0; i != m_chains.size();++i){
-			swap(m_chains[i],m_chainOperator.samples());//set the current GibbsChain
-			m_chainOperator.step(m_k);//do the next step along the gibbs chain
-			modelAverage.addVH(m_chainOperator.samples().hidden, m_chainOperator.samples().visible);//update gradient
-			swap(m_chains[i],m_chainOperator.samples());//save the GibbsChain.
+		//using samples from the Markov chain. Every thread advances a contiguous range of chains
+		//using its own copy of the chain operator and accumulates its own gradient.
+		std::size_t numChains = m_chains.size();
+		std::size_t numThreads = std::max<std::size_t>(1,std::min<std::size_t>(SHARK_NUM_THREADS,numChains));
+		std::vector<typename RBM::GradientType> threadAverages(numThreads,modelAverage);
+		SHARK_PARALLEL_FOR(int t = 0; t < (int)numThreads; ++t){
+			MarkovChainType chainOperator = m_chainOperator;
+			std::size_t start = t * numChains / numThreads;
+			std::size_t end = (t+1) * numChains / numThreads;
+			for(std::size_t i = start; i != end;++i){
+				swap(m_chains[i],chainOperator.samples());//set the current GibbsChain
+				chainOperator.step(m_k,m_chainRngs[i]);//do the next step along the gibbs chain
+				threadAverages[t].addVH(chainOperator.samples().hidden, chainOperator.samples().visible);//update gradient
+				swap(m_chains[i],chainOperator.samples());//save the GibbsChain.
+			}
+		}
+		for(std::size_t t = 0; t != numThreads; ++t){
+			modelAverage += threadAverages[t];
 		}
 		
 		derivative.resize(mpe_rbm->numberOfParameters());
@@ -163,6 +186,7 @@ private:
 	RBM* mpe_rbm;
 	mutable MarkovChainType m_chainOperator;
 	mutable std::vector<typename MarkovChainType::SampleBatch> m_chains;
+	mutable std::vector<typename RBM::RngType> m_chainRngs;
 	UnlabeledData<RealVector> m_data;
 
 	unsigned int m_k;
@@ -31,7 +31,9 @@
 #define SHARK_UNSUPERVISED_RBM_SINGLECHAINAPPROXIMATOR_H
 
 #include <shark/ObjectiveFunctions/AbstractObjectiveFunction.h>
+#include <shark/Core/OpenMP.h>
 #include "Impl/DataEvaluator.h"
+#include <vector>
 
 namespace shark{
 	
@@ -40,6 +42,10 @@ namespace shark{
 ///Taking samples only from a single chain leads to a high mixing rate but the correlation of the samples is higher than using
 ///several chains. This approximator should be used with a sampling scheme which also achieves a faster decorrelation of samples like
 ///tempering.
+///
+///As the samples of a single chain depend on each other, the chain itself is run sequentially. The samples are collected
+///in one batch per thread and the gradients of the batches are computed in parallel. Every thread
+///accumulates its own gradient, which are merged in a fixed order at the end.
 template<class MarkovChainType>	
 class SingleChainApproximator: public SingleObjectiveFunction{
 public:
@@ -126,21 +132,32 @@ public:
 		}
 		
 		//calculate the gradient. we do this by normal k-step sampling for exactly as many
-		//samples as calculated in samplesToDraw but saving the result in an intermediate
-		//batch variable gradientbatch. When this batch is full, we do an update step of the gradient.
+		//samples as calculated in samplesToDraw but saving the result in intermediate
+		//batch variables. When one batch for every thread is full, the threads update their gradients in parallel.
 		//this is an a bit more efficient grouping and preserves us from using batches of size1 as the argument 
 		//of addVH which might be inefficient.
-		for(std::size_t batch = 0; batch != batches; ++batch){
-			//calculate the size of the next batch which is batchSize as long as there are enough samples left to draw
-			std::size_t currentBatchSize = std::min(samplesToDraw-batch*m_batchSize, m_batchSize);
-			typename MarkovChainType::SampleBatch gradientBatch(currentBatchSize, mpe_rbm->numberOfVN(),mpe_rbm->numberOfHN());
-			//fill the batch with fresh samples
-			for(std::size_t i = 0; i != currentBatchSize; ++i){
-				m_chain.step(m_k);
-				get(gradientBatch,i) = m_chain.sample();
+		std::size_t numThreads = std::max<std::size_t>(1,std::min<std::size_t>(SHARK_NUM_THREADS,batches));
+		std::vector<typename MarkovChainType::SampleBatch> gradientBatches(numThreads);
+		std::vector<typename RBM::GradientType> threadAverages(numThreads,modelAverage);
+		for(std::size_t batch = 0; batch < batches; batch += numThreads){
+			std::size_t currentThreads = std::min(numThreads, batches - batch);
+			for(std::size_t t = 0; t != currentThreads; ++t){
+				//calculate the size of the next batch which is batchSize as long as there are enough samples left to draw
+				std::size_t currentBatchSize = std::min(samplesToDraw-(batch+t)*m_batchSize, m_batchSize);
+				gradientBatches[t] = typename MarkovChainType::SampleBatch(currentBatchSize, mpe_rbm->numberOfVN(),mpe_rbm->numberOfHN());
+				//fill the batch with fresh samples
+				for(std::size_t i = 0; i != currentBatchSize; ++i){
+					m_chain.step(m_k);
+					get(gradientBatches[t],i) = m_chain.sample();
+				}
 			}
 			//do the gradient update
-			modelAverage.addVH(gradientBatch.hidden, gradientBatch.visible);
+			SHARK_PARALLEL_FOR(int t = 0; t < (int)currentThreads; ++t){
+				threadAverages[t].addVH(gradientBatches[t].hidden, gradientBatches[t].visible);
+			}
+		}
+		for(std::size_t t = 0; t != numThreads; ++t){
+			modelAverage += threadAverages[t];
 		}
 		
 		derivative.resize(mpe_rbm->numberOfParameters());
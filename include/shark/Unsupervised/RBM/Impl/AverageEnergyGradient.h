@@ -115,6 +115,7 @@ public:
 		noalias(m_deltaWeights) += weight * gradient.m_deltaWeights;
 		noalias(m_deltaBiasVisible) += weight * gradient.m_deltaBiasVisible;
 		noalias(m_deltaBiasHidden) += weight * gradient.m_deltaBiasHidden;
+		return *this;
 	}
 	
 	///\brief Calculates the expectation of the energy gradient with respect to p(h|v) for a complete Batch.
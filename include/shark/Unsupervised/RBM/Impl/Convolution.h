@@ -0,0 +1,542 @@
+/*!
+ *
+ *
+ * \brief       Batched 2D convolution kernels used by the ConvolutionalRBM
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SHARK_UNSUPERVISED_RBM_IMPL_CONVOLUTION_H
+#define SHARK_UNSUPERVISED_RBM_IMPL_CONVOLUTION_H
+
+#include <shark/LinAlg/Base.h>
+#include <shark/LinAlg/BLAS/matrix_set.hpp>
+#include <shark/Core/OpenMP.h>
+
+#include <complex>
+#include <vector>
+#include <cmath>
+
+namespace shark{
+
+///\brief Algorithm used to compute the filter responses of a convolutional model.
+///
+///GemmConvolution copies all image patches into the columns of a matrix ("im2col") and computes all
+///responses of a batch with a single matrix-matrix product. FFTConvolution computes the responses
+///in the frequency domain, which is faster for large filters. AutomaticConvolution chooses the
+///algorithm with the smaller estimated cost for the given image and filter sizes.
+enum ConvolutionAlgorithm{
+	AutomaticConvolution,
+	GemmConvolution,
+	FFTConvolution
+};
+
+namespace detail{
+
+///\brief Geometry of a valid convolution of images with a set of filters.
+///
+///Images are stored row-major in the rows of a batch matrix. The responses of filter f are stored
+///row-major as a responseSize1 x responseSize2 image starting at index f*responseSize1*responseSize2.
+struct ConvolutionShape{
+	std::size_t imageSize1;
+	std::size_t imageSize2;
+	std::size_t filterSize1;
+	std::size_t filterSize2;
+	std::size_t numFilters;
+
+	ConvolutionShape(
+		std::size_t imageSize1, std::size_t imageSize2,
+		std::size_t filterSize1, std::size_t filterSize2,
+		std::size_t numFilters
+	):imageSize1(imageSize1), imageSize2(imageSize2)
+	, filterSize1(filterSize1), filterSize2(filterSize2)
+	, numFilters(numFilters){}
+
+	std::size_t responseSize1()const{
+		return imageSize1 - filterSize1 + 1;
+	}
+	std::size_t responseSize2()const{
+		return imageSize2 - filterSize2 + 1;
+	}
+	std::size_t numResponses()const{
+		return responseSize1() * responseSize2();
+	}
+	std::size_t filterElements()const{
+		return filterSize1 * filterSize2;
+	}
+	std::size_t imageElements()const{
+		return imageSize1 * imageSize2;
+	}
+};
+
+inline std::size_t nextPowerOfTwo(std::size_t n){
+	std::size_t p = 1;
+	while(p < n) p *= 2;
+	return p;
+}
+
+///\brief Returns the algorithm with the smaller estimated number of operations per image.
+///
+///The GEMM path needs numResponses*filterElements*numFilters multiply-adds. The FFT path needs one
+///transform of size n per filter and image, each costing O(n log2(n)). The constant relating both was
+///measured with the default blas kernels; with an optimized blas the GEMM path is chosen too rarely.
+inline ConvolutionAlgorithm chooseConvolutionAlgorithm(ConvolutionShape const& shape){
+	double gemmCost = double(shape.numResponses()) * shape.filterElements() * shape.numFilters;
+	double fftSize = double(nextPowerOfTwo(shape.imageSize1) * nextPowerOfTwo(shape.imageSize2));
+	double fftCost = 4.0 * (shape.numFilters + 1) * fftSize * std::log(fftSize)/std::log(2.0);
+	return fftCost < gemmCost ? FFTConvolution : GemmConvolution;
+}
+
+///\brief Two dimensional radix-2 fast fourier transform of complex row-major data.
+class FFT2D{
+public:
+	typedef std::complex<double> Complex;
+
+	///\brief Creates the transform for size1 x size2 arrays, both sizes must be powers of two.
+	FFT2D(std::size_t size1, std::size_t size2)
+	: m_size1(size1), m_size2(size2)
+	, m_plan1(size1), m_plan2(size2){}
+
+	std::size_t size1()const{
+		return m_size1;
+	}
+	std::size_t size2()const{
+		return m_size2;
+	}
+	std::size_t size()const{
+		return m_size1 * m_size2;
+	}
+
+	///\brief Transforms data in place. Only the first nonzeroRows rows of the input may be nonzero.
+	void forward(Complex* data, std::size_t nonzeroRows)const{
+		for(std::size_t i = 0; i != nonzeroRows; ++i){
+			m_plan2.transform(data + i * m_size2, false);
+		}
+		transformColumns(data, false);
+	}
+	///\brief Computes the unscaled inverse transform in place.
+	void inverse(Complex* data)const{
+		transformColumns(data, true);
+		for(std::size_t i = 0; i != m_size1; ++i){
+			m_plan2.transform(data + i * m_size2, true);
+		}
+	}
+private:
+	class Plan1D{
+	public:
+		Plan1D(std::size_t n):m_bitReverse(n),m_twiddles(n/2){
+			std::size_t bits = 0;
+			while((std::size_t(1) << bits) < n) ++bits;
+			for(std::size_t i = 0; i != n; ++i){
+				std::size_t reversed = 0;
+				for(std::size_t b = 0; b != bits; ++b){
+					reversed |= ((i >> b) & 1) << (bits - 1 - b);
+				}
+				m_bitReverse[i] = reversed;
+			}
+			double const pi = 3.141592653589793238;
+			for(std::size_t k = 0; k != n/2; ++k){
+				m_twiddles[k] = Complex(std::cos(2*pi*k/n), -std::sin(2*pi*k/n));
+			}
+		}
+
+		void transform(Complex* x, bool inverse)const{
+			std::size_t n = m_bitReverse.size();
+			for(std::size_t i = 0; i != n; ++i){
+				std::size_t j = m_bitReverse[i];
+				if(i < j) std::swap(x[i],x[j]);
+			}
+			double sign = inverse? -1.0: 1.0;
+			for(std::size_t len = 2; len <= n; len *= 2){
+				std::size_t half = len/2;
+				std::size_t step = n/len;
+				for(std::size_t i = 0; i < n; i += len){
+					for(std::size_t k = 0; k != half; ++k){
+						Complex w = m_twiddles[k*step];
+						Complex u = x[i+k];
+						Complex v = x[i+k+half];
+						//written out as the complex operator* checks for NaN and infinities
+						double vr = v.real() * w.real() - sign * v.imag() * w.imag();
+						double vi = v.imag() * w.real() + sign * v.real() * w.imag();
+						x[i+k] = Complex(u.real() + vr, u.imag() + vi);
+						x[i+k+half] = Complex(u.real() - vr, u.imag() - vi);
+					}
+				}
+			}
+		}
+	private:
+		std::vector<std::size_t> m_bitReverse;
+		std::vector<Complex> m_twiddles;
+	};
+
+	void transformColumns(Complex* data, bool inverse)const{
+		std::vector<Complex> column(m_size1);
+		for(std::size_t j = 0; j != m_size2; ++j){
+			for(std::size_t i = 0; i != m_size1; ++i){
+				column[i] = data[i * m_size2 + j];
+			}
+			m_plan1.transform(&column[0], inverse);
+			for(std::size_t i = 0; i != m_size1; ++i){
+				data[i * m_size2 + j] = column[i];
+			}
+		}
+	}
+
+	std::size_t m_size1;
+	std::size_t m_size2;
+	Plan1D m_plan1;
+	Plan1D m_plan2;
+};
+
+///\brief Stores the size1 x size2 row-major image zero padded in the fft buffer and transforms it.
+inline void fftImage(
+	double const* image, std::size_t size1, std::size_t size2,
+	FFT2D const& fft, std::complex<double>* buffer
+){
+	std::fill(buffer, buffer + fft.size(), std::complex<double>());
+	for(std::size_t i = 0; i != size1; ++i){
+		for(std::size_t j = 0; j != size2; ++j){
+			buffer[i * fft.size2() + j] = image[i * size2 + j];
+		}
+	}
+	fft.forward(buffer, size1);
+}
+
+///\brief Product a*b, or a*conj(b) if conjugate is true, written out for the same reason as in FFT2D.
+inline std::complex<double> complexProduct(std::complex<double> a, std::complex<double> b, bool conjugate){
+	double sign = conjugate? -1.0 : 1.0;
+	return std::complex<double>(
+		a.real() * b.real() - sign * a.imag() * b.imag(),
+		a.imag() * b.real() + sign * a.real() * b.imag()
+	);
+}
+
+///\brief Number of images processed at once by one thread.
+///
+///The patch matrix of a chunk has roughly 2^18 entries so that it stays in the cache, and every thread gets at least one chunk.
+inline std::size_t convolutionChunkSize(ConvolutionShape const& shape, std::size_t batchSize){
+	std::size_t entriesPerImage = shape.numResponses() * std::max(shape.filterElements(),shape.numFilters);
+	std::size_t imagesPerThread = (batchSize + SHARK_NUM_THREADS - 1) / SHARK_NUM_THREADS;
+	return std::max<std::size_t>(1, std::min(imagesPerThread, (std::size_t(1) << 18)/entriesPerImage));
+}
+
+///\brief Copies the patches of the images [start,end) of the batch into the columns of the patch matrix ("im2col").
+///
+///Column i*numResponses+x1*responseSize2+x2 holds the patch of image i at position (x1,x2).
+///Storing the patches as columns makes all products of the GEMM path run over long contiguous rows.
+template<class Matrix>
+void imagePatches(
+	Matrix const& images, std::size_t start, std::size_t end,
+	ConvolutionShape const& shape, RealMatrix& patches
+){
+	std::size_t responseSize1 = shape.responseSize1();
+	std::size_t responseSize2 = shape.responseSize2();
+	std::size_t numResponses = shape.numResponses();
+	patches.resize(shape.filterElements(), (end-start) * numResponses);
+	for(std::size_t i = start; i != end; ++i){
+		std::size_t offset = (i - start) * numResponses;
+		for(std::size_t a = 0; a != shape.filterSize1; ++a){
+			for(std::size_t b = 0; b != shape.filterSize2; ++b){
+				std::size_t element = a * shape.filterSize2 + b;
+				for(std::size_t x1 = 0; x1 != responseSize1; ++x1){
+					std::size_t pixel = (x1 + a) * shape.imageSize2 + b;
+					std::size_t col = offset + x1 * responseSize2;
+					for(std::size_t x2 = 0; x2 != responseSize2; ++x2){
+						patches(element, col + x2) = images(i, pixel + x2);
+					}
+				}
+			}
+		}
+	}
+}
+
+///\brief Copies the responses of the images [start,end) into a matrix with one row per filter.
+template<class Matrix>
+void responseRows(
+	Matrix const& responses, std::size_t start, std::size_t end,
+	ConvolutionShape const& shape, RealMatrix& rows
+){
+	std::size_t numResponses = shape.numResponses();
+	rows.resize(shape.numFilters, (end-start) * numResponses);
+	for(std::size_t i = start; i != end; ++i){
+		for(std::size_t f = 0; f != shape.numFilters; ++f){
+			for(std::size_t r = 0; r != numResponses; ++r){
+				rows(f, (i - start) * numResponses + r) = responses(i, f * numResponses + r);
+			}
+		}
+	}
+}
+
+///\brief Stores the filters as rows of a matrix.
+inline RealMatrix filterMatrix(blas::matrix_set<RealMatrix> const& filters){
+	RealMatrix result(filters.size(), filters.size1() * filters.size2());
+	for(std::size_t f = 0; f != filters.size(); ++f){
+		blas::dense_matrix_adaptor<double> filter = to_matrix(row(result,f), filters.size1(), filters.size2());
+		noalias(filter) = filters[f];
+	}
+	return result;
+}
+
+///\brief Computes the responses of all filters to all images of the batch (valid cross-correlation).
+///
+///@param images batch of images, one per row
+///@param filters the filters
+///@param shape sizes of images and filters
+///@param responses batch of responses, one row per image. Must have the correct size.
+///@param algorithm the algorithm to use
+template<class MatrixV>
+void convolutionResponses(
+	MatrixV const& images, blas::matrix_set<RealMatrix> const& filters,
+	ConvolutionShape const& shape, RealMatrix& responses,
+	ConvolutionAlgorithm algorithm
+){
+	std::size_t batchSize = images.size1();
+	std::size_t numResponses = shape.numResponses();
+	if(algorithm == AutomaticConvolution)
+		algorithm = chooseConvolutionAlgorithm(shape);
+
+	if(algorithm == GemmConvolution){
+		RealMatrix weights = filterMatrix(filters);
+		std::size_t chunkSize = convolutionChunkSize(shape,batchSize);
+		std::size_t numChunks = (batchSize + chunkSize - 1) / chunkSize;
+		SHARK_PARALLEL_FOR(int c = 0; c < (int)numChunks; ++c){
+			std::size_t start = c * chunkSize;
+			std::size_t end = std::min(start + chunkSize, batchSize);
+			RealMatrix patches;
+			imagePatches(images, start, end, shape, patches);
+			RealMatrix result(shape.numFilters, patches.size2());
+			noalias(result) = prod(weights, patches);
+			for(std::size_t i = start; i != end; ++i){
+				for(std::size_t f = 0; f != shape.numFilters; ++f){
+					noalias(subrange(row(responses,i), f * numResponses, (f+1) * numResponses))
+					= subrange(row(result,f), (i - start) * numResponses, (i - start + 1) * numResponses);
+				}
+			}
+		}
+		return;
+	}
+
+	typedef std::complex<double> Complex;
+	FFT2D fft(nextPowerOfTwo(shape.imageSize1), nextPowerOfTwo(shape.imageSize2));
+	std::size_t fftSize = fft.size();
+	std::vector<Complex> filterSpectra(shape.numFilters * fftSize);
+	for(std::size_t f = 0; f != shape.numFilters; ++f){
+		RealMatrix filter = filters[f];
+		fftImage(&filter(0,0), shape.filterSize1, shape.filterSize2, fft, &filterSpectra[f * fftSize]);
+	}
+	std::size_t responseSize1 = shape.responseSize1();
+	std::size_t responseSize2 = shape.responseSize2();
+	double scaling = 1.0/fftSize;
+	SHARK_PARALLEL_FOR(int i = 0; i < (int)batchSize; ++i){
+		RealVector image = row(images,i);
+		std::vector<Complex> imageSpectrum(fftSize);
+		std::vector<Complex> buffer(fftSize);
+		fftImage(&image(0), shape.imageSize1, shape.imageSize2, fft, &imageSpectrum[0]);
+		for(std::size_t f = 0; f != shape.numFilters; ++f){
+			Complex const* filterSpectrum = &filterSpectra[f * fftSize];
+			for(std::size_t k = 0; k != fftSize; ++k){
+				buffer[k] = complexProduct(imageSpectrum[k], filterSpectrum[k], true);
+			}
+			fft.inverse(&buffer[0]);
+			for(std::size_t x1 = 0; x1 != responseSize1; ++x1){
+				for(std::size_t x2 = 0; x2 != responseSize2; ++x2){
+					responses(i, f * numResponses + x1 * responseSize2 + x2) = scaling * buffer[x1 * fft.size2() + x2].real();
+				}
+			}
+		}
+	}
+}
+
+///\brief Computes the images generated by the responses of all filters (full convolution, the transpose of convolutionResponses).
+///
+///@param responses batch of responses, one per row
+///@param filters the filters
+///@param shape sizes of images and filters
+///@param images batch of images, one row per image. Must have the correct size.
+///@param algorithm the algorithm to use
+template<class MatrixH>
+void convolutionImages(
+	MatrixH const& responses, blas::matrix_set<RealMatrix> const& filters,
+	ConvolutionShape const& shape, RealMatrix& images,
+	ConvolutionAlgorithm algorithm
+){
+	std::size_t batchSize = responses.size1();
+	std::size_t numResponses = shape.numResponses();
+	std::size_t responseSize1 = shape.responseSize1();
+	std::size_t responseSize2 = shape.responseSize2();
+	if(algorithm == AutomaticConvolution)
+		algorithm = chooseConvolutionAlgorithm(shape);
+
+	if(algorithm == GemmConvolution){
+		RealMatrix weights = filterMatrix(filters);
+		std::size_t chunkSize = convolutionChunkSize(shape,batchSize);
+		std::size_t numChunks = (batchSize + chunkSize - 1) / chunkSize;
+		SHARK_PARALLEL_FOR(int c = 0; c < (int)numChunks; ++c){
+			std::size_t start = c * chunkSize;
+			std::size_t end = std::min(start + chunkSize, batchSize);
+			RealMatrix rows;
+			responseRows(responses, start, end, shape, rows);
+			RealMatrix patches(shape.filterElements(), rows.size2());
+			noalias(patches) = prod(trans(weights), rows);
+			//add the patches back to the images ("col2im")
+			for(std::size_t i = start; i != end; ++i){
+				row(images,i).clear();
+				std::size_t offset = (i - start) * numResponses;
+				for(std::size_t a = 0; a != shape.filterSize1; ++a){
+					for(std::size_t b = 0; b != shape.filterSize2; ++b){
+						std::size_t element = a * shape.filterSize2 + b;
+						for(std::size_t x1 = 0; x1 != responseSize1; ++x1){
+							std::size_t pixel = (x1 + a) * shape.imageSize2 + b;
+							std::size_t col = offset + x1 * responseSize2;
+							for(std::size_t x2 = 0; x2 != responseSize2; ++x2){
+								images(i, pixel + x2) += patches(element, col + x2);
+							}
+						}
+					}
+				}
+			}
+		}
+		return;
+	}
+
+	typedef std::complex<double> Complex;
+	FFT2D fft(nextPowerOfTwo(shape.imageSize1), nextPowerOfTwo(shape.imageSize2));
+	std::size_t fftSize = fft.size();
+	std::vector<Complex> filterSpectra(shape.numFilters * fftSize);
+	for(std::size_t f = 0; f != shape.numFilters; ++f){
+		RealMatrix filter = filters[f];
+		fftImage(&filter(0,0), shape.filterSize1, shape.filterSize2, fft, &filterSpectra[f * fftSize]);
+	}
+	double scaling = 1.0/fftSize;
+	SHARK_PARALLEL_FOR(int i = 0; i < (int)batchSize; ++i){
+		RealVector response = row(responses,i);
+		std::vector<Complex> imageSpectrum(fftSize);
+		std::vector<Complex> buffer(fftSize);
+		for(std::size_t f = 0; f != shape.numFilters; ++f){
+			fftImage(&response(f * numResponses), responseSize1, responseSize2, fft, &buffer[0]);
+			Complex const* filterSpectrum = &filterSpectra[f * fftSize];
+			for(std::size_t k = 0; k != fftSize; ++k){
+				imageSpectrum[k] += complexProduct(buffer[k], filterSpectrum[k], false);
+			}
+		}
+		fft.inverse(&imageSpectrum[0]);
+		for(std::size_t x1 = 0; x1 != shape.imageSize1; ++x1){
+			for(std::size_t x2 = 0; x2 != shape.imageSize2; ++x2){
+				images(i, x1 * shape.imageSize2 + x2) = scaling * imageSpectrum[x1 * fft.size2() + x2].real();
+			}
+		}
+	}
+}
+
+///\brief Adds the derivative of sum_i <responses_i, convolutionResponses(images_i)> with respect to the filters to gradient.
+///
+///@param responses batch of (weighted) responses, one per row
+///@param images batch of images, one per row
+///@param shape sizes of images and filters
+///@param gradient the gradient of the filters the result is added to
+///@param algorithm the algorithm to use
+template<class MatrixH, class MatrixV>
+void convolutionFilterGradient(
+	MatrixH const& responses, MatrixV const& images,
+	ConvolutionShape const& shape, blas::matrix_set<RealMatrix>& gradient,
+	ConvolutionAlgorithm algorithm
+){
+	std::size_t batchSize = responses.size1();
+	std::size_t numResponses = shape.numResponses();
+	if(algorithm == AutomaticConvolution)
+		algorithm = chooseConvolutionAlgorithm(shape);
+
+	RealMatrix weightGradient(shape.numFilters, shape.filterElements(),0.0);
+	if(algorithm == GemmConvolution){
+		std::size_t chunkSize = convolutionChunkSize(shape,batchSize);
+		std::size_t numChunks = (batchSize + chunkSize - 1) / chunkSize;
+		//the chunks are dealt out to the threads in turn, every thread sums its own gradient
+		//and the gradients are merged in a fixed order, so the result does not depend on the scheduling
+		std::size_t numThreads = std::min<std::size_t>(SHARK_NUM_THREADS, numChunks);
+		std::vector<RealMatrix> threadGradients(numThreads, weightGradient);
+		SHARK_PARALLEL_FOR(int t = 0; t < (int)numThreads; ++t){
+			RealMatrix rows;
+			RealMatrix patches;
+			for(std::size_t c = t; c < numChunks; c += numThreads){
+				std::size_t start = c * chunkSize;
+				std::size_t end = std::min(start + chunkSize, batchSize);
+				responseRows(responses, start, end, shape, rows);
+				imagePatches(images, start, end, shape, patches);
+				axpy_prod(rows, trans(patches), threadGradients[t], false);
+			}
+		}
+		for(std::size_t t = 0; t != numThreads; ++t){
+			noalias(weightGradient) += threadGradients[t];
+		}
+	}else{
+		//sum the spectra of the gradients over the batch and transform back once per filter
+		typedef std::complex<double> Complex;
+		FFT2D fft(nextPowerOfTwo(shape.imageSize1), nextPowerOfTwo(shape.imageSize2));
+		std::size_t fftSize = fft.size();
+		std::size_t responseSize1 = shape.responseSize1();
+		std::size_t responseSize2 = shape.responseSize2();
+		std::size_t numThreads = std::min<std::size_t>(SHARK_NUM_THREADS, batchSize);
+		std::vector<std::vector<Complex> > spectraOfThreads(numThreads, std::vector<Complex>(shape.numFilters * fftSize));
+		SHARK_PARALLEL_FOR(int t = 0; t < (int)numThreads; ++t){
+			std::vector<Complex>& threadSpectra = spectraOfThreads[t];
+			std::vector<Complex> imageSpectrum(fftSize);
+			std::vector<Complex> buffer(fftSize);
+			for(std::size_t i = t; i < batchSize; i += numThreads){
+				RealVector image = row(images,i);
+				RealVector response = row(responses,i);
+				fftImage(&image(0), shape.imageSize1, shape.imageSize2, fft, &imageSpectrum[0]);
+				for(std::size_t f = 0; f != shape.numFilters; ++f){
+					fftImage(&response(f * numResponses), responseSize1, responseSize2, fft, &buffer[0]);
+					Complex* spectrum = &threadSpectra[f * fftSize];
+					for(std::size_t k = 0; k != fftSize; ++k){
+						spectrum[k] += complexProduct(imageSpectrum[k], buffer[k], true);
+					}
+				}
+			}
+		}
+		//merge the spectra of the threads in a fixed order
+		std::vector<Complex>& gradientSpectra = spectraOfThreads[0];
+		for(std::size_t t = 1; t != numThreads; ++t){
+			for(std::size_t k = 0; k != gradientSpectra.size(); ++k){
+				gradientSpectra[k] += spectraOfThreads[t][k];
+			}
+		}
+		double scaling = 1.0/fftSize;
+		for(std::size_t f = 0; f != shape.numFilters; ++f){
+			Complex* spectrum = &gradientSpectra[f * fftSize];
+			fft.inverse(spectrum);
+			for(std::size_t a = 0; a != shape.filterSize1; ++a){
+				for(std::size_t b = 0; b != shape.filterSize2; ++b){
+					weightGradient(f, a * shape.filterSize2 + b) = scaling * spectrum[a * fft.size2() + b].real();
+				}
+			}
+		}
+	}
+	for(std::size_t f = 0; f != shape.numFilters; ++f){
+		noalias(gradient[f]) += to_matrix(row(weightGradient,f), shape.filterSize1, shape.filterSize2);
+	}
+}
+
+}}
+#endif
@@ -3,6 +3,7 @@
 
 #include <shark/LinAlg/Base.h>
 #include <shark/LinAlg/BLAS/matrix_set.hpp>
+#include <shark/Unsupervised/RBM/Impl/Convolution.h>
 namespace shark{
 namespace detail{
 ///\brief The gradient of the energy averaged over a set of cumulative added samples.
@@ -111,9 +112,12 @@ public:
 		
 		//now add the new gradient with its corrected weight
 		double weight = std::exp(gradient.m_logWeightSum-m_logWeightSum);
-		noalias(m_deltaWeights) += weight * gradient.m_deltaWeights;
+		for(std::size_t f = 0; f != m_deltaWeights.size(); ++f){
+			noalias(m_deltaWeights[f]) += weight * gradient.m_deltaWeights[f];
+		}
 		noalias(m_deltaBiasVisible) += weight * gradient.m_deltaBiasVisible;
 		noalias(m_deltaBiasHidden) += weight * gradient.m_deltaBiasHidden;
+		return *this;
 	}
 	
 	///\brief Calculates the expectation of the energy gradient with respect to p(h|v) for a complete Batch.
@@ -172,27 +176,10 @@ private:
 
 	template<class MatrixH, class MatrixV>
 	void updateConnectionDerivative(MatrixH const& hiddens, MatrixV const& visibles){
-		
-		std::size_t numFilters = mpe_rbm->numFilters();
-		std::size_t responseSize1 = mpe_rbm->responseSize1();
-		std::size_t responseSize2 = mpe_rbm->responseSize2();
-		for(std::size_t i = 0; i != hiddens.size1();++i){
-			blas::dense_matrix_adaptor<double const> visible = 
-				to_matrix(row(visibles,i),mpe_rbm->inputSize1(),mpe_rbm->inputSize2());
-			blas::dense_matrix_adaptor<double const> hidden = 
-				to_matrix(row(hiddens,i),numFilters*responseSize1,responseSize2);
-			
-			for (std::size_t x1=0; x1 != responseSize1; ++x1) {
-				for(std::size_t x2=0; x2 != responseSize2; ++x2) {
-					std::size_t end1 = x1+mpe_rbm->filterSize1();
-					std::size_t end2 = x2+mpe_rbm->filterSize2();
-					for(std::size_t f = 0; f != numFilters;++f){
-						double val = hidden(f*responseSize1+x1,x2);
-						noalias(m_deltaWeights[f]) += subrange(visible,x1,end1,x2,end2)*val;
-					}
-				}
-			}
-		}
+		detail::convolutionFilterGradient(
+			hiddens,visibles,mpe_rbm->convolutionShape(),
+			m_deltaWeights,mpe_rbm->convolutionAlgorithm()
+		);
 	}
 	
 	template<class WeightVector>
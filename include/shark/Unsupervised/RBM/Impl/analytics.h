@@ -39,6 +39,7 @@
 
 #include <boost/static_assert.hpp>
 #include <boost/range/numeric.hpp>
+#include <vector>
 namespace shark {
 namespace detail{
 	
@@ -253,12 +254,117 @@ namespace detail{
 		return logZn + softPlus(-diff);
 	}
 
+	/// \brief Enumerates the states of a layer with two states per neuron in Gray code order.
+	///
+	/// Two consecutive states in Gray code order differ only in the state of one neuron.
+	/// As the input of the connected layer is linear in the state, it can be updated by adding
+	/// or subtracting the input caused by flipping this neuron. For n neurons in the enumerated
+	/// layer and m neurons in the connected layer this costs O(m) per state instead of O(nm).
+	/// The states are enumerated in batches and the input is computed from scratch at the start of every batch,
+	/// so rounding errors do not accumulate. As enumerate is const, several threads can enumerate different batches at the same time.
+	template<class Enumeration>
+	class GrayCodeEnumeration{
+	public:
+		/// \brief Returns the states needed to construct the enumeration.
+		///
+		/// The first row holds the state with all neurons in their first state,
+		/// row i+1 the state where only neuron i is in its second state.
+		static RealMatrix basisStates(std::size_t numberOfNeurons){
+			RealMatrix basis(numberOfNeurons+1,numberOfNeurons);
+			Enumeration::state(row(basis,0),0);
+			for(std::size_t i = 0; i != numberOfNeurons; ++i){
+				Enumeration::state(row(basis,i+1),std::size_t(1) << i);
+			}
+			return basis;
+		}
+		
+		/// \brief Constructs the enumeration from the basis states and the inputs of the connected layer given these states.
+		GrayCodeEnumeration(RealMatrix const& basis, RealMatrix const& basisInputs)
+		: m_firstState(row(basis,0))
+		, m_secondState(basis.size2())
+		, m_firstInput(row(basisInputs,0))
+		, m_flipInputs(basis.size2(),basisInputs.size2()){
+			SIZE_CHECK(basis.size1() == basis.size2()+1);
+			SIZE_CHECK(basisInputs.size1() == basis.size1());
+			for(std::size_t i = 0; i != basis.size2(); ++i){
+				m_secondState(i) = basis(i+1,i);
+				noalias(row(m_flipInputs,i)) = row(basisInputs,i+1) - m_firstInput;
+			}
+		}
+		
+		/// \brief Stores the states start,...,start+states.size1()-1 of the enumeration and the inputs of the connected layer.
+		void enumerate(std::size_t start, RealMatrix& states, RealMatrix& inputs)const{
+			SIZE_CHECK(states.size1() == inputs.size1());
+			SIZE_CHECK(states.size2() == m_firstState.size());
+			SIZE_CHECK(inputs.size2() == m_firstInput.size());
+			
+			//compute the first state and its input from scratch
+			RealVector state = m_firstState;
+			RealVector input = m_firstInput;
+			std::size_t code = grayCode(start);
+			for(std::size_t i = 0; i != state.size(); ++i){
+				if(code & (std::size_t(1) << i)){
+					state(i) = m_secondState(i);
+					noalias(input) += row(m_flipInputs,i);
+				}
+			}
+			
+			for(std::size_t elem = 0; elem != states.size1(); ++elem){
+				if(elem != 0){
+					//the elem-th state differs from the previous one in only one neuron
+					std::size_t position = start+elem;
+					std::size_t neuron = flippedNeuron(position);
+					if(grayCode(position) & (std::size_t(1) << neuron)){
+						state(neuron) = m_secondState(neuron);
+						noalias(input) += row(m_flipInputs,neuron);
+					}else{
+						state(neuron) = m_firstState(neuron);
+						noalias(input) -= row(m_flipInputs,neuron);
+					}
+				}
+				noalias(row(states,elem)) = state;
+				noalias(row(inputs,elem)) = input;
+			}
+		}
+	private:
+		RealVector m_firstState;//state of all neurons being in their first state
+		RealVector m_secondState;//value of every neuron in its second state
+		RealVector m_firstInput;//input of the connected layer given m_firstState
+		RealMatrix m_flipInputs;//row i holds the change of the input when neuron i changes to its second state
+		
+		static std::size_t grayCode(std::size_t position){
+			return position ^ (position >> 1);
+		}
+		
+		//the neuron flipped between position-1 and position is the lowest set bit of position
+		static std::size_t flippedNeuron(std::size_t position){
+			std::size_t neuron = 0;
+			for(; !(position & 1); position >>= 1){
+				++neuron;
+			}
+			return neuron;
+		}
+	};
+	
+	///\brief Combines the log partitions computed by different threads.
+	inline double combineLogPartitions(std::vector<double> const& logPartitions){
+		double logZ = -std::numeric_limits<double>::infinity();
+		for(std::size_t i = 0; i != logPartitions.size(); ++i){
+			if(logPartitions[i] != -std::numeric_limits<double>::infinity())
+				logZ = updateLogPartition(logZ,-logPartitions[i]);
+		}
+		return logZ;
+	}
+
 	/// \brief Estimates the partition function with factorization over the hidden variables. 
 	///
 	/// Instead of summing over the unnormalized joint probability of all states of hidden and visible variables 
 	/// this function sums over the unnormalized marginal probability of all states of the visible variables,
 	/// which is calculated via factorization over the hidden variables. 
 	///
+	/// The states are enumerated in Gray code order, updating the input of the hidden neurons incrementally.
+	/// The batches of states are distributed over all threads and every thread accumulates its own part of the log partition.
+	///
 	/// Enumeration is the state space of the hidden variables.
 	///
 	/// @param rbm the RBM
@@ -268,31 +374,34 @@ namespace detail{
 	double logPartitionFunctionImplFactHidden(const RBMType& rbm, Enumeration, double beta){
 		std::size_t values = Enumeration::numberOfStates(rbm.numberOfVN());
 		std::size_t batchSize = std::min(values, std::size_t(500));
+		std::size_t numBatches = (values+batchSize-1)/batchSize;
+		
+		RealMatrix basis = GrayCodeEnumeration<Enumeration>::basisStates(rbm.numberOfVN());
+		RealMatrix basisInputs(basis.size1(),rbm.numberOfHN());
+		rbm.energy().inputHidden(basisInputs,basis);
+		GrayCodeEnumeration<Enumeration> enumeration(basis,basisInputs);
 		
 		//over all possible values of the visible neurons
-		double logZ = -std::numeric_limits<double>::infinity();
-		SHARK_PARALLEL_FOR (std::size_t x = 0; x < values; x+=batchSize) {
-			std::size_t currentBatchSize=std::min<std::size_t>(batchSize,values-x);
+		std::vector<double> threadLogZ(SHARK_NUM_THREADS,-std::numeric_limits<double>::infinity());
+		SHARK_PARALLEL_FOR (std::size_t b = 0; b < numBatches; ++b) {
+			std::size_t start = b*batchSize;
+			std::size_t currentBatchSize=std::min<std::size_t>(batchSize,values-start);
 			RealMatrix stateMatrix(currentBatchSize,rbm.numberOfVN());
-			
-			for(long long elem = 0; elem != currentBatchSize;++elem){
-				//generation of the x+elem-th state vector
-				Enumeration::state(row(stateMatrix,elem),x+elem);
-			}
+			RealMatrix inputMatrix(currentBatchSize,rbm.numberOfHN());
+			enumeration.enumerate(start,stateMatrix,inputMatrix);
 			
 			RealVector p =rbm.energy().logUnnormalizedProbabilityVisible(
-				stateMatrix, blas::repeat(beta,currentBatchSize)
+				stateMatrix, inputMatrix, blas::repeat(beta,currentBatchSize)
 			);
 	
-			//accumulate changes to the log partition
-			SHARK_CRITICAL_REGION{
-				logZ = boost::accumulate(
-					-p,
-					logZ,updateLogPartition
-				);
-			}
+			//accumulate changes to the log partition of this thread
+			double& logZ = threadLogZ[SHARK_THREAD_NUM];
+			logZ = boost::accumulate(
+				-p,
+				logZ,updateLogPartition
+			);
 		}
-		return logZ;
+		return combineLogPartitions(threadLogZ);
 	}
 	
 	
@@ -302,6 +411,9 @@ namespace detail{
 	/// this function sums over the unnormalized marginal probability of all states of the hidden variables,
 	/// which is calculated via factorization over the visible variables. 
 	///
+	/// The states are enumerated in Gray code order, updating the input of the visible neurons incrementally.
+	/// The batches of states are distributed over all threads and every thread accumulates its own part of the log partition.
+	///
 	/// Enumeration is the state space of the hidden variables.
 	///
 	/// @param rbm the RBM
@@ -312,31 +424,34 @@ namespace detail{
 	double logPartitionFunctionImplFactVisible(const RBMType& rbm, Enumeration, double beta){		
 		std::size_t values = Enumeration::numberOfStates(rbm.numberOfHN());
 		std::size_t batchSize=std::min(values,std::size_t(500));
-		//over all possible values of the visible neurons
-		double logZ = -std::numeric_limits<double>::infinity();
-		SHARK_PARALLEL_FOR(std::size_t x = 0;x <  values; x+=batchSize) {
-			std::size_t currentBatchSize=std::min<std::size_t>(batchSize,values-x);
+		std::size_t numBatches = (values+batchSize-1)/batchSize;
+		
+		RealMatrix basis = GrayCodeEnumeration<Enumeration>::basisStates(rbm.numberOfHN());
+		RealMatrix basisInputs(basis.size1(),rbm.numberOfVN());
+		rbm.energy().inputVisible(basisInputs,basis);
+		GrayCodeEnumeration<Enumeration> enumeration(basis,basisInputs);
+		
+		//over all possible values of the hidden neurons
+		std::vector<double> threadLogZ(SHARK_NUM_THREADS,-std::numeric_limits<double>::infinity());
+		SHARK_PARALLEL_FOR(std::size_t b = 0; b < numBatches; ++b) {
+			std::size_t start = b*batchSize;
+			std::size_t currentBatchSize=std::min<std::size_t>(batchSize,values-start);
 			RealMatrix stateMatrix(currentBatchSize,rbm.numberOfHN());
-			
-			
-			for(std::size_t elem = 0; elem != currentBatchSize; ++elem){
-				//generation of the x-th state vector
-				Enumeration::state(row(stateMatrix,elem),x+elem);
-			}
+			RealMatrix inputMatrix(currentBatchSize,rbm.numberOfVN());
+			enumeration.enumerate(start,stateMatrix,inputMatrix);
 			
 			RealVector p=rbm.energy().logUnnormalizedProbabilityHidden(
-				stateMatrix, blas::repeat(beta,currentBatchSize)
+				stateMatrix, inputMatrix, blas::repeat(beta,currentBatchSize)
 			);
 			
-			//accumulate changes to the log partition
-			SHARK_CRITICAL_REGION{
-				logZ = boost::accumulate(
-					-p,
-					logZ,updateLogPartition
-				);
-			}
+			//accumulate changes to the log partition of this thread
+			double& logZ = threadLogZ[SHARK_THREAD_NUM];
+			logZ = boost::accumulate(
+				-p,
+				logZ,updateLogPartition
+			);
 		}
-		return logZ;
+		return combineLogPartitions(threadLogZ);
 	}
 	
 	//===========Warning=========
@@ -36,6 +36,9 @@ namespace shark{
 	
 
 ///\brief Implements parallel tempering but also stores additional statistics on the energy differences
+///
+///The chain is advanced using a TemperedMarkovChain and thus also runs the temperatures in parallel
+///and supports the adaptation of the temperatures.
 template<class Operator>
 class EnergyStoringTemperedMarkovChain{
 private:
@@ -115,6 +118,29 @@ public:
 		return m_chain.beta();
 	}
 	
+	/// \brief Returns the rate with which the temperatures are adapted.
+	double temperatureAdaptation()const{
+		return m_chain.temperatureAdaptation();
+	}
+	
+	/// \brief Sets the rate with which the temperatures are adapted to achieve uniform acceptance rates of swaps.
+	///
+	/// See TemperedMarkovChain::setTemperatureAdaptation. The stored energy differences are only meaningful
+	/// for a fixed set of temperatures, so the adaptation should be turned off before they are collected.
+	void setTemperatureAdaptation(double rate){
+		m_chain.setTemperatureAdaptation(rate);
+	}
+	
+	/// \brief Returns the mean acceptance probability of swaps between temperatures i and i+1 since the last reset.
+	RealVector swapAcceptanceRates()const{
+		return m_chain.swapAcceptanceRates();
+	}
+	
+	/// \brief Resets the statistics of the swap acceptance rates.
+	void resetSwapAcceptanceRates(){
+		m_chain.resetSwapAcceptanceRates();
+	}
+	
 	///\brief Returns the current state of the chain for beta = 1.
 	const_reference sample()const{
 		return m_chain.sample();
@@ -144,7 +170,13 @@ public:
 	}
 	//updates the chain using the current sample
 	void step(unsigned int k){
-		m_chain.step(k);
+		step(k, transitionOperator().rbm()->rng());
+	}
+	
+	//updates the chain using the current sample and the given random number generator
+	template<class Rng>
+	void step(unsigned int k, Rng& rng){
+		m_chain.step(k,rng);
 		
 		if(!storeEnergyDifferences()) return;
 		
@@ -121,15 +121,27 @@ public:
 
 	///\brief Samples a new batch of states of the hidden units using their precomputed statistics.
 	void sampleHidden(HiddenSampleBatch& sampleBatch)const{
+		sampleHidden(sampleBatch, mpe_rbm->rng());
+	}
+	
+	///\brief Samples a new batch of states of the hidden units using the given random number generator.
+	template<class Rng>
+	void sampleHidden(HiddenSampleBatch& sampleBatch, Rng& rng)const{
 		//sample state of the hidden neurons, input and statistics was allready computed by precompute
-		mpe_rbm->hiddenNeurons().sample(sampleBatch.statistics, sampleBatch.state, m_alphaHidden, mpe_rbm->rng());
+		mpe_rbm->hiddenNeurons().sample(sampleBatch.statistics, sampleBatch.state, m_alphaHidden, rng);
 	}
 
 
 	///\brief Samples a new batch of states of the visible units using their precomputed statistics.
 	void sampleVisible(VisibleSampleBatch& sampleBatch)const{
+		sampleVisible(sampleBatch, mpe_rbm->rng());
+	}
+	
+	///\brief Samples a new batch of states of the visible units using the given random number generator.
+	template<class Rng>
+	void sampleVisible(VisibleSampleBatch& sampleBatch, Rng& rng)const{
 		//sample state of the visible neurons, input and statistics was allready computed by precompute
-		mpe_rbm->visibleNeurons().sample(sampleBatch.statistics, sampleBatch.state, m_alphaVisible, mpe_rbm->rng());
+		mpe_rbm->visibleNeurons().sample(sampleBatch.statistics, sampleBatch.state, m_alphaVisible, rng);
 	}
 	
 	/// \brief Applies the Gibbs operator a number of times to a given sample.
@@ -138,11 +150,23 @@ public:
 	/// That is, Given a State (v,h), computes p(v|h),draws v and then computes p(h|v) and draws h . this is repeated several times
 	template<class BetaVector>
 	void stepVH(HiddenSampleBatch& hiddenBatch, VisibleSampleBatch& visibleBatch, std::size_t numberOfSteps, BetaVector const& beta){
+		stepVH(hiddenBatch, visibleBatch, numberOfSteps, beta, mpe_rbm->rng());
+	}
+	
+	/// \brief Applies the Gibbs operator a number of times to a given sample using the given random number generator.
+	///
+	/// As the operator itself is not changed, several threads can advance different samples at the same time
+	/// as long as every thread uses its own random number generator.
+	template<class BetaVector, class Rng>
+	void stepVH(
+		HiddenSampleBatch& hiddenBatch, VisibleSampleBatch& visibleBatch,
+		std::size_t numberOfSteps, BetaVector const& beta, Rng& rng
+	)const{
 		for(unsigned int i=0; i != numberOfSteps; i++){
 			precomputeVisible(hiddenBatch,visibleBatch,beta);
-			sampleVisible(visibleBatch);
+			sampleVisible(visibleBatch,rng);
 			precomputeHidden(hiddenBatch, visibleBatch,beta);
-			sampleHidden(hiddenBatch);
+			sampleHidden(hiddenBatch,rng);
 		}
 	}
 
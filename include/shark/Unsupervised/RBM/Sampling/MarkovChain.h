@@ -105,7 +105,17 @@ public:
 	/// 
  	/// @param numberOfSteps the number of steps
 	void step(unsigned int numberOfSteps){
-		m_operator.stepVH(m_samples.hidden,m_samples.visible,numberOfSteps,blas::repeat(1.0,batchSize()));
+		step(numberOfSteps, m_operator.rbm()->rng());
+	}
+	
+	/// \brief Runs the chain for a given number of steps using the given random number generator.
+	/// 
+	/// Different chains sharing the same RBM can be run in parallel if every chain uses its own generator.
+ 	/// @param numberOfSteps the number of steps
+ 	/// @param rng the random number generator used for sampling
+	template<class Rng>
+	void step(unsigned int numberOfSteps, Rng& rng){
+		m_operator.stepVH(m_samples.hidden,m_samples.visible,numberOfSteps,blas::repeat(1.0,batchSize()),rng);
 	}
 	
 	/// \brief Returns the current sample of the Markov chain. 
@@ -30,6 +30,7 @@
 #ifndef SHARK_UNSUPERVISED_RBM_SAMPLING_TEMPEREDMARKOVCHAIN_H
 #define SHARK_UNSUPERVISED_RBM_SAMPLING_TEMPEREDMARKOVCHAIN_H
 
+#include <shark/Core/OpenMP.h>
 #include <shark/Data/Dataset.h>
 #include <shark/Rng/DiscreteUniform.h>
 #include <shark/Unsupervised/RBM/Tags.h>
@@ -41,6 +42,15 @@ namespace shark{
 //\brief models a set of tempered Markov chains given a TransitionOperator.
 // e.g.  TemperedMarkovChain<GibbsOperator<RBM> > chain, leads to the set of chains
 // used for parallel tempering. 
+//
+// When several threads are available, the temperatures are split into contiguous blocks, one per thread.
+// The Gibbs steps of the blocks are done in parallel, each block using its own random number generator
+// seeded from the generator passed to step. The swaps between neighbouring temperatures are proposed in parallel as well:
+// in the even and odd phase every pair of temperatures is disjoint from all others so no locking is needed.
+// For a fixed seed and number of threads the chain is reproducible.
+//
+// Optionally the temperature ladder can be adapted so that the acceptance rates of swaps between all
+// neighbouring temperatures become equal, see setTemperatureAdaptation.
 template<class Operator>
 class TemperedMarkovChain{
 private:
@@ -71,7 +81,14 @@ private:
 	RealVector m_betas;
 	Operator m_operator;
 	
-	void metropolisSwap(reference low, double betaLow, reference high, double betaHigh){
+	RealVector m_swapProbabilities;//acceptance probabilities of the last swap proposals
+	RealVector m_acceptanceSum;//sum of acceptance probabilities of all swap proposals since the last reset
+	std::size_t m_numberOfSwapProposals;
+	double m_adaptationRate;
+	
+	///\brief Proposes to swap the samples of two neighbouring temperatures and returns the acceptance probability.
+	template<class Rng>
+	double metropolisSwap(reference low, double betaLow, reference high, double betaHigh, Rng& rng)const{
 		RealVector const& baseRate = transitionOperator().rbm()->visibleNeurons().baseRate();
 		double betaDiff = betaLow - betaHigh;
 		double energyDiff = low.energy - high.energy; 
@@ -79,15 +96,71 @@ private:
 		double r = betaDiff * energyDiff + betaDiff*baseRateDiff;
 		
 		
-		Uniform<typename RBM::RngType> uni(m_operator.rbm()->rng(),0,1);
+		Uniform<Rng> uni(rng,0,1);
 		double z = uni();
 		if( r >= 0 || (z > 0 && std::log(z) < r) ){
 			swap(high,low);
 		}
+		return r >= 0? 1.0 : std::exp(r);
+	}
+	
+	///\brief Does one Gibbs step and computes the energies of the temperatures in [start,end).
+	template<class Rng>
+	void blockStep(std::size_t start, std::size_t end, Rng& rng){
+		std::size_t visibles=m_operator.rbm()->numberOfVN();
+		std::size_t hiddens=m_operator.rbm()->numberOfHN();
+		SampleBatch block(end-start,visibles,hiddens);
+		for(std::size_t i = start; i != end; ++i){
+			get(block,i-start) = get(m_temperedChains,i);
+		}
+		RealVector betas = subrange(m_betas,start,end);
+		m_operator.stepVH(block.hidden, block.visible,1,betas,rng);
+		block.energy = m_operator.calculateEnergy(block.hidden, block.visible);
+		for(std::size_t i = start; i != end; ++i){
+			get(m_temperedChains,i) = get(block,i-start);
+		}
+	}
+	
+	///\brief Proposes swaps between the temperatures i and i+1 for i = first, first+2,... using the given block generators.
+	template<class Rng>
+	void swapPhase(std::size_t first, std::vector<Rng>& rngs){
+		std::size_t elems = m_temperedChains.size();
+		std::size_t numBlocks = rngs.size();
+		SHARK_PARALLEL_FOR(int b = 0; b < (int)numBlocks; ++b){
+			//pairs are assigned to the block of their lower temperature
+			std::size_t start = b * elems / numBlocks;
+			std::size_t end = std::min((b+1) * elems / numBlocks, elems-1);
+			if(start % 2 != first % 2)
+				++start;
+			for(std::size_t i = start; i < end; i+=2){
+				m_swapProbabilities(i) = metropolisSwap(
+					reference(m_temperedChains,i),m_betas(i),
+					reference(m_temperedChains,i+1),m_betas(i+1),rngs[b]
+				);
+			}
+		}
+	}
+	
+	///\brief Changes the distances of the inverse temperatures based on the acceptance probabilities of the last swaps.
+	///
+	/// The distance between neighbouring inverse temperatures is increased when the acceptance probability is above average
+	/// and decreased otherwise. The highest and lowest inverse temperatures stay fixed.
+	void adaptTemperatures(){
+		std::size_t pairs = m_swapProbabilities.size();
+		double meanProbability = sum(m_swapProbabilities)/pairs;
+		RealVector distances(pairs);
+		for(std::size_t i = 0; i != pairs; ++i){
+			distances(i) = (m_betas(i) - m_betas(i+1)) * std::exp(m_adaptationRate * (m_swapProbabilities(i) - meanProbability));
+		}
+		double range = m_betas(0) - m_betas(pairs);
+		distances *= range/sum(distances);
+		for(std::size_t i = 1; i != pairs; ++i){
+			m_betas(i) = m_betas(i-1) - distances(i-1);
+		}
 	}
 
 public:
-	TemperedMarkovChain(RBM* rbm):m_operator(rbm){}
+	TemperedMarkovChain(RBM* rbm):m_operator(rbm),m_numberOfSwapProposals(0),m_adaptationRate(0){}
 	
 	const Operator& transitionOperator()const{
 		return m_operator;
@@ -105,6 +178,8 @@ public:
 		std::size_t hiddens=m_operator.rbm()->numberOfHN();
 		m_temperedChains = SampleBatch(temperatures,visibles,hiddens);
 		m_betas.resize(temperatures);
+		m_swapProbabilities = RealVector(temperatures > 0? temperatures - 1: 0, 0.0);
+		resetSwapAcceptanceRates();
 	}
 	
 	/// \brief Sets the number of temperatures and initializes them in a uniform spacing
@@ -146,6 +221,37 @@ public:
 		return m_betas;
 	}
 	
+	/// \brief Returns the rate with which the temperatures are adapted.
+	double temperatureAdaptation()const{
+		return m_adaptationRate;
+	}
+	
+	/// \brief Sets the rate with which the temperatures are adapted to achieve uniform acceptance rates of swaps.
+	///
+	/// After every step the distance between two neighbouring inverse temperatures is multiplied with 
+	/// \f$ \exp(\gamma (p_i - \bar p)) \f$, where \f$ p_i \f$ is the acceptance probability of the last swap
+	/// between the two temperatures and \f$ \bar p \f$ the mean over all pairs. Afterwards
+	/// the distances are rescaled so that the highest and lowest inverse temperatures stay fixed.
+	/// Changing the temperatures violates the Markov property of the chain. Thus the adaptation should be used
+	/// during burn-in or with a small rate. A rate of 0 (default) turns the adaptation off.
+	void setTemperatureAdaptation(double rate){
+		SHARK_CHECK(rate >= 0, "[TemperedMarkovChain::setTemperatureAdaptation] rate must be non-negative");
+		m_adaptationRate = rate;
+	}
+	
+	/// \brief Returns the mean acceptance probability of swaps between temperatures i and i+1 since the last reset.
+	RealVector swapAcceptanceRates()const{
+		if(m_numberOfSwapProposals == 0)
+			return RealVector(m_acceptanceSum.size(),0.0);
+		return m_acceptanceSum / double(m_numberOfSwapProposals);
+	}
+	
+	/// \brief Resets the statistics of the swap acceptance rates.
+	void resetSwapAcceptanceRates(){
+		m_acceptanceSum = RealVector(m_swapProbabilities.size(),0.0);
+		m_numberOfSwapProposals = 0;
+	}
+	
 	///\brief Returns the current state of the chain for beta = 1.
 	const_reference sample()const{
 		return const_reference(m_temperedChains,0);
@@ -194,30 +300,56 @@ public:
 	}
 	//updates the chain using the current sample
 	void step(unsigned int k){
+		step(k, m_operator.rbm()->rng());
+	}
+	
+	//updates the chain using the current sample and the given random number generator
+	template<class Rng>
+	void step(unsigned int k, Rng& rng){
+		std::size_t elems = m_temperedChains.size();
+		std::size_t numBlocks = std::min<std::size_t>(SHARK_NUM_THREADS,elems);
 		for(std::size_t i = 0; i != k; ++i){
-			//do one step of the tempered the Markov chains at the same time
-			m_operator.stepVH(m_temperedChains.hidden, m_temperedChains.visible,1,m_betas);
-			
-			//calculate energy for samples at all temperatures
-			m_temperedChains.energy = m_operator.calculateEnergy(
-				m_temperedChains.hidden,
-				m_temperedChains.visible 
-			);
-
-			//EVEN phase
-			std::size_t elems = m_temperedChains.size();
-			for(std::size_t i = 0; i < elems-1; i+=2){
-				metropolisSwap(
-					reference(m_temperedChains,i),m_betas(i),
-					reference(m_temperedChains,i+1),m_betas(i+1)
+			if(numBlocks <= 1){
+				//do one step of the tempered the Markov chains at the same time
+				m_operator.stepVH(m_temperedChains.hidden, m_temperedChains.visible,1,m_betas,rng);
+				
+				//calculate energy for samples at all temperatures
+				m_temperedChains.energy = m_operator.calculateEnergy(
+					m_temperedChains.hidden,
+					m_temperedChains.visible 
 				);
+
+				//EVEN phase
+				for(std::size_t i = 0; i < elems-1; i+=2){
+					m_swapProbabilities(i) = metropolisSwap(
+						reference(m_temperedChains,i),m_betas(i),
+						reference(m_temperedChains,i+1),m_betas(i+1),rng
+					);
+				}
+				//ODD phase
+				for(std::size_t i = 1; i < elems-1; i+=2){
+					m_swapProbabilities(i) = metropolisSwap(
+						reference(m_temperedChains,i),m_betas(i),
+						reference(m_temperedChains,i+1),m_betas(i+1),rng
+					);
+				}
 			}
-			//ODD phase
-			for(std::size_t i = 1; i < elems-1; i+=2){
-				metropolisSwap(
-					reference(m_temperedChains,i),m_betas(i),
-					reference(m_temperedChains,i+1),m_betas(i+1)
-				);
+			else{
+				//every block of temperatures gets its own generator
+				std::vector<Rng> rngs(numBlocks);
+				for(std::size_t b = 0; b != numBlocks; ++b){
+					rngs[b].seed(rng());
+				}
+				SHARK_PARALLEL_FOR(int b = 0; b < (int)numBlocks; ++b){
+					blockStep(b * elems / numBlocks, (b+1) * elems / numBlocks, rngs[b]);
+				}
+				swapPhase(0,rngs);//EVEN phase
+				swapPhase(1,rngs);//ODD phase
+			}
+			m_acceptanceSum += m_swapProbabilities;
+			++m_numberOfSwapProposals;
+			if(m_adaptationRate > 0 && elems > 2){
+				adaptTemperatures();
 			}
 			m_operator.rbm()->hiddenNeurons().sufficientStatistics(
 				m_temperedChains.hidden.input,m_temperedChains.hidden.statistics, m_betas
@@ -99,7 +99,9 @@ CMA::CMA()
 , m_dSigma( 0 )
 , m_muEff( 0 )
 , m_lowerBound( 1E-20)
-, m_counter( 0 ) {
+, m_counter( 0 )
+, m_eigenUpdateInterval( 0 )
+, m_lastEigenUpdate( 0 ) {
 	m_features |= REQUIRES_VALUE;
 }
 
@@ -128,6 +130,8 @@ void CMA::read( InArchive & archive ) {
 	archive >> m_mutationDistribution;
 
 	archive >> m_counter;
+	archive >> m_eigenUpdateInterval;
+	archive >> m_lastEigenUpdate;
 }
 
 void CMA::write( OutArchive & archive ) const {
@@ -156,6 +160,8 @@ void CMA::write( OutArchive & archive ) const {
 	archive << m_mutationDistribution;
 
 	archive << m_counter;
+	archive << m_eigenUpdateInterval;
+	archive << m_lastEigenUpdate;
 }
 
 
@@ -236,6 +242,7 @@ void CMA::init(
 
 	m_lowerBound = 1E-20;
 	m_counter = 0;
+	m_lastEigenUpdate = 0;
 }
 
 /**
@@ -248,13 +255,15 @@ void CMA::updateStrategyParameters( const std::vector<Individual<RealVector, dou
 
 	// Covariance matrix update
 	RealMatrix& C = m_mutationDistribution.covarianceMatrix();
-	RealMatrix Z( m_numberOfVariables, m_numberOfVariables, 0.0); // matric for rank-mu update
+	// matrix for rank-mu update, computed as Y^T diag(w) Y with the steps of the parents as rows of Y
+	RealMatrix Y( m_mu, m_numberOfVariables );
+	RealMatrix weightedY( m_mu, m_numberOfVariables );
 	for( unsigned int i = 0; i < m_mu; i++ ) {
-		noalias(Z) += m_weights( i ) * blas::outer_prod(
-			offspring[i].searchPoint() - m_mean,
-			offspring[i].searchPoint() - m_mean
-		);
+		noalias(row(Y,i)) = offspring[i].searchPoint() - m_mean;
+		noalias(row(weightedY,i)) = m_weights( i ) * row(Y,i);
 	}
+	RealMatrix Z( m_numberOfVariables, m_numberOfVariables );
+	axpy_prod( trans(Y), weightedY, Z );
 	
 	double hSigLHS = norm_2( m_evolutionPathSigma ) / std::sqrt(1. - pow((1 - m_cSigma), 2.*(m_counter+1)));
 	double hSigRHS = (1.4 + 2 / (m_numberOfVariables+1.)) * chi( m_numberOfVariables );
@@ -271,8 +280,14 @@ void CMA::updateStrategyParameters( const std::vector<Individual<RealVector, dou
 	m_sigma *= std::exp( (m_cSigma / m_dSigma) * (norm_2(m_evolutionPathSigma)/ chi( m_numberOfVariables ) - 1.) ); // eq. (39)
 
 	
-	// update mutation distribution
-	m_mutationDistribution.update();
+	// update mutation distribution, the eigendecomposition is only recomputed every few generations
+	unsigned int interval = m_eigenUpdateInterval;
+	if( interval == 0 )
+		interval = std::max( 1u, static_cast<unsigned int>( 1. / (10. * m_numberOfVariables * (m_c1 + m_cMu)) ) );
+	if( m_counter - m_lastEigenUpdate >= interval ) {
+		m_mutationDistribution.update();
+		m_lastEigenUpdate = m_counter;
+	}
 	
 	//mean update
 	m_mean = m;
@@ -292,11 +307,15 @@ void CMA::step(ObjectiveFunctionType const& function){
 
 	std::vector< Individual<RealVector, double, RealVector> > offspring( m_lambda );
 
+	//sample all offspring at once
+	RealMatrix steps;
+	RealMatrix samples;
+	m_mutationDistribution.generate( steps, samples, m_lambda );
+
 	PenalizingEvaluator penalizingEvaluator;
 	for( unsigned int i = 0; i < offspring.size(); i++ ) {
-		MultiVariateNormalDistribution::result_type sample = m_mutationDistribution();
-		offspring[i].chromosome() = sample.second;
-		offspring[i].searchPoint() = m_mean + m_sigma * sample.first;
+		offspring[i].chromosome() = row(samples,i);
+		offspring[i].searchPoint() = m_mean + m_sigma * row(steps,i);
 	}
 	penalizingEvaluator( function, offspring.begin(), offspring.end() );
 
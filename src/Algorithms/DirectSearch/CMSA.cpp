@@ -74,18 +74,23 @@ void CMSA::init( ObjectiveFunctionType & function, SearchPointType const& p) {
 	m_sigma = 1.0;
 	m_cSigma = 1./::sqrt( 2. * m_numberOfVariables );
 	m_cC = 1. + (m_numberOfVariables*(m_numberOfVariables + 1.))/(2.*m_mu);
+	m_eigenUpdateCounter = 0;
 }
 
 
 void CMSA::step(ObjectiveFunctionType const& function){
 	std::vector< IndividualType > offspring( m_lambda );
 
+	//sample all offspring at once
+	RealMatrix steps;
+	RealMatrix samples;
+	m_mutationDistribution.generate( steps, samples, m_lambda );
+
 	PenalizingEvaluator penalizingEvaluator;
 	for( unsigned int i = 0; i < offspring.size(); i++ ) {		    
-		MultiVariateNormalDistribution::result_type sample = m_mutationDistribution();
 		offspring[i].chromosome().sigma = m_sigma * ::exp( m_cSigma * Rng::gauss( 0, 1 ) );
-		offspring[i].chromosome().step = sample.first;
-		offspring[i].searchPoint() = m_mean + offspring[i].chromosome().sigma * sample.first;
+		offspring[i].chromosome().step = row(steps,i);
+		offspring[i].searchPoint() = m_mean + offspring[i].chromosome().sigma * row(steps,i);
 	}
 	penalizingEvaluator( function, offspring.begin(), offspring.end() );
 
@@ -103,17 +108,24 @@ void CMSA::step(ObjectiveFunctionType const& function){
 void CMSA::updateStrategyParameters( const std::vector< CMSA::IndividualType > & offspringNew ) {
 	RealVector xPrimeNew = cog( offspringNew, PointExtractor() );
 	// Covariance Matrix Update
-	RealMatrix Znew( m_numberOfVariables, m_numberOfVariables,0.0 );
 	RealMatrix& C = m_mutationDistribution.covarianceMatrix();
-	// Rank-mu-Update
+	// Rank-mu-Update, computed as 1/mu S^T S with the steps as rows of S
+	RealMatrix S( m_mu, m_numberOfVariables );
 	for( unsigned int i = 0; i < m_mu; i++ ) {
-		noalias(Znew) += 1./m_mu * blas::outer_prod( 
-			offspringNew[i].chromosome().step,
-			offspringNew[i].chromosome().step
-		);
+		noalias(row(S,i)) = offspringNew[i].chromosome().step;
 	}
+	RealMatrix Znew( m_numberOfVariables, m_numberOfVariables );
+	axpy_prod( trans(S), S, Znew, true, 1./m_mu );
 	noalias(C) = (1. - 1./m_cC) * C + 1./m_cC * Znew;
-	m_mutationDistribution.update();
+
+	// the eigendecomposition is only recomputed every few generations
+	unsigned int interval = m_eigenUpdateInterval;
+	if( interval == 0 )
+		interval = std::max( 1u, static_cast<unsigned int>( m_cC / (10. * m_numberOfVariables) ) );
+	if( ++m_eigenUpdateCounter >= interval ) {
+		m_mutationDistribution.update();
+		m_eigenUpdateCounter = 0;
+	}
 
 	// Step size update
 	double sigmaNew = 0.;
@@ -136,6 +148,8 @@ void CMSA::read( InArchive & archive ) {
 
 	archive >> m_mean;
 	archive >> m_mutationDistribution;
+	archive >> m_eigenUpdateInterval;
+	archive >> m_eigenUpdateCounter;
 }
 void CMSA::write( OutArchive & archive ) const {
 	archive << m_numberOfVariables;
@@ -148,4 +162,6 @@ void CMSA::write( OutArchive & archive ) const {
 
 	archive << m_mean;
 	archive << m_mutationDistribution;
+	archive << m_eigenUpdateInterval;
+	archive << m_eigenUpdateCounter;
 }
@@ -113,7 +113,8 @@ void PCA::setData(UnlabeledData<RealVector> const& inputs) {
 //! Returns a model mapping the original data to the
 //! m-dimensional PCA coordinate system.
 void PCA::encoder(LinearModel<>& model, std::size_t m) {
-	if(!m) m = std::min(m_n,m_l);
+	if(!m) m = m_eigenvectors.size2();
+	SHARK_CHECK(m <= m_eigenvectors.size2(), "[PCA::encoder] more components requested than computed");
 	
 	RealMatrix A = trans(columns(m_eigenvectors, 0, m) );
 	RealVector offset(A.size1(),0.0); 
@@ -138,7 +139,8 @@ void PCA::encoder(LinearModel<>& model, std::size_t m) {
 //! m-dimensional PCA coordinate system back to the
 //! n-dimensional original coordinate system.
 void PCA::decoder(LinearModel<>& model, std::size_t m) {
-	if(!m) m = std::min(m_n,m_l);
+	if(!m) m = m_eigenvectors.size2();
+	SHARK_CHECK(m <= m_eigenvectors.size2(), "[PCA::decoder] more components requested than computed");
 	if( m == m_n && !m_whitening){
 		model.setStructure(m_eigenvectors, m_mean);
 	}
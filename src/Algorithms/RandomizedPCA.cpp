@@ -0,0 +1,177 @@
+//===========================================================================
+/*!
+ *
+ *
+ * \brief       Randomized and incremental PCA
+ *
+ *
+ *
+ * \author      -
+ * \date        2015
+ *
+ *
+ * \par Copyright 1995-2015 Shark Development Team
+ *
+ * <BR><HR>
+ * This file is part of Shark.
+ * <http://image.diku.dk/shark/>
+ *
+ * Shark is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Shark is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Shark.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+//===========================================================================
+#define SHARK_COMPILE_DLL
+#include <shark/LinAlg/eigenvalues.h>
+#include <shark/Data/Statistics.h>
+#include <shark/Rng/GlobalRng.h>
+#include <shark/Core/OpenMP.h>
+#include <shark/Algorithms/Trainers/RandomizedPCA.h>
+
+using namespace shark;
+
+namespace{
+/// computes Y = C Q for the covariance matrix C of the data in one pass over the batches
+void covarianceProduct(
+	UnlabeledData<RealVector> const& inputs,
+	RealVector const& mean,
+	RealMatrix const& Q,
+	RealMatrix& Y
+){
+	std::size_t numBatches = inputs.numberOfBatches();
+	std::size_t numThreads = std::min(SHARK_NUM_THREADS,numBatches);
+	Y.resize(Q.size1(),Q.size2());
+	Y.clear();
+	parallelBlocks(numBatches, numThreads, [&](std::size_t, std::size_t start, std::size_t end){
+		RealMatrix threadY(Q.size1(),Q.size2(),0.0);
+		for(std::size_t b = start; b != end; ++b){
+			std::size_t batchSize = inputs.batch(b).size1();
+			RealMatrix X = inputs.batch(b)-repeat(mean,batchSize);
+			RealMatrix XQ(batchSize,Q.size2());
+			axpy_prod(X,Q,XQ);
+			axpy_prod(trans(X),XQ,threadY,false);
+		}
+		SHARK_CRITICAL_REGION{
+			noalias(Y) += threadY;
+		}
+	});
+	Y /= inputs.numberOfElements();
+}
+
+/// orthonormalizes the columns of Q by Gram-Schmidt with reorthogonalization.
+/// Columns in the span of the previous ones are set to zero.
+void orthonormalize(RealMatrix& Q){
+	RealVector coefficients(Q.size2());
+	for(std::size_t j = 0; j != Q.size2(); ++j){
+		double initialNorm = norm_2(column(Q,j));
+		for(std::size_t pass = 0; pass != 2 && j != 0; ++pass){
+			RealVectorRange c = subrange(coefficients,0,j);
+			axpy_prod(trans(columns(Q,0,j)),column(Q,j),c);
+			axpy_prod(columns(Q,0,j),c,column(Q,j),false,-1.0);
+		}
+		double norm = norm_2(column(Q,j));
+		if(norm <= 1.e-12 * initialNorm || norm == 0)
+			column(Q,j).clear();
+		else
+			column(Q,j) /= norm;
+	}
+}
+}
+
+void RandomizedPCA::setData(UnlabeledData<RealVector> const& inputs) {
+	SHARK_CHECK(inputs.numberOfElements() >= 2, "[RandomizedPCA::setData] input needs to contain at least two points");
+	m_l = inputs.numberOfElements();
+	m_n = dataDimension(inputs);
+	std::size_t components = std::min(m_components,std::min(m_n,m_l));
+	std::size_t subspace = std::min(components+m_oversampling,m_n);
+
+	m_mean = shark::mean(inputs);
+
+	//random start, followed by the power iterations
+	RealMatrix Q(m_n,subspace);
+	for(std::size_t i = 0; i != m_n; ++i){
+		for(std::size_t j = 0; j != subspace; ++j){
+			Q(i,j) = Rng::gauss();
+		}
+	}
+	RealMatrix Y;
+	for(std::size_t iter = 0; iter <= m_iterations; ++iter){
+		covarianceProduct(inputs,m_mean,Q,Y);
+		swap(Q,Y);
+		orthonormalize(Q);
+	}
+
+	//Rayleigh-Ritz: eigendecomposition of the covariance matrix projected onto the subspace
+	covarianceProduct(inputs,m_mean,Q,Y);
+	RealMatrix H(subspace,subspace);
+	axpy_prod(trans(Q),Y,H);
+	noalias(H) = 0.5*(H+trans(H));
+	RealMatrix U;
+	RealVector lambda;
+	eigensymm(H,U,lambda,components);
+
+	m_eigenvalues = max(lambda,0.0);
+	m_eigenvectors.resize(m_n,components);
+	axpy_prod(Q,U,m_eigenvectors);
+}
+
+void IncrementalPCA::update(RealMatrix const& batch){
+	std::size_t batchSize = batch.size1();
+	if(batchSize == 0) return;
+	if(m_l == 0){
+		m_n = batch.size2();
+		m_mean.resize(m_n);
+		m_mean.clear();
+		m_eigenvalues.resize(0);
+		m_eigenvectors.resize(m_n,0);
+	}
+	SIZE_CHECK(batch.size2() == m_n);
+	std::size_t k = m_eigenvectors.size2();
+
+	//new mean, the old points are weighted by the number of points seen so far
+	RealVector batchMean = sum_rows(batch)/double(batchSize);
+	std::size_t total = m_l + batchSize;
+	double correction = std::sqrt(double(m_l)*batchSize/total);
+
+	//rows of M: current components scaled by their singular values,
+	//the centered batch and the correction for the shifted mean
+	std::size_t rowsM = k + batchSize + 1;
+	RealMatrix M(rowsM,m_n);
+	for(std::size_t i = 0; i != k; ++i){
+		noalias(row(M,i)) = std::sqrt(m_eigenvalues(i)*m_l)*column(m_eigenvectors,i);
+	}
+	noalias(rows(M,k,k+batchSize)) = batch - repeat(batchMean,batchSize);
+	noalias(row(M,rowsM-1)) = correction*(m_mean-batchMean);
+	noalias(m_mean) = (m_l*m_mean + batchSize*batchMean)/double(total);
+
+	//the right singular vectors of M are the new components.
+	//they are obtained from the eigendecomposition of the small matrix M M^T
+	RealMatrix G(rowsM,rowsM);
+	symm_prod(M,G);
+	std::size_t components = std::min(m_components,std::min(m_n,total-1));
+	RealMatrix U;
+	RealVector lambda;
+	if(components != 0)
+		eigensymm(G,U,lambda,components);
+
+	//V = M^T U Sigma^-1, directions with vanishing singular value are dropped
+	std::size_t rank = 0;
+	while(rank != components && lambda(rank) > 1.e-12*std::max(lambda(0),1.e-300))
+		++rank;
+	m_eigenvectors.resize(m_n,rank);
+	axpy_prod(trans(M),columns(U,0,rank),m_eigenvectors);
+	for(std::size_t i = 0; i != rank; ++i)
+		column(m_eigenvectors,i) /= std::sqrt(lambda(i));
+	m_eigenvalues = subrange(lambda,0,rank)/double(total);
+	m_l = total;
+}
@@ -30,51 +30,106 @@
  */
 #define SHARK_COMPILE_DLL
 #include <shark/Models/RNNet.h>
+#include <shark/Models/Neurons.h>
 
 using namespace std;
 using namespace shark;
 
+namespace{
+	//applies the sigmoid of the network to a block of activations
+	template<class Matrix>
+	void applyNeuron(RecurrentStructure::SigmoidType type, Matrix activations){
+		switch(type){
+			case RecurrentStructure::Tanh:
+				noalias(activations) = TanhNeuron()(activations);
+			break;
+			case RecurrentStructure::Logistic:
+				noalias(activations) = LogisticNeuron()(activations);
+			break;
+			case RecurrentStructure::Linear:
+			break;
+			case RecurrentStructure::FastSigmoid:
+				noalias(activations) = FastSigmoidNeuron()(activations);
+			break;
+		}
+	}
+	
+	//multiplies a block of errors with the derivative of the sigmoid given the neuron activations
+	template<class Matrix1, class Matrix2>
+	void multiplyNeuronDerivative(RecurrentStructure::SigmoidType type, Matrix1 const& activations, Matrix2& errors){
+		switch(type){
+			case RecurrentStructure::Tanh:
+				noalias(errors) *= TanhNeuron().derivative(activations);
+			break;
+			case RecurrentStructure::Logistic:
+				noalias(errors) *= LogisticNeuron().derivative(activations);
+			break;
+			case RecurrentStructure::Linear:
+			break;
+			case RecurrentStructure::FastSigmoid:
+				noalias(errors) *= FastSigmoidNeuron().derivative(activations);
+			break;
+		}
+	}
+}
+
 void RNNet::eval(BatchInputType const& patterns, BatchOutputType& outputs, State& state)const{
 	//initialize the history for the whole batch of sequences
 	InternalState& s = state.toState<InternalState>();
 	std::size_t warmUpLength=m_warmUpSequence.size();
 	std::size_t numUnits = mpe_structure->numberOfUnits();
-	s.timeActivation.resize(size(patterns));
-	outputs.resize(size(patterns));
+	std::size_t batchSize = size(patterns);
+	
+	//the batch is processed up to the length of its longest sequence
+	std::size_t maxLength = 0;
+	s.sequenceLengths.resize(batchSize);
+	outputs.resize(batchSize);
+	for(std::size_t b = 0; b != batchSize;++b){
+		s.sequenceLengths[b] = size(get(patterns,b));
+		maxLength = std::max(maxLength,s.sequenceLengths[b]);
+		outputs[b].resize(s.sequenceLengths[b],RealVector(outputSize()));
+	}
+	std::size_t sequenceLength = maxLength+warmUpLength+1;
+	s.timeActivation.resize(sequenceLength);
+	for (std::size_t t = 0; t != sequenceLength;t++){
+		s.timeActivation[t].resize(batchSize,numUnits);
+	}
+	s.timeActivation[0].clear();
 
 	//calculation of the sequences
-	for(std::size_t b = 0; b != size(patterns);++b){
-		std::size_t sequenceLength=size(get(patterns,b))+warmUpLength+1;
-		s.timeActivation[b].resize(sequenceLength,RealVector(numUnits));
-		outputs[b].resize(size(get(patterns,b)),RealVector(numUnits));
-		Sequence& sequence = s.timeActivation[b];
-		sequence[0].clear();
-		for (std::size_t t = 1; t < sequenceLength;t++){
-			//we want to treat input neurons exactly as hidden or output neurons, so we copy the current
-			//pattern at the beginning of the the last activation pattern. After that, all activations
-			//required for this timestep are in s.timeActivation[t-1]
+	for (std::size_t t = 1; t < sequenceLength;t++){
+		RealMatrix& lastActivation = s.timeActivation[t-1];
+		RealMatrix& activation = s.timeActivation[t];
+		//we want to treat input neurons exactly as hidden or output neurons, so we copy the current
+		//patterns at the beginning of the the last activation patterns. After that, all activations
+		//required for this timestep are in lastActivation
+		for(std::size_t b = 0; b != batchSize;++b){
 			if(t<=warmUpLength)
 				//we are still in warm up phase
-				noalias(subrange(sequence[t-1],0,inputSize())) = m_warmUpSequence[t-1];
-			else
-				noalias(subrange(sequence[t-1],0,inputSize())) = patterns[b][t-1-warmUpLength];
-			//and set the bias to 1
-			sequence[t-1](mpe_structure->bias())=1;
+				noalias(subrange(row(lastActivation,b),0,inputSize())) = m_warmUpSequence[t-1];
+			else if(t-1-warmUpLength < s.sequenceLengths[b])
+				noalias(subrange(row(lastActivation,b),0,inputSize())) = patterns[b][t-1-warmUpLength];
+			else//the sequence is already over
+				subrange(row(lastActivation,b),0,inputSize()).clear();
+		}
+		//and set the bias to 1
+		noalias(column(lastActivation,mpe_structure->bias())) = blas::repeat(1.0,batchSize);
 
-			//activation of the hidden neurons is now just a matrix vector multiplication
-			axpy_prod(
-				mpe_structure->weights(),
-				sequence[t-1],
-				subrange(sequence[t],inputSize()+1,numUnits)
-			);
-			//now apply the sigmoid function
-			for (std::size_t i = inputSize()+1;i != numUnits;i++)
-				sequence[t](i) = mpe_structure->neuron(sequence[t](i));
-			
-			//if the warmup is over, we can copy the results into the output
-			if(t>warmUpLength)
-				outputs[b][t-1-warmUpLength] = subrange(sequence[t],numUnits-outputSize(),numUnits);
-			
+		//activation of the hidden neurons of the whole batch is now just a matrix matrix multiplication
+		axpy_prod(
+			lastActivation,
+			trans(mpe_structure->weights()),
+			columns(activation,inputSize()+1,numUnits)
+		);
+		//now apply the sigmoid function
+		applyNeuron(mpe_structure->sigmoidType(),columns(activation,inputSize()+1,numUnits));
+		
+		//if the warmup is over, we can copy the results into the output
+		if(t>warmUpLength){
+			for(std::size_t b = 0; b != batchSize;++b){
+				if(t-1-warmUpLength < s.sequenceLengths[b])
+					noalias(outputs[b][t-1-warmUpLength]) = subrange(row(activation,b),numUnits-outputSize(),numUnits);
+			}
 		}
 	}
 }
@@ -86,50 +141,63 @@ void RNNet::weightedParameterDerivative(
 	//SIZE_CHECK(pattern.size() == coefficients.size());
 	InternalState const& s = state.toState<InternalState>();
 	gradient.resize(numberOfParameters());
-	gradient.clear();
 	
 	std::size_t numUnits = mpe_structure->numberOfUnits();
 	std::size_t numNeurons = mpe_structure->numberOfNeurons();
 	std::size_t warmUpLength=m_warmUpSequence.size();
-	for(std::size_t b = 0; b != size(patterns); ++b){
-		Sequence const& sequence = s.timeActivation[b];
-		std::size_t sequenceLength = size(s.timeActivation[b]);
-		RealMatrix errorDerivative(sequenceLength,numNeurons);
-		errorDerivative.clear();
-		//copy errors
-		for (std::size_t t = warmUpLength+1; t != sequenceLength; ++t)
-			for(std::size_t i = 0; i != outputSize(); ++i)
-				errorDerivative(t,i+numNeurons-outputSize())=coefficients[b][t-warmUpLength-1](i);
-		
-		//backprop through time
-		for (std::size_t t = (int)sequence.size()-1; t > 0; t--){
-			for (std::size_t j = 0; j != numNeurons; ++j){
-				double derivative = mpe_structure->neuronDerivative(sequence[t](j+mpe_structure->inputs()+1));
-				errorDerivative(t,j)*=derivative;
-			}
-			axpy_prod(
-				trans(columns(mpe_structure->weights(), inputSize()+1,numUnits)),
-				row(errorDerivative,t),
-				row(errorDerivative,t-1),
-				false
-			);
+	std::size_t batchSize = s.sequenceLengths.size();
+	std::size_t sequenceLength = s.timeActivation.size();
+	
+	//errorDerivative[t] holds the errors of all neurons of the batch at timestep t
+	std::vector<RealMatrix> errorDerivative(sequenceLength,RealMatrix(batchSize,numNeurons,0.0));
+	//copy errors
+	for(std::size_t b = 0; b != batchSize; ++b){
+		for (std::size_t t = 0; t != s.sequenceLengths[b]; ++t){
+			noalias(subrange(row(errorDerivative[t+warmUpLength+1],b),numNeurons-outputSize(),numNeurons))
+			= coefficients[b][t];
 		}
-		
-		
-		//update gradient for batch element i
-		std::size_t param = 0;
-		for (std::size_t i = 0; i != numNeurons; ++i){
-			for (std::size_t j = 0; j != numUnits; ++j){
-				if(!mpe_structure->connection(i,j))continue;
-
-				for(std::size_t t=1;t != sequence.size(); ++t)
-					gradient(param)+=errorDerivative(t,i) * sequence[t-1](j);
-				
-				++param;
-			}
+	}
+	
+	//backprop through time, one timestep of the whole batch at a time.
+	//Padded timesteps of shorter sequences have zero error and do not contribute.
+	//the transposed copy of the recurrent weights lets the product below compute inner products over consecutive memory
+	RealMatrix recurrentWeightsT = trans(columns(mpe_structure->weights(), inputSize()+1,numUnits));
+	for (std::size_t t = sequenceLength-1; t > 0; t--){
+		multiplyNeuronDerivative(
+			mpe_structure->sigmoidType(),
+			columns(s.timeActivation[t],inputSize()+1,numUnits),
+			errorDerivative[t]
+		);
+		if(t == 1) break;//the errors at timestep 0 are not needed
+		axpy_prod(
+			errorDerivative[t],
+			trans(recurrentWeightsT),
+			errorDerivative[t-1],
+			false
+		);
+	}
+	
+	//The gradient of the weights is the sum over all timesteps t of the products of the errors at t
+	//and the activations at t-1. We compute it as one matrix product of all time blocks. 
+	//The blocks are transposed first, so the product sums over consecutive memory.
+	std::size_t numSteps = sequenceLength-1;
+	RealMatrix errorsT(numNeurons,numSteps*batchSize);
+	RealMatrix activationsT(numUnits,numSteps*batchSize);
+	for (std::size_t t = 1; t < sequenceLength; t++){
+		noalias(columns(errorsT,(t-1)*batchSize,t*batchSize)) = trans(errorDerivative[t]);
+		noalias(columns(activationsT,(t-1)*batchSize,t*batchSize)) = trans(s.timeActivation[t-1]);
+	}
+	RealMatrix weightGradient(numNeurons,numUnits);
+	axpy_prod(errorsT,trans(activationsT),weightGradient);
+	
+	std::size_t param = 0;
+	for (std::size_t i = 0; i != numNeurons; ++i){
+		for (std::size_t j = 0; j != numUnits; ++j){
+			if(!mpe_structure->connection(i,j))continue;
+			gradient(param) = weightGradient(i,j);
+			++param;
 		}
-		//sanity check
-		SIZE_CHECK(param == mpe_structure->parameters());
 	}
+	//sanity check
+	SIZE_CHECK(param == mpe_structure->parameters());
 }
-
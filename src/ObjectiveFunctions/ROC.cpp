@@ -33,6 +33,7 @@
 //===========================================================================
 #define SHARK_COMPILE_DLL
 #include <shark/ObjectiveFunctions/ROC.h>
+#include <shark/ObjectiveFunctions/NegativeAUC.h>
 
 using namespace shark;
 
@@ -57,10 +58,10 @@ double ROC::threshold(double falseAcceptanceRate)const{
 double ROC::value(double falseAcceptanceRate)const
 {
 	double threshold = this->threshold(falseAcceptanceRate);
-	size_t i;
 
 	// "verification rate" = 1.0 - "false rejection rate"
-	for (i = 0; m_scorePositive[i] < threshold && i < m_scorePositive.size(); i++);
+	// the scores are sorted, so the number of rejected positives is found by binary search
+	std::size_t i = std::lower_bound(m_scorePositive.begin(), m_scorePositive.end(), threshold) - m_scorePositive.begin();
 	if (i == 0) return 1.0;
 	else if (i == m_scorePositive.size()) return 0.0;
 
@@ -86,7 +87,7 @@ double ROC::equalErrorRate()const
 	for (i = 0; i < (int)m_scoreNegative.size(); i++)
 	{
 		threshold = m_scoreNegative[i];
-		for (; m_scorePositive[c] < threshold && c < (int)m_scorePositive.size(); c++);
+		for (; c < (int)m_scorePositive.size() && m_scorePositive[c] < threshold; c++);
 
 		e1 = i / di;			// type 1 error
 		e2 = 1.0 - c / dc;		// type 2 error
@@ -96,3 +97,40 @@ double ROC::equalErrorRate()const
 	return 0.5 *(e1 + e2);
 }
 
+
+//! Area under the ROC curve, ties count one half
+double ROC::area()const
+{
+	std::size_t P = m_scorePositive.size();
+	std::size_t N = m_scoreNegative.size();
+	SHARK_CHECK(P > 0 && N > 0, "[ROC::area] both classes must be present");
+
+	double A = detail::countOrderedPairs(m_scorePositive, m_scoreNegative, 0.5);
+	return A / (double(P) * double(N));
+}
+
+//! Average precision, the area under the precision-recall curve
+double ROC::averagePrecision()const
+{
+	std::size_t P = m_scorePositive.size();
+	std::size_t N = m_scoreNegative.size();
+	SHARK_CHECK(P > 0, "[ROC::averagePrecision] no positive examples");
+
+	// lower the threshold from the largest score downwards. Recall only changes
+	// at scores of positive examples, so only those thresholds are visited.
+	double AP = 0.0;
+	std::size_t i = P; // positives with index >= i are accepted
+	std::size_t j = N; // negatives with index >= j are accepted
+	while (i > 0)
+	{
+		double threshold = m_scorePositive[i - 1];
+		std::size_t next = i;
+		while (next > 0 && m_scorePositive[next - 1] >= threshold) next--;
+		while (j > 0 && m_scoreNegative[j - 1] >= threshold) j--;
+		double truePositives = double(P - next);
+		double falsePositives = double(N - j);
+		AP += (i - next) / double(P) * truePositives / (truePositives + falsePositives);
+		i = next;
+	}
+	return AP;
+}